@@ -0,0 +1,218 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+//Compares the startup cost of decoding PNG textures and building their mip
+//chains with loading baked textures, over every PNG file in a directory:
+//
+//   Locus_Benchmark_BakedTexture [assetDirectory]
+//
+//Without a directory, a set of generated PNG files in the working directory
+//is used. The baked files are written to the working directory. A cold load
+//is a first run, when every texture is baked. A warm load is every run after
+//that. The OS file cache isn't flushed between runs.
+
+#include "BenchmarkUtility.h"
+
+#include "Locus/Rendering/BakedTexture.h"
+#include "Locus/Rendering/MipChain.h"
+#include "Locus/Rendering/Image.h"
+
+#include "Locus/FileSystem/FileSystemUtil.h"
+
+#include "Locus/Common/ThreadPool.h"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <algorithm>
+
+#include <cmath>
+#include <cstdio>
+
+using namespace Locus;
+
+static const unsigned int Num_Generated_Assets = 16;
+static const unsigned int Generated_Asset_Size = 1024;
+static const unsigned int Num_Repetitions = 3;
+
+static std::vector<std::string> GenerateAssets()
+{
+   std::vector<std::string> assetPaths;
+
+   for (unsigned int assetIndex = 0; assetIndex < Num_Generated_Assets; ++assetIndex)
+   {
+      Image image(Generated_Asset_Size, Generated_Asset_Size, 4);
+
+      for (unsigned int y = 0; y < Generated_Asset_Size; ++y)
+      {
+         for (unsigned int x = 0; x < Generated_Asset_Size; ++x)
+         {
+            unsigned char* pixel = image.GetPixel(x, y);
+
+            pixel[0] = static_cast<unsigned char>(128 + 127 * std::sin(x * 0.01 * (assetIndex + 1)));
+            pixel[1] = static_cast<unsigned char>(128 + 127 * std::cos(y * 0.013 + assetIndex));
+            pixel[2] = static_cast<unsigned char>(x ^ y);
+            pixel[3] = static_cast<unsigned char>(x * y / Generated_Asset_Size + assetIndex * 9);
+         }
+      }
+
+      assetPaths.push_back("BakedTextureBenchmark_" + std::to_string(assetIndex) + ".png");
+
+      image.SaveAsPNG(assetPaths.back());
+   }
+
+   return assetPaths;
+}
+
+static std::vector<std::string> FindAssets(const std::string& assetDirectory)
+{
+   std::vector<std::string> fileNames;
+   GetAllFilesInDirectory(assetDirectory, fileNames);
+
+   std::sort(fileNames.begin(), fileNames.end());
+
+   std::vector<std::string> assetPaths;
+
+   for (const std::string& fileName : fileNames)
+   {
+      if ((fileName.size() > 4) && (fileName.compare(fileName.size() - 4, 4, ".png") == 0))
+      {
+         assetPaths.push_back(assetDirectory + "/" + fileName);
+      }
+   }
+
+   return assetPaths;
+}
+
+//BC1 or BC3 where the components allow it, since that is what a game would ship
+static BakedTexture::Format CompressedFormat(unsigned int numPixelComponents)
+{
+   switch (numPixelComponents)
+   {
+   case 4:
+      return BakedTexture::Format::BC3;
+
+   case 3:
+      return BakedTexture::Format::BC1;
+
+   default:
+      return BakedTexture::Format::Uncompressed;
+   }
+}
+
+//reads one byte per page, so that the mapped levels are actually paged in as an upload would
+static unsigned int TouchLevels(const BakedTexture& bakedTexture)
+{
+   unsigned int sum = 0;
+
+   for (unsigned int level = 0; level < bakedTexture.NumLevels(); ++level)
+   {
+      const BakedTexture::Level& bakedLevel = bakedTexture.GetLevel(level);
+
+      for (std::size_t byteIndex = 0; byteIndex < bakedLevel.sizeInBytes; byteIndex += 4096)
+      {
+         sum += bakedLevel.pixelData[byteIndex];
+      }
+   }
+
+   return sum;
+}
+
+int main(int argc, char** argv)
+{
+   const bool generated = (argc < 2);
+
+   const std::vector<std::string> assetPaths = (generated ? GenerateAssets() : FindAssets(argv[1]));
+
+   if (assetPaths.empty())
+   {
+      std::cout << "No PNG files found" << std::endl;
+      return 1;
+   }
+
+   std::vector<unsigned int> numPixelComponents;
+   std::vector<std::string> bakedPaths;
+
+   for (const std::string& assetPath : assetPaths)
+   {
+      numPixelComponents.push_back(Image(assetPath).NumPixelComponents());
+
+      std::string fileName = assetPath.substr(assetPath.find_last_of('/') + 1);
+
+      bakedPaths.push_back("BakedTextureBenchmark_" + fileName + ".lbtx");
+   }
+
+   const std::string assetCount = std::to_string(assetPaths.size()) + " textures";
+
+   ThreadPool threadPool;
+
+   volatile unsigned int sink = 0;
+
+   Benchmark::PrintResult("PNG decode + mip chain, " + assetCount, Benchmark::AverageMilliseconds(Num_Repetitions, [&]()
+   {
+      for (const std::string& assetPath : assetPaths)
+      {
+         MipChain mipChain(Image(assetPath), false, &threadPool);
+
+         sink = sink + mipChain.PixelData()[0];
+      }
+   }));
+
+   for (bool compressed : { false, true })
+   {
+      auto loadAll = [&]()
+      {
+         for (std::size_t assetIndex = 0; assetIndex < assetPaths.size(); ++assetIndex)
+         {
+            BakedTexture::Format format = (compressed ? CompressedFormat(numPixelComponents[assetIndex]) : BakedTexture::Format::Uncompressed);
+
+            std::unique_ptr<BakedTexture> bakedTexture = BakedTexture::LoadOrBake(assetPaths[assetIndex], bakedPaths[assetIndex], format, &threadPool);
+
+            sink = sink + TouchLevels(*bakedTexture);
+         }
+      };
+
+      const std::string formatName = (compressed ? "BC1/BC3" : "uncompressed");
+
+      double coldMilliseconds = 0;
+
+      for (unsigned int repetition = 0; repetition < Num_Repetitions; ++repetition)
+      {
+         for (const std::string& bakedPath : bakedPaths)
+         {
+            std::remove(bakedPath.c_str());
+         }
+
+         Benchmark::Stopwatch stopwatch;
+
+         loadAll();
+
+         coldMilliseconds += stopwatch.ElapsedMilliseconds();
+      }
+
+      Benchmark::PrintResult("Baked " + formatName + ", cold, " + assetCount, coldMilliseconds / Num_Repetitions);
+      Benchmark::PrintResult("Baked " + formatName + ", warm, " + assetCount, Benchmark::AverageMilliseconds(Num_Repetitions, loadAll));
+   }
+
+   for (const std::string& bakedPath : bakedPaths)
+   {
+      std::remove(bakedPath.c_str());
+   }
+
+   if (generated)
+   {
+      for (const std::string& assetPath : assetPaths)
+      {
+         std::remove(assetPath.c_str());
+      }
+   }
+
+   return 0;
+}
\ No newline at end of file
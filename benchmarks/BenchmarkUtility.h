@@ -0,0 +1,67 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+namespace Locus
+{
+
+namespace Benchmark
+{
+
+class Stopwatch
+{
+public:
+   Stopwatch()
+      : start(std::chrono::steady_clock::now())
+   {
+   }
+
+   void Restart()
+   {
+      start = std::chrono::steady_clock::now();
+   }
+
+   double ElapsedMilliseconds() const
+   {
+      return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+   }
+
+private:
+   std::chrono::steady_clock::time_point start;
+};
+
+/// \return the average time in milliseconds of one call to func, over numRepetitions calls.
+template <class Func>
+double AverageMilliseconds(unsigned int numRepetitions, Func func)
+{
+   Stopwatch stopwatch;
+
+   for (unsigned int repetition = 0; repetition < numRepetitions; ++repetition)
+   {
+      func();
+   }
+
+   return stopwatch.ElapsedMilliseconds() / numRepetitions;
+}
+
+inline void PrintResult(const std::string& name, double milliseconds)
+{
+   std::cout << std::left << std::setw(64) << name << std::right << std::setw(12) << std::fixed << std::setprecision(3) << milliseconds << " ms" << std::endl;
+}
+
+}
+
+}
\ No newline at end of file
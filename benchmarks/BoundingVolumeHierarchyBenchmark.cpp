@@ -0,0 +1,413 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "BenchmarkUtility.h"
+
+#include "Locus/Geometry/BoundingVolumeHierarchy.h"
+#include "Locus/Geometry/RelativeTransformation.h"
+#include "Locus/Geometry/Moveable.h"
+#include "Locus/Geometry/Plane.h"
+#include "Locus/Geometry/Geometry.h"
+#include "Locus/Geometry/Vector3Geometry.h"
+
+#include "Locus/Common/ThreadPool.h"
+#include "Locus/Common/Util.h"
+
+#include <vector>
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+
+using namespace Locus;
+
+static const std::size_t Num_Query_Major_Segments = 250;
+static const std::size_t Num_Build_Major_Segments = 500;
+static const std::size_t Num_Minor_Segments = 200;
+
+static const float Major_Radius = 10.0f;
+static const float Minor_Radius = 3.0f;
+
+static const std::size_t Leaf_Triangles = 8;
+static const std::size_t Max_Depth = 6;
+
+static const unsigned int Num_Repetitions = 10;
+static const unsigned int Num_Build_Repetitions = 3;
+
+typedef std::unordered_map<std::size_t, Triangle3D_t> TriangleInputMap_t;
+
+/*!
+ * \brief The node layout BoundingVolumeHierarchy had before it was
+ * flattened: every node owns its triangle indices and up to eight
+ * heap-allocated children.
+ *
+ * \details BuildPointerNode is the builder of that time. It splits at
+ * the same centers as BoundingVolumeHierarchy's octant split, so both
+ * layouts have the same shape and give the same intersection sets.
+ */
+template <class BoundingVolume>
+struct PointerNode
+{
+   BoundingVolume boundingVolume;
+   bool isLeaf;
+   std::vector<std::size_t> containedTriangles;
+   std::array<std::unique_ptr<PointerNode>, 8> children;
+};
+
+//a torus around the Z axis with two triangles per quad
+static std::vector<Triangle3D_t> MakeTorus(std::size_t numMajorSegments)
+{
+   auto getPoint = [numMajorSegments](std::size_t majorIndex, std::size_t minorIndex)->FVector3
+   {
+      float majorAngle = (TWO_PI * (majorIndex % numMajorSegments)) / numMajorSegments;
+      float minorAngle = (TWO_PI * (minorIndex % Num_Minor_Segments)) / Num_Minor_Segments;
+
+      float distanceFromAxis = Major_Radius + Minor_Radius * std::cos(minorAngle);
+
+      return FVector3(distanceFromAxis * std::cos(majorAngle), distanceFromAxis * std::sin(majorAngle), Minor_Radius * std::sin(minorAngle));
+   };
+
+   std::vector<Triangle3D_t> triangles;
+   triangles.reserve(2 * numMajorSegments * Num_Minor_Segments);
+
+   for (std::size_t majorIndex = 0; majorIndex < numMajorSegments; ++majorIndex)
+   {
+      for (std::size_t minorIndex = 0; minorIndex < Num_Minor_Segments; ++minorIndex)
+      {
+         FVector3 corner00 = getPoint(majorIndex, minorIndex);
+         FVector3 corner10 = getPoint(majorIndex + 1, minorIndex);
+         FVector3 corner01 = getPoint(majorIndex, minorIndex + 1);
+         FVector3 corner11 = getPoint(majorIndex + 1, minorIndex + 1);
+
+         triangles.push_back(Triangle3D_t(corner00, corner10, corner11));
+         triangles.push_back(Triangle3D_t(corner00, corner11, corner01));
+      }
+   }
+
+   return triangles;
+}
+
+static std::vector<FVector3> GetUniquePointsFromTriangles(const TriangleInputMap_t& triangles)
+{
+   std::vector<FVector3> uniquePoints;
+   uniquePoints.reserve(triangles.size() * Triangle3D_t::NumPointsOnATriangle);
+
+   for (const TriangleInputMap_t::value_type& triangle : triangles)
+   {
+      uniquePoints.push_back(triangle.second[0]);
+      uniquePoints.push_back(triangle.second[1]);
+      uniquePoints.push_back(triangle.second[2]);
+   }
+
+   SortAndRemoveDuplicates(uniquePoints);
+
+   return uniquePoints;
+}
+
+static FVector3 GetCenterOfBoundingVolume(const Sphere& boundingVolume)
+{
+   return boundingVolume.center;
+}
+
+static FVector3 GetCenterOfBoundingVolume(const AxisAlignedBox& boundingVolume)
+{
+   return boundingVolume.Centroid();
+}
+
+static FVector3 GetCenterOfBoundingVolume(const OrientedBox& boundingVolume)
+{
+   return boundingVolume.centroid;
+}
+
+template <class BoundingVolume>
+static BoundingVolume InstantiateBoundingVolumeFromPoints(const std::vector<FVector3>& points)
+{
+   return BoundingVolume(points);
+}
+
+template <>
+AxisAlignedBox InstantiateBoundingVolumeFromPoints(const std::vector<FVector3>& points)
+{
+   return AxisAlignedBox(points, false);
+}
+
+//the first octant that the triangle is not entirely outside of
+static std::size_t GetOctant(const std::array<Plane, 3>& splitPlanes, const Triangle3D_t& triangle)
+{
+   std::size_t octant = 0;
+
+   if (splitPlanes[0].triangleIntersectionTest(triangle) == Plane::IntersectionQuery::Negative)
+   {
+      octant += 4;
+   }
+
+   if (splitPlanes[1].triangleIntersectionTest(triangle) == Plane::IntersectionQuery::Positive)
+   {
+      octant += 2;
+   }
+
+   if (splitPlanes[2].triangleIntersectionTest(triangle) == Plane::IntersectionQuery::Negative)
+   {
+      octant += 1;
+   }
+
+   return octant;
+}
+
+template <class BoundingVolume>
+static std::unique_ptr<PointerNode<BoundingVolume>> BuildPointerNode(const TriangleInputMap_t& triangles, const BoundingVolume& boundingVolume, std::size_t currentDepth)
+{
+   std::unique_ptr<PointerNode<BoundingVolume>> node = std::make_unique<PointerNode<BoundingVolume>>();
+
+   node->boundingVolume = boundingVolume;
+   node->isLeaf = true;
+
+   node->containedTriangles.reserve(triangles.size());
+
+   for (const TriangleInputMap_t::value_type& triangle : triangles)
+   {
+      node->containedTriangles.push_back(triangle.first);
+   }
+
+   if ((triangles.size() > Leaf_Triangles) && (currentDepth < Max_Depth))
+   {
+      node->isLeaf = false;
+
+      const FVector3 center = GetCenterOfBoundingVolume(boundingVolume);
+
+      const std::array<Plane, 3> splitPlanes = { Plane(center, Vec3D::XAxis()), Plane(center, Vec3D::YAxis()), Plane(center, Vec3D::ZAxis()) };
+
+      std::array<TriangleInputMap_t, 8> trianglesInOctants;
+
+      for (const TriangleInputMap_t::value_type& triangle : triangles)
+      {
+         trianglesInOctants[GetOctant(splitPlanes, triangle.second)][triangle.first] = triangle.second;
+      }
+
+      for (std::size_t childIndex = 0; childIndex < 8; ++childIndex)
+      {
+         if (!trianglesInOctants[childIndex].empty())
+         {
+            node->children[childIndex] = BuildPointerNode(trianglesInOctants[childIndex], InstantiateBoundingVolumeFromPoints<BoundingVolume>(GetUniquePointsFromTriangles(trianglesInOctants[childIndex])), currentDepth + 1);
+         }
+      }
+   }
+
+   return node;
+}
+
+template <class BoundingVolume>
+static std::unique_ptr<PointerNode<BoundingVolume>> BuildPointerTree(const std::vector<Triangle3D_t>& triangles)
+{
+   TriangleInputMap_t triangleInputMap;
+
+   for (std::size_t triangleIndex = 0; triangleIndex < triangles.size(); ++triangleIndex)
+   {
+      triangleInputMap.emplace(triangleIndex, triangles[triangleIndex]);
+   }
+
+   return BuildPointerNode(triangleInputMap, InstantiateBoundingVolumeFromPoints<BoundingVolume>(GetUniquePointsFromTriangles(triangleInputMap)), 0);
+}
+
+template <class BoundingVolume>
+static std::unique_ptr<PointerNode<BoundingVolume>> CopyPointerNode(const PointerNode<BoundingVolume>& otherNode)
+{
+   std::unique_ptr<PointerNode<BoundingVolume>> node = std::make_unique<PointerNode<BoundingVolume>>();
+
+   node->boundingVolume = otherNode.boundingVolume;
+   node->isLeaf = otherNode.isLeaf;
+   node->containedTriangles = otherNode.containedTriangles;
+
+   for (std::size_t childIndex = 0; childIndex < 8; ++childIndex)
+   {
+      if (otherNode.children[childIndex] != nullptr)
+      {
+         node->children[childIndex] = CopyPointerNode(*otherNode.children[childIndex]);
+      }
+   }
+
+   return node;
+}
+
+template <class BoundingVolume>
+static void InsertContainedTriangles(const PointerNode<BoundingVolume>& node, std::unordered_set<std::size_t>& intersectionSet)
+{
+   intersectionSet.insert(node.containedTriangles.begin(), node.containedTriangles.end());
+}
+
+//BoundingVolumeHierarchy::GetIntersection written for the pointer layout, so that
+//only the layout differs between the two timings
+template <class BoundingVolume>
+static void GetIntersection(const PointerNode<BoundingVolume>& thisRoot, const Moveable& thisMoveable, const PointerNode<BoundingVolume>& otherRoot, const Moveable& otherMoveable, std::unordered_set<std::size_t>& thisIntersectionSet, std::unordered_set<std::size_t>& otherIntersectionSet)
+{
+   RelativeTransformation relativeTransformation(thisMoveable, otherMoveable);
+
+   std::vector<std::pair<const PointerNode<BoundingVolume>*, const PointerNode<BoundingVolume>*>> stack;
+   stack.reserve(128);
+
+   stack.emplace_back(&thisRoot, &otherRoot);
+
+   while (!stack.empty())
+   {
+      const PointerNode<BoundingVolume>* thisNode = stack.back().first;
+      const PointerNode<BoundingVolume>* otherNode = stack.back().second;
+
+      stack.pop_back();
+
+      if (!thisNode->boundingVolume.Intersects(otherNode->boundingVolume, relativeTransformation))
+      {
+         continue;
+      }
+
+      if (thisNode->isLeaf && otherNode->isLeaf)
+      {
+         InsertContainedTriangles(*thisNode, thisIntersectionSet);
+         InsertContainedTriangles(*otherNode, otherIntersectionSet);
+
+         continue;
+      }
+
+      bool descendThis = !thisNode->isLeaf && (otherNode->isLeaf || (thisNode->boundingVolume.SurfaceArea() >= otherNode->boundingVolume.SurfaceArea()));
+
+      const PointerNode<BoundingVolume>* descendedNode = (descendThis ? thisNode : otherNode);
+
+      for (const std::unique_ptr<PointerNode<BoundingVolume>>& child : descendedNode->children)
+      {
+         if (child != nullptr)
+         {
+            if (descendThis)
+            {
+               stack.emplace_back(child.get(), otherNode);
+            }
+            else
+            {
+               stack.emplace_back(thisNode, child.get());
+            }
+         }
+      }
+   }
+}
+
+//returns false if the two layouts found different intersection sets
+template <class BoundingVolume>
+static bool CompareLayouts(const std::string& treeName, const std::vector<Triangle3D_t>& triangles, const Moveable& moveable1, const Moveable& moveable2)
+{
+   const std::unique_ptr<PointerNode<BoundingVolume>> pointerTree = BuildPointerTree<BoundingVolume>(triangles);
+   const BoundingVolumeHierarchy<BoundingVolume> flattenedTree(triangles, Leaf_Triangles, Max_Depth);
+
+   Benchmark::PrintResult(treeName + " copy, pointer layout", Benchmark::AverageMilliseconds(Num_Repetitions, [&]()
+   {
+      CopyPointerNode(*pointerTree);
+   }));
+
+   Benchmark::PrintResult(treeName + " copy, flattened", Benchmark::AverageMilliseconds(Num_Repetitions, [&]()
+   {
+      BoundingVolumeHierarchy<BoundingVolume> copiedTree(flattenedTree);
+   }));
+
+   std::unordered_set<std::size_t> pointerSet1, pointerSet2;
+
+   Benchmark::PrintResult(treeName + " GetIntersection, pointer layout", Benchmark::AverageMilliseconds(Num_Repetitions, [&]()
+   {
+      pointerSet1.clear();
+      pointerSet2.clear();
+
+      GetIntersection(*pointerTree, moveable1, *pointerTree, moveable2, pointerSet1, pointerSet2);
+   }));
+
+   std::unordered_set<std::size_t> flattenedSet1, flattenedSet2;
+
+   Benchmark::PrintResult(treeName + " GetIntersection, flattened", Benchmark::AverageMilliseconds(Num_Repetitions, [&]()
+   {
+      flattenedSet1.clear();
+      flattenedSet2.clear();
+
+      flattenedTree.GetIntersection(moveable1, flattenedTree, moveable2, flattenedSet1, flattenedSet2);
+   }));
+
+   std::cout << pointerSet1.size() << " and " << pointerSet2.size() << " triangles in the intersection sets" << std::endl;
+
+   return ((pointerSet1 == flattenedSet1) && (pointerSet2 == flattenedSet2));
+}
+
+template <class BoundingVolume>
+static void TimeBuilds(const std::string& treeName, const std::vector<Triangle3D_t>& triangles, ThreadPool& threadPool)
+{
+   const std::string threadCount = std::to_string(threadPool.NumThreads()) + " thread(s)";
+
+   Benchmark::PrintResult(treeName + " build, per-node hash maps", Benchmark::AverageMilliseconds(Num_Build_Repetitions, [&]()
+   {
+      BuildPointerTree<BoundingVolume>(triangles);
+   }));
+
+   Benchmark::PrintResult(treeName + " build, octants, serial", Benchmark::AverageMilliseconds(Num_Build_Repetitions, [&]()
+   {
+      BoundingVolumeHierarchy<BoundingVolume> tree(triangles, Leaf_Triangles, Max_Depth);
+   }));
+
+   Benchmark::PrintResult(treeName + " build, octants, " + threadCount, Benchmark::AverageMilliseconds(Num_Build_Repetitions, [&]()
+   {
+      BoundingVolumeHierarchy<BoundingVolume> tree(triangles, Leaf_Triangles, Max_Depth, &threadPool);
+   }));
+
+   //binary splits need three levels to divide as finely as one level of octants
+   const typename BoundingVolumeHierarchy<BoundingVolume>::SplitMethod surfaceAreaHeuristic = BoundingVolumeHierarchy<BoundingVolume>::SplitMethod::BinnedSurfaceAreaHeuristic;
+
+   Benchmark::PrintResult(treeName + " build, SAH, serial", Benchmark::AverageMilliseconds(Num_Build_Repetitions, [&]()
+   {
+      BoundingVolumeHierarchy<BoundingVolume> tree(triangles, surfaceAreaHeuristic, Leaf_Triangles, 3 * Max_Depth);
+   }));
+
+   Benchmark::PrintResult(treeName + " build, SAH, " + threadCount, Benchmark::AverageMilliseconds(Num_Build_Repetitions, [&]()
+   {
+      BoundingVolumeHierarchy<BoundingVolume> tree(triangles, surfaceAreaHeuristic, Leaf_Triangles, 3 * Max_Depth, &threadPool);
+   }));
+}
+
+int main()
+{
+   const std::vector<Triangle3D_t> buildTriangles = MakeTorus(Num_Build_Major_Segments);
+
+   std::cout << buildTriangles.size() << " triangles" << std::endl;
+
+   ThreadPool threadPool(std::max(std::thread::hardware_concurrency(), 1u));
+
+   TimeBuilds<Sphere>("Sphere tree", buildTriangles, threadPool);
+   TimeBuilds<AxisAlignedBox>("AABB tree", buildTriangles, threadPool);
+   TimeBuilds<OrientedBox>("OBB tree", buildTriangles, threadPool);
+
+   const std::vector<Triangle3D_t> triangles = MakeTorus(Num_Query_Major_Segments);
+
+   std::cout << triangles.size() << " triangles" << std::endl;
+
+   //two instances of the model, the second tilted and overlapping the rim of the first
+   Moveable moveable1;
+
+   Moveable moveable2;
+   moveable2.Rotate(FVector3(0.3f, 0.0f, 0.0f));
+   moveable2.Translate(FVector3(2.0f * Major_Radius + Minor_Radius, 0.0f, 0.0f));
+
+   bool setsMatch = CompareLayouts<Sphere>("Sphere tree", triangles, moveable1, moveable2);
+   setsMatch = CompareLayouts<AxisAlignedBox>("AABB tree", triangles, moveable1, moveable2) && setsMatch;
+   setsMatch = CompareLayouts<OrientedBox>("OBB tree", triangles, moveable1, moveable2) && setsMatch;
+
+   if (!setsMatch)
+   {
+      std::cout << "The two layouts found different intersection sets" << std::endl;
+      return 1;
+   }
+
+   return 0;
+}
\ No newline at end of file
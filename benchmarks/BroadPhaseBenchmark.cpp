@@ -0,0 +1,225 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "BenchmarkUtility.h"
+
+#include "Locus/Geometry/CollisionManager.h"
+#include "Locus/Geometry/Collidable.h"
+
+#include <vector>
+#include <string>
+#include <random>
+#include <cmath>
+#include <utility>
+#include <algorithm>
+#include <iostream>
+
+using namespace Locus;
+
+class Box : public Collidable
+{
+public:
+   Box()
+      : index(0), halfLength(1.0f), resolvedPairs(nullptr)
+   {
+   }
+
+   std::size_t index;
+   FVector3 center;
+   FVector3 velocity;
+   float halfLength;
+   std::vector<std::pair<std::size_t, std::size_t>>* resolvedPairs;
+
+   virtual void UpdateBroadCollisionExtent() override
+   {
+      Collidable::UpdateBroadCollisionExtent(center, halfLength);
+   }
+
+   virtual void ResolveCollision(Collidable& collidable) override
+   {
+      std::size_t otherIndex = static_cast<const Box&>(collidable).index;
+
+      resolvedPairs->push_back( std::make_pair(std::min(index, otherIndex), std::max(index, otherIndex)) );
+   }
+};
+
+enum class Distribution
+{
+   Uniform,
+
+   //boxes gathered around a few random points
+   Clustered,
+
+   //boxes spread over a few thin slabs perpendicular to the x axis,
+   //so that many of them overlap along x
+   Stratified
+};
+
+static std::string DistributionName(Distribution distribution)
+{
+   switch (distribution)
+   {
+   case Distribution::Clustered:
+      return "clustered";
+
+   case Distribution::Stratified:
+      return "stratified";
+
+   default:
+      return "uniform";
+   }
+}
+
+static std::string BroadPhaseName(CollisionManager::BroadPhaseType broadPhaseType)
+{
+   return ((broadPhaseType == CollisionManager::BroadPhaseType::SweepAndPrune) ? "SweepAndPrune" : "HashedGrid");
+}
+
+struct BenchmarkResult
+{
+   double milliseconds;
+
+   //the sorted pairs found on the last frame
+   std::vector<std::pair<std::size_t, std::size_t>> pairs;
+};
+
+//times UpdateCollisions on numBoxes boxes that all move every frame. The
+//world grows with the number of boxes so that the density stays the same
+static BenchmarkResult TimeMovingBoxes(CollisionManager::BroadPhaseType broadPhaseType, Distribution distribution, std::size_t numBoxes)
+{
+   const unsigned int numFrames = 20;
+   const float worldHalfLength = 10.0f * std::cbrt(static_cast<float>(numBoxes));
+   const std::size_t numClusters = 16;
+   const std::size_t numStrata = 4;
+
+   std::mt19937 randomEngine(1);
+   std::uniform_real_distribution<float> positionDistribution(-worldHalfLength, worldHalfLength);
+   std::normal_distribution<float> clusterDistribution(0.0f, worldHalfLength / 16.0f);
+   std::uniform_real_distribution<float> strataDistribution(-1.0f, 1.0f);
+   std::uniform_real_distribution<float> velocityDistribution(-1.0f, 1.0f);
+   std::uniform_real_distribution<float> halfLengthDistribution(0.5f, 3.0f);
+
+   std::vector<FVector3> clusterCenters(numClusters);
+   for (FVector3& clusterCenter : clusterCenters)
+   {
+      clusterCenter = FVector3(positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine));
+   }
+
+   BenchmarkResult result;
+
+   std::vector<Box> boxes(numBoxes);
+   std::vector<CollisionHandle_t> handles(numBoxes);
+
+   CollisionManager collisionManager(broadPhaseType);
+
+   collisionManager.StartAddRemoveBatch();
+
+   for (std::size_t boxIndex = 0; boxIndex < numBoxes; ++boxIndex)
+   {
+      Box& box = boxes[boxIndex];
+
+      box.index = boxIndex;
+
+      switch (distribution)
+      {
+      case Distribution::Clustered:
+         box.center = clusterCenters[boxIndex % numClusters] + FVector3(clusterDistribution(randomEngine), clusterDistribution(randomEngine), clusterDistribution(randomEngine));
+         break;
+
+      case Distribution::Stratified:
+         box.center = FVector3(worldHalfLength * (static_cast<float>(boxIndex % numStrata) / numStrata) + strataDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine));
+         break;
+
+      default:
+         box.center = FVector3(positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine));
+         break;
+      }
+
+      box.velocity = FVector3(velocityDistribution(randomEngine), velocityDistribution(randomEngine), velocityDistribution(randomEngine));
+
+      if (distribution == Distribution::Stratified)
+      {
+         box.velocity.x *= 0.01f;
+      }
+
+      box.halfLength = halfLengthDistribution(randomEngine);
+      box.resolvedPairs = &result.pairs;
+      box.UpdateBroadCollisionExtent();
+
+      handles[boxIndex] = collisionManager.Add(&box);
+   }
+
+   collisionManager.FinishAddRemoveBatch();
+   collisionManager.UpdateCollisions();
+
+   double totalMilliseconds = 0.0;
+
+   Benchmark::Stopwatch stopwatch;
+
+   for (unsigned int frame = 0; frame < numFrames; ++frame)
+   {
+      for (std::size_t boxIndex = 0; boxIndex < numBoxes; ++boxIndex)
+      {
+         Box& box = boxes[boxIndex];
+
+         box.center += box.velocity;
+         box.UpdateBroadCollisionExtent();
+
+         collisionManager.Update(handles[boxIndex]);
+      }
+
+      stopwatch.Restart();
+      collisionManager.UpdateCollisions();
+      totalMilliseconds += stopwatch.ElapsedMilliseconds();
+   }
+
+   result.milliseconds = totalMilliseconds / numFrames;
+
+   collisionManager.TransmitCollisions();
+   std::sort(result.pairs.begin(), result.pairs.end());
+
+   return result;
+}
+
+int main()
+{
+   const std::size_t boxCounts[] = { 100, 1000, 5000, 10000, 50000 };
+   const Distribution distributions[] = { Distribution::Uniform, Distribution::Clustered, Distribution::Stratified };
+   const CollisionManager::BroadPhaseType broadPhaseTypes[] = { CollisionManager::BroadPhaseType::SweepAndPrune, CollisionManager::BroadPhaseType::HashedGrid };
+
+   bool allPairsIdentical = true;
+
+   for (Distribution distribution : distributions)
+   {
+      for (std::size_t numBoxes : boxCounts)
+      {
+         std::vector<std::pair<std::size_t, std::size_t>> firstPairs;
+
+         for (CollisionManager::BroadPhaseType broadPhaseType : broadPhaseTypes)
+         {
+            BenchmarkResult result = TimeMovingBoxes(broadPhaseType, distribution, numBoxes);
+
+            Benchmark::PrintResult(BroadPhaseName(broadPhaseType) + ", " + std::to_string(numBoxes) + " " + DistributionName(distribution) + " moving boxes", result.milliseconds);
+
+            if (broadPhaseType == broadPhaseTypes[0])
+            {
+               firstPairs = std::move(result.pairs);
+            }
+            else if (result.pairs != firstPairs)
+            {
+               std::cout << "The broad phases found different pairs" << std::endl;
+               allPairsIdentical = false;
+            }
+         }
+      }
+   }
+
+   return (allPairsIdentical ? 0 : 1);
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "BenchmarkUtility.h"
+
+#include "Locus/Geometry/FrustumCuller.h"
+#include "Locus/Geometry/Frustum.h"
+#include "Locus/Geometry/Sphere.h"
+
+#include "Locus/Common/ThreadPool.h"
+
+#include <vector>
+#include <string>
+#include <random>
+#include <thread>
+#include <algorithm>
+
+using namespace Locus;
+
+static const std::size_t Num_Objects = 100000;
+static const unsigned int Num_Repetitions = 20;
+
+static std::vector<Sphere> MakeSpheres()
+{
+   std::mt19937 randomEngine(1);
+   std::uniform_real_distribution<float> positionDistribution(-500.0f, 500.0f);
+   std::uniform_real_distribution<float> radiusDistribution(0.5f, 4.0f);
+
+   std::vector<Sphere> spheres(Num_Objects);
+
+   for (Sphere& sphere : spheres)
+   {
+      sphere = Sphere(FVector3(positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine)), radiusDistribution(randomEngine));
+   }
+
+   return spheres;
+}
+
+static double TimeCull(FrustumCuller& culler, const Frustum& frustum, std::vector<CullingHandle_t>& visibleHandles)
+{
+   return Benchmark::AverageMilliseconds(Num_Repetitions, [&]()
+   {
+      culler.Cull(frustum, visibleHandles);
+   });
+}
+
+int main()
+{
+   std::vector<Sphere> spheres = MakeSpheres();
+
+   Frustum frustum(FVector3(0.0f, 0.0f, 0.0f), FVector3(0.0f, 0.0f, -1.0f), FVector3(0.0f, 1.0f, 0.0f), 90.0f, 60.0f, 0.1f, 400.0f);
+
+   FrustumCuller culler;
+
+   std::vector<CullingHandle_t> handles;
+   handles.reserve(Num_Objects);
+
+   for (const Sphere& sphere : spheres)
+   {
+      handles.push_back(culler.Add(sphere));
+   }
+
+   const std::string objectCount = std::to_string(Num_Objects) + " objects";
+
+   Benchmark::PrintResult("Update, " + objectCount, Benchmark::AverageMilliseconds(Num_Repetitions, [&]()
+   {
+      for (std::size_t objectIndex = 0; objectIndex < Num_Objects; ++objectIndex)
+      {
+         culler.Update(handles[objectIndex], spheres[objectIndex]);
+      }
+   }));
+
+   std::vector<CullingHandle_t> serialVisibleHandles;
+
+   Benchmark::PrintResult("Cull, serial, " + objectCount, TimeCull(culler, frustum, serialVisibleHandles));
+
+   const unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+   for (unsigned int numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+   {
+      ThreadPool threadPool(numThreads);
+      culler.SetThreadPool(&threadPool);
+
+      std::vector<CullingHandle_t> visibleHandles;
+
+      Benchmark::PrintResult("Cull, " + std::to_string(numThreads) + " thread(s), " + objectCount, TimeCull(culler, frustum, visibleHandles));
+
+      culler.SetThreadPool(nullptr);
+
+      if (visibleHandles != serialVisibleHandles)
+      {
+         std::cout << "The threaded cull found different visible objects than the serial one" << std::endl;
+         return 1;
+      }
+   }
+
+   std::cout << serialVisibleHandles.size() << " of " << Num_Objects << " objects are visible" << std::endl;
+
+   return 0;
+}
\ No newline at end of file
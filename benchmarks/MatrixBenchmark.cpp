@@ -0,0 +1,287 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "BenchmarkUtility.h"
+
+#include "Locus/Math/Matrix.h"
+#include "Locus/Math/SJTPermutations.h"
+
+#include "Locus/Common/Float.h"
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+using namespace Locus;
+
+typedef Matrix<double> Matrix_t;
+
+static Matrix_t MakeRandomMatrix(unsigned int dimension, std::mt19937& randomEngine)
+{
+   std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+
+   Matrix_t matrix(dimension, dimension);
+
+   for (unsigned int row = 0; row < dimension; ++row)
+   {
+      for (unsigned int col = 0; col < dimension; ++col)
+      {
+         matrix(row, col) = distribution(randomEngine);
+      }
+   }
+
+   return matrix;
+}
+
+//the triple loop operator* used before it was tiled
+static Matrix_t OldMultiply(const Matrix_t& matrixLeft, const Matrix_t& matrixRight)
+{
+   Matrix_t multiplied(matrixLeft.Rows(), matrixRight.Columns());
+
+   for (unsigned int rowInResult = 0; rowInResult < matrixLeft.Rows(); ++rowInResult)
+   {
+      for (unsigned int columnInResult = 0; columnInResult < matrixRight.Columns(); ++columnInResult)
+      {
+         double multipliedValue = 0;
+
+         for (unsigned int commonDimensionIndex = 0; commonDimensionIndex < matrixLeft.Columns(); ++commonDimensionIndex)
+         {
+            multipliedValue += matrixLeft(rowInResult, commonDimensionIndex) * matrixRight(commonDimensionIndex, columnInResult);
+         }
+
+         multiplied(rowInResult, columnInResult) = multipliedValue;
+      }
+   }
+
+   return multiplied;
+}
+
+//the expansion over all n! permutations that Determinant used before the LU decomposition
+static double OldDeterminant(const Matrix_t& matrix)
+{
+   double determinant = 0;
+
+   SJTPermutations permutations(matrix.Rows());
+
+   char signOfPermutation = 1;
+
+   do
+   {
+      double determinantSubProduct = signOfPermutation;
+
+      for (unsigned int dimensionIndex = 0; dimensionIndex < matrix.Rows(); ++dimensionIndex)
+      {
+         determinantSubProduct *= matrix(dimensionIndex, permutations.GetElement(dimensionIndex));
+      }
+
+      determinant += determinantSubProduct;
+
+      signOfPermutation *= -1;
+   } while (permutations.GenerateNext());
+
+   return determinant;
+}
+
+//the reduction of [A | I] to reduced row echelon form that Invert used before the LU decomposition
+static bool OldInvert(Matrix_t& matrix)
+{
+   const unsigned int dimension = matrix.Rows();
+
+   Matrix_t augmentedMatrix = matrix;
+
+   augmentedMatrix.AddColumns(dimension);
+
+   for (unsigned int col = dimension; col < (2 * dimension); ++col)
+   {
+      augmentedMatrix(col - dimension, col) = 1;
+   }
+
+   augmentedMatrix.MakeRowEchelon(true);
+
+   for (unsigned int col = 0; col < dimension; ++col)
+   {
+      if (FNotEqual<double>(augmentedMatrix(col, col), 1))
+      {
+         return false;
+      }
+   }
+
+   for (unsigned int row = 0; row < dimension; ++row)
+   {
+      for (unsigned int col = 0; col < dimension; ++col)
+      {
+         matrix(row, col) = augmentedMatrix(row, dimension + col);
+      }
+   }
+
+   return true;
+}
+
+//max |A * inverse - I|
+static double InverseResidual(const Matrix_t& matrix, const Matrix_t& inverse)
+{
+   Matrix_t product = matrix * inverse;
+
+   double residual = 0;
+
+   for (unsigned int row = 0; row < product.Rows(); ++row)
+   {
+      for (unsigned int col = 0; col < product.Columns(); ++col)
+      {
+         residual = std::max(residual, std::fabs(product(row, col) - ((row == col) ? 1 : 0)));
+      }
+   }
+
+   return residual;
+}
+
+static unsigned int RepetitionsFor(unsigned int dimension)
+{
+   return std::max(1000000u / (dimension * dimension * dimension), 1u);
+}
+
+//returns false if the tiled product differs from the triple loop
+static bool CompareMultiply(unsigned int dimension, std::mt19937& randomEngine)
+{
+   const Matrix_t matrixLeft = MakeRandomMatrix(dimension, randomEngine);
+   const Matrix_t matrixRight = MakeRandomMatrix(dimension, randomEngine);
+
+   const std::string size = std::to_string(dimension) + "x" + std::to_string(dimension);
+   const unsigned int numRepetitions = RepetitionsFor(dimension);
+
+   Matrix_t oldProduct(1, 1);
+   Matrix_t product(1, 1);
+
+   Benchmark::PrintResult("Multiply " + size + ", triple loop", Benchmark::AverageMilliseconds(numRepetitions, [&]()
+   {
+      oldProduct = OldMultiply(matrixLeft, matrixRight);
+   }));
+
+   Benchmark::PrintResult("Multiply " + size + ", tiled", Benchmark::AverageMilliseconds(numRepetitions, [&]()
+   {
+      product = matrixLeft * matrixRight;
+   }));
+
+   bool identical = (oldProduct.GetElements() == product.GetElements());
+
+   std::cout << (identical ? "identical products" : "products differ") << std::endl;
+
+   return identical;
+}
+
+static void CompareDeterminant(unsigned int dimension, std::mt19937& randomEngine)
+{
+   const Matrix_t matrix = MakeRandomMatrix(dimension, randomEngine);
+
+   const std::string size = std::to_string(dimension) + "x" + std::to_string(dimension);
+
+   double oldDeterminant = 0;
+   double determinant = 0;
+
+   Benchmark::PrintResult("Determinant " + size + ", permutation expansion", Benchmark::AverageMilliseconds(3, [&]()
+   {
+      oldDeterminant = OldDeterminant(matrix);
+   }));
+
+   Benchmark::PrintResult("Determinant " + size + ", LU, 1000 calls", Benchmark::AverageMilliseconds(10, [&]()
+   {
+      for (unsigned int call = 0; call < 1000; ++call)
+      {
+         determinant = matrix.Determinant();
+      }
+   }));
+
+   std::cout << std::scientific << std::setprecision(2) << "relative difference " << std::fabs(determinant - oldDeterminant) / std::fabs(oldDeterminant) << std::endl;
+}
+
+static void CompareInvert(unsigned int dimension, std::mt19937& randomEngine)
+{
+   const Matrix_t matrix = MakeRandomMatrix(dimension, randomEngine);
+
+   const std::string size = std::to_string(dimension) + "x" + std::to_string(dimension);
+   const unsigned int numRepetitions = RepetitionsFor(dimension);
+
+   Matrix_t oldInverse(matrix);
+   bool oldInverted = false;
+
+   Benchmark::PrintResult("Invert " + size + ", row echelon", Benchmark::AverageMilliseconds(numRepetitions, [&]()
+   {
+      oldInverse = matrix;
+      oldInverted = OldInvert(oldInverse);
+   }));
+
+   Matrix_t inverse(matrix);
+   bool inverted = false;
+
+   Benchmark::PrintResult("Invert " + size + ", LU", Benchmark::AverageMilliseconds(numRepetitions, [&]()
+   {
+      inverse = matrix;
+      inverted = inverse.Invert();
+   }));
+
+   std::vector<double> x(dimension, 1.0);
+   std::vector<double> b = matrix * x;
+   std::vector<double> solution;
+
+   Benchmark::PrintResult("Solve " + size + ", LU", Benchmark::AverageMilliseconds(numRepetitions, [&]()
+   {
+      matrix.Solve(b, solution);
+   }));
+
+   double solutionError = 0;
+
+   for (double element : solution)
+   {
+      solutionError = std::max(solutionError, std::fabs(element - 1.0));
+   }
+
+   std::cout << std::scientific << std::setprecision(2);
+
+   if (oldInverted)
+   {
+      std::cout << "row echelon residual " << InverseResidual(matrix, oldInverse);
+   }
+   else
+   {
+      std::cout << "row echelon reported a singular matrix";
+   }
+
+   if (inverted)
+   {
+      std::cout << ", LU residual " << InverseResidual(matrix, inverse);
+   }
+   else
+   {
+      std::cout << ", LU reported a singular matrix";
+   }
+
+   std::cout << ", solve error " << solutionError << std::endl;
+}
+
+int main()
+{
+   std::mt19937 randomEngine(1);
+
+   bool productsMatch = CompareMultiply(64, randomEngine);
+   productsMatch = CompareMultiply(300, randomEngine) && productsMatch;
+
+   CompareDeterminant(8, randomEngine);
+   CompareDeterminant(10, randomEngine);
+
+   CompareInvert(10, randomEngine);
+   CompareInvert(100, randomEngine);
+   CompareInvert(300, randomEngine);
+
+   return (productsMatch ? 0 : 1);
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "BenchmarkUtility.h"
+
+#include "Locus/Geometry/TickMoveables.h"
+
+#include "Locus/Common/ThreadPool.h"
+
+#include <vector>
+#include <string>
+#include <random>
+#include <thread>
+#include <algorithm>
+
+using namespace Locus;
+
+static const std::size_t Num_Moveables = 100000;
+static const unsigned int Num_Frames = 10;
+
+static std::vector<MoveableMotion> MakeMotions()
+{
+   std::mt19937 randomEngine(1);
+   std::uniform_real_distribution<float> translationDistribution(-0.5f, 0.5f);
+   std::uniform_real_distribution<float> rotationDistribution(-0.05f, 0.05f);
+
+   std::vector<MoveableMotion> motions(Num_Moveables);
+
+   for (MoveableMotion& motion : motions)
+   {
+      motion.translation = FVector3(translationDistribution(randomEngine), translationDistribution(randomEngine), translationDistribution(randomEngine));
+      motion.rotation = FVector3(rotationDistribution(randomEngine), rotationDistribution(randomEngine), rotationDistribution(randomEngine));
+   }
+
+   return motions;
+}
+
+//reads the model transformation of every readStride-th moveable, the way
+//a renderer would for the visible ones
+static float ReadTransformations(const std::vector<Moveable>& moveables, std::size_t readStride)
+{
+   float sum = 0.0f;
+
+   for (std::size_t moveableIndex = 0; moveableIndex < moveables.size(); moveableIndex += readStride)
+   {
+      sum += moveables[moveableIndex].CurrentModelTransformation()(0, 3);
+   }
+
+   return sum;
+}
+
+int main()
+{
+   const std::vector<MoveableMotion> motions = MakeMotions();
+
+   std::vector<Moveable> moveables(Num_Moveables);
+
+   const std::string moveableCount = std::to_string(Num_Moveables) + " moveables";
+
+   volatile float sink = 0.0f;
+
+   //what every frame cost when each Translate and Rotate composed the transformations
+   Benchmark::PrintResult("Compose after every move, " + moveableCount, Benchmark::AverageMilliseconds(Num_Frames, [&]()
+   {
+      for (std::size_t moveableIndex = 0; moveableIndex < Num_Moveables; ++moveableIndex)
+      {
+         moveables[moveableIndex].Translate(motions[moveableIndex].translation);
+         moveables[moveableIndex].UpdateTransformations();
+
+         moveables[moveableIndex].Rotate(motions[moveableIndex].rotation);
+         moveables[moveableIndex].UpdateTransformations();
+      }
+
+      sink = sink + ReadTransformations(moveables, 1);
+   }));
+
+   Benchmark::PrintResult("TickMoveables, read all, " + moveableCount, Benchmark::AverageMilliseconds(Num_Frames, [&]()
+   {
+      TickMoveables(moveables.data(), motions.data(), Num_Moveables);
+
+      sink = sink + ReadTransformations(moveables, 1);
+   }));
+
+   Benchmark::PrintResult("TickMoveables, read 10%, " + moveableCount, Benchmark::AverageMilliseconds(Num_Frames, [&]()
+   {
+      TickMoveables(moveables.data(), motions.data(), Num_Moveables);
+
+      sink = sink + ReadTransformations(moveables, 10);
+   }));
+
+   const unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+   for (unsigned int numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+   {
+      ThreadPool threadPool(numThreads);
+
+      Benchmark::PrintResult("TickMoveables, " + std::to_string(numThreads) + " thread(s), no reads, " + moveableCount, Benchmark::AverageMilliseconds(Num_Frames, [&]()
+      {
+         TickMoveables(moveables.data(), motions.data(), Num_Moveables, &threadPool);
+      }));
+   }
+
+   return 0;
+}
\ No newline at end of file
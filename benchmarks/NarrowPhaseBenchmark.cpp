@@ -0,0 +1,126 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "BenchmarkUtility.h"
+
+#include "Locus/Geometry/CollisionManager.h"
+#include "Locus/Geometry/Collidable.h"
+#include "Locus/Geometry/Vector3Geometry.h"
+
+#include "Locus/Common/ThreadPool.h"
+
+#include <vector>
+#include <string>
+#include <random>
+#include <thread>
+#include <algorithm>
+
+using namespace Locus;
+
+//a ball whose narrow phase test checks every point on its surface against
+//the other ball. This stands in for the mesh tests done by real Collidables
+class SampledBall : public Collidable
+{
+public:
+   SampledBall()
+      : radius(1.0f)
+   {
+   }
+
+   FVector3 center;
+   float radius;
+   std::vector<FVector3> surfacePoints;
+
+   virtual void UpdateBroadCollisionExtent() override
+   {
+      Collidable::UpdateBroadCollisionExtent(center, radius);
+   }
+
+   virtual bool CollidesWith(Collidable& collidable) const override
+   {
+      const SampledBall& other = static_cast<const SampledBall&>(collidable);
+
+      const float otherSquaredRadius = other.radius * other.radius;
+
+      for (const FVector3& surfacePoint : surfacePoints)
+      {
+         if (SquaredNorm(center + surfacePoint - other.center) <= otherSquaredRadius)
+         {
+            return true;
+         }
+      }
+
+      return false;
+   }
+
+   virtual void ResolveCollision(Collidable&) override
+   {
+   }
+};
+
+static double TimeTransmitCollisions(ThreadPool* threadPool)
+{
+   const std::size_t numBalls = 20000;
+   const std::size_t numSurfacePoints = 512;
+   const unsigned int numRepetitions = 5;
+
+   std::mt19937 randomEngine(1);
+   std::uniform_real_distribution<float> positionDistribution(-150.0f, 150.0f);
+   std::uniform_real_distribution<float> radiusDistribution(1.0f, 4.0f);
+   std::normal_distribution<float> directionDistribution;
+
+   std::vector<SampledBall> balls(numBalls);
+
+   CollisionManager collisionManager;
+   collisionManager.SetNarrowPhaseThreadPool(threadPool);
+
+   collisionManager.StartAddRemoveBatch();
+
+   for (SampledBall& ball : balls)
+   {
+      ball.center = FVector3(positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine));
+      ball.radius = radiusDistribution(randomEngine);
+
+      ball.surfacePoints.resize(numSurfacePoints);
+
+      for (FVector3& surfacePoint : ball.surfacePoints)
+      {
+         surfacePoint = NormVector(FVector3(directionDistribution(randomEngine), directionDistribution(randomEngine), directionDistribution(randomEngine))) * ball.radius;
+      }
+
+      ball.UpdateBroadCollisionExtent();
+
+      collisionManager.Add(&ball);
+   }
+
+   collisionManager.FinishAddRemoveBatch();
+   collisionManager.UpdateCollisions();
+
+   return Benchmark::AverageMilliseconds(numRepetitions, [&]()
+   {
+      collisionManager.TransmitCollisions();
+   });
+}
+
+int main()
+{
+   Benchmark::PrintResult("TransmitCollisions, serial", TimeTransmitCollisions(nullptr));
+
+   const unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+   for (unsigned int numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+   {
+      ThreadPool threadPool(numThreads);
+
+      Benchmark::PrintResult("TransmitCollisions, " + std::to_string(numThreads) + " thread(s)", TimeTransmitCollisions(&threadPool));
+   }
+
+   return 0;
+}
\ No newline at end of file
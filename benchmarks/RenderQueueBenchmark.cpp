@@ -0,0 +1,124 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "BenchmarkUtility.h"
+
+#include "Locus/Rendering/RenderQueue.h"
+
+#include <vector>
+#include <string>
+#include <random>
+#include <iostream>
+
+using namespace Locus;
+
+//Recording and sorting only use the texture and vertex data pointers as
+//keys, so these stand in for real objects, which would need a GL context
+struct FakeResources
+{
+   FakeResources(std::size_t numTextures, std::size_t numVertexData)
+      : storage((numTextures + numVertexData) * Stride)
+   {
+      for (std::size_t textureIndex = 0; textureIndex < numTextures; ++textureIndex)
+      {
+         textures.push_back( reinterpret_cast<const Texture*>(&storage[textureIndex * Stride]) );
+      }
+
+      for (std::size_t vertexDataIndex = 0; vertexDataIndex < numVertexData; ++vertexDataIndex)
+      {
+         vertexData.push_back( reinterpret_cast<const GPUVertexData*>(&storage[(numTextures + vertexDataIndex) * Stride]) );
+      }
+   }
+
+   static const std::size_t Stride = 256;
+
+   std::vector<char> storage;
+   std::vector<const Texture*> textures;
+   std::vector<const GPUVertexData*> vertexData;
+};
+
+static void PrintStateChanges(const std::string& name, const RenderQueue::StateChanges& stateChanges)
+{
+   std::cout << name << ": " << stateChanges.programChanges << " program, " << stateChanges.textureChanges << " texture, "
+             << stateChanges.vertexDataChanges << " vertex data changes for " << stateChanges.drawCalls << " draws" << std::endl;
+}
+
+static void RunBenchmark(std::size_t numPackets)
+{
+   const unsigned int numRepetitions = 20;
+   const ID_t numPrograms = 8;
+
+   FakeResources resources(64, 256);
+
+   std::mt19937 randomEngine(1);
+   std::uniform_int_distribution<ID_t> programDistribution(1, numPrograms);
+   std::uniform_int_distribution<std::size_t> textureDistribution(0, resources.textures.size() - 1);
+   std::uniform_int_distribution<std::size_t> vertexDataDistribution(0, resources.vertexData.size() - 1);
+   std::uniform_int_distribution<unsigned int> layerDistribution(0, 3);
+
+   struct Draw
+   {
+      ID_t program;
+      const Texture* texture;
+      const GPUVertexData* vertexData;
+      unsigned int layer;
+   };
+
+   std::vector<Draw> draws(numPackets);
+
+   for (Draw& draw : draws)
+   {
+      draw.program = programDistribution(randomEngine);
+      draw.texture = resources.textures[textureDistribution(randomEngine)];
+      draw.vertexData = resources.vertexData[vertexDataDistribution(randomEngine)];
+      draw.layer = layerDistribution(randomEngine);
+   }
+
+   RenderQueue renderQueue;
+   renderQueue.Reserve(numPackets);
+
+   auto record = [&]()
+   {
+      renderQueue.Clear();
+
+      for (const Draw& draw : draws)
+      {
+         renderQueue.Add(draw.program, draw.texture, draw.vertexData, Transformation::Identity(), draw.layer);
+      }
+   };
+
+   std::string suffix = ", " + std::to_string(numPackets) + " packets";
+
+   Benchmark::PrintResult("Record" + suffix, Benchmark::AverageMilliseconds(numRepetitions, record));
+
+   record();
+   PrintStateChanges("Recording order" + suffix, renderQueue.CountStateChanges());
+
+   Benchmark::PrintResult("Record and Sort" + suffix, Benchmark::AverageMilliseconds(numRepetitions, [&]()
+   {
+      record();
+      renderQueue.Sort();
+   }));
+
+   PrintStateChanges("Sorted order" + suffix, renderQueue.CountStateChanges());
+
+   Benchmark::PrintResult("CountStateChanges" + suffix, Benchmark::AverageMilliseconds(numRepetitions, [&]()
+   {
+      renderQueue.CountStateChanges();
+   }));
+}
+
+int main()
+{
+   RunBenchmark(10000);
+   RunBenchmark(100000);
+
+   return 0;
+}
\ No newline at end of file
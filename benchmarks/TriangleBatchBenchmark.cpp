@@ -0,0 +1,309 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "BenchmarkUtility.h"
+
+#include "Locus/Common/InstructionSet.h"
+
+#include "Locus/Geometry/TriangleBatch.h"
+#include "Locus/Geometry/Triangle.h"
+#include "Locus/Geometry/Geometry.h"
+
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+using namespace Locus;
+
+static PlainTriangle3D MakeTriangle(const FVector3& point0, const FVector3& point1, const FVector3& point2)
+{
+   PlainTriangle3D triangle;
+
+   triangle.points[0] = point0;
+   triangle.points[1] = point1;
+   triangle.points[2] = point2;
+
+   return triangle;
+}
+
+static std::vector<PlainTriangle3D> MakeRandomTriangles(std::size_t numTriangles, std::mt19937& randomEngine)
+{
+   std::uniform_real_distribution<float> centerDistribution(-1.0f, 1.0f);
+   std::uniform_real_distribution<float> offsetDistribution(-0.4f, 0.4f);
+
+   auto randomPoint = [&](const FVector3& center)->FVector3
+   {
+      return center + FVector3(offsetDistribution(randomEngine), offsetDistribution(randomEngine), offsetDistribution(randomEngine));
+   };
+
+   std::vector<PlainTriangle3D> triangles;
+
+   for (std::size_t triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+   {
+      FVector3 center(centerDistribution(randomEngine), centerDistribution(randomEngine), centerDistribution(randomEngine));
+
+      triangles.push_back(MakeTriangle(randomPoint(center), randomPoint(center), randomPoint(center)));
+   }
+
+   return triangles;
+}
+
+//a torus around the Z axis with two triangles per quad, rotated by the given angle around the X axis and then moved
+static std::vector<PlainTriangle3D> MakeTorus(std::size_t numMajorSegments, std::size_t numMinorSegments, float angle, const FVector3& translation)
+{
+   auto getPoint = [=](std::size_t majorIndex, std::size_t minorIndex)->FVector3
+   {
+      float majorAngle = (TWO_PI * (majorIndex % numMajorSegments)) / numMajorSegments;
+      float minorAngle = (TWO_PI * (minorIndex % numMinorSegments)) / numMinorSegments;
+
+      float distanceFromAxis = 2.0f + 0.6f * std::cos(minorAngle);
+
+      FVector3 point(distanceFromAxis * std::cos(majorAngle), distanceFromAxis * std::sin(majorAngle), 0.6f * std::sin(minorAngle));
+
+      return FVector3(point.x, (point.y * std::cos(angle)) - (point.z * std::sin(angle)), (point.y * std::sin(angle)) + (point.z * std::cos(angle))) + translation;
+   };
+
+   std::vector<PlainTriangle3D> triangles;
+
+   for (std::size_t majorIndex = 0; majorIndex < numMajorSegments; ++majorIndex)
+   {
+      for (std::size_t minorIndex = 0; minorIndex < numMinorSegments; ++minorIndex)
+      {
+         FVector3 corner00 = getPoint(majorIndex, minorIndex);
+         FVector3 corner10 = getPoint(majorIndex + 1, minorIndex);
+         FVector3 corner01 = getPoint(majorIndex, minorIndex + 1);
+         FVector3 corner11 = getPoint(majorIndex + 1, minorIndex + 1);
+
+         triangles.push_back(MakeTriangle(corner00, corner10, corner11));
+         triangles.push_back(MakeTriangle(corner00, corner11, corner01));
+      }
+   }
+
+   return triangles;
+}
+
+static bool BoundsOverlap(const PlainTriangle3D& triangle1, const PlainTriangle3D& triangle2)
+{
+   for (int coordinate = 0; coordinate < 3; ++coordinate)
+   {
+      float min1 = std::min({triangle1.points[0][coordinate], triangle1.points[1][coordinate], triangle1.points[2][coordinate]});
+      float max1 = std::max({triangle1.points[0][coordinate], triangle1.points[1][coordinate], triangle1.points[2][coordinate]});
+      float min2 = std::min({triangle2.points[0][coordinate], triangle2.points[1][coordinate], triangle2.points[2][coordinate]});
+      float max2 = std::max({triangle2.points[0][coordinate], triangle2.points[1][coordinate], triangle2.points[2][coordinate]});
+
+      if ((max1 < min2) || (max2 < min1))
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+//each query triangle with the candidates it is tested against, the way
+//Model::GetResolvedCollision groups the pairs that the BVH reports
+struct CandidateGroup
+{
+   PlainTriangle3D query;
+   std::vector<PlainTriangle3D> candidates;
+};
+
+static std::size_t CountPairs(const std::vector<CandidateGroup>& groups)
+{
+   std::size_t numPairs = 0;
+
+   for (const CandidateGroup& group : groups)
+   {
+      numPairs += group.candidates.size();
+   }
+
+   return numPairs;
+}
+
+static std::string InstructionSetName(InstructionSet instructionSet)
+{
+   switch (instructionSet)
+   {
+   case InstructionSet::AVX:
+      return "AVX";
+
+   case InstructionSet::SSE2:
+      return "SSE2";
+
+   default:
+      return "scalar";
+   }
+}
+
+//times every way of testing the groups. The batches are built once and timed
+//separately. Each count is checked against TrianglesIntersect, which also
+//keeps the compiler from dropping the work
+static int TimeGroups(const std::string& name, const std::vector<CandidateGroup>& groups, unsigned int numRepetitions)
+{
+   std::size_t expectedHits = 0;
+
+   for (const CandidateGroup& group : groups)
+   {
+      for (const PlainTriangle3D& candidate : group.candidates)
+      {
+         if (TrianglesIntersect(group.query, candidate))
+         {
+            ++expectedHits;
+         }
+      }
+   }
+
+   std::cout << name << ": " << CountPairs(groups) << " pairs, " << expectedHits << " intersecting" << std::endl;
+
+   int result = 0;
+   std::size_t numHits = 0;
+
+   Benchmark::PrintResult(name + ", Triangle3D_t built per pair, one way", Benchmark::AverageMilliseconds(numRepetitions, [&]()
+   {
+      numHits = 0;
+
+      for (const CandidateGroup& group : groups)
+      {
+         Triangle3D_t query = ToTriangle(group.query);
+
+         for (const PlainTriangle3D& candidate : group.candidates)
+         {
+            if (query.TriangleIntersection(ToTriangle(candidate)))
+            {
+               ++numHits;
+            }
+         }
+      }
+   }));
+
+   std::cout << "   which finds " << numHits << " of the intersecting pairs" << std::endl;
+
+   Benchmark::PrintResult(name + ", TrianglesIntersect", Benchmark::AverageMilliseconds(numRepetitions, [&]()
+   {
+      numHits = 0;
+
+      for (const CandidateGroup& group : groups)
+      {
+         for (const PlainTriangle3D& candidate : group.candidates)
+         {
+            if (TrianglesIntersect(group.query, candidate))
+            {
+               ++numHits;
+            }
+         }
+      }
+   }));
+
+   if (numHits != expectedHits)
+   {
+      result = 1;
+   }
+
+   const InstructionSet supportedInstructionSet = DetectInstructionSet();
+
+   const InstructionSet instructionSets[] = { InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX };
+
+   std::vector<TriangleBatch> batches(groups.size());
+
+   Benchmark::PrintResult(name + ", building the batches", Benchmark::AverageMilliseconds(numRepetitions, [&]()
+   {
+      for (std::size_t groupIndex = 0; groupIndex < groups.size(); ++groupIndex)
+      {
+         batches[groupIndex].Clear();
+
+         for (const PlainTriangle3D& candidate : groups[groupIndex].candidates)
+         {
+            batches[groupIndex].Add(candidate);
+         }
+      }
+   }));
+
+   std::vector<std::size_t> intersectingIndices;
+
+   for (InstructionSet instructionSet : instructionSets)
+   {
+      if (instructionSet > supportedInstructionSet)
+      {
+         continue;
+      }
+
+      LimitInstructionSet(instructionSet);
+
+      Benchmark::PrintResult(name + ", TriangleBatch with " + InstructionSetName(instructionSet), Benchmark::AverageMilliseconds(numRepetitions, [&]()
+      {
+         numHits = 0;
+
+         for (std::size_t groupIndex = 0; groupIndex < groups.size(); ++groupIndex)
+         {
+            intersectingIndices.clear();
+            batches[groupIndex].FindIntersections(groups[groupIndex].query, intersectingIndices);
+
+            numHits += intersectingIndices.size();
+         }
+      }));
+
+      if (numHits != expectedHits)
+      {
+         result = 1;
+      }
+   }
+
+   LimitInstructionSet(InstructionSet::AVX);
+
+   return result;
+}
+
+int main()
+{
+   std::mt19937 randomEngine(1);
+
+   std::vector<PlainTriangle3D> randomCandidates = MakeRandomTriangles(20000, randomEngine);
+
+   std::vector<CandidateGroup> randomGroups(64);
+
+   for (CandidateGroup& group : randomGroups)
+   {
+      group.query = MakeRandomTriangles(1, randomEngine).front();
+      group.candidates = randomCandidates;
+   }
+
+   int result = TimeGroups("Random", randomGroups, 5);
+
+   //two crossing tori, with the pairs whose bounds overlap as the candidates
+   std::vector<PlainTriangle3D> torus1 = MakeTorus(192, 64, 0.0f, FVector3(0.0f, 0.0f, 0.0f));
+   std::vector<PlainTriangle3D> torus2 = MakeTorus(192, 64, HALF_PI, FVector3(3.0f, 0.0f, 0.0f));
+
+   std::vector<CandidateGroup> meshGroups;
+
+   for (const PlainTriangle3D& query : torus1)
+   {
+      CandidateGroup group;
+      group.query = query;
+
+      for (const PlainTriangle3D& candidate : torus2)
+      {
+         if (BoundsOverlap(query, candidate))
+         {
+            group.candidates.push_back(candidate);
+         }
+      }
+
+      if (!group.candidates.empty())
+      {
+         meshGroups.push_back(group);
+      }
+   }
+
+   result |= TimeGroups("Tori", meshGroups, 50);
+
+   return result;
+}
\ No newline at end of file
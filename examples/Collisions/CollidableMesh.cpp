@@ -13,6 +13,7 @@
 #include "Locus/Geometry/Geometry.h"
 #include "Locus/Geometry/Plane.h"
 #include "Locus/Geometry/Triangle.h"
+#include "Locus/Geometry/TriangleBatch.h"
 
 #include "Locus/Rendering/RenderingState.h"
 
@@ -78,16 +79,21 @@ void CollidableMesh::CreateBoundingVolumeHierarchy()
 
 bool CollidableMesh::GetCollidableMeshIntersection(CollidableMesh& other,  Locus::Triangle3D_t& intersectingTriangle1, Locus::Triangle3D_t& intersectingTriangle2)
 {
-   std::unordered_set<std::size_t> thisIntersectionSet;
-   std::unordered_set<std::size_t> otherIntersectionSet;
+   auto trianglesIntersect = [this, &other](std::size_t thisTriangleIndex, std::size_t otherTriangleIndex)->bool
+   {
+      return Locus::TrianglesIntersect(GetPlainFaceTriangle(thisTriangleIndex), other.GetPlainFaceTriangle(otherTriangleIndex));
+   };
 
-   boundingVolumeHierarchy->GetIntersection(*this, *other.boundingVolumeHierarchy, other, thisIntersectionSet, otherIntersectionSet);
+   Locus::TrianglePair_t intersectingPair;
 
-   if ((thisIntersectionSet.size() > 0) && (otherIntersectionSet.size() > 0))
+   if (boundingVolumeHierarchy->Intersects(*this, *other.boundingVolumeHierarchy, other, trianglesIntersect, &intersectingPair))
    {
-      return GetResolvedCollision(other, CurrentModelTransformation(), other.CurrentModelTransformation(), thisIntersectionSet, otherIntersectionSet, intersectingTriangle1, intersectingTriangle2);
+      intersectingTriangle1 = GetFaceTriangle(intersectingPair.first);
+      intersectingTriangle2 = other.GetFaceTriangle(intersectingPair.second);
+
+      return true;
    }
-   
+
    return false;
 }
 
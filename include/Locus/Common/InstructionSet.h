@@ -0,0 +1,49 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "LocusCommonAPI.h"
+
+#include <cstddef>
+
+namespace Locus
+{
+
+/// The SIMD instruction sets that kernels are written for, from narrowest to widest.
+enum class InstructionSet
+{
+   Scalar,
+   SSE2,
+   AVX
+};
+
+const std::size_t Num_Instruction_Sets = 3;
+
+/*!
+ * \return the widest instruction set that the CPU and the OS
+ * support, but no wider than the one given to
+ * LimitInstructionSet.
+ *
+ * \details The CPU is only queried by the first call.
+ */
+LOCUS_COMMON_API InstructionSet DetectInstructionSet();
+
+/*!
+ * \brief Keeps DetectInstructionSet from returning anything
+ * wider than the given instruction set.
+ *
+ * \details Lets tests and benchmarks run the narrower kernels
+ * on CPUs that support wider ones. Passing InstructionSet::AVX
+ * removes the limit.
+ */
+LOCUS_COMMON_API void LimitInstructionSet(InstructionSet widestInstructionSet);
+
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "LocusCommonAPI.h"
+
+#include <functional>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Locus
+{
+
+#include "Locus/Preprocessor/BeginSilenceDLLInterfaceWarnings"
+
+/*!
+ * \brief A fixed set of worker threads that run
+ * queued tasks.
+ *
+ * \details All public methods are thread safe.
+ * The worker threads are joined on destruction
+ * after the tasks that are already queued have
+ * run.
+ */
+class LOCUS_COMMON_API ThreadPool
+{
+public:
+   /*!
+    * \param[in] numThreads The number of worker
+    * threads. If it is zero, then the number of
+    * hardware threads is used (at least one).
+    */
+   explicit ThreadPool(unsigned int numThreads = 0);
+   ~ThreadPool();
+
+   ThreadPool(const ThreadPool&) = delete;
+   ThreadPool& operator=(const ThreadPool&) = delete;
+
+   /// \return The number of worker threads.
+   unsigned int NumThreads() const;
+
+   /// Queues a task to be run on one of the worker threads.
+   void Enqueue(const std::function<void()>& task);
+
+   /*!
+    * \brief Calls func on consecutive ranges that
+    * together cover [0, count), and returns after
+    * all of them have finished.
+    *
+    * \param[in] count The number of items.
+    *
+    * \param[in] grainSize The max number of items
+    * in a range. If it is zero, then a grain size
+    * is chosen based on count and NumThreads.
+    *
+    * \param[in] func Called with the beginning
+    * (inclusive) and end (exclusive) of a range.
+    * It may be called concurrently on different
+    * ranges.
+    *
+    * \details The calling thread works on ranges
+    * too, so ParallelFor may be called from within
+    * a task of this ThreadPool. If func throws, the
+    * first exception is rethrown on the calling
+    * thread after all ranges have been handled.
+    */
+   void ParallelFor(std::size_t count, std::size_t grainSize, const std::function<void(std::size_t, std::size_t)>& func);
+
+private:
+   std::vector<std::thread> workers;
+   std::queue<std::function<void()>> tasks;
+
+   std::mutex tasksMutex;
+   std::condition_variable tasksCondition;
+
+   bool stopping;
+
+   void WorkerLoop();
+};
+
+#include "Locus/Preprocessor/EndSilenceDLLInterfaceWarnings"
+
+}
\ No newline at end of file
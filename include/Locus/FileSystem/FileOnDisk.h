@@ -57,6 +57,16 @@ public:
    /// \sa DataStream::Read
    virtual std::size_t Read(char* bytes, std::size_t numBytesToRead) override;
 
+   /*!
+    * \brief Writes the given bytes at the current position.
+    *
+    * \return the number of bytes written.
+    *
+    * \details The file must have been opened with
+    * OpenMode::Write or OpenMode::Append.
+    */
+   std::size_t Write(const char* bytes, std::size_t numBytesToWrite);
+
    /// \sa DataStream::Seek
    virtual bool Seek(std::size_t offset, DataStream::SeekType seekType) override;
 
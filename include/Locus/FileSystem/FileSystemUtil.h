@@ -8,16 +8,39 @@
 *                                                                                                        *
 \********************************************************************************************************/
 
+#pragma once
+
 #include "LocusFileSystemAPI.h"
 
 #include <string>
 #include <vector>
 
+#include <cstdint>
+
 namespace Locus
 {
 
 struct MountedFilePath;
 
+/*!
+ * \brief The size and last modified time of a file. This is
+ * much cheaper to obtain than the contents of the file, and
+ * changes whenever the file is rewritten.
+ *
+ * \details lastModifiedTime is only meant to be compared to
+ * the lastModifiedTime of another FileStamp of the same file.
+ * Its unit depends on the platform and on where the file is
+ * mounted. It is -1 if it can't be determined.
+ */
+struct FileStamp
+{
+   std::uint64_t sizeInBytes;
+   std::int64_t lastModifiedTime;
+};
+
+LOCUS_FILE_SYSTEM_API bool operator==(const FileStamp& first, const FileStamp& second);
+LOCUS_FILE_SYSTEM_API bool operator!=(const FileStamp& first, const FileStamp& second);
+
 /// \return The full path to the current running executable.
 LOCUS_FILE_SYSTEM_API std::string GetExePath();
 
@@ -48,6 +71,23 @@ LOCUS_FILE_SYSTEM_API void ReadWholeFile(const std::string& filePath, std::vecto
  */
 LOCUS_FILE_SYSTEM_API void ReadWholeFile(const MountedFilePath& mountedFilePath, std::vector<char>& data);
 
+/*!
+ * \param[in] filePath The full path of the file.
+ *
+ * \throws Exception if the file doesn't exist.
+ */
+LOCUS_FILE_SYSTEM_API FileStamp GetFileStamp(const std::string& filePath);
+
+/*!
+ * \param[in] mountedFilePath Path to the file in an archive or
+ * on disk, relative to a path passed to MountDirectoryOrArchive.
+ *
+ * \throws Exception if the file doesn't exist.
+ *
+ * \sa MountDirectoryOrArchive
+ */
+LOCUS_FILE_SYSTEM_API FileStamp GetFileStamp(const MountedFilePath& mountedFilePath);
+
 LOCUS_FILE_SYSTEM_API bool GetAllFilesInDirectory(const std::string& directoryPath, std::vector<std::string>& filesInDirectory);
 
 } // namespace Locus
\ No newline at end of file
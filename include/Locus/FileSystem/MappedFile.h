@@ -0,0 +1,62 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "LocusFileSystemAPI.h"
+
+#include <string>
+#include <memory>
+
+#include <cstddef>
+
+namespace Locus
+{
+
+struct MappedFile_Impl;
+
+#include "Locus/Preprocessor/BeginSilenceDLLInterfaceWarnings"
+
+/*!
+ * \brief A read only view of a whole file on disk,
+ * mapped into memory.
+ *
+ * \details Pages are read by the OS on first access,
+ * and stay shared with the file cache, so nothing is
+ * copied up front. Files in archives can't be mapped.
+ */
+class LOCUS_FILE_SYSTEM_API MappedFile
+{
+public:
+   /*!
+    * \param[in] filePath The full path to the file.
+    *
+    * \throws Exception
+    */
+   explicit MappedFile(const std::string& filePath);
+
+   ~MappedFile();
+
+   MappedFile(const MappedFile&) = delete;
+   MappedFile& operator=(const MappedFile&) = delete;
+
+   /// \return the start of the file, or null if the file is empty.
+   const unsigned char* Data() const;
+
+   std::size_t SizeInBytes() const;
+
+private:
+   std::unique_ptr<MappedFile_Impl> impl;
+   std::string filePath;
+};
+
+#include "Locus/Preprocessor/EndSilenceDLLInterfaceWarnings"
+
+} // namespace Locus
\ No newline at end of file
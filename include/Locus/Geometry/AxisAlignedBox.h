@@ -24,6 +24,7 @@ namespace Locus
 
 class Sphere;
 class Moveable;
+struct RelativeTransformation;
 
 /// An axis-aligned box
 class LOCUS_GEOMETRY_API AxisAlignedBox
@@ -99,6 +100,15 @@ public:
     */
    bool Intersects(const Moveable& thisMoveable, const AxisAlignedBox& other, const Moveable& otherMoveable) const;
 
+   /*!
+    * \details Unlike other bounding volumes, transformed boxes stay
+    * aligned with the world axes, so this is the same test as above
+    * using the Moveables of relativeTransformation.
+    *
+    * \sa RelativeTransformation
+    */
+   bool Intersects(const AxisAlignedBox& other, const RelativeTransformation& relativeTransformation) const;
+
    /// \return true if this box intersects the given sphere fully or partially.
    bool Intersects(const Sphere& sphere) const;
 
@@ -165,6 +175,9 @@ public:
     */
    float DiagonalLength() const;
 
+   /// \return the total area of the six faces of this box.
+   float SurfaceArea() const;
+
    /// \return the centroid of the box.
    FVector3 Centroid() const;
 
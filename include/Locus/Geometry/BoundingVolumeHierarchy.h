@@ -18,6 +18,7 @@
 #include "Sphere.h"
 #include "AxisAlignedBox.h"
 #include "OrientedBox.h"
+#include "RelativeTransformation.h"
 
 #include "Locus/Math/Vectors.h"
 
@@ -28,6 +29,8 @@
 #include <unordered_set>
 #include <algorithm>
 #include <type_traits>
+#include <functional>
+#include <utility>
 
 #include <cmath>
 
@@ -36,11 +39,12 @@ namespace Locus
 
 class Moveable;
 class OrientedBox;
+class ThreadPool;
 
 #include "Locus/Preprocessor/BeginSilenceDLLInterfaceWarnings"
 
-// Used internally by BoundingVolumeHierarchy
-typedef std::unordered_map<std::size_t, Triangle3D_t> TriangleInputMap_t;
+/// A triangle index from one BoundingVolumeHierarchy paired with a triangle index from another.
+typedef std::pair<std::size_t, std::size_t> TrianglePair_t;
 
 //{CodeReview:NarrowPhaseCollisions}
 /*!
@@ -66,6 +70,53 @@ public:
     */
    static const std::size_t NUM_TREE_CHILDREN = 8;
 
+   /*!
+    * \brief How the triangles of a node are divided
+    * among its children during construction.
+    */
+   enum class SplitMethod
+   {
+      /// Up to eight children, split at the center of the node's bounding volume.
+      Octants,
+
+      /*!
+       * \brief Two children, split along the axis and at the
+       * position that minimize the surface area heuristic,
+       * evaluated over a fixed number of bins of triangle centroids.
+       *
+       * \details Better suited to elongated or unevenly
+       * tessellated models than Octants. Only the split changes;
+       * each node's bounding volume is made the same way as with
+       * Octants. In particular, AxisAlignedBox nodes remain cubes
+       * around a bounding sphere, because AxisAlignedBox::TransformBy
+       * does not account for rotation.
+       */
+      BinnedSurfaceAreaHeuristic
+   };
+
+   /// A summary of the shape of a built tree.
+   struct Statistics
+   {
+      std::size_t numNodes;
+      std::size_t numLeaves;
+
+      /// Depth of the deepest node. The root has a depth of zero.
+      std::size_t maxDepth;
+
+      float averageLeafTriangles;
+
+      /*!
+       * \brief The surface area heuristic cost of the tree.
+       *
+       * \details The sum over all nodes of the node's surface
+       * area, weighted by one for internal nodes and by the number
+       * of triangles for leaves. Lower is better. It is not
+       * normalized, so it is only comparable between trees built
+       * from the same triangles.
+       */
+      float surfaceAreaHeuristicCost;
+   };
+
    /*!
     * \return The first power of eight that is greater
     * than or equal to the number of faces in the given
@@ -103,20 +154,47 @@ public:
     * given model.
     *
     * \details The BoundingVolumeHierarchy is constructed the same
-    * as BoundingVolumeHierarchy(const std::vector<Triangle3D_t>&, std::size_t, std::size_t)
+    * as BoundingVolumeHierarchy(const std::vector<Triangle3D_t>&, std::size_t, std::size_t, ThreadPool*)
     * given this model's identity face triangles.
     *
     * \note If the model's triangles change, then the BoundingVolumeHierarchy
     * should be recreated.
     *
-    * \sa Model::GetIdentityFaceTriangles GetMaxTreeDepth BoundingVolumeHierarchy(const std::vector<Triangle3D_t>&, std::size_t, std::size_t)
+    * \sa Model::GetIdentityFaceTriangles GetMaxTreeDepth BoundingVolumeHierarchy(const std::vector<Triangle3D_t>&, std::size_t, std::size_t, ThreadPool*)
+    */
+   template <class VertexIndexerType, class VertexType>
+   BoundingVolumeHierarchy(const Model<VertexIndexerType, VertexType>& model, std::size_t leafTriangles, std::size_t maxDepthClamp = 0, ThreadPool* threadPool = nullptr)
+      : BoundingVolumeHierarchy(model, SplitMethod::Octants, leafTriangles, maxDepthClamp, threadPool)
+   {
+   }
+
+   /*!
+    * \brief Same as BoundingVolumeHierarchy(const Model<VertexIndexerType, VertexType>&, std::size_t, std::size_t, ThreadPool*)
+    * but with a choice of how nodes are split.
+    *
+    * \details Binary splits need three levels to divide a
+    * model as finely as one level of octants, so with
+    * SplitMethod::BinnedSurfaceAreaHeuristic the max depth
+    * from GetMaxTreeDepth is tripled before it is clamped.
     */
    template <class VertexIndexerType, class VertexType>
-   BoundingVolumeHierarchy(const Model<VertexIndexerType, VertexType>& model, std::size_t leafTriangles, std::size_t maxDepthClamp = 0) 
+   BoundingVolumeHierarchy(const Model<VertexIndexerType, VertexType>& model, SplitMethod splitMethod, std::size_t leafTriangles, std::size_t maxDepthClamp = 0, ThreadPool* threadPool = nullptr)
    {
       std::vector<Triangle3D_t> identityFaceTriangles = model.GetIdentityFaceTriangles();
 
-      ConstructFromTriangles(identityFaceTriangles, leafTriangles, BoundingVolumeHierarchy::GetMaxTreeDepth(model, maxDepthClamp));
+      std::size_t maxDepth = BoundingVolumeHierarchy::GetMaxTreeDepth(model);
+
+      if (splitMethod == SplitMethod::BinnedSurfaceAreaHeuristic)
+      {
+         maxDepth *= 3;
+      }
+
+      if (maxDepthClamp != 0)
+      {
+         maxDepth = std::min(maxDepth, maxDepthClamp);
+      }
+
+      ConstructFromTriangles(identityFaceTriangles, splitMethod, leafTriangles, maxDepth, threadPool);
    }
 
    /*!
@@ -126,11 +204,16 @@ public:
     * \param[in] leafTriangles If a bounding volume is encountered
     * with a number of triangles less than or equal to this value,
     * then that bounding volume is considered to be a leaf of the
-    * tree.
+    * tree. A value of 0 is treated as 1, since a single triangle
+    * cannot be split.
     *
     * \param[in] maxDepth Bounding volumes are not subdivided
     * further if the decomposition reaches this depth.
     *
+    * \param[in] threadPool If not null, then large subtrees are
+    * built in parallel on this ThreadPool. The resulting tree is
+    * the same either way.
+    *
     * \details First a bounding volume is placed centered around
     * the centroid of the given triangles. This bounding volume
     * is set as the root of the tree. Next, this bounding volume
@@ -147,10 +230,25 @@ public:
     * \note There is no attempt at optimal balancing.
     *
     * \note The resulting tree is not guaranteed to be a heap.
+    *
+    * \note The built tree is stored as a single array of nodes in
+    * depth-first order, with the triangles of every node referenced
+    * as a range of one shared index buffer. Copying a
+    * BoundingVolumeHierarchy therefore copies two arrays rather than
+    * allocating every node separately.
+    */
+   BoundingVolumeHierarchy(const std::vector<Triangle3D_t>& triangles, std::size_t leafTriangles, std::size_t maxDepth, ThreadPool* threadPool = nullptr);
+
+   /*!
+    * \brief Same as BoundingVolumeHierarchy(const std::vector<Triangle3D_t>&, std::size_t, std::size_t, ThreadPool*)
+    * but with a choice of how nodes are split.
+    *
+    * \sa SplitMethod
     */
-   BoundingVolumeHierarchy(const std::vector<Triangle3D_t>& triangles, std::size_t leafTriangles, std::size_t maxDepth);
+   BoundingVolumeHierarchy(const std::vector<Triangle3D_t>& triangles, SplitMethod splitMethod, std::size_t leafTriangles, std::size_t maxDepth, ThreadPool* threadPool = nullptr);
 
-   BoundingVolumeHierarchy(const BoundingVolumeHierarchy& otherBoundingVolumeHierarchy);
+   /// \return A summary of the shape of this tree, for comparing construction options.
+   Statistics GetStatistics() const;
 
    //{CodeReview:NarrowPhaseCollisions}
    /*!
@@ -175,6 +273,11 @@ public:
     * BoundingVolumeHierarchy that intersected with any triangle of this
     * BoundingVolumeHierarchy.
     *
+    * \details The sets are filled with the triangles of every pair of leaves
+    * that overlap, found with the same traversal as GetCandidateTrianglePairs.
+    * They can hold triangles that don't intersect anything, but never miss
+    * one that does.
+    *
     * \note If the BoundingVolumeHierarchy has been constructed from a vector of
     * triangles, then the indices given in the intersection set correspond to the
     * indices of that vector. If the BoundingVolumeHierarchy has been constructed
@@ -209,27 +312,94 @@ public:
     */
    void GetIntersection(const Moveable& thisMoveable, const OrientedBox& orientedBox, std::unordered_set<std::size_t>& thisIntersectionSet) const;
 
+   //{CodeReview:NarrowPhaseCollisions}
+   /*!
+    * \brief Gets every pair of triangles, one from this BoundingVolumeHierarchy
+    * and one from the other, whose leaves overlap after transformations are
+    * applied to both BoundingVolumeHierarchies.
+    *
+    * \param[out] candidatePairs Cleared and then filled with the candidate
+    * pairs. The first index of each pair refers to this BoundingVolumeHierarchy
+    * and the second to the other. Its capacity is kept, so passing the same
+    * vector on every call avoids allocating once it has grown large enough.
+    *
+    * \details Node pairs are descended depth first using a fixed-size stack,
+    * so nothing is allocated apart from growing candidatePairs. When both nodes
+    * of a pair can be descended, the one with the larger bounding volume is.
+    * The triangles themselves are not tested.
+    *
+    * \note For a description of the triangle indices, see the description of
+    * GetIntersection(const Moveable&, const BoundingVolumeHierarchy<BoundingVolume>&, const Moveable&, std::unordered_set<std::size_t>&, std::unordered_set<std::size_t>&) const
+    */
+   void GetCandidateTrianglePairs(const Moveable& thisMoveable, const BoundingVolumeHierarchy<BoundingVolume>& otherBoundingVolumeHierarchy, const Moveable& otherMoveable, std::vector<TrianglePair_t>& candidatePairs) const;
+
+   /*!
+    * \return true if any leaf of this BoundingVolumeHierarchy overlaps any leaf
+    * of the other after transformations are applied to both. The traversal stops
+    * at the first such pair of leaves.
+    *
+    * \sa GetCandidateTrianglePairs
+    */
+   bool Intersects(const Moveable& thisMoveable, const BoundingVolumeHierarchy<BoundingVolume>& otherBoundingVolumeHierarchy, const Moveable& otherMoveable) const;
+
+   /*!
+    * \return true if trianglePairIntersects returns true for any candidate pair
+    * of triangles. The traversal stops at the first such pair.
+    *
+    * \param[in] trianglePairIntersects Called with a triangle index of this
+    * BoundingVolumeHierarchy and a triangle index of the other, in the same
+    * way as the pairs given by GetCandidateTrianglePairs. Typically tests the
+    * two transformed triangles against each other.
+    *
+    * \param[out] intersectingPair If not null, receives the pair for which
+    * trianglePairIntersects returned true.
+    *
+    * \sa GetCandidateTrianglePairs
+    */
+   bool Intersects(const Moveable& thisMoveable, const BoundingVolumeHierarchy<BoundingVolume>& otherBoundingVolumeHierarchy, const Moveable& otherMoveable, const std::function<bool(std::size_t, std::size_t)>& trianglePairIntersects, TrianglePair_t* intersectingPair = nullptr) const;
+
 private:
+   /*!
+    * \brief A node of the flattened tree.
+    *
+    * \details Nodes are stored in depth-first order, so the
+    * first child of a non-leaf node immediately follows it and
+    * the subtree of a node occupies the next subtreeSize nodes
+    * (including itself). The next sibling of a child is found
+    * by skipping over the child's subtree.
+    */
    struct Node
    {
-      //{CodeReview:NarrowPhaseCollisions}
-      Node(const TriangleInputMap_t& triangles, const BoundingVolume& boundingVolume, std::size_t leafTriangles, std::size_t currentDepth, std::size_t maxDepth);
-      Node(const Node& otherNode);
-
       BoundingVolume boundingVolume;
       bool isLeaf;
 
-      std::vector<std::size_t> containedTriangles;
-      std::array<std::unique_ptr<Node>, NUM_TREE_CHILDREN> children;
+      std::size_t subtreeSize;
+
+      /// Range of triangleIndices holding every triangle in this node's subtree.
+      std::size_t firstTriangle;
+      std::size_t numTriangles;
    };
 
-   void ConstructFromTriangles(const std::vector<Triangle3D_t>& triangles, std::size_t leafTriangles, std::size_t maxDepth);
+   /// Subtrees with fewer triangles than this are never split across threads.
+   static const std::size_t Parallel_Build_Min_Triangles = 4096;
+
+   /// Number of bins per axis used by SplitMethod::BinnedSurfaceAreaHeuristic.
+   static const std::size_t Num_Surface_Area_Heuristic_Bins = 16;
+
+   /// Number of node pairs held by the fixed-size stack of the simultaneous traversal.
+   static const std::size_t Traversal_Stack_Size = 128;
+
+   struct Builder;
+
+   void ConstructFromTriangles(const std::vector<Triangle3D_t>& triangles, SplitMethod splitMethod, std::size_t leafTriangles, std::size_t maxDepth, ThreadPool* threadPool);
 
-   static void GatherIntersectionsFromCheckList(const Node* node, const std::vector<Node*>& checkList, const Moveable& moveable, const Moveable& checkMoveable, std::vector<Node*>& hitList, std::unordered_set<std::size_t>& intersectionSet);
+   void InsertContainedTriangles(const Node& node, std::unordered_set<std::size_t>& intersectionSet) const;
 
-   static void FinalizeIntersection(const Moveable& thisMoveable, const Moveable& otherMoveable, const std::vector<Node*>& thisRemainingNodes, const std::vector<Node*>& otherCheckList, std::unordered_set<std::size_t>& thisIntersectionSet);
+   template <class LeafPairFunction>
+   bool TraverseOverlappingLeaves(const RelativeTransformation& relativeTransformation, const BoundingVolumeHierarchy<BoundingVolume>& otherTree, std::size_t thisRootIndex, std::size_t otherRootIndex, LeafPairFunction& leafPairFunction) const;
 
-   std::unique_ptr<Node> root;
+   std::vector<Node> nodes;
+   std::vector<std::size_t> triangleIndices;
 };
 
 #include "Locus/Preprocessor/EndSilenceDLLInterfaceWarnings"
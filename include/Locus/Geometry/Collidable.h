@@ -77,6 +77,24 @@ public:
     */
    virtual bool CollidesWith(Collidable& collidable) const;
 
+   /*!
+    * \brief Called on the calling thread of
+    * CollisionManager::TransmitCollisions before
+    * CollidesWith is evaluated concurrently. Does
+    * nothing by default.
+    *
+    * \details Overriders should bring up to date any
+    * state that CollidesWith reads and that is computed
+    * on demand. The composed transformations of a
+    * Collidable that is also a Moveable are already
+    * brought up to date by the CollisionManager. It may
+    * be called more than once per TransmitCollisions
+    * call.
+    *
+    * \sa CollisionManager::SetNarrowPhaseThreadPool
+    */
+   virtual void PrepareForNarrowPhase();
+
    /*!
     * \brief Overriders should do narrow phase collision
     * detection and response.
@@ -13,14 +13,22 @@
 #include "LocusGeometryAPI.h"
 
 #include <memory>
+#include <cstddef>
 
 namespace Locus
 {
 
 class Collidable;
+class ThreadPool;
 
 struct CollisionManager_Impl;
 
+/// Identifies a Collidable that has been added to a CollisionManager.
+typedef std::size_t CollisionHandle_t;
+
+/// Never returned by CollisionManager::Add.
+LOCUS_GEOMETRY_API extern const CollisionHandle_t BAD_COLLISION_HANDLE;
+
 #include "Locus/Preprocessor/BeginSilenceDLLInterfaceWarnings"
 
 //{CodeReview:BroadPhaseCollisions}
@@ -28,7 +36,36 @@ struct CollisionManager_Impl;
 class LOCUS_GEOMETRY_API CollisionManager
 {
 public:
+   /*!
+    * \brief The algorithm used to find the pairs of
+    * Collidables whose broad collision extents intersect.
+    *
+    * \details Both find the same pairs.
+    */
+   enum class BroadPhaseType
+   {
+      /*!
+       * Keeps the extents sorted along each axis. Best when
+       * the Collidables are spread out. Degrades when many
+       * of them overlap along one axis.
+       */
+      SweepAndPrune,
+
+      /*!
+       * Buckets the extents into the cells of a sparse
+       * uniform grid. Insensitive to clustering along an
+       * axis, but sensitive to the cell size.
+       *
+       * \sa SetGridCellSize
+       */
+      HashedGrid
+   };
+
+   /// Uses BroadPhaseType::SweepAndPrune.
    CollisionManager();
+
+   explicit CollisionManager(BroadPhaseType broadPhaseType);
+
    ~CollisionManager();
 
    CollisionManager(const CollisionManager&) = delete;
@@ -38,12 +75,18 @@ public:
     * \brief Adds a Collidable object to the underlying
     * collection.
     *
+    * \return A handle that may be passed to
+    * Update(CollisionHandle_t). It stays valid until
+    * the Collidable is removed. After that it may be
+    * reused by a subsequent call to Add.
+    *
     * \note It is a no-op if the Collidable is already
-    * in the collection.
+    * in the collection. In that case, the existing
+    * handle is returned.
     *
     * \sa StartAddRemoveBatch FinishAddRemoveBatch
     */
-   void Add(Collidable* collidable);
+   CollisionHandle_t Add(Collidable* collidable);
 
    /*!
     * \brief Update the CollisionManager's copy
@@ -63,6 +106,16 @@ public:
     */
    void Update(Collidable* collidable);
 
+   /*!
+    * \brief Same as Update(Collidable*), but skips the
+    * lookup of the Collidable.
+    *
+    * \param[in] handle The handle returned from Add.
+    *
+    * \sa Add Update(Collidable*)
+    */
+   void Update(CollisionHandle_t handle);
+
    /*!
     * \brief Removes a Collidable object from the underlying
     * collection.
@@ -79,6 +132,13 @@ public:
     * consists of all pairs of Collidables whose broad
     * collision extents intersect.
     *
+    * \details The list is maintained incrementally. Pairs
+    * are only added or removed when the endpoints of their
+    * extents pass each other along an axis, so the cost of
+    * this call depends on how far the Collidables moved
+    * since the last call rather than on the number of
+    * Collidables squared.
+    *
     * \sa Update
     */
    void UpdateCollisions();
@@ -93,10 +153,42 @@ public:
     * C1 and C2, were found to intersect, then only
     * C1.ResolveCollision(C2) is called.
     *
+    * \details If a narrow phase ThreadPool has been
+    * set, then CollidesWith is first evaluated for
+    * all the pairs concurrently. ResolveCollision
+    * is then called on the calling thread in the
+    * same order as it would be without the ThreadPool.
+    *
     * \sa UpdateCollisions Collidable::ResolveCollision
+    * SetNarrowPhaseThreadPool
     */
    void TransmitCollisions();
 
+   /*!
+    * \brief Sets the ThreadPool used by TransmitCollisions
+    * to evaluate Collidable::CollidesWith in parallel.
+    *
+    * \param[in] threadPool Not owned by the CollisionManager.
+    * It must outlive the CollisionManager or be unset first.
+    * If it is null, then TransmitCollisions runs serially.
+    * It is null by default.
+    *
+    * \note When a ThreadPool is set, CollidesWith may be
+    * called concurrently on different Collidables, and all
+    * calls to CollidesWith happen before any call to
+    * ResolveCollision in the same TransmitCollisions call.
+    * The results are the same as those of the serial path
+    * as long as CollidesWith does not depend on the effects
+    * of ResolveCollision. Before that, TransmitCollisions
+    * composes the transformations of both Collidables of
+    * every pair that are also Moveables, and calls
+    * Collidable::PrepareForNarrowPhase on them, on the
+    * calling thread.
+    *
+    * \sa TransmitCollisions
+    */
+   void SetNarrowPhaseThreadPool(ThreadPool* threadPool);
+
    /*!
     * \brief Should be called for performance reasons
     * before multiple calls to Add or Remove.
@@ -115,6 +207,28 @@ public:
    /// Clears the underlying collection of Collidable objects.
    void Clear();
 
+   /*!
+    * \brief Switches the broad phase algorithm. The active
+    * collision list is recomputed from the current extents.
+    *
+    * \sa BroadPhaseType
+    */
+   void SetBroadPhaseType(BroadPhaseType broadPhaseType);
+
+   /// \sa SetBroadPhaseType
+   BroadPhaseType GetBroadPhaseType() const;
+
+   /*!
+    * \brief Sets the side length of the grid cells used
+    * by BroadPhaseType::HashedGrid.
+    *
+    * \details If it is not positive, then the cell size
+    * is set to the mean side length of the broad collision
+    * extents whenever Collidables are added or removed.
+    * That is the default.
+    */
+   void SetGridCellSize(float cellSize);
+
 private:
    std::unique_ptr<CollisionManager_Impl> impl;
 };
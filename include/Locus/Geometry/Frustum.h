@@ -56,7 +56,6 @@ public:
    /// \return true if the sphere given by its center and radius is completely within the frustum.
    bool Within(const FVector3& centerOfSphere, float sphereRadius) const;
 
-private:
    enum PlaneLocations
    {
       Near = 0,
@@ -68,6 +67,10 @@ private:
       NUM_PLANES
    };
 
+   /// \return the given plane. Its normal is unit length and points into the frustum.
+   const Plane& GetPlane(PlaneLocations location) const;
+
+private:
    Plane planes[NUM_PLANES];
    FVector3 viewPoint;
    FVector3 forwardVector;
@@ -0,0 +1,122 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "LocusGeometryAPI.h"
+
+#include <vector>
+
+#include <cstddef>
+
+namespace Locus
+{
+
+class Frustum;
+class Sphere;
+class AxisAlignedBox;
+class ThreadPool;
+
+/// Identifies a bounding volume that has been added to a FrustumCuller.
+typedef std::size_t CullingHandle_t;
+
+/// Never returned by FrustumCuller::Add.
+LOCUS_GEOMETRY_API extern const CullingHandle_t BAD_CULLING_HANDLE;
+
+#include "Locus/Preprocessor/BeginSilenceDLLInterfaceWarnings"
+
+/*!
+ * \brief Finds which of many world space bounding volumes are
+ * visible from a Frustum.
+ *
+ * \details Each bounding volume is kept as a sphere, in separate
+ * arrays of center coordinates and radii, so that Cull can test
+ * 8 spheres at a time against the six planes with AVX, or 4 at
+ * a time with SSE2, depending on what the CPU supports. Axis
+ * aligned boxes are stored as their enclosing spheres.
+ *
+ * A sphere is visible unless it is entirely on the outer side of
+ * one of the planes. This is the same test as
+ * Frustum::Within(const FVector3&, float), except that no
+ * floating point tolerance is used.
+ */
+class LOCUS_GEOMETRY_API FrustumCuller
+{
+public:
+   FrustumCuller();
+
+   FrustumCuller(const FrustumCuller&) = delete;
+   FrustumCuller& operator=(const FrustumCuller&) = delete;
+
+   /*!
+    * \brief Adds a bounding volume.
+    *
+    * \return A handle that identifies the volume in Update,
+    * Remove, and the results of Cull. It stays valid until
+    * the volume is removed. After that it may be reused by
+    * a later Add.
+    */
+   CullingHandle_t Add(const Sphere& boundingSphere);
+   CullingHandle_t Add(const AxisAlignedBox& boundingBox);
+
+   /// Replaces the bounding volume of the given handle, e.g. after its object has moved.
+   void Update(CullingHandle_t handle, const Sphere& boundingSphere);
+   void Update(CullingHandle_t handle, const AxisAlignedBox& boundingBox);
+
+   void Remove(CullingHandle_t handle);
+
+   void Clear();
+
+   /// \return the number of bounding volumes that have been added and not removed.
+   std::size_t Size() const;
+
+   /*!
+    * \brief Splits Cull across the threads of the given pool.
+    *
+    * \details If null (the default), Cull runs on the calling
+    * thread only. The pool must outlive its use here.
+    */
+   void SetThreadPool(ThreadPool* threadPool);
+
+   /*!
+    * \brief Replaces the contents of visibleHandles with the
+    * handles of the bounding volumes that are visible from the
+    * given frustum, in increasing order.
+    */
+   void Cull(const Frustum& frustum, std::vector<CullingHandle_t>& visibleHandles);
+
+private:
+   /*!
+    * The arrays are padded to a whole number of blocks with
+    * removed entries, so the kernels never need a scalar tail.
+    * Removed entries have an infinitely negative radius, which
+    * puts them outside of every plane.
+    */
+   std::vector<float> centerXs;
+   std::vector<float> centerYs;
+   std::vector<float> centerZs;
+   std::vector<float> radii;
+
+   std::size_t numHandles;
+
+   std::vector<CullingHandle_t> freeHandles;
+
+   ThreadPool* threadPool;
+
+   /// The visible lanes of each block, used when Cull runs on several threads.
+   std::vector<unsigned int> blockMasks;
+
+   void Set(CullingHandle_t handle, float centerX, float centerY, float centerZ, float radius);
+   CullingHandle_t Add(float centerX, float centerY, float centerZ, float radius);
+};
+
+#include "Locus/Preprocessor/EndSilenceDLLInterfaceWarnings"
+
+}
\ No newline at end of file
@@ -20,6 +20,7 @@
 #include "Geometry.h"
 #include "PointCloud.h"
 #include "Triangle.h"
+#include "TriangleBatch.h"
 #include "Line.h"
 #include "LineSegment.h"
 #include "Triangulation.h"
@@ -68,8 +69,9 @@ struct ModelVertexIndexer
    }
 
    ModelVertexIndexer(std::size_t positionID)
-      : positionID(positionID)
+      : positionID(static_cast<std::uint32_t>(positionID))
    {
+      assert(positionID <= UINT32_MAX);
    }
 
    bool operator <(const ModelVertexIndexer& other) const
@@ -77,7 +79,7 @@ struct ModelVertexIndexer
       return positionID < other.positionID;
    }
 
-   std::size_t positionID;
+   std::uint32_t positionID;
 };
 
 struct ModelVertex
@@ -104,13 +106,13 @@ template <class VertexIndexerType = ModelVertexIndexer, class VertexType = Model
 class Model : public PointCloud
 {
 public:
+   /// A polygon passed to AddFace. It is fanned into triangles when added.
    typedef std::vector<VertexIndexerType> face_t;
 
    static_assert(std::is_base_of<ModelVertexIndexer, VertexIndexerType>::value, "VertexIndexerType must derive from ModelVertexIndexer");
    static_assert(std::is_base_of<ModelVertex, VertexType>::value, "VertexType must derive from ModelVertex");
 
    Model()
-      : numTotalVertices(0)
    {
    }
 
@@ -128,7 +130,7 @@ public:
 
    std::size_t NumFaces() const
    {
-      return faces.size();
+      return faceVertices.size() / Triangle3D_t::NumPointsOnATriangle;
    }
 
    std::vector<VertexType> GetFace(std::size_t faceIndex) const
@@ -138,14 +140,14 @@ public:
 
    std::vector<VertexType> GetFace(std::size_t faceIndex, const Transformation& modelTransformation) const
    {
-      assert( faceIndex < faces.size() );
+      assert( faceIndex < NumFaces() );
 
       std::vector<VertexType> face(3);
 
       for (int i = 0; i < 3; ++i)
       {
          face[i] = GetVertex(faceIndex, i);
-         face[i].position = modelTransformation.MultVertex(positions[faces[faceIndex][i].positionID]);
+         face[i].position = modelTransformation.MultVertex(positions[FaceVertex(faceIndex, i).positionID]);
       }
 
       return face;
@@ -158,19 +160,38 @@ public:
 
    Triangle3D_t GetFaceTriangle(std::size_t faceIndex, const Transformation& modelTransformation) const
    {
-      assert( faceIndex < faces.size() );
-         
+      assert( faceIndex < NumFaces() );
+
       return Triangle3D_t
       (
-         modelTransformation.MultVertex(positions[faces[faceIndex][0].positionID]),
-         modelTransformation.MultVertex(positions[faces[faceIndex][1].positionID]),
-         modelTransformation.MultVertex(positions[faces[faceIndex][2].positionID])
+         modelTransformation.MultVertex(positions[FaceVertex(faceIndex, 0).positionID]),
+         modelTransformation.MultVertex(positions[FaceVertex(faceIndex, 1).positionID]),
+         modelTransformation.MultVertex(positions[FaceVertex(faceIndex, 2).positionID])
       );
    }
 
+   PlainTriangle3D GetPlainFaceTriangle(std::size_t faceIndex) const
+   {
+      return GetPlainFaceTriangle(faceIndex, CurrentModelTransformation());
+   }
+
+   PlainTriangle3D GetPlainFaceTriangle(std::size_t faceIndex, const Transformation& modelTransformation) const
+   {
+      assert( faceIndex < NumFaces() );
+
+      return PlainTriangle3D
+      {
+         {
+            modelTransformation.MultVertex(positions[FaceVertex(faceIndex, 0).positionID]),
+            modelTransformation.MultVertex(positions[FaceVertex(faceIndex, 1).positionID]),
+            modelTransformation.MultVertex(positions[FaceVertex(faceIndex, 2).positionID])
+         }
+      };
+   }
+
    std::vector<Triangle3D_t> GetIdentityFaceTriangles() const
    {
-      std::size_t numFaces = faces.size();
+      std::size_t numFaces = NumFaces();
 
       std::vector<Triangle3D_t> identityFaceTriangles;
       identityFaceTriangles.reserve(numFaces);
@@ -181,9 +202,9 @@ public:
          (
             Triangle3D_t
             (
-               positions[faces[faceIndex][0].positionID],
-               positions[faces[faceIndex][1].positionID],
-               positions[faces[faceIndex][2].positionID]
+               positions[FaceVertex(faceIndex, 0).positionID],
+               positions[FaceVertex(faceIndex, 1).positionID],
+               positions[FaceVertex(faceIndex, 2).positionID]
             )
          );
       }
@@ -191,54 +212,41 @@ public:
       return identityFaceTriangles;
    }
 
+   /// \details faces with more than three vertices are fanned into triangles.
    void AddFace(const face_t& face)
    {
-      numTotalVertices += face.size();
+      std::size_t numPoints = face.size();
 
-      faces.push_back(face);
+      assert(numPoints >= Triangle3D_t::NumPointsOnATriangle);
+
+      for (std::size_t pointIndex = 2; pointIndex < numPoints; ++pointIndex)
+      {
+         AddTriangle(face[0], face[pointIndex - 1], face[pointIndex]);
+      }
    }
 
    void AddTriangle(VertexIndexerType v1, VertexIndexerType v2, VertexIndexerType v3)
    {
-      numTotalVertices += 3;
-
-      face_t face(3);
-      face[0] = v1;
-      face[1] = v2;
-      face[2] = v3;
-
-      faces.push_back(face);
+      faceVertices.push_back(v1);
+      faceVertices.push_back(v2);
+      faceVertices.push_back(v3);
    }
 
    void AddQuad(VertexIndexerType v1, VertexIndexerType v2, VertexIndexerType v3, VertexIndexerType v4)
    {
-      numTotalVertices += 6;
-
-      face_t face(3);
-      face[0] = v1;
-      face[1] = v2;
-      face[2] = v3;
-
-      faces.push_back(face);
-
-      face[0] = v1;
-      face[1] = v3;
-      face[2] = v4;
-
-      faces.push_back(face);
+      AddTriangle(v1, v2, v3);
+      AddTriangle(v1, v3, v4);
    }
 
    virtual void Clear()
    {
       PointCloud::Clear();
 
-      ClearAndShrink(faces);
+      ClearAndShrink(faceVertices);
 
       edgeIndexMap.clear();
 
       ClearAndShrink(edgeAdjacency);
-
-      numTotalVertices = 0;
    }
 
    void GetIntersection(const Model<VertexIndexerType,VertexType>& other, std::vector<std::vector<FVector3>>& intersectionPoints,  std::vector<std::vector<FVector3>>& intersectionTriangles) const
@@ -250,17 +258,17 @@ public:
       std::vector<FVector3> thisTrianglePoints(3);
       std::vector<FVector3> otherTrianglePoints(3);
 
-      for (const face_t& face : faces)
+      for (std::size_t faceIndex = 0, numFaces = NumFaces(); faceIndex < numFaces; ++faceIndex)
       {
-         Triangle3D_t thisTriangle(thisTransformedPositions[face[0].positionID],
-                                    thisTransformedPositions[face[1].positionID],
-                                    thisTransformedPositions[face[2].positionID]);
+         Triangle3D_t thisTriangle(thisTransformedPositions[FaceVertex(faceIndex, 0).positionID],
+                                    thisTransformedPositions[FaceVertex(faceIndex, 1).positionID],
+                                    thisTransformedPositions[FaceVertex(faceIndex, 2).positionID]);
 
-         for (const face_t& otherFace : other.faces)
+         for (std::size_t otherFaceIndex = 0, numOtherFaces = other.NumFaces(); otherFaceIndex < numOtherFaces; ++otherFaceIndex)
          {
-            Triangle3D_t otherTriangle(otherTransformedPositions[otherFace[0].positionID],
-                                       otherTransformedPositions[otherFace[1].positionID],
-                                       otherTransformedPositions[otherFace[2].positionID]);
+            Triangle3D_t otherTriangle(otherTransformedPositions[other.FaceVertex(otherFaceIndex, 0).positionID],
+                                       otherTransformedPositions[other.FaceVertex(otherFaceIndex, 1).positionID],
+                                       otherTransformedPositions[other.FaceVertex(otherFaceIndex, 2).positionID]);
 
             IntersectionType intersectionType = thisTriangle.TriangleIntersection(otherTriangle, individualIntersection);
 
@@ -288,17 +296,17 @@ public:
       std::vector<FVector3> thisTransformedPositions = GetTransformedPositions();
       std::vector<FVector3> otherTransformedPositions = other.GetTransformedPositions();
 
-      for (const face_t& face : faces)
+      for (std::size_t faceIndex = 0, numFaces = NumFaces(); faceIndex < numFaces; ++faceIndex)
       {
-         Triangle3D_t thisTriangle(thisTransformedPositions[face[0].positionID],
-                                    thisTransformedPositions[face[1].positionID],
-                                    thisTransformedPositions[face[2].positionID]);
+         Triangle3D_t thisTriangle(thisTransformedPositions[FaceVertex(faceIndex, 0).positionID],
+                                    thisTransformedPositions[FaceVertex(faceIndex, 1).positionID],
+                                    thisTransformedPositions[FaceVertex(faceIndex, 2).positionID]);
 
-         for (const face_t& otherFace : other.faces)
+         for (std::size_t otherFaceIndex = 0, numOtherFaces = other.NumFaces(); otherFaceIndex < numOtherFaces; ++otherFaceIndex)
          {
-            Triangle3D_t otherTriangle(otherTransformedPositions[otherFace[0].positionID],
-                                       otherTransformedPositions[otherFace[1].positionID],
-                                       otherTransformedPositions[otherFace[2].positionID]);
+            Triangle3D_t otherTriangle(otherTransformedPositions[other.FaceVertex(otherFaceIndex, 0).positionID],
+                                       otherTransformedPositions[other.FaceVertex(otherFaceIndex, 1).positionID],
+                                       otherTransformedPositions[other.FaceVertex(otherFaceIndex, 2).positionID]);
                
             if (thisTriangle.TriangleIntersection(otherTriangle))
             {
@@ -323,26 +331,26 @@ public:
    template <class OtherVertexIndexerType, class OtherVertexType>
    bool GetResolvedCollision(const Model<OtherVertexIndexerType,OtherVertexType>& other, const Transformation& thisTransformation, const Transformation& otherTransformation, const std::unordered_set<std::size_t>& thisIntersectionSet, const std::unordered_set<std::size_t>& otherIntersectionSet, Triangle3D_t& thisIntersectingTriangle, Triangle3D_t& otherIntersectingTriangle) const
    {
-      std::vector<Triangle3D_t> otherTriangles;
-      otherTriangles.reserve(otherIntersectionSet.size());
+      TriangleBatch otherTriangles;
+      otherTriangles.Reserve(otherIntersectionSet.size());
 
       for (std::size_t otherTriangleIndex : otherIntersectionSet)
       {
-         otherTriangles.push_back(other.GetFaceTriangle(otherTriangleIndex, otherTransformation));
+         otherTriangles.Add(other.GetPlainFaceTriangle(otherTriangleIndex, otherTransformation));
       }
 
       for (std::size_t thisTriangleIndex : thisIntersectionSet)
       {
-         thisIntersectingTriangle = GetFaceTriangle(thisTriangleIndex, thisTransformation);
+         PlainTriangle3D thisTriangle = GetPlainFaceTriangle(thisTriangleIndex, thisTransformation);
+
+         std::size_t otherBatchIndex = otherTriangles.FindFirstIntersection(thisTriangle);
 
-         for (const Triangle3D_t& otherTriangle : otherTriangles)
+         if (otherBatchIndex != TriangleBatch::No_Intersection)
          {
-            if (thisIntersectingTriangle.TriangleIntersection(otherTriangle))
-            {
-               otherIntersectingTriangle = otherTriangle;
+            thisIntersectingTriangle = ToTriangle(thisTriangle);
+            otherIntersectingTriangle = ToTriangle(otherTriangles[otherBatchIndex]);
 
-               return true;
-            }
+            return true;
          }
       }
 
@@ -355,11 +363,11 @@ public:
 
       std::vector<FVector3> intersectionPoints;
 
-      for (const face_t& face : faces)
+      for (std::size_t faceIndex = 0, numFaces = NumFaces(); faceIndex < numFaces; ++faceIndex)
       {
-         Triangle3D_t thisTriangle(thisTransformedPositions[face[0].positionID],
-                                    thisTransformedPositions[face[1].positionID],
-                                    thisTransformedPositions[face[2].positionID]);
+         Triangle3D_t thisTriangle(thisTransformedPositions[FaceVertex(faceIndex, 0).positionID],
+                                    thisTransformedPositions[FaceVertex(faceIndex, 1).positionID],
+                                    thisTransformedPositions[FaceVertex(faceIndex, 2).positionID]);
 
          if (thisTriangle.LineIntersection(line, intersectionPoints) != IntersectionType::None)
          {
@@ -379,7 +387,7 @@ public:
       std::vector<VertexType> newFaceVertices;
 
       //make the mesh on the positive side of the plane
-      for (std::size_t faceIndex = 0, numFaces = faces.size(); faceIndex < numFaces; ++faceIndex)
+      for (std::size_t faceIndex = 0, numFaces = NumFaces(); faceIndex < numFaces; ++faceIndex)
       {
          std::vector<VertexType> face = GetFace(faceIndex, modelTransformation);
          Triangle3D_t faceTriangle(face[0].position, face[1].position, face[2].position);
@@ -488,7 +496,7 @@ public:
 
       std::unordered_set<ModelEdge_t> uniqueEdgeSet;
 
-      for (std::size_t thisFaceIndex = 0, numFaces = faces.size(); thisFaceIndex < numFaces; ++thisFaceIndex)
+      for (std::size_t thisFaceIndex = 0, numFaces = NumFaces(); thisFaceIndex < numFaces; ++thisFaceIndex)
       {
          for (std::size_t vertexIndex = 0; vertexIndex < Triangle3D_t::NumPointsOnATriangle; ++vertexIndex)
          {
@@ -506,7 +514,7 @@ public:
       std::array<std::size_t, Max_Adjacent_Edges> initialAdjacencyForEdge = {No_Adjacency, No_Adjacency, No_Adjacency, No_Adjacency};
       edgeAdjacency.resize(uniqueEdgeSet.size(), initialAdjacencyForEdge);
 
-      for (std::size_t thisFaceIndex = 0, numFaces = faces.size(); thisFaceIndex < numFaces; ++thisFaceIndex)
+      for (std::size_t thisFaceIndex = 0, numFaces = NumFaces(); thisFaceIndex < numFaces; ++thisFaceIndex)
       {
          std::size_t edgeIndex1 = edgeIndexMap[ MakeEdge(thisFaceIndex, 0) ];
          std::size_t edgeIndex2 = edgeIndexMap[ MakeEdge(thisFaceIndex, 1) ];
@@ -523,53 +531,6 @@ public:
       }
    }
 
-   void Triangulate()
-   {
-      numTotalVertices = 0;
-
-      for (std::size_t iFace = 0, numFaces = faces.size(); iFace < numFaces; ++iFace)
-      {
-         if (faces[iFace].size() > 3)
-         {
-            face_t originalVertices = faces[iFace];
-
-            std::size_t originalSize = originalVertices.size();
-
-            std::size_t numTriangles = (originalSize - 4 + 2);
-
-            face_t triangleVertices(3);
-
-            std::size_t triangleIndeces[] = {0, 1, 2};
-
-            std::size_t iTriangle = 0;
-
-            do
-            {
-               triangleVertices[0] = originalVertices[triangleIndeces[0]];
-               triangleVertices[1] = originalVertices[triangleIndeces[1]++];
-               triangleVertices[2] = originalVertices[triangleIndeces[2]++];
-
-               if (iTriangle == 0)
-               {
-                  faces[iFace] = triangleVertices;
-               }
-               else
-               {
-                  faces.push_back(triangleVertices);
-               }
-
-               ++iTriangle;
-            } while (triangleIndeces[2] < originalSize);
-
-            numTotalVertices += numTriangles * 3;
-         }
-         else
-         {
-            numTotalVertices += 3;
-         }
-      }
-   }
-
    void ScaleModel(float scale)
    {
       if (FNotEqual<float>(scale, 1.0f))
@@ -592,15 +553,30 @@ public:
 protected:
    static const std::size_t Max_Adjacent_Edges = 4;
 
-   std::vector<face_t> faces;
+   /*!
+    * \brief the vertices of all the faces, three per triangle.
+    *
+    * \details face f is made of the vertices at 3f, 3f + 1,
+    * and 3f + 2. Keeping them in one flat array avoids an
+    * allocation per face and keeps the faces contiguous.
+    */
+   std::vector<VertexIndexerType> faceVertices;
 
    std::unordered_map<ModelEdge_t, std::size_t> edgeIndexMap; //note: max number of faces: SIZE_MAX - 1
    std::vector< std::array<std::size_t, Max_Adjacent_Edges> > edgeAdjacency;
 
-   std::size_t numTotalVertices;
-
    static const std::size_t No_Adjacency = SIZE_MAX;
 
+   VertexIndexerType& FaceVertex(std::size_t faceIndex, std::size_t vertexIndex)
+   {
+      return faceVertices[faceIndex * Triangle3D_t::NumPointsOnATriangle + vertexIndex];
+   }
+
+   const VertexIndexerType& FaceVertex(std::size_t faceIndex, std::size_t vertexIndex) const
+   {
+      return faceVertices[faceIndex * Triangle3D_t::NumPointsOnATriangle + vertexIndex];
+   }
+
    virtual VertexType GetVertex(std::size_t /*faceIndex*/, int /*vertexIndex*/) const
    {
       return VertexType();
@@ -631,7 +607,7 @@ protected:
       } while (triangleIndeces[2] < numPoints);
    }
 
-   bool IsDegenerateFace(const face_t& face)
+   bool IsDegenerateFace(const std::array<VertexIndexerType, Triangle3D_t::NumPointsOnATriangle>& face) const
    {
       return ( (face[0].positionID == face[1].positionID) ||
                (face[0].positionID == face[2].positionID) ||
@@ -642,9 +618,7 @@ protected:
    virtual void Construct(const std::vector<std::vector<VertexType>>& faceTriangles, std::vector<std::size_t>* degenerateFaceIndices = nullptr)
    {
       positions.clear();
-      faces.clear();
-
-      numTotalVertices = 0;
+      faceVertices.clear();
 
       if (degenerateFaceIndices != nullptr)
       {
@@ -669,45 +643,30 @@ protected:
       GetUniqueItems<FVector3>(vertPositions, positions, [](const FVector3& first, const FVector3& second)->bool{ return ApproximatelyEqual(first, second); }, sortedPositionIndices);
 
       //construct faces
-      std::size_t numDegenerateFaces = 0;
-
-      VertexIndexerType vertex;
-      face_t face(Triangle3D_t::NumPointsOnATriangle);
+      std::array<VertexIndexerType, Triangle3D_t::NumPointsOnATriangle> face;
 
-      faces.reserve(numFaces);
+      faceVertices.reserve(numFaces * Triangle3D_t::NumPointsOnATriangle);
 
-      std::vector<face_t> degenerateFaces;
-      degenerateFaces.reserve(numFaces);
+      std::size_t sortedPositionIndex = 0;
 
       for (std::size_t faceIndex = 0; faceIndex < numFaces; ++faceIndex)
       {
          for (std::size_t i = 0; i < Triangle3D_t::NumPointsOnATriangle; ++i)
          {
-            vertex.positionID = sortedPositionIndices[numTotalVertices];
-
-            face[i] = vertex;
-            ++numTotalVertices;
+            face[i].positionID = static_cast<std::uint32_t>(sortedPositionIndices[sortedPositionIndex]);
+            ++sortedPositionIndex;
          }
 
          if (!IsDegenerateFace(face))
          {
-            faces.push_back(face);
+            faceVertices.insert(faceVertices.end(), face.begin(), face.end());
          }
-         else
+         else if (degenerateFaceIndices != nullptr)
          {
-            ++numDegenerateFaces;
-
-            degenerateFaces.push_back(face);
-
-            if (degenerateFaceIndices != nullptr)
-            {
-               degenerateFaceIndices->push_back(faceIndex);
-            }
+            degenerateFaceIndices->push_back(faceIndex);
          }
       }
 
-      numTotalVertices -= numDegenerateFaces * Triangle3D_t::NumPointsOnATriangle;
-
       ComputeCentroid();
       ToModel();
 
@@ -719,8 +678,8 @@ private:
    {
       ModelEdge_t edge;
 
-      edge.first = faces[faceIndex][vertexIndex].positionID;
-      edge.second = faces[faceIndex][(vertexIndex + 1) % Triangle3D_t::NumPointsOnATriangle].positionID;
+      edge.first = FaceVertex(faceIndex, vertexIndex).positionID;
+      edge.second = FaceVertex(faceIndex, (vertexIndex + 1) % Triangle3D_t::NumPointsOnATriangle).positionID;
 
       if (edge.first > edge.second)
       {
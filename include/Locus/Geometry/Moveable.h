@@ -19,6 +19,22 @@
 namespace Locus
 {
 
+/*!
+ * \brief An object with a translation, rotation, and scale.
+ *
+ * \details Translate, Rotate, Scale, and Reset only mark the
+ * composed transformations as out of date. They are composed
+ * when CurrentModelTransformation or
+ * CurrentTranslationAndRotation is next called, so an object
+ * that moves several times a frame is composed at most once,
+ * and not at all if nothing reads it.
+ *
+ * Because of this, reading the composed transformations of an
+ * out of date Moveable from several threads at once is a data
+ * race. Call UpdateTransformations first when that can happen.
+ * CollisionManager does this for every Collidable that is also
+ * a Moveable before its parallel narrow phase.
+ */
 class LOCUS_GEOMETRY_API Moveable
 {
 public:
@@ -40,15 +56,17 @@ public:
    const Transformation& CurrentModelTransformation() const;
    const Transformation& CurrentTranslationAndRotation() const;
 
+   /// Composes the transformations now if they are out of date.
+   void UpdateTransformations() const;
+
 private:
    Transformation modelRotation;
    FVector3 modelTranslation;
    FVector3 modelScale;
 
-   Transformation modelTransformation;
-   Transformation modelTranslationAndRotation;
-
-   void UpdateTransformations();
+   mutable Transformation modelTransformation;
+   mutable Transformation modelTranslationAndRotation;
+   mutable bool transformationsAreDirty;
 };
 
 }
\ No newline at end of file
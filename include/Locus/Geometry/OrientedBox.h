@@ -26,6 +26,7 @@ namespace Locus
 
 class Sphere;
 class Moveable;
+struct RelativeTransformation;
 
 class LOCUS_GEOMETRY_API OrientedBox : private AxisAlignedBox
 {
@@ -52,11 +53,15 @@ public:
 
    bool Intersects(const Moveable& thisMoveable, const OrientedBox& other, const Moveable& otherMoveable) const;
 
+   /// \sa RelativeTransformation
+   bool Intersects(const OrientedBox& other, const RelativeTransformation& relativeTransformation) const;
+
    void AxesAndRotation(std::array<FVector3, 3>& axes, Transformation& rotation) const;
 
    Plane MaxSplitPlane() const;
 
    float DiagonalLength() const;
+   float SurfaceArea() const;
 
    FVector3 centroid;
 
@@ -35,6 +35,25 @@ public:
    const std::vector<FVector3>& GetPositions() const;
    std::vector<FVector3> GetTransformedPositions(const Transformation* transformation = nullptr) const;
 
+   /*!
+    * \brief Transforms the positions into a caller supplied buffer.
+    *
+    * \details transformedPositions is resized to the number of
+    * positions, so reusing the same vector across calls avoids
+    * any allocation. If transformation is null, the current model
+    * transformation is used.
+    */
+   void GetTransformedPositions(std::vector<FVector3>& transformedPositions, const Transformation* transformation = nullptr) const;
+
+   /*!
+    * \brief Transforms the positions into separate arrays of x,
+    * y, and z coordinates.
+    *
+    * \details Better suited than the interleaved overload to large
+    * clouds whose results are then processed in bulk.
+    */
+   void GetTransformedPositions(std::vector<float>& xs, std::vector<float>& ys, std::vector<float>& zs, const Transformation* transformation = nullptr) const;
+
    virtual void AddPosition(const FVector3& v);
    void AddPositions(const std::vector<FVector3>& positionsToAdd);
 
@@ -0,0 +1,58 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "LocusGeometryAPI.h"
+
+#include "Transformation.h"
+
+namespace Locus
+{
+
+class Moveable;
+
+#include "Locus/Preprocessor/BeginSilenceDLLInterfaceWarnings"
+
+/*!
+ * \brief The placement of one Moveable as seen from another,
+ * computed once per query between two objects.
+ *
+ * \details The frame of thisMoveable is its model space with
+ * its rotation and translation applied but not its scale. Since
+ * that frame is rigid, distances and angles in it are the same
+ * as in world space, so a bounding volume of thisMoveable scaled
+ * by thisScale can be compared there with a bounding volume of
+ * otherMoveable mapped by otherToThis. This costs one vertex
+ * transformation per test instead of re-transforming both
+ * volumes into world space.
+ *
+ * Both Moveables must outlive this object.
+ */
+struct LOCUS_GEOMETRY_API RelativeTransformation
+{
+   RelativeTransformation(const Moveable& thisMoveable, const Moveable& otherMoveable);
+
+   const Moveable& thisMoveable;
+   const Moveable& otherMoveable;
+
+   float thisScale;
+   float otherScale;
+
+   /// Maps points in the model space of otherMoveable to the frame of thisMoveable.
+   Transformation otherToThis;
+
+   /// The rotation of otherMoveable relative to the rotation of thisMoveable.
+   Transformation otherRotationToThis;
+};
+
+#include "Locus/Preprocessor/EndSilenceDLLInterfaceWarnings"
+
+}
\ No newline at end of file
@@ -18,6 +18,7 @@ namespace Locus
 {
 
 class Moveable;
+struct RelativeTransformation;
 
 class LOCUS_GEOMETRY_API Sphere
 {
@@ -28,7 +29,11 @@ public:
 
    bool Intersects(const Moveable& thisMoveable, const Sphere& other, const Moveable& otherMoveable) const;
 
+   /// \sa RelativeTransformation
+   bool Intersects(const Sphere& other, const RelativeTransformation& relativeTransformation) const;
+
    float Volume() const;
+   float SurfaceArea() const;
 
    FVector3 center;
    float radius;
@@ -0,0 +1,66 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "Moveable.h"
+
+#include "Locus/Common/ThreadPool.h"
+
+#include <type_traits>
+
+#include <cstddef>
+
+namespace Locus
+{
+
+/// The motion applied to one Moveable by TickMoveables.
+struct MoveableMotion
+{
+   FVector3 translation;
+   FVector3 rotation;
+};
+
+/*!
+ * \brief Translates and then rotates moveables[i] by motions[i]
+ * for every i below count.
+ *
+ * \details moveables is a contiguous array, such as the data of
+ * a std::vector<MoveableType>, so that the motion state of
+ * consecutive objects is read in order rather than through
+ * pointers. Like the individual calls, this doesn't compose any
+ * transformations. If threadPool isn't null, the moveables are
+ * split across its threads.
+ */
+template <class MoveableType>
+void TickMoveables(MoveableType* moveables, const MoveableMotion* motions, std::size_t count, ThreadPool* threadPool = nullptr)
+{
+   static_assert(std::is_base_of<Moveable, MoveableType>::value, "TickMoveables requires Moveables");
+
+   auto tickRange = [moveables, motions](std::size_t begin, std::size_t end)
+   {
+      for (std::size_t moveableIndex = begin; moveableIndex < end; ++moveableIndex)
+      {
+         moveables[moveableIndex].Translate(motions[moveableIndex].translation);
+         moveables[moveableIndex].Rotate(motions[moveableIndex].rotation);
+      }
+   };
+
+   if (threadPool == nullptr)
+   {
+      tickRange(0, count);
+   }
+   else
+   {
+      threadPool->ParallelFor(count, 0, tickRange);
+   }
+}
+
+}
\ No newline at end of file
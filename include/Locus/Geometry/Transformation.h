@@ -15,22 +15,61 @@
 #include "Locus/Math/Matrix.h"
 #include "Locus/Math/Vectors.h"
 
+#include <array>
+#include <cstddef>
+
 namespace Locus
 {
 
 #include "Locus/Preprocessor/BeginSilenceDLLInterfaceWarnings"
 
-class LOCUS_GEOMETRY_API Transformation : public Matrix<float>
+/*!
+ * \brief A 4 x 4 affine or projective transformation.
+ *
+ * \details The sixteen elements are stored inline in
+ * column major order, so constructing, copying, and
+ * multiplying transformations never touches the heap.
+ * Matrix<float> remains the type to use for general
+ * N x M matrices; the explicit conversions below can be
+ * used when one of its operations is needed.
+ */
+class LOCUS_GEOMETRY_API Transformation
 {
 public:
-   Transformation();
-   Transformation(float m0, float m4, float m8,  float m12,
-                  float m1, float m5, float m9,  float m13,
-                  float m2, float m6, float m10, float m14,
-                  float m3, float m7, float m11, float m15);
-
+   static const std::size_t Num_Elements = 16;
+
+   typedef std::array<float, Num_Elements> Elements_t;
+
+   /// \details constructs the identity transformation.
+   constexpr Transformation()
+      : elements{{ 1, 0, 0, 0,
+                   0, 1, 0, 0,
+                   0, 0, 1, 0,
+                   0, 0, 0, 1 }}
+   {
+   }
+
+   /// \details the elements are given in row major order.
+   constexpr Transformation(float m0, float m4, float m8,  float m12,
+                            float m1, float m5, float m9,  float m13,
+                            float m2, float m6, float m10, float m14,
+                            float m3, float m7, float m11, float m15)
+      : elements{{ m0,  m1,  m2,  m3,
+                   m4,  m5,  m6,  m7,
+                   m8,  m9,  m10, m11,
+                   m12, m13, m14, m15 }}
+   {
+   }
+
+   /// \details asserts if the given matrix is not 4 x 4.
+   explicit Transformation(const Matrix<float>& matrix);
+
+   /// \details asserts if the given matrix is not 4 x 4.
    Transformation& operator=(const Matrix<float>& matrix);
 
+   /// \return a general 4 x 4 matrix with the same elements as this transformation.
+   Matrix<float> ToMatrix() const;
+
    static const FVector3& IdentityScale();
 
    static const Transformation& Identity();
@@ -43,9 +82,81 @@ public:
    static Transformation Perspective(float fovy, float aspect, float zNear, float zFar);
    static Transformation Orthographic(float left, float right, float bottom, float top, float nearVal, float farVal);
 
+   /// \return the elements in column major order.
+   const Elements_t& GetElements() const
+   {
+      return elements;
+   }
+
+   /// \return the element at row rowIndex and column colIndex.
+   float& operator()(unsigned int rowIndex, unsigned int colIndex)
+   {
+      return elements[colIndex * 4 + rowIndex];
+   }
+
+   /// \return the element at row rowIndex and column colIndex.
+   constexpr const float& operator()(unsigned int rowIndex, unsigned int colIndex) const
+   {
+      return elements[colIndex * 4 + rowIndex];
+   }
+
+   /// Sets the transformation to be the identity transformation.
+   void SetToIdentity();
+
+   /// \return the elements of the upper left 3 x 3 sub matrix in column major order.
+   std::array<float, 9> GetUpperLeftElements() const;
+
+   /// \return the transpose of the current transformation.
+   Transformation TransposedMatrix() const;
+
+   /// Transposes the current transformation.
+   void Transpose();
+
+   /// Multiplies the current transformation by the given transformation.
+   void MultMatrix(const Transformation& otherTransformation);
+
+   /*!
+    * \brief Inverts the transformation.
+    *
+    * \return true if the transformation is invertible.
+    * If it isn't, then the transformation is unchanged.
+    */
+   bool Invert();
+
    FVector3 MultVector(const FVector3& v) const;
    FVector3 MultVertex(const FVector3& v) const;
 
+   /*!
+    * \brief Transforms numVectors directions, ignoring the
+    * translation.
+    *
+    * \details result may be the same array as vectors.
+    */
+   void MultVectors(const FVector3* vectors, std::size_t numVectors, FVector3* result) const;
+
+   /*!
+    * \brief Transforms numVertices positions.
+    *
+    * \details Uses AVX or SSE2 when the CPU supports them.
+    * result may be the same array as vertices.
+    */
+   void MultVertices(const FVector3* vertices, std::size_t numVertices, FVector3* result) const;
+
+   /*!
+    * \brief Transforms numVertices positions, writing the
+    * x, y, and z coordinates of the results to separate arrays.
+    */
+   void MultVertices(const FVector3* vertices, std::size_t numVertices, float* resultXs, float* resultYs, float* resultZs) const;
+
+   /*!
+    * \brief Transforms numVertices positions that are stored
+    * as separate arrays of x, y, and z coordinates.
+    *
+    * \details each result array may be the same as the
+    * corresponding input array.
+    */
+   void MultVertices(const float* xs, const float* ys, const float* zs, std::size_t numVertices, float* resultXs, float* resultYs, float* resultZs) const;
+
    void TranslateBy(const FVector3& t);
    void InverseTranslateBy(const FVector3& t);
 
@@ -54,8 +165,13 @@ public:
 
    void ScaleBy(const FVector3& scale);
    void InverseScaleBy(const FVector3& scale);
+
+private:
+   Elements_t elements;
 };
 
 #include "Locus/Preprocessor/EndSilenceDLLInterfaceWarnings"
 
+LOCUS_GEOMETRY_API Transformation operator*(const Transformation& transformationLeft, const Transformation& transformationRight);
+
 }
\ No newline at end of file
@@ -0,0 +1,132 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "LocusGeometryAPI.h"
+
+#include "Moveable.h"
+#include "Transformation.h"
+
+#include "Locus/Math/Vectors.h"
+
+#include <vector>
+#include <limits>
+
+#include <cstddef>
+
+namespace Locus
+{
+
+class ThreadPool;
+
+/// Identifies a node of a TransformationHierarchy.
+typedef std::size_t TransformationNode_t;
+
+#include "Locus/Preprocessor/BeginSilenceDLLInterfaceWarnings"
+
+/*!
+ * \brief Parent/child transformations, such as turrets and
+ * emitters attached to a ship, with cached world
+ * transformations.
+ *
+ * \details Each node has a local translation, rotation, and
+ * scale, kept in a Moveable, relative to its parent. Nodes are
+ * stored in flat arrays in the order they were added, and a
+ * parent must be added before its children, so parents always
+ * come before their children.
+ *
+ * Changing a node only marks it. Update then recomputes the
+ * world transformations of the marked nodes and of everything
+ * below them in one pass over the arrays. Nodes in unchanged
+ * subtrees keep their cached world transformation, so drawing
+ * and collision code can read it with
+ * GetWorldTransformation rather than rebuilding it.
+ *
+ * Nodes can't be removed individually. Clear removes all of
+ * them.
+ */
+class LOCUS_GEOMETRY_API TransformationHierarchy
+{
+public:
+   /// The parent of root nodes.
+   static const TransformationNode_t No_Parent = std::numeric_limits<TransformationNode_t>::max();
+
+   TransformationHierarchy();
+
+   /*!
+    * \brief Adds a node with an identity local transformation.
+    *
+    * \param[in] parent must be No_Parent or a node that has
+    * already been added.
+    */
+   TransformationNode_t AddNode(TransformationNode_t parent);
+
+   void Clear();
+
+   std::size_t Size() const;
+
+   TransformationNode_t GetParent(TransformationNode_t node) const;
+
+   /// \return the number of ancestors of the node. Root nodes have a depth of zero.
+   unsigned int GetDepth(TransformationNode_t node) const;
+
+   /// \sa Moveable
+   void Translate(TransformationNode_t node, const FVector3& translation);
+   void Rotate(TransformationNode_t node, const FVector3& rotation);
+   void Scale(TransformationNode_t node, const FVector3& scale);
+   void Reset(TransformationNode_t node, const FVector3& position, const Transformation& rotationTransformation = Transformation::Identity(), const FVector3& scale = Transformation::IdentityScale());
+
+   /// \return the translation, rotation, and scale of the node relative to its parent.
+   const Moveable& GetLocal(TransformationNode_t node) const;
+
+   /*!
+    * \brief Recomputes the world transformations of the nodes
+    * that changed since the last Update, and of their
+    * descendants.
+    *
+    * \details If threadPool isn't null, the nodes of each depth
+    * are split across its threads, one depth after another.
+    * This only pays off for large hierarchies.
+    */
+   void Update(ThreadPool* threadPool = nullptr);
+
+   /*!
+    * \return the transformation from the model space of the
+    * node to world space, as of the last Update.
+    */
+   const Transformation& GetWorldTransformation(TransformationNode_t node) const;
+
+   /// \return the world transformations of all the nodes, indexed by node.
+   const std::vector<Transformation>& GetWorldTransformations() const;
+
+private:
+   std::vector<TransformationNode_t> parents;
+   std::vector<unsigned int> depths;
+   std::vector<Moveable> locals;
+   std::vector<Transformation> worldTransformations;
+
+   /*!
+    * Set when the local transformation of the node changes, and
+    * during Update when one of its ancestors has changed. char is
+    * used rather than bool so that different elements can be
+    * written concurrently.
+    */
+   std::vector<char> dirty;
+
+   /// The nodes at each depth, used by the parallel Update.
+   std::vector<std::vector<TransformationNode_t>> levels;
+
+   void UpdateNode(TransformationNode_t node);
+};
+
+#include "Locus/Preprocessor/EndSilenceDLLInterfaceWarnings"
+
+}
\ No newline at end of file
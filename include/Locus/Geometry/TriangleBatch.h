@@ -0,0 +1,116 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "LocusGeometryAPI.h"
+
+#include "TriangleFwd.h"
+
+#include "Locus/Math/Vectors.h"
+
+#include <vector>
+#include <array>
+#include <limits>
+
+namespace Locus
+{
+
+#include "Locus/Preprocessor/BeginSilenceDLLInterfaceWarnings"
+
+/*!
+ * \brief Three points and nothing else.
+ *
+ * \details Unlike Triangle3D_t, it has no virtual methods and
+ * no heap allocated point storage, so it is cheap to create in
+ * the inner loops of the narrow phase.
+ */
+struct PlainTriangle3D
+{
+   FVector3 points[3];
+};
+
+/// \return the points of the given Triangle3D_t as a PlainTriangle3D.
+LOCUS_GEOMETRY_API PlainTriangle3D ToPlainTriangle(const Triangle3D_t& triangle);
+
+/// \return the points of the given PlainTriangle3D as a Triangle3D_t.
+LOCUS_GEOMETRY_API Triangle3D_t ToTriangle(const PlainTriangle3D& triangle);
+
+/*!
+ * \return true if the two triangles intersect.
+ *
+ * \details Uses the interval overlap method of Moller. Unlike
+ * Triangle3D_t::TriangleIntersection, the test is symmetric and
+ * does not allocate. Coplanar (or nearly parallel) triangles
+ * fall back to Triangle3D_t::CoplanarTriangleIntersection.
+ *
+ * \sa TriangleBatch
+ */
+LOCUS_GEOMETRY_API bool TrianglesIntersect(const PlainTriangle3D& triangle1, const PlainTriangle3D& triangle2);
+
+/*!
+ * \brief Candidate triangles stored as separate coordinate
+ * arrays so that one triangle can be tested against several
+ * of them at once.
+ *
+ * \details The queries test 8 candidates at a time with AVX
+ * or 4 at a time with SSE2, depending on what the CPU supports.
+ * Each candidate gets exactly the same answer as
+ * TrianglesIntersect would give. Clearing the batch keeps its
+ * capacity, so reusing one batch avoids allocating once it has
+ * grown large enough.
+ */
+class LOCUS_GEOMETRY_API TriangleBatch
+{
+public:
+   /// Returned by FindFirstIntersection when no candidate intersects.
+   static const std::size_t No_Intersection = std::numeric_limits<std::size_t>::max();
+
+   /// Removes all the candidates.
+   void Clear();
+
+   /// Reserves room for the given number of candidates.
+   void Reserve(std::size_t numTriangles);
+
+   /// Adds a candidate at the back of the batch.
+   void Add(const PlainTriangle3D& triangle);
+
+   /// \return the number of candidates.
+   std::size_t Size() const;
+
+   /// \return the candidate at the given index.
+   PlainTriangle3D operator[](std::size_t index) const;
+
+   /*!
+    * \return the index of the first candidate that intersects
+    * the given triangle, or No_Intersection if none do.
+    */
+   std::size_t FindFirstIntersection(const PlainTriangle3D& triangle) const;
+
+   /*!
+    * \brief Appends the index of every candidate that intersects
+    * the given triangle to intersectingIndices, in increasing
+    * order.
+    */
+   void FindIntersections(const PlainTriangle3D& triangle, std::vector<std::size_t>& intersectingIndices) const;
+
+private:
+   static const std::size_t Num_Coordinates = 9;
+
+   /// x, y, and z of the first point, then of the second, then of the third.
+   std::array<std::vector<float>, Num_Coordinates> coordinates;
+
+   template <bool StopAtFirst>
+   std::size_t Find(const PlainTriangle3D& triangle, std::vector<std::size_t>* intersectingIndices) const;
+};
+
+#include "Locus/Preprocessor/EndSilenceDLLInterfaceWarnings"
+
+}
\ No newline at end of file
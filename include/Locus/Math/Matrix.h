@@ -150,7 +150,13 @@ public:
    /// \return the current matrix with the given row and column removed.
    Matrix<ScalarType> SubMatrix(unsigned int rowIndexToRemove, unsigned int colIndexToRemove) const;
 
-   /// Multiplies the current matrix by the given matrix.
+   /*!
+    * \brief Multiplies the current matrix by the given matrix.
+    *
+    * \details The multiplication is tiled so that large
+    * matrices stay cache friendly. The result is the same
+    * as the naive triple loop.
+    */
    void MultMatrix(const Matrix<ScalarType>& otherMatrix);
 
    /// Swaps the given rows of the matrix.
@@ -178,6 +184,9 @@ public:
     * \return the determinant of the matrix.
     *
     * \details asserts if the matrix is rectangular.
+    * Matrices larger than 3 x 3 are factored with an
+    * LU decomposition with partial pivoting, which is
+    * O(n^3).
     */
    ScalarType Determinant() const;
 
@@ -185,7 +194,10 @@ public:
     * \return true if the matrix is invertible.
     *
     * \details rectangular matrices are considered to
-    * never be invertible.
+    * never be invertible. A square matrix is considered
+    * invertible if no pivot of its LU decomposition is
+    * negligible relative to the matrix's largest element.
+    * This agrees with Invert and Solve.
     */
    bool IsInvertible() const;
 
@@ -205,10 +217,30 @@ public:
     *
     * \return true if the matrix is invertible.
     *
+    * \details asserts if the matrix is rectangular. If
+    * the matrix is not invertible, then it is left
+    * unchanged.
+    *
     * \sa IsInvertible
     */
    bool Invert();
 
+   /*!
+    * \brief Solves the linear system Ax = b, where A is
+    * this matrix.
+    *
+    * \return true if the matrix is invertible. x is
+    * left unchanged otherwise.
+    *
+    * \details asserts if the matrix is rectangular or
+    * if b does not have one element per row. This is
+    * cheaper and more accurate than multiplying b by
+    * the inverse.
+    *
+    * \sa IsInvertible
+    */
+   bool Solve(const std::vector<ScalarType>& b, std::vector<ScalarType>& x) const;
+
    /*!
     * \return the trace of the matrix.
     *
@@ -0,0 +1,53 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "LocusMathAPI.h"
+
+#include <array>
+
+namespace Locus
+{
+
+/*!
+ * \brief Solves for the eigenvalues and eigenvectors of a
+ * real symmetric 3x3 matrix using cyclic Jacobi rotations.
+ *
+ * \param[in] matrix The matrix in row major order. Only the
+ * upper triangle is read.
+ *
+ * \param[out] eigenvalues The eigenvalues in descending order.
+ *
+ * \param[out] eigenvectors eigenvectors[i] is the unit
+ * eigenvector of eigenvalues[i].
+ *
+ * \details Unlike Matrix::SolveEigenvectors, this never fails.
+ * The eigenvectors always form a right handed orthonormal
+ * basis, including when eigenvalues are repeated (any basis
+ * of the repeated eigenspace is returned in that case) or the
+ * matrix is singular. Supported types are float, double, and
+ * long double.
+ */
+template <typename ScalarType>
+void SolveSymmetricEigen3x3(const std::array<ScalarType, 9>& matrix, std::array<ScalarType, 3>& eigenvalues, std::array<std::array<ScalarType, 3>, 3>& eigenvectors);
+
+#define LOCUS_SYMMETRIC_EIGEN_EXTERN_TEMPLATE(Type) \
+extern template LOCUS_SHARED_IMPORTS void SolveSymmetricEigen3x3<Type>(const std::array<Type, 9>& matrix, std::array<Type, 3>& eigenvalues, std::array<std::array<Type, 3>, 3>& eigenvectors);
+
+#ifdef LOCUS_MATH_SHARED_IMPORTS
+
+LOCUS_SYMMETRIC_EIGEN_EXTERN_TEMPLATE(float);
+LOCUS_SYMMETRIC_EIGEN_EXTERN_TEMPLATE(double);
+LOCUS_SYMMETRIC_EIGEN_EXTERN_TEMPLATE(long double);
+
+#endif
+
+}
\ No newline at end of file
@@ -0,0 +1,162 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "LocusRenderingAPI.h"
+
+#include "Locus/FileSystem/FileSystemUtil.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Locus
+{
+
+class Image;
+class MappedFile;
+class ThreadPool;
+struct MountedFilePath;
+
+#include "Locus/Preprocessor/BeginSilenceDLLInterfaceWarnings"
+
+/*!
+ * \brief A texture in the Locus baked texture format,
+ * mapped into memory.
+ *
+ * \details A baked texture file holds a header, a level
+ * table, and then every mip level of the texture. The
+ * header records the FileStamp and a hash of the source
+ * file, so that LoadOrBake can tell when the baked file
+ * is stale. Rows
+ * are stored bottom to top, the way they are sent to GL,
+ * and each level starts on a 16 byte boundary. Levels
+ * are either raw pixels or BC1/BC3 blocks. Integers are
+ * stored little endian.
+ *
+ * Loading maps the file and points the levels straight
+ * into the mapping, so nothing is decoded or copied. The
+ * level pointers are valid as long as this object is.
+ */
+class LOCUS_RENDERING_API BakedTexture
+{
+public:
+   enum class Format
+   {
+      Uncompressed,
+      BC1, ///< also known as DXT1. RGB only.
+      BC3  ///< also known as DXT5. RGBA.
+   };
+
+   struct Level
+   {
+      unsigned int width;
+      unsigned int height;
+      const unsigned char* pixelData;
+      std::size_t sizeInBytes;
+   };
+
+   /*!
+    * \param[in] filePath The full path to a file written by Bake.
+    *
+    * \throws Exception if the file can't be mapped or isn't a
+    * valid baked texture. Level k of a valid baked texture is
+    * max(1, width >> k) by max(1, height >> k), where width and
+    * height are those of level 0.
+    */
+   explicit BakedTexture(const std::string& filePath);
+
+   ~BakedTexture();
+
+   BakedTexture(const BakedTexture&) = delete;
+   BakedTexture& operator=(const BakedTexture&) = delete;
+
+   Format GetFormat() const;
+
+   /// \details 3 for BC1 and 4 for BC3.
+   unsigned int NumPixelComponents() const;
+
+   unsigned int NumLevels() const;
+   const Level& GetLevel(unsigned int level) const;
+
+   /// \return the FileStamp of the source file that was passed to Bake.
+   const FileStamp& SourceStamp() const;
+
+   /// \return the hash of the source file that was passed to Bake.
+   std::uint64_t SourceHash() const;
+
+   /// \return the hash that Bake expects for a source file with the given contents.
+   static std::uint64_t HashSource(const std::vector<char>& sourceBytes);
+
+   /// How LoadOrBake decides that a baked texture is stale.
+   enum class StalenessCheck
+   {
+      SourceStamp, ///< Compares the FileStamp of the source file. Only the file status is read.
+      SourceHash   ///< Compares the hash of the source file. The whole file is read.
+   };
+
+   /*!
+    * \brief Builds the full mip chain of the image and writes
+    * it to filePath in the baked texture format.
+    *
+    * \param[in] threadPool If not null, then the mip chain
+    * and block compression are split across its worker threads.
+    *
+    * \param[in] sourceStamp The FileStamp of the file that
+    * image was loaded from. It is stored in the header.
+    *
+    * \param[in] sourceHash The HashSource of the file that
+    * image was loaded from. It is stored in the header.
+    *
+    * \details BC1 requires a three or four component image.
+    * Alpha is dropped. BC3 requires a four component image.
+    *
+    * \throws Exception
+    */
+   static void Bake(const Image& image, Format format, const std::string& filePath, const FileStamp& sourceStamp, std::uint64_t sourceHash, ThreadPool* threadPool = nullptr);
+
+   /*!
+    * \brief Loads the baked texture at bakedFilePath, baking
+    * it first from sourceFilePath if it is missing, invalid,
+    * of a different format, or was baked from a different
+    * source file.
+    *
+    * \details By default only the FileStamp of the source file
+    * is compared, so an up to date texture is loaded without
+    * reading the source file. The source file is hashed if
+    * stalenessCheck is SourceHash, or if its last modified
+    * time can't be determined. It is only decoded when the
+    * texture is baked.
+    *
+    * \throws Exception
+    */
+   static std::unique_ptr<BakedTexture> LoadOrBake(const std::string& sourceFilePath, const std::string& bakedFilePath, Format format, ThreadPool* threadPool = nullptr,
+                                                   StalenessCheck stalenessCheck = StalenessCheck::SourceStamp);
+
+   static std::unique_ptr<BakedTexture> LoadOrBake(const MountedFilePath& sourceFilePath, const std::string& bakedFilePath, Format format, ThreadPool* threadPool = nullptr,
+                                                   StalenessCheck stalenessCheck = StalenessCheck::SourceStamp);
+
+private:
+   std::unique_ptr<MappedFile> mappedFile;
+
+   Format format;
+   unsigned int numPixelComponents;
+   FileStamp sourceStamp;
+   std::uint64_t sourceHash;
+   std::vector<Level> levels;
+};
+
+#include "Locus/Preprocessor/EndSilenceDLLInterfaceWarnings"
+
+}
\ No newline at end of file
@@ -42,9 +42,18 @@ public:
    GLSLVersion GetHighestSupportedGLSLVersion() const;
    bool Supports(GLSLVersion version) const;
 
+   /*!
+    * \return true if instanced arrays are supported, either
+    * by OpenGL 3.3 or by the ARB_instanced_arrays extension.
+    *
+    * \sa InstancedDrawable
+    */
+   bool SupportsInstancing() const;
+
 private:
    Vendor vendor;
    GLSLVersion highestSupportedGLSLVersion;
+   bool supportsInstancing;
 
    void InitializeVendor();
    bool InitializeGLSL();
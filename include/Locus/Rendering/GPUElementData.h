@@ -0,0 +1,68 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "LocusRenderingAPI.h"
+#include "GLCommonTypes.h"
+
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Locus
+{
+
+/*!
+ * \brief An index buffer (GL_ELEMENT_ARRAY_BUFFER) drawn with
+ * glDrawElements.
+ *
+ * \details The indices are uploaded as 16 bit values when every
+ * vertex they refer to fits, and as 32 bit values otherwise.
+ */
+class LOCUS_RENDERING_API GPUElementData
+{
+public:
+   GPUElementData();
+   ~GPUElementData();
+
+   GPUElementData(const GPUElementData&) = delete;
+   GPUElementData& operator=(const GPUElementData&) = delete;
+
+   void Bind() const;
+
+   /*!
+    * \param[in] indices the indices to upload.
+    * \param[in] numVertices the number of vertices the indices
+    * refer to. It decides the size of each uploaded index.
+    * \param[in] usage the usage hint passed to glBufferData.
+    */
+   void Buffer(const std::vector<std::uint32_t>& indices, std::size_t numVertices, GLenum usage);
+
+   void Draw(GLenum drawMode) const;
+
+   /// Draws the indices numInstances times with one call. Instancing must be supported.
+   void DrawInstanced(GLenum drawMode, GLsizei numInstances) const;
+
+   std::size_t NumIndices() const;
+
+   /// \return the size of the uploaded index buffer in bytes.
+   std::size_t SizeInBytes() const;
+
+private:
+   GLuint elementBufferID;
+
+   GLenum indexType;
+
+   std::size_t numIndices;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "LocusRenderingAPI.h"
+#include "GLCommonTypes.h"
+
+#include <vector>
+
+#include <cstddef>
+
+namespace Locus
+{
+
+class ShaderController;
+
+struct LOCUS_RENDERING_API GPUInstanceDataStorage
+{
+   float modelTransformation[16];
+   unsigned char color[4];
+};
+
+/*!
+ * \brief A buffer of per instance attributes (a model matrix
+ * and a color) that are advanced once per instance rather than
+ * once per vertex.
+ *
+ * \details The buffer is meant to be rewritten every frame.
+ * Each Buffer call orphans the previous storage before writing
+ * into it, so the driver doesn't have to wait for draws that
+ * still read the old instances.
+ */
+class LOCUS_RENDERING_API GPUInstanceData
+{
+public:
+   GPUInstanceData();
+   ~GPUInstanceData();
+
+   GPUInstanceData(const GPUInstanceData&) = delete;
+   GPUInstanceData& operator=(const GPUInstanceData&) = delete;
+
+   void Bind() const;
+
+   void Buffer(const std::vector<GPUInstanceDataStorage>& instances);
+
+   /*!
+    * \brief Points the Instance_Model and Instance_Color
+    * attributes of the current program at the buffer, with a
+    * divisor of one.
+    *
+    * \details Instancing must be supported. Call
+    * ResetAttributeDivisors after drawing.
+    */
+   void SetAttributes(ShaderController& shaderController) const;
+
+   /*!
+    * \brief Sets the divisors set by SetAttributes back to zero
+    * and disables the attribute arrays.
+    *
+    * \details The divisor belongs to the attribute location
+    * rather than to the program, so leaving it set would break
+    * later programs that read per vertex data from the same
+    * locations. The arrays are disabled so that the attributes
+    * can then be given constant values with SetConstantAttributes.
+    */
+   void ResetAttributeDivisors(ShaderController& shaderController) const;
+
+   /*!
+    * \brief Gives the Instance_Model and Instance_Color
+    * attributes of the current program the values of one
+    * instance for every vertex of the following draws.
+    *
+    * \details This lets a program loaded with instancing draw
+    * one instance per draw call when instancing isn't
+    * supported. The attribute arrays must not be enabled.
+    */
+   static void SetConstantAttributes(ShaderController& shaderController, const GPUInstanceDataStorage& instance);
+
+   std::size_t NumInstances() const;
+
+private:
+   GLuint instanceBufferID;
+
+   std::size_t numInstances;
+   std::size_t capacity;
+};
+
+}
\ No newline at end of file
@@ -13,12 +13,19 @@
 #include "LocusRenderingAPI.h"
 #include "GLCommonTypes.h"
 
+#include <memory>
+#include <vector>
+
 #include <cstddef>
+#include <cstdint>
 
 namespace Locus
 {
 
 class ShaderController;
+class GPUElementData;
+
+#include "Locus/Preprocessor/BeginSilenceDLLInterfaceWarnings"
 
 class LOCUS_RENDERING_API GPUVertexData
 {
@@ -34,6 +41,19 @@ public:
    void Buffer(std::size_t numVertices, GLenum usage);
    void BufferSub(GLintptr offset, std::size_t numSubVertices, GLvoid* data);
 
+   /*!
+    * \brief Uploads an index buffer into the buffered vertices.
+    *
+    * \details Once elements are buffered, Draw uses glDrawElements
+    * rather than glDrawArrays.
+    *
+    * \sa GPUElementData
+    */
+   void BufferElements(const std::vector<std::uint32_t>& indices, GLenum usage);
+
+   /// Drops the index buffer so that Draw goes back to glDrawArrays.
+   void ClearElements();
+
    static void SetClientStateToDefault();
 
    virtual void SetAttributes(ShaderController& shaderController) const = 0;
@@ -42,6 +62,26 @@ public:
    void PreDraw(ShaderController& shaderController) const;
    void Draw(ShaderController& shaderController) const;
 
+   /*!
+    * \brief Issues only the draw call.
+    *
+    * \details PreDraw must have been called for this vertex
+    * data with the current shader program, and nothing else
+    * may have been bound since.
+    */
+   void DrawPrepared() const;
+
+   /*!
+    * \brief Issues one draw call that draws the vertices
+    * numInstances times.
+    *
+    * \details The same requirements as DrawPrepared apply, and
+    * instancing must be supported.
+    *
+    * \sa GLInfo::SupportsInstancing
+    */
+   void DrawPreparedInstanced(GLsizei numInstances) const;
+
    GLenum drawMode;
 
 private:
@@ -52,6 +92,10 @@ private:
    bool populated;
 
    std::size_t numVertices;
+
+   std::unique_ptr<GPUElementData> elementData;
 };
 
+#include "Locus/Preprocessor/EndSilenceDLLInterfaceWarnings"
+
 }
\ No newline at end of file
@@ -22,6 +22,11 @@ struct MountedFilePath;
 
 #include "Locus/Preprocessor/BeginSilenceDLLInterfaceWarnings"
 
+/*!
+ * \details Images may be loaded from files on several threads
+ * at once. The decoder isn't thread safe, so the decoding
+ * itself is serialized.
+ */
 class LOCUS_RENDERING_API Image
 {
 public:
@@ -50,6 +55,12 @@ public:
    void FlipVertically();
    void Scale(unsigned int newWidth, unsigned int newHeight);
 
+   /// Scales each dimension to its closest power of 2. Does nothing if both already are.
+   void ScaleToClosestPowerOf2();
+
+   /// \return true if ScaleToClosestPowerOf2 would do nothing.
+   bool HasPowerOf2Dimensions() const;
+
    bool SaveAsBMP(const std::string& filePath) const;
    bool SaveAsPNG(const std::string& filePath) const;
    bool SaveAsTGA(const std::string& filePath) const;
@@ -65,6 +76,8 @@ private:
 
    static unsigned int GetPixelOffset(unsigned int x, unsigned int y, unsigned int width, unsigned int numPixelComponents);
 
+   static unsigned int ClosestPowerOf2(unsigned int num);
+
    void FinishLoad(unsigned char* pixels, unsigned int width, unsigned int height, unsigned int numPixelComponents);
 };
 
@@ -0,0 +1,84 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "LocusRenderingAPI.h"
+
+#include "GPUVertexDataStorage.h"
+
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Locus
+{
+
+#include "Locus/Preprocessor/BeginSilenceDLLInterfaceWarnings"
+
+/*!
+ * \brief Unique vertices and the triangle list that indexes
+ * them.
+ *
+ * \details Nothing here touches OpenGL, so the data can be
+ * built and inspected without a context.
+ */
+struct LOCUS_RENDERING_API IndexedVertexData
+{
+   std::vector<GPUVertexDataStorage> vertices;
+   std::vector<std::uint32_t> indices;
+};
+
+#include "Locus/Preprocessor/EndSilenceDLLInterfaceWarnings"
+
+/*!
+ * \brief Collapses identical vertices of an unindexed triangle
+ * list.
+ *
+ * \details vertices are identical when all of their bytes are
+ * equal, so any attribute that is not sent should be zero
+ * filled. The indices reproduce the triangles of
+ * triangleVertices in the same order.
+ */
+LOCUS_RENDERING_API void BuildIndexedVertexData(const std::vector<GPUVertexDataStorage>& triangleVertices, IndexedVertexData& indexedVertexData);
+
+/*!
+ * \brief Reorders triangles so that the post transform vertex
+ * cache is hit more often.
+ *
+ * \details This is Tom Forsyth's "Linear-Speed Vertex Cache
+ * Optimisation". It greedily emits the triangle with the best
+ * score, where vertices score higher the more recently they
+ * were used and the fewer triangles they have left. It does not
+ * depend on the exact cache size of the hardware.
+ */
+LOCUS_RENDERING_API void OptimizeVertexCacheOrder(std::vector<std::uint32_t>& triangleIndices, std::size_t numVertices);
+
+/*!
+ * \brief Reorders the vertices into the order in which the
+ * indices first use them, and remaps the indices to match.
+ *
+ * \details this keeps vertex fetches close together in memory.
+ * Unreferenced vertices are dropped.
+ */
+LOCUS_RENDERING_API void OptimizeVertexFetchOrder(IndexedVertexData& indexedVertexData);
+
+/*!
+ * \return the average number of vertex cache misses per
+ * triangle when drawing the given triangle list through a FIFO
+ * cache holding cacheSize vertices.
+ *
+ * \details 3 is the worst possible value, and about 0.5 is the
+ * best possible value for a large regular mesh.
+ */
+LOCUS_RENDERING_API float AverageCacheMissRatio(const std::vector<std::uint32_t>& triangleIndices, std::size_t cacheSize);
+
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "LocusRenderingAPI.h"
+
+#include "Drawable.h"
+#include "Color.h"
+#include "GPUInstanceData.h"
+
+#include "Locus/Geometry/Transformation.h"
+
+#include <vector>
+#include <memory>
+
+#include <cstddef>
+
+namespace Locus
+{
+
+class SingleDrawable;
+class GPUVertexData;
+
+#include "Locus/Preprocessor/BeginSilenceDLLInterfaceWarnings"
+
+/*!
+ * \brief Draws many copies of one SingleDrawable, such as a
+ * Mesh, each with its own model transformation and color.
+ *
+ * \details The vertex data of the shared drawable is used as is
+ * and isn't copied. UpdateGPUVertexData uploads the instances
+ * into a per instance buffer, and Draw then draws every copy
+ * with one instanced draw call. This requires the current
+ * program to have been loaded with instancing
+ * (see ShaderController::LoadShaderProgram) and
+ * GLInfo::SupportsInstancing. Otherwise, Draw falls back to one
+ * draw call per instance. If the current program was loaded
+ * with instancing, each draw sets the instance attributes to
+ * constant values, so the instance colors are still applied.
+ * If it wasn't, only the model transformations are applied.
+ *
+ * Draw uploads the transformations itself, so the top of the
+ * model view stack should hold only the view transformation.
+ */
+class LOCUS_RENDERING_API InstancedDrawable : public Drawable
+{
+public:
+   struct Instance
+   {
+      Transformation modelTransformation;
+      Color color;
+   };
+
+   /// \details sharedDrawable must outlive this object.
+   InstancedDrawable(const SingleDrawable& sharedDrawable);
+
+   void ClearInstances();
+   void AddInstance(const Transformation& modelTransformation, const Color& color);
+   void SetInstance(std::size_t instanceIndex, const Transformation& modelTransformation, const Color& color);
+
+   std::size_t NumInstances() const;
+
+   /// Creates the per instance buffer. The shared drawable's vertex data is created separately.
+   virtual void CreateGPUVertexData() override;
+   virtual void DeleteGPUVertexData() override;
+
+   /// Uploads the instances. Call this whenever they change, typically once per frame.
+   virtual void UpdateGPUVertexData() override;
+
+   virtual void Draw(RenderingState& renderingState) const override;
+
+private:
+   const SingleDrawable& sharedDrawable;
+
+   std::vector<Instance> instances;
+   std::vector<GPUInstanceDataStorage> instanceStorage;
+
+   std::unique_ptr<GPUInstanceData> gpuInstanceData;
+
+   bool CanDrawInstanced(RenderingState& renderingState) const;
+
+   void DrawOnePerInstance(RenderingState& renderingState, const GPUVertexData& sharedVertexData) const;
+};
+
+#include "Locus/Preprocessor/EndSilenceDLLInterfaceWarnings"
+
+}
\ No newline at end of file
@@ -23,10 +23,14 @@
 #include "GPUVertexData.h"
 
 #include <cstddef>
+#include <cstdint>
+#include <cassert>
 
 namespace Locus
 {
 
+struct IndexedVertexData;
+
 struct MeshVertexIndexer : public ModelVertexIndexer
 {
    MeshVertexIndexer() 
@@ -35,8 +39,9 @@ struct MeshVertexIndexer : public ModelVertexIndexer
    }
 
    MeshVertexIndexer(std::size_t positionID, std::size_t textureCoordinateID, std::size_t normalID, std::size_t colorID)
-      : ModelVertexIndexer(positionID), textureCoordinateID(textureCoordinateID), normalID(normalID), colorID(colorID)
+      : ModelVertexIndexer(positionID), textureCoordinateID(static_cast<std::uint32_t>(textureCoordinateID)), normalID(static_cast<std::uint32_t>(normalID)), colorID(static_cast<std::uint32_t>(colorID))
    {
+      assert((textureCoordinateID <= UINT32_MAX) && (normalID <= UINT32_MAX) && (colorID <= UINT32_MAX));
    }
 
    bool operator <(const MeshVertexIndexer& other) const
@@ -63,9 +68,9 @@ struct MeshVertexIndexer : public ModelVertexIndexer
       }
    }
 
-   std::size_t textureCoordinateID;
-   std::size_t normalID;
-   std::size_t colorID;
+   std::uint32_t textureCoordinateID;
+   std::uint32_t normalID;
+   std::uint32_t colorID;
 };
 
 struct MeshVertex : public ModelVertex
@@ -112,6 +117,14 @@ public:
    void AssignNormals();
    virtual void Clear();
 
+   /*!
+    * \brief Builds the deduplicated, cache ordered vertices and
+    * indices that UpdateGPUVertexData uploads.
+    *
+    * \details This doesn't need an OpenGL context.
+    */
+   void GetIndexedVertexData(IndexedVertexData& indexedVertexData) const;
+
    virtual void UpdateGPUVertexData() override;
    void BindGPUVertexData() const;
 
@@ -126,6 +139,9 @@ private:
    std::vector<FVector3> normals;
    std::vector<TextureCoordinate> textureCoordinates;
    std::vector<Color> colors;
+
+   /// gpuVertexDataTransferInfo, except that normals aren't sent if there are none.
+   GPUVertexDataTransferInfo GetTransferInfoToSend() const;
 };
 
 #include "Locus/Preprocessor/EndSilenceDLLInterfaceWarnings"
@@ -0,0 +1,80 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "LocusRenderingAPI.h"
+
+#include <vector>
+#include <cstddef>
+
+namespace Locus
+{
+
+class Image;
+class ThreadPool;
+
+#include "Locus/Preprocessor/BeginSilenceDLLInterfaceWarnings"
+
+/*!
+ * \brief All the mipmap levels of an image, stored
+ * in one contiguous allocation.
+ *
+ * \details Each level is made from the previous one
+ * with a 2x2 box filter. A dimension that is already
+ * one stays one, and the last row or column of an odd
+ * dimension is dropped. Levels are tightly packed one
+ * after the other, starting with a copy of the image
+ * itself at level 0. No OpenGL calls are made, so a
+ * MipChain may be built on any thread.
+ */
+class LOCUS_RENDERING_API MipChain
+{
+public:
+   struct Level
+   {
+      unsigned int width;
+      unsigned int height;
+      std::size_t offset;
+   };
+
+   /*!
+    * \param[in] sRGB If true, then the color
+    * components are averaged in linear space
+    * and converted back to sRGB. Alpha (the
+    * last component of two and four component
+    * images) is always averaged as is.
+    *
+    * \param[in] threadPool If not null, then the
+    * rows of large levels are filtered on its
+    * worker threads.
+    */
+   MipChain(const Image& image, bool sRGB, ThreadPool* threadPool = nullptr);
+
+   unsigned int NumLevels() const;
+   unsigned int NumPixelComponents() const;
+
+   const Level& GetLevel(unsigned int level) const;
+   const unsigned char* LevelPixelData(unsigned int level) const;
+
+   /// \return all the levels, with level 0 first.
+   const std::vector<unsigned char>& PixelData() const;
+
+private:
+   unsigned int numPixelComponents;
+   std::vector<Level> levels;
+   std::vector<unsigned char> pixelData;
+
+   void BuildLevel(unsigned int level, bool sRGB, ThreadPool* threadPool);
+};
+
+#include "Locus/Preprocessor/EndSilenceDLLInterfaceWarnings"
+
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "LocusRenderingAPI.h"
+
+#include "Locus/Common/IDType.h"
+
+#include "Locus/Geometry/Transformation.h"
+
+#include <vector>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Locus
+{
+
+class RenderingState;
+class Texture;
+class GPUVertexData;
+class SingleDrawable;
+
+#include "Locus/Preprocessor/BeginSilenceDLLInterfaceWarnings"
+
+/*!
+ * \brief Collects the draws of a frame so that they can be
+ * submitted in an order that changes state as little as
+ * possible.
+ *
+ * \details Each draw is recorded as a packet holding the
+ * shader program, the texture, the vertex data, and the model
+ * transformation. Sort orders the packets by a 64 bit key that
+ * holds, from most to least significant, a layer, the program,
+ * the texture, and the vertex data. Submit then switches only
+ * the state that differs from the previous packet. Recording,
+ * sorting, and CountStateChanges make no OpenGL calls, so they
+ * can be used without a context.
+ */
+class LOCUS_RENDERING_API RenderQueue
+{
+public:
+   struct Packet
+   {
+      ID_t program;
+      const Texture* texture;
+      const GPUVertexData* vertexData;
+      Transformation modelTransformation;
+   };
+
+   /// The state changes and draw calls made when submitting the queue.
+   struct StateChanges
+   {
+      std::size_t programChanges;
+      std::size_t textureChanges;
+      std::size_t vertexDataChanges;
+      std::size_t drawCalls;
+   };
+
+   static const unsigned int Max_Layer = 255;
+
+   RenderQueue();
+
+   void Clear();
+   void Reserve(std::size_t numPackets);
+
+   /*!
+    * \brief Records a draw.
+    *
+    * \param[in] texture may be null for untextured draws.
+    * \param[in] vertexData the draw is dropped if this is null.
+    * \param[in] layer packets in lower layers are always
+    * submitted first, which can be used for things such as
+    * sky boxes or transparent geometry. Asserts if greater
+    * than Max_Layer.
+    */
+   void Add(ID_t program, const Texture* texture, const GPUVertexData* vertexData, const Transformation& modelTransformation, unsigned int layer = 0);
+
+   void Add(ID_t program, const Texture* texture, const SingleDrawable& drawable, const Transformation& modelTransformation, unsigned int layer = 0);
+
+   std::size_t Size() const;
+
+   /// \return the packet recorded at the given index.
+   const Packet& operator[](std::size_t packetIndex) const;
+
+   /*!
+    * \brief Sorts the packets by their keys.
+    *
+    * \details Packets with equal keys keep the order in which
+    * they were recorded.
+    */
+   void Sort();
+
+   /// \return the packet indices in the order Submit would draw them.
+   std::vector<std::size_t> GetSubmissionOrder() const;
+
+   /// \return the state changes that Submit would make in the current order.
+   StateChanges CountStateChanges() const;
+
+   /*!
+    * \brief Draws the packets in the current order.
+    *
+    * \details The queue is left unchanged so that it can be
+    * submitted again. Recorded packets are drawn in recording
+    * order if Sort hasn't been called.
+    */
+   void Submit(RenderingState& renderingState) const;
+
+   static std::uint64_t MakeSortKey(unsigned int layer, ID_t program, const Texture* texture, const GPUVertexData* vertexData);
+
+private:
+   std::vector<Packet> packets;
+
+   //sort key and packet index, in submission order
+   std::vector<std::pair<std::uint64_t, std::uint32_t>> order;
+};
+
+#include "Locus/Preprocessor/EndSilenceDLLInterfaceWarnings"
+
+}
\ No newline at end of file
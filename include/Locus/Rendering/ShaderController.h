@@ -41,18 +41,33 @@ public:
    void StopProgams();
 
    ID_t LoadShaderProgram(const Shader& shader1, const Shader& shader2, bool doesTexturing, bool doesLighting);
-   ID_t LoadShaderProgram(GLInfo::GLSLVersion activeGLSLVersion, bool doesTexturing, unsigned int numLights);
+   ID_t LoadShaderProgram(GLInfo::GLSLVersion activeGLSLVersion, bool doesTexturing, unsigned int numLights, bool doesInstancing = false);
 
    void SetTextureUniform(const std::string& whichTex, GLuint textureUnit);
    void SetMatrix4Uniform(const std::string& whichMatrix, const float* matrixElements);
    void SetMatrix3Uniform(const std::string& whichMatrix, const float* matrixElements);
+
+   /*!
+    * \brief Sets a uniform of the generated shaders by ID.
+    *
+    * \details These skip the string lookup, and they skip the
+    * GL call when the uniform already holds the value.
+    *
+    * \sa ShaderProgram::SetUniform
+    */
+   void SetTextureUniform(ShaderSource::UniformID whichTex, GLuint textureUnit);
+   void SetMatrix4Uniform(ShaderSource::UniformID whichMatrix, const float* matrixElements);
+   void SetMatrix3Uniform(ShaderSource::UniformID whichMatrix, const float* matrixElements);
+
    void SetGlobalAmbientLightColorUniform(const Color& globalAmbientColor);
    void SetLightUniforms(unsigned int whichLight, const Light& light);
 
    GLint GetAttributeLocation(const std::string& attribute);
-   GLint GetUniformLocation(const std::string& uniform);
 
    GLint EnableAttribute(const std::string& attribute);
+   GLint EnableAttribute(const std::string& attribute, unsigned int numLocations);
+
+   void DisableAttribute(const std::string& attribute, unsigned int numLocations = 1);
 
    bool CurrentProgramDoesLighting() const;
    bool CurrentProgramDoesTexturing() const;
@@ -66,6 +81,10 @@ private:
 
    ShaderProgram* currentProgram;
 
+   //private so that uniforms are only set through the setters above,
+   //which keep the current program's remembered uniform values in sync
+   GLint GetUniformLocation(const std::string& uniform);
+
    void DisableCurrentProgramAttributes();
 };
 
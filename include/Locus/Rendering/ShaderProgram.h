@@ -13,12 +13,17 @@
 #include "LocusRenderingAPI.h"
 
 #include "Shader.h"
+#include "ShaderVariables.h"
 #include "GLCommonTypes.h"
 
 #include <string>
-#include <map>
+#include <unordered_map>
+#include <vector>
+#include <array>
 #include <set>
 
+#include <cstddef>
+
 namespace Locus
 {
 
@@ -42,17 +47,95 @@ public:
    GLint GetAttributeLocation(const std::string& attribute) const;
    GLint GetUniformLocation(const std::string& uniform) const;
 
+   GLint GetUniformLocation(ShaderSource::UniformID uniform) const;
+   GLint GetLightUniformLocation(unsigned int whichLight, ShaderSource::LightUniformID lightUniform) const;
+
+   /// \return the number of lights whose uniforms were found when the program linked.
+   unsigned int NumLights() const;
+
+   /*!
+    * \brief Sets uniforms of the generated shaders by ID.
+    *
+    * \details The program must be in use. Each uniform remembers
+    * the last value it was given, and the GL call is skipped if
+    * the value hasn't changed. Uniforms that aren't active in
+    * the program are ignored.
+    */
+   void SetUniform(ShaderSource::UniformID uniform, GLint value);
+   void SetUniform(ShaderSource::UniformID uniform, float x, float y, float z, float w);
+   void SetUniformMatrix3(ShaderSource::UniformID uniform, const float* matrixElements);
+   void SetUniformMatrix4(ShaderSource::UniformID uniform, const float* matrixElements);
+
+   void SetLightUniform(unsigned int whichLight, ShaderSource::LightUniformID lightUniform, float value);
+   void SetLightUniform(unsigned int whichLight, ShaderSource::LightUniformID lightUniform, float x, float y, float z);
+   void SetLightUniform(unsigned int whichLight, ShaderSource::LightUniformID lightUniform, float x, float y, float z, float w);
+
+   /*!
+    * \brief Forgets the remembered value of the uniform at the
+    * given location.
+    *
+    * \details This must be called when a uniform is set outside
+    * of the ID based setters. Otherwise, a later call with the
+    * remembered value would wrongly be skipped.
+    */
+   void ForgetUniformValue(GLint location);
+
    GLint EnableAttribute(const std::string& attribute);
 
+   /*!
+    * \brief Enables an attribute that takes up more than one
+    * location, such as a mat4 attribute, which takes up four.
+    *
+    * \return the first location of the attribute.
+    */
+   GLint EnableAttribute(const std::string& attribute, unsigned int numLocations);
+
+   /// Disables an attribute enabled with EnableAttribute(const std::string&, unsigned int).
+   void DisableAttribute(const std::string& attribute, unsigned int numLocations);
+
    void DisableProgramAttributes();
 
    static void Stop();
 
 private:
-   mutable std::map<std::string, GLint> attributeLocationMap;
-   mutable std::map<std::string, GLint> uniformLocationMap;
+   static const std::size_t Max_Uniform_Values = 16;
+
+   struct CachedUniform
+   {
+      CachedUniform();
+
+      /// \return true if the uniform is active and newValues differs from its current value.
+      bool Update(const float* newValues, std::size_t numNewValues);
+
+      /// \return true if the uniform is active and newValue differs from its current value.
+      bool Update(GLint newValue);
+
+      void Forget();
+
+      GLint location;
+
+      //integer uniforms are remembered separately from float ones so
+      //that integers that don't fit exactly in a float aren't conflated
+      bool hasIntValue;
+      GLint intValue;
+
+      std::size_t numValues;
+      std::array<float, Max_Uniform_Values> values;
+   };
+
+   typedef std::array<CachedUniform, static_cast<std::size_t>(ShaderSource::LightUniformID::Num_Light_Uniforms)> LightUniforms_t;
+
+   mutable std::unordered_map<std::string, GLint> attributeLocationMap;
+   mutable std::unordered_map<std::string, GLint> uniformLocationMap;
+
+   std::array<CachedUniform, static_cast<std::size_t>(ShaderSource::UniformID::Num_Uniforms)> uniforms;
+   std::vector<LightUniforms_t> lightUniforms;
 
    std::set<GLint> enabledAttributes;
+
+   void ResolveUniformLocations();
+
+   CachedUniform* GetLightUniform(unsigned int whichLight, ShaderSource::LightUniformID lightUniform);
 };
 
 #include "Locus/Preprocessor/EndSilenceDLLInterfaceWarnings"
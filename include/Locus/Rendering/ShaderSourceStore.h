@@ -23,7 +23,17 @@ namespace ShaderSource
 {
 
 //{CodeReview:ShaderGeneration}
-LOCUS_RENDERING_API std::string Vert(GLInfo::GLSLVersion version, bool textured, unsigned int numLights);
+/*!
+ * \param[in] instanced if true, the vertex shader also reads a
+ * per instance model matrix (Instance_Model) and color
+ * (Instance_Color). Mat_MVP and Mat_MV are then expected to hold
+ * only the view and projection, and the instance color multiplies
+ * the vertex color. Only GLSL 1.30 shaders support this; it is
+ * ignored for older versions.
+ *
+ * \sa InstancedDrawable
+ */
+LOCUS_RENDERING_API std::string Vert(GLInfo::GLSLVersion version, bool textured, unsigned int numLights, bool instanced = false);
 LOCUS_RENDERING_API std::string Frag(GLInfo::GLSLVersion version, bool textured, unsigned int numLights);
 
 LOCUS_RENDERING_API std::string GetMultiVariableName(const std::string& variableName, unsigned int index);
@@ -29,6 +29,9 @@ LOCUS_RENDERING_API extern const std::string Vert_Pos;
 LOCUS_RENDERING_API extern const std::string Vert_Tex;
 LOCUS_RENDERING_API extern const std::string Vert_Normal;
 
+LOCUS_RENDERING_API extern const std::string Instance_Model;
+LOCUS_RENDERING_API extern const std::string Instance_Color;
+
 LOCUS_RENDERING_API extern const std::string Light_GlobalAmbient;
 LOCUS_RENDERING_API extern const std::string Light_EyePos;
 LOCUS_RENDERING_API extern const std::string Light_Diffuse;
@@ -41,6 +44,41 @@ LOCUS_RENDERING_API extern const std::string ToLightDirection;
 LOCUS_RENDERING_API extern const std::string ToEyeDirection;
 LOCUS_RENDERING_API extern const std::string CalculatedLightAttenuation;
 
+/*!
+ * \brief IDs for the uniforms of the generated shaders.
+ *
+ * \details The locations of these uniforms are resolved once
+ * when a ShaderProgram links, so setting them by ID doesn't
+ * look up any strings.
+ */
+enum class UniformID : unsigned int
+{
+   Map_Diffuse,
+   Mat_MVP,
+   Mat_MV,
+   Mat_Normal,
+   Light_GlobalAmbient,
+   Num_Uniforms
+};
+
+/// IDs for the uniforms that the generated shaders declare once per light.
+enum class LightUniformID : unsigned int
+{
+   EyePos,
+   Diffuse,
+   Ambient,
+   Specular,
+   Attenuation,
+   LinearAttenuation,
+   QuadraticAttenuation,
+   Num_Light_Uniforms
+};
+
+LOCUS_RENDERING_API const std::string& GetUniformName(UniformID uniform);
+
+/// \return the name of the uniform without the light index.
+LOCUS_RENDERING_API const std::string& GetLightUniformName(LightUniformID lightUniform);
+
 }
 
 }
\ No newline at end of file
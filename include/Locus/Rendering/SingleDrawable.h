@@ -32,6 +32,9 @@ public:
 
    virtual void Draw(RenderingState& renderingState) const override;
 
+   /// \return the vertex data, or null if it hasn't been created.
+   const GPUVertexData* GetGPUVertexData() const;
+
 protected:
    std::unique_ptr<GPUVertexData> gpuVertexData;
 };
@@ -19,6 +19,8 @@ namespace Locus
 {
 
 class Image;
+class MipChain;
+class BakedTexture;
 class GLInfo;
 
 class LOCUS_RENDERING_API Texture
@@ -33,6 +35,18 @@ public:
    };
 
    Texture(const Image& image, MipmapGeneration mipmapGeneration, TextureFiltering filtering, bool clamp, const GLInfo& glInfo);
+
+   /// Sends every level of the given chain as is. The texture is mipmapped if the chain has more than one level.
+   Texture(const MipChain& mipChain, TextureFiltering filtering, bool clamp);
+
+   /*!
+    * \brief Sends every level of the baked texture straight from its mapping.
+    *
+    * \throws Exception if the texture is BC1 or BC3 compressed and
+    * S3TC compression isn't supported.
+    */
+   Texture(const BakedTexture& bakedTexture, TextureFiltering filtering, bool clamp);
+
    ~Texture();
 
    Texture(const Texture&) = delete;
@@ -45,16 +59,18 @@ public:
    static GLint GLSizedFormat(unsigned int numPixelComponents);
 
    static void SendTextureData(const Image& image, GLint textureLevel);
+   static void SendTextureData(const unsigned char* pixelData, unsigned int width, unsigned int height, unsigned int numPixelComponents, GLint textureLevel);
 
 private:
    GLuint id;
 
-   static unsigned int ClosestPowerOf2(unsigned int num);
+   static void SetFiltering(bool mipmapped, TextureFiltering filtering);
+   static void SetWrapping(bool clamp);
 
    void GenerateMipmaps(const Image& image, MipmapGeneration mipmapGeneration, const GLInfo& glInfo) const;
    void GenerateMipmapsLegacy(const Image& image) const;
    void GenerateManualMipmaps(const Image& image) const;
-   static void GenerateManualMipmapsUsingPowerOf2Image(Image& image);
+   static void GenerateManualMipmapsUsingPowerOf2Image(const Image& image);
 };
 
 }
\ No newline at end of file
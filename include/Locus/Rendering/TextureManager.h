@@ -14,6 +14,8 @@
 
 #include "GLCommonTypes.h"
 #include "Texture.h"
+#include "TextureStreamer.h"
+#include "BakedTexture.h"
 
 #include <string>
 #include <unordered_map>
@@ -24,6 +26,7 @@ namespace Locus
 
 class GLInfo;
 class Texture;
+class ThreadPool;
 struct MountedFilePath;
 
 #include "Locus/Preprocessor/BeginSilenceDLLInterfaceWarnings"
@@ -40,6 +43,63 @@ public:
    void Load(const std::string& textureName, const std::string& textureLocation, Texture::MipmapGeneration mipmapGeneration, TextureFiltering filtering, bool clamp);
    void Load(const std::string& textureName, const MountedFilePath& textureLocation, Texture::MipmapGeneration mipmapGeneration, TextureFiltering filtering, bool clamp);
 
+   /*!
+    * \brief Loads a texture from the baked texture at
+    * bakedFilePath, baking it first from textureLocation
+    * if it is missing, invalid, of a different format, or
+    * out of date.
+    *
+    * \throws Exception
+    *
+    * \sa BakedTexture::LoadOrBake
+    */
+   void LoadBaked(const std::string& textureName, const std::string& textureLocation, const std::string& bakedFilePath, BakedTexture::Format format, TextureFiltering filtering, bool clamp);
+   void LoadBaked(const std::string& textureName, const MountedFilePath& textureLocation, const std::string& bakedFilePath, BakedTexture::Format format, TextureFiltering filtering, bool clamp);
+
+   /*!
+    * \brief Loads the texture in the background.
+    *
+    * \details The file is read and decoded on the
+    * streaming thread pool (see SetStreamingThreadPool),
+    * and the texture is created by a later call to
+    * UpdateStreaming. Until then, GetTexture returns a
+    * 1x1 white placeholder for textureName. If loading
+    * fails, UpdateStreaming forgets the request, so
+    * GetTexture returns null and textureName may be
+    * requested again.
+    *
+    * \return the handle of the request, or
+    * BAD_TEXTURE_STREAM_HANDLE if textureName was
+    * already loaded with Load. Requesting a name that
+    * is already streaming returns the same handle.
+    */
+   TextureStreamHandle_t LoadAsync(const std::string& textureName, const std::string& textureLocation, Texture::MipmapGeneration mipmapGeneration, TextureFiltering filtering, bool clamp);
+   TextureStreamHandle_t LoadAsync(const std::string& textureName, const MountedFilePath& textureLocation, Texture::MipmapGeneration mipmapGeneration, TextureFiltering filtering, bool clamp);
+
+   /// \details the thread pool must outlive this object or be unset first.
+   void SetStreamingThreadPool(ThreadPool* threadPool);
+
+   /*!
+    * \brief Creates the textures that have finished
+    * decoding. Call this once per frame.
+    *
+    * \param[in] uploadBudget The max number of pixel
+    * bytes to upload. At least one texture is created
+    * if any is waiting.
+    *
+    * \return the number of textures created.
+    */
+   std::size_t UpdateStreaming(std::size_t uploadBudget);
+
+   /*!
+    * \details The handle is only valid until the
+    * UpdateStreaming call that creates the texture or
+    * forgets the failed request. After that, use
+    * GetTexture.
+    */
+   TextureStreamer::State GetStreamState(TextureStreamHandle_t handle) const;
+
+   /// \return the texture, or the placeholder if it is still streaming.
    Texture* GetTexture(const std::string& textureName) const;
 
    virtual void UnLoad();
@@ -49,8 +109,19 @@ private:
 
    const GLInfo& glInfo;
 
+   std::unique_ptr<TextureUploader> uploader;
+   std::unique_ptr<TextureStreamer> streamer;
+   std::unordered_map<std::string, TextureStreamHandle_t> streamHandles;
+   std::unique_ptr<Texture> placeholderTexture;
+
    template <class FilePathType>
    void Load(const std::string& textureName, const FilePathType& textureFilePath, Texture::MipmapGeneration mipmapGeneration, TextureFiltering filtering, bool clamp);
+
+   template <class FilePathType>
+   void LoadBaked(const std::string& textureName, const FilePathType& textureFilePath, const std::string& bakedFilePath, BakedTexture::Format format, TextureFiltering filtering, bool clamp);
+
+   template <class FilePathType>
+   TextureStreamHandle_t LoadAsync(const std::string& textureName, const FilePathType& textureFilePath, Texture::MipmapGeneration mipmapGeneration, TextureFiltering filtering, bool clamp);
 };
 
 #include "Locus/Preprocessor/EndSilenceDLLInterfaceWarnings"
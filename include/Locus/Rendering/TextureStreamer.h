@@ -0,0 +1,166 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "LocusRenderingAPI.h"
+
+#include "Texture.h"
+#include "TextureFiltering.h"
+
+#include <string>
+#include <functional>
+#include <memory>
+
+#include <cstddef>
+
+namespace Locus
+{
+
+class Image;
+class MipChain;
+class ThreadPool;
+
+typedef std::size_t TextureStreamHandle_t;
+
+/// Never returned by TextureStreamer::Request.
+LOCUS_RENDERING_API extern const TextureStreamHandle_t BAD_TEXTURE_STREAM_HANDLE;
+
+#include "Locus/Preprocessor/BeginSilenceDLLInterfaceWarnings"
+
+/*!
+ * \brief A texture that has been decoded and is waiting
+ * to be uploaded.
+ *
+ * \details If mipmapGeneration is Manual, then the image
+ * has already been scaled to a power of 2 and mipChain
+ * holds every level. image is null in that case.
+ * Otherwise, mipChain is null.
+ */
+struct LOCUS_RENDERING_API StreamedTexture
+{
+   TextureStreamHandle_t handle;
+   std::string textureName;
+
+   Texture::MipmapGeneration mipmapGeneration;
+   TextureFiltering filtering;
+   bool clamp;
+
+   std::unique_ptr<Image> image;
+   std::unique_ptr<MipChain> mipChain;
+
+   /// \return the number of pixel bytes that will be uploaded.
+   std::size_t NumBytes() const;
+};
+
+/// Receives decoded textures on the thread that calls TextureStreamer::ProcessUploads.
+class LOCUS_RENDERING_API TextureUploader
+{
+public:
+   virtual ~TextureUploader();
+
+   virtual void Upload(StreamedTexture& streamedTexture) = 0;
+};
+
+struct TextureStreamer_Impl;
+
+/*!
+ * \brief Loads textures in the background.
+ *
+ * \details Request queues an image to be loaded and
+ * decoded on a ThreadPool (see SetThreadPool). The
+ * manual mip chain is built there too. Decoded textures
+ * are handed to the TextureUploader, oldest first, from
+ * ProcessUploads, which is meant to be called once per
+ * frame on the thread that owns the GL context.
+ *
+ * TextureStreamer makes no GL calls itself, so it can
+ * be driven without a GL context by any TextureUploader.
+ * Request, ProcessUploads, and Clear should be called
+ * from the same thread.
+ */
+class LOCUS_RENDERING_API TextureStreamer
+{
+public:
+   enum class State
+   {
+      Decoding,
+      WaitingForUpload,
+      Ready,
+      Failed
+   };
+
+   /// \details uploader must outlive this object.
+   TextureStreamer(TextureUploader& uploader);
+
+   /// Waits for the images that are still being decoded.
+   ~TextureStreamer();
+
+   TextureStreamer(const TextureStreamer&) = delete;
+   TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+   /*!
+    * \details If threadPool is null, which is the default,
+    * then Request decodes on the calling thread. The upload
+    * is still deferred to ProcessUploads.
+    */
+   void SetThreadPool(ThreadPool* threadPool);
+
+   /*!
+    * \param[in] loadImage Produces the image. It is called
+    * on a worker thread, and may throw to signal failure.
+    */
+   TextureStreamHandle_t Request(const std::string& textureName, const std::function<Image()>& loadImage, Texture::MipmapGeneration mipmapGeneration, TextureFiltering filtering, bool clamp);
+
+   State GetState(TextureStreamHandle_t handle) const;
+
+   /*!
+    * \brief Lets a later Request reuse the handle of a
+    * request that is Ready or Failed.
+    *
+    * \details Each handle takes one slot until it is
+    * released or Clear is called, so a streamer that
+    * serves requests indefinitely should release the
+    * handles it is done with. The handle becomes invalid.
+    */
+   void Release(TextureStreamHandle_t handle);
+
+   /// \return the number of requests that are not yet Ready or Failed.
+   std::size_t NumPending() const;
+
+   /*!
+    * \brief Uploads decoded textures until uploadBudget
+    * bytes have been uploaded.
+    *
+    * \details At least one texture is uploaded if any is
+    * waiting, even if it is larger than the budget, so that
+    * large textures can't stall the queue. If the
+    * uploader throws, then that request is Failed.
+    *
+    * \return the number of textures uploaded.
+    */
+   std::size_t ProcessUploads(std::size_t uploadBudget);
+
+   /*!
+    * \brief Drops all requests.
+    *
+    * \details Blocks until the images that are still being
+    * decoded are done. Their results are discarded. Existing
+    * handles become invalid.
+    */
+   void Clear();
+
+private:
+   std::unique_ptr<TextureStreamer_Impl> impl;
+};
+
+#include "Locus/Preprocessor/EndSilenceDLLInterfaceWarnings"
+
+}
\ No newline at end of file
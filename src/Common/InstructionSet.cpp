@@ -0,0 +1,86 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "Locus/Common/InstructionSet.h"
+
+#include <atomic>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+
+   #define LOCUS_X86
+
+   #ifdef _MSC_VER
+      #include <intrin.h>
+   #endif
+
+#endif
+
+namespace Locus
+{
+
+static InstructionSet QueryInstructionSet()
+{
+#ifdef LOCUS_X86
+
+   #ifdef _MSC_VER
+
+      int cpuInfo[4];
+      __cpuid(cpuInfo, 1);
+
+      bool hasSSE2 = ((cpuInfo[3] & (1 << 26)) != 0);
+
+      //AVX also needs the OS to save the upper halves of the ymm registers
+      bool hasAVX = ((cpuInfo[2] & (1 << 28)) != 0) && ((cpuInfo[2] & (1 << 27)) != 0) && ((_xgetbv(0) & 0x6) == 0x6);
+
+   #else
+
+      __builtin_cpu_init();
+
+      bool hasSSE2 = (__builtin_cpu_supports("sse2") != 0);
+      bool hasAVX = (__builtin_cpu_supports("avx") != 0);
+
+   #endif
+
+   if (hasAVX)
+   {
+      return InstructionSet::AVX;
+   }
+
+   if (hasSSE2)
+   {
+      return InstructionSet::SSE2;
+   }
+
+#endif //LOCUS_X86
+
+   return InstructionSet::Scalar;
+}
+
+static std::atomic<int>& WidestAllowedInstructionSet()
+{
+   static std::atomic<int> widestAllowedInstructionSet(static_cast<int>(InstructionSet::AVX));
+
+   return widestAllowedInstructionSet;
+}
+
+InstructionSet DetectInstructionSet()
+{
+   static const InstructionSet instructionSet = QueryInstructionSet();
+
+   return static_cast<InstructionSet>(std::min(static_cast<int>(instructionSet), WidestAllowedInstructionSet().load(std::memory_order_relaxed)));
+}
+
+void LimitInstructionSet(InstructionSet widestInstructionSet)
+{
+   WidestAllowedInstructionSet().store(static_cast<int>(widestInstructionSet), std::memory_order_relaxed);
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,184 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "Locus/Common/ThreadPool.h"
+
+#include <atomic>
+#include <memory>
+#include <exception>
+#include <algorithm>
+
+namespace Locus
+{
+
+ThreadPool::ThreadPool(unsigned int numThreads)
+   : stopping(false)
+{
+   if (numThreads == 0)
+   {
+      numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+   }
+
+   workers.reserve(numThreads);
+
+   for (unsigned int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+   {
+      workers.emplace_back(&ThreadPool::WorkerLoop, this);
+   }
+}
+
+ThreadPool::~ThreadPool()
+{
+   {
+      std::lock_guard<std::mutex> lock(tasksMutex);
+      stopping = true;
+   }
+
+   tasksCondition.notify_all();
+
+   for (std::thread& worker : workers)
+   {
+      worker.join();
+   }
+}
+
+unsigned int ThreadPool::NumThreads() const
+{
+   return static_cast<unsigned int>(workers.size());
+}
+
+void ThreadPool::Enqueue(const std::function<void()>& task)
+{
+   {
+      std::lock_guard<std::mutex> lock(tasksMutex);
+      tasks.push(task);
+   }
+
+   tasksCondition.notify_one();
+}
+
+void ThreadPool::WorkerLoop()
+{
+   for (;;)
+   {
+      std::function<void()> task;
+
+      {
+         std::unique_lock<std::mutex> lock(tasksMutex);
+
+         tasksCondition.wait(lock, [this]()->bool{ return stopping || !tasks.empty(); });
+
+         if (tasks.empty())
+         {
+            return;
+         }
+
+         task = std::move(tasks.front());
+         tasks.pop();
+      }
+
+      task();
+   }
+}
+
+void ThreadPool::ParallelFor(std::size_t count, std::size_t grainSize, const std::function<void(std::size_t, std::size_t)>& func)
+{
+   if (count == 0)
+   {
+      return;
+   }
+
+   if (grainSize == 0)
+   {
+      //aim for a few ranges per thread so uneven ranges balance out
+      grainSize = std::max<std::size_t>(count / (4 * (workers.size() + 1)), 1);
+   }
+
+   std::size_t numRanges = (count + grainSize - 1) / grainSize;
+
+   if (numRanges == 1)
+   {
+      func(0, count);
+      return;
+   }
+
+   //The state is shared with the helper tasks, since a helper may
+   //only start running after this call has returned
+   struct ParallelForState
+   {
+      std::atomic<std::size_t> nextRange;
+      std::size_t numRangesDone;
+      std::exception_ptr firstException;
+      std::mutex doneMutex;
+      std::condition_variable doneCondition;
+   };
+
+   std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>();
+   state->nextRange = 0;
+   state->numRangesDone = 0;
+
+   std::function<void()> runRanges = [state, count, grainSize, numRanges, func]()
+   {
+      for (;;)
+      {
+         std::size_t range = state->nextRange++;
+
+         if (range >= numRanges)
+         {
+            return;
+         }
+
+         std::size_t begin = range * grainSize;
+
+         std::exception_ptr exception;
+
+         try
+         {
+            func(begin, std::min(begin + grainSize, count));
+         }
+         catch (...)
+         {
+            exception = std::current_exception();
+         }
+
+         std::lock_guard<std::mutex> lock(state->doneMutex);
+
+         if (exception && !state->firstException)
+         {
+            state->firstException = exception;
+         }
+
+         if (++state->numRangesDone == numRanges)
+         {
+            state->doneCondition.notify_all();
+         }
+      }
+   };
+
+   std::size_t numHelpers = std::min<std::size_t>(workers.size(), numRanges - 1);
+
+   for (std::size_t helperIndex = 0; helperIndex < numHelpers; ++helperIndex)
+   {
+      Enqueue(runRanges);
+   }
+
+   runRanges();
+
+   std::unique_lock<std::mutex> lock(state->doneMutex);
+
+   state->doneCondition.wait(lock, [&state, numRanges]()->bool{ return state->numRangesDone == numRanges; });
+
+   if (state->firstException)
+   {
+      std::rethrow_exception(state->firstException);
+   }
+}
+
+}
\ No newline at end of file
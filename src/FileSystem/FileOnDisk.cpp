@@ -148,6 +148,11 @@ std::size_t FileOnDisk::Read(char* bytes, std::size_t numBytesToRead)
    return fread(bytes, 1, numBytesToRead, impl->fileHandle);
 }
 
+std::size_t FileOnDisk::Write(const char* bytes, std::size_t numBytesToWrite)
+{
+   return fwrite(bytes, 1, numBytesToWrite, impl->fileHandle);
+}
+
 bool FileOnDisk::Seek(std::size_t offset, DataStream::SeekType seekType)
 {
    int origin = 0;
@@ -12,10 +12,13 @@
 
 #include "Locus/FileSystem/FileOnDisk.h"
 #include "Locus/FileSystem/File.h"
+#include "Locus/FileSystem/MountedFilePath.h"
 
 #include "Locus/Common/Exception.h"
 #include "Locus/Common/Parsing.h"
 
+#include "physfs.h"
+
 #if defined(LOCUS_WINDOWS)
    #define NOMINMAX
    #include <windows.h>
@@ -23,8 +26,13 @@
    #include <stdlib.h>
 #else
    #include <unistd.h>
+   #include <dirent.h>
+   #include <sys/stat.h>
 #endif
 
+#include <sys/types.h>
+#include <sys/stat.h>
+
 #include <mutex>
 
 namespace Locus
@@ -142,10 +150,28 @@ static std::string GetExePath_Internal()
    }
 }
 
-//TODO
 bool GetAllFilesInDirectory(const std::string& directoryPath, std::vector<std::string>& filesInDirectory)
 {
-   return false;
+   filesInDirectory.clear();
+
+   DIR* directory = opendir(directoryPath.c_str());
+
+   if (directory == nullptr)
+   {
+      return false;
+   }
+
+   while (dirent* entry = readdir(directory))
+   {
+      struct stat entryStatus;
+
+      if ((stat((directoryPath + "/" + entry->d_name).c_str(), &entryStatus) == 0) && !S_ISDIR(entryStatus.st_mode))
+      {
+         filesInDirectory.push_back(entry->d_name);
+      }
+   }
+
+   return (closedir(directory) == 0);
 }
 
 #endif
@@ -181,4 +207,58 @@ void ReadWholeFile(const MountedFilePath& mountedFilePath, std::vector<char>& da
    file.ReadWholeFile(data);
 }
 
+bool operator==(const FileStamp& first, const FileStamp& second)
+{
+   return (first.sizeInBytes == second.sizeInBytes) && (first.lastModifiedTime == second.lastModifiedTime);
+}
+
+bool operator!=(const FileStamp& first, const FileStamp& second)
+{
+   return !(first == second);
+}
+
+FileStamp GetFileStamp(const std::string& filePath)
+{
+   FileStamp fileStamp;
+
+   #if defined(LOCUS_WINDOWS)
+      struct _stat64 fileStatus;
+
+      if (_stat64(filePath.c_str(), &fileStatus) != 0)
+      {
+         throw Exception(std::string("Failed to get the status of file ") + filePath);
+      }
+
+      fileStamp.lastModifiedTime = static_cast<std::int64_t>(fileStatus.st_mtime);
+   #else
+      struct stat fileStatus;
+
+      if (stat(filePath.c_str(), &fileStatus) != 0)
+      {
+         throw Exception(std::string("Failed to get the status of file ") + filePath);
+      }
+
+      //nanoseconds, since a file can be rewritten within a second
+      #if defined(LOCUS_OSX)
+         fileStamp.lastModifiedTime = static_cast<std::int64_t>(fileStatus.st_mtimespec.tv_sec) * 1000000000 + fileStatus.st_mtimespec.tv_nsec;
+      #else
+         fileStamp.lastModifiedTime = static_cast<std::int64_t>(fileStatus.st_mtim.tv_sec) * 1000000000 + fileStatus.st_mtim.tv_nsec;
+      #endif
+   #endif
+
+   fileStamp.sizeInBytes = static_cast<std::uint64_t>(fileStatus.st_size);
+
+   return fileStamp;
+}
+
+FileStamp GetFileStamp(const MountedFilePath& mountedFilePath)
+{
+   FileStamp fileStamp;
+
+   fileStamp.sizeInBytes = File(mountedFilePath, DataStream::OpenMode::Read).SizeInBytes();
+   fileStamp.lastModifiedTime = PHYSFS_getLastModTime(mountedFilePath.path.c_str());
+
+   return fileStamp;
+}
+
 }
\ No newline at end of file
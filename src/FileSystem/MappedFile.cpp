@@ -0,0 +1,155 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "Locus/FileSystem/MappedFile.h"
+
+#include "Locus/Common/Exception.h"
+
+#if defined(LOCUS_WINDOWS)
+   #ifndef WIN32_LEAN_AND_MEAN
+      #define WIN32_LEAN_AND_MEAN
+   #endif
+   #ifndef NOMINMAX
+      #define NOMINMAX
+   #endif
+   #include <windows.h>
+#else
+   #include <sys/mman.h>
+   #include <sys/stat.h>
+   #include <fcntl.h>
+   #include <unistd.h>
+#endif
+
+namespace Locus
+{
+
+struct MappedFile_Impl
+{
+   const unsigned char* data;
+   std::size_t sizeInBytes;
+
+#if defined(LOCUS_WINDOWS)
+   HANDLE fileHandle;
+   HANDLE mappingHandle;
+#endif
+};
+
+MappedFile::MappedFile(const std::string& filePath)
+   : impl(std::make_unique<MappedFile_Impl>()), filePath(filePath)
+{
+   impl->data = nullptr;
+   impl->sizeInBytes = 0;
+
+#if defined(LOCUS_WINDOWS)
+   impl->fileHandle = INVALID_HANDLE_VALUE;
+   impl->mappingHandle = nullptr;
+
+   impl->fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+   if (impl->fileHandle == INVALID_HANDLE_VALUE)
+   {
+      throw Exception(std::string("Failed to open file ") + filePath + "\nerror code: " + std::to_string(GetLastError()));
+   }
+
+   LARGE_INTEGER fileSize;
+
+   if (!GetFileSizeEx(impl->fileHandle, &fileSize))
+   {
+      CloseHandle(impl->fileHandle);
+      throw Exception(std::string("Failed to get the size of file ") + filePath);
+   }
+
+   impl->sizeInBytes = static_cast<std::size_t>(fileSize.QuadPart);
+
+   if (impl->sizeInBytes > 0)
+   {
+      impl->mappingHandle = CreateFileMappingA(impl->fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+      if (impl->mappingHandle != nullptr)
+      {
+         impl->data = static_cast<const unsigned char*>(MapViewOfFile(impl->mappingHandle, FILE_MAP_READ, 0, 0, 0));
+      }
+
+      if (impl->data == nullptr)
+      {
+         if (impl->mappingHandle != nullptr)
+         {
+            CloseHandle(impl->mappingHandle);
+         }
+
+         CloseHandle(impl->fileHandle);
+         throw Exception(std::string("Failed to map file ") + filePath);
+      }
+   }
+#else
+   int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+
+   if (fileDescriptor == -1)
+   {
+      throw Exception(std::string("Failed to open file ") + filePath);
+   }
+
+   struct stat fileStatus;
+
+   if (fstat(fileDescriptor, &fileStatus) != 0)
+   {
+      close(fileDescriptor);
+      throw Exception(std::string("Failed to get the size of file ") + filePath);
+   }
+
+   impl->sizeInBytes = static_cast<std::size_t>(fileStatus.st_size);
+
+   if (impl->sizeInBytes > 0)
+   {
+      void* mapping = mmap(nullptr, impl->sizeInBytes, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+      if (mapping == MAP_FAILED)
+      {
+         close(fileDescriptor);
+         throw Exception(std::string("Failed to map file ") + filePath);
+      }
+
+      impl->data = static_cast<const unsigned char*>(mapping);
+   }
+
+   //the mapping stays valid after the descriptor is closed
+   close(fileDescriptor);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#if defined(LOCUS_WINDOWS)
+   if (impl->data != nullptr)
+   {
+      UnmapViewOfFile(impl->data);
+      CloseHandle(impl->mappingHandle);
+   }
+
+   CloseHandle(impl->fileHandle);
+#else
+   if (impl->data != nullptr)
+   {
+      munmap(const_cast<unsigned char*>(impl->data), impl->sizeInBytes);
+   }
+#endif
+}
+
+const unsigned char* MappedFile::Data() const
+{
+   return impl->data;
+}
+
+std::size_t MappedFile::SizeInBytes() const
+{
+   return impl->sizeInBytes;
+}
+
+}
\ No newline at end of file
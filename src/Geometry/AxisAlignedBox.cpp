@@ -12,6 +12,7 @@
 #include "Locus/Geometry/Triangle.h"
 #include "Locus/Geometry/Sphere.h"
 #include "Locus/Geometry/Moveable.h"
+#include "Locus/Geometry/RelativeTransformation.h"
 
 #include "Locus/Common/Float.h"
 
@@ -155,6 +156,11 @@ bool AxisAlignedBox::Intersects(const Moveable& thisMoveable, const AxisAlignedB
    return thisTransformed.Intersects(otherTransformed);
 }
 
+bool AxisAlignedBox::Intersects(const AxisAlignedBox& other, const RelativeTransformation& relativeTransformation) const
+{
+   return Intersects(relativeTransformation.thisMoveable, other, relativeTransformation.otherMoveable);
+}
+
 bool AxisAlignedBox::Intersects(const Sphere& sphere) const
 {
    //On Faster Sphere-Box Overlap Testing. J. Graphics Tools 12(1): 3-8 (2007)
@@ -267,6 +273,13 @@ float AxisAlignedBox::DiagonalLength() const
    return Norm(max - min);
 }
 
+float AxisAlignedBox::SurfaceArea() const
+{
+   FVector3 lengths = max - min;
+
+   return 2.0f * ((lengths.x * lengths.y) + (lengths.y * lengths.z) + (lengths.z * lengths.x));
+}
+
 FVector3 AxisAlignedBox::Centroid() const
 {
    return min + ((max - min) / 2.0f);
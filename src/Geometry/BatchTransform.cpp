@@ -0,0 +1,352 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "BatchTransform.h"
+#include "InstructionSet.h"
+
+namespace Locus
+{
+
+namespace BatchTransform
+{
+
+/////////////////////////////////////////Scalar/////////////////////////////////////////
+
+static void MultVertexScalar(const float* m, float x, float y, float z, float& resultX, float& resultY, float& resultZ)
+{
+   resultX = m[0] * x + m[4] * y + m[8]  * z + m[12];
+   resultY = m[1] * x + m[5] * y + m[9]  * z + m[13];
+   resultZ = m[2] * x + m[6] * y + m[10] * z + m[14];
+}
+
+static void MultVerticesScalar(const float* m, const float* vertices, std::size_t numVertices, float* result)
+{
+   for (std::size_t i = 0; i < numVertices; ++i)
+   {
+      const float* vertex = vertices + 3 * i;
+      float* resultVertex = result + 3 * i;
+
+      MultVertexScalar(m, vertex[0], vertex[1], vertex[2], resultVertex[0], resultVertex[1], resultVertex[2]);
+   }
+}
+
+static void MultVerticesScalar(const float* m, const float* vertices, std::size_t numVertices, float* resultXs, float* resultYs, float* resultZs)
+{
+   for (std::size_t i = 0; i < numVertices; ++i)
+   {
+      const float* vertex = vertices + 3 * i;
+
+      MultVertexScalar(m, vertex[0], vertex[1], vertex[2], resultXs[i], resultYs[i], resultZs[i]);
+   }
+}
+
+static void MultVerticesScalar(const float* m, const float* xs, const float* ys, const float* zs, std::size_t numVertices, float* resultXs, float* resultYs, float* resultZs)
+{
+   for (std::size_t i = 0; i < numVertices; ++i)
+   {
+      MultVertexScalar(m, xs[i], ys[i], zs[i], resultXs[i], resultYs[i], resultZs[i]);
+   }
+}
+
+#ifdef LOCUS_X86
+
+/////////////////////////////////////////SSE2/////////////////////////////////////////
+
+struct SSE2Matrix
+{
+   __m128 m0, m1, m2, m4, m5, m6, m8, m9, m10, m12, m13, m14;
+};
+
+static LOCUS_TARGET_SSE2 SSE2Matrix BroadcastSSE2(const float* m)
+{
+   return SSE2Matrix{ _mm_set1_ps(m[0]), _mm_set1_ps(m[1]),  _mm_set1_ps(m[2]),
+                      _mm_set1_ps(m[4]), _mm_set1_ps(m[5]),  _mm_set1_ps(m[6]),
+                      _mm_set1_ps(m[8]), _mm_set1_ps(m[9]),  _mm_set1_ps(m[10]),
+                      _mm_set1_ps(m[12]), _mm_set1_ps(m[13]), _mm_set1_ps(m[14]) };
+}
+
+static LOCUS_TARGET_SSE2 void MultVerticesSSE2(const SSE2Matrix& m, __m128& x, __m128& y, __m128& z)
+{
+   __m128 resultX = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m.m0, x), _mm_mul_ps(m.m4, y)), _mm_mul_ps(m.m8, z)), m.m12);
+   __m128 resultY = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m.m1, x), _mm_mul_ps(m.m5, y)), _mm_mul_ps(m.m9, z)), m.m13);
+   __m128 resultZ = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m.m2, x), _mm_mul_ps(m.m6, y)), _mm_mul_ps(m.m10, z)), m.m14);
+
+   x = resultX;
+   y = resultY;
+   z = resultZ;
+}
+
+//a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+static LOCUS_TARGET_SSE2 void DeinterleaveSSE2(__m128 a, __m128 b, __m128 c, __m128& x, __m128& y, __m128& z)
+{
+   __m128 x2y2x3y3 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+   __m128 y0z0y1z1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+
+   x = _mm_shuffle_ps(a, x2y2x3y3, _MM_SHUFFLE(2, 0, 3, 0));
+   y = _mm_shuffle_ps(y0z0y1z1, x2y2x3y3, _MM_SHUFFLE(3, 1, 2, 0));
+   z = _mm_shuffle_ps(y0z0y1z1, c, _MM_SHUFFLE(3, 0, 3, 1));
+}
+
+static LOCUS_TARGET_SSE2 void InterleaveSSE2(__m128 x, __m128 y, __m128 z, __m128& a, __m128& b, __m128& c)
+{
+   __m128 x0y0x1y1 = _mm_unpacklo_ps(x, y);
+   __m128 x2y2x3y3 = _mm_unpackhi_ps(x, y);
+
+   a = _mm_shuffle_ps(x0y0x1y1, _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0));
+   b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), x2y2x3y3, _MM_SHUFFLE(1, 0, 2, 0));
+   c = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+static LOCUS_TARGET_SSE2 void MultVerticesSSE2(const float* m, const float* vertices, std::size_t numVertices, float* result)
+{
+   SSE2Matrix broadcastMatrix = BroadcastSSE2(m);
+
+   std::size_t numVectorized = numVertices - (numVertices % 4);
+
+   for (std::size_t i = 0; i < numVectorized; i += 4)
+   {
+      __m128 x, y, z;
+      DeinterleaveSSE2(_mm_loadu_ps(vertices + 3 * i), _mm_loadu_ps(vertices + 3 * i + 4), _mm_loadu_ps(vertices + 3 * i + 8), x, y, z);
+
+      MultVerticesSSE2(broadcastMatrix, x, y, z);
+
+      __m128 a, b, c;
+      InterleaveSSE2(x, y, z, a, b, c);
+
+      _mm_storeu_ps(result + 3 * i, a);
+      _mm_storeu_ps(result + 3 * i + 4, b);
+      _mm_storeu_ps(result + 3 * i + 8, c);
+   }
+
+   MultVerticesScalar(m, vertices + 3 * numVectorized, numVertices - numVectorized, result + 3 * numVectorized);
+}
+
+static LOCUS_TARGET_SSE2 void MultVerticesSSE2(const float* m, const float* vertices, std::size_t numVertices, float* resultXs, float* resultYs, float* resultZs)
+{
+   SSE2Matrix broadcastMatrix = BroadcastSSE2(m);
+
+   std::size_t numVectorized = numVertices - (numVertices % 4);
+
+   for (std::size_t i = 0; i < numVectorized; i += 4)
+   {
+      __m128 x, y, z;
+      DeinterleaveSSE2(_mm_loadu_ps(vertices + 3 * i), _mm_loadu_ps(vertices + 3 * i + 4), _mm_loadu_ps(vertices + 3 * i + 8), x, y, z);
+
+      MultVerticesSSE2(broadcastMatrix, x, y, z);
+
+      _mm_storeu_ps(resultXs + i, x);
+      _mm_storeu_ps(resultYs + i, y);
+      _mm_storeu_ps(resultZs + i, z);
+   }
+
+   MultVerticesScalar(m, vertices + 3 * numVectorized, numVertices - numVectorized, resultXs + numVectorized, resultYs + numVectorized, resultZs + numVectorized);
+}
+
+static LOCUS_TARGET_SSE2 void MultVerticesSSE2(const float* m, const float* xs, const float* ys, const float* zs, std::size_t numVertices, float* resultXs, float* resultYs, float* resultZs)
+{
+   SSE2Matrix broadcastMatrix = BroadcastSSE2(m);
+
+   std::size_t numVectorized = numVertices - (numVertices % 4);
+
+   for (std::size_t i = 0; i < numVectorized; i += 4)
+   {
+      __m128 x = _mm_loadu_ps(xs + i);
+      __m128 y = _mm_loadu_ps(ys + i);
+      __m128 z = _mm_loadu_ps(zs + i);
+
+      MultVerticesSSE2(broadcastMatrix, x, y, z);
+
+      _mm_storeu_ps(resultXs + i, x);
+      _mm_storeu_ps(resultYs + i, y);
+      _mm_storeu_ps(resultZs + i, z);
+   }
+
+   MultVerticesScalar(m, xs + numVectorized, ys + numVectorized, zs + numVectorized, numVertices - numVectorized, resultXs + numVectorized, resultYs + numVectorized, resultZs + numVectorized);
+}
+
+/////////////////////////////////////////AVX/////////////////////////////////////////
+
+struct AVXMatrix
+{
+   __m256 m0, m1, m2, m4, m5, m6, m8, m9, m10, m12, m13, m14;
+};
+
+static LOCUS_TARGET_AVX AVXMatrix BroadcastAVX(const float* m)
+{
+   return AVXMatrix{ _mm256_set1_ps(m[0]), _mm256_set1_ps(m[1]),  _mm256_set1_ps(m[2]),
+                     _mm256_set1_ps(m[4]), _mm256_set1_ps(m[5]),  _mm256_set1_ps(m[6]),
+                     _mm256_set1_ps(m[8]), _mm256_set1_ps(m[9]),  _mm256_set1_ps(m[10]),
+                     _mm256_set1_ps(m[12]), _mm256_set1_ps(m[13]), _mm256_set1_ps(m[14]) };
+}
+
+static LOCUS_TARGET_AVX void MultVerticesAVX(const AVXMatrix& m, __m256& x, __m256& y, __m256& z)
+{
+   __m256 resultX = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m.m0, x), _mm256_mul_ps(m.m4, y)), _mm256_mul_ps(m.m8, z)), m.m12);
+   __m256 resultY = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m.m1, x), _mm256_mul_ps(m.m5, y)), _mm256_mul_ps(m.m9, z)), m.m13);
+   __m256 resultZ = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m.m2, x), _mm256_mul_ps(m.m6, y)), _mm256_mul_ps(m.m10, z)), m.m14);
+
+   x = resultX;
+   y = resultY;
+   z = resultZ;
+}
+
+//AVX shuffles don't cross the two 128 bit lanes, so eight interleaved vertices
+//are loaded with vertices 0 to 3 in the low lanes and vertices 4 to 7 in the
+//high lanes. The SSE2 shuffles then apply to each lane unchanged
+static LOCUS_TARGET_AVX __m256 LoadLanesAVX(const float* low, const float* high)
+{
+   return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+}
+
+static LOCUS_TARGET_AVX void StoreLanesAVX(float* low, float* high, __m256 value)
+{
+   _mm_storeu_ps(low, _mm256_castps256_ps128(value));
+   _mm_storeu_ps(high, _mm256_extractf128_ps(value, 1));
+}
+
+static LOCUS_TARGET_AVX void LoadVerticesAVX(const float* vertices, __m256& x, __m256& y, __m256& z)
+{
+   __m256 a = LoadLanesAVX(vertices,     vertices + 12);
+   __m256 b = LoadLanesAVX(vertices + 4, vertices + 16);
+   __m256 c = LoadLanesAVX(vertices + 8, vertices + 20);
+
+   __m256 x2y2x3y3 = _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+   __m256 y0z0y1z1 = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+
+   x = _mm256_shuffle_ps(a, x2y2x3y3, _MM_SHUFFLE(2, 0, 3, 0));
+   y = _mm256_shuffle_ps(y0z0y1z1, x2y2x3y3, _MM_SHUFFLE(3, 1, 2, 0));
+   z = _mm256_shuffle_ps(y0z0y1z1, c, _MM_SHUFFLE(3, 0, 3, 1));
+}
+
+static LOCUS_TARGET_AVX void StoreVerticesAVX(float* vertices, __m256 x, __m256 y, __m256 z)
+{
+   __m256 x0y0x1y1 = _mm256_unpacklo_ps(x, y);
+   __m256 x2y2x3y3 = _mm256_unpackhi_ps(x, y);
+
+   __m256 a = _mm256_shuffle_ps(x0y0x1y1, _mm256_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0));
+   __m256 b = _mm256_shuffle_ps(_mm256_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), x2y2x3y3, _MM_SHUFFLE(1, 0, 2, 0));
+   __m256 c = _mm256_shuffle_ps(_mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+
+   StoreLanesAVX(vertices,     vertices + 12, a);
+   StoreLanesAVX(vertices + 4, vertices + 16, b);
+   StoreLanesAVX(vertices + 8, vertices + 20, c);
+}
+
+static LOCUS_TARGET_AVX void MultVerticesAVX(const float* m, const float* vertices, std::size_t numVertices, float* result)
+{
+   AVXMatrix broadcastMatrix = BroadcastAVX(m);
+
+   std::size_t numVectorized = numVertices - (numVertices % 8);
+
+   for (std::size_t i = 0; i < numVectorized; i += 8)
+   {
+      __m256 x, y, z;
+      LoadVerticesAVX(vertices + 3 * i, x, y, z);
+
+      MultVerticesAVX(broadcastMatrix, x, y, z);
+
+      StoreVerticesAVX(result + 3 * i, x, y, z);
+   }
+
+   MultVerticesScalar(m, vertices + 3 * numVectorized, numVertices - numVectorized, result + 3 * numVectorized);
+}
+
+static LOCUS_TARGET_AVX void MultVerticesAVX(const float* m, const float* vertices, std::size_t numVertices, float* resultXs, float* resultYs, float* resultZs)
+{
+   AVXMatrix broadcastMatrix = BroadcastAVX(m);
+
+   std::size_t numVectorized = numVertices - (numVertices % 8);
+
+   for (std::size_t i = 0; i < numVectorized; i += 8)
+   {
+      __m256 x, y, z;
+      LoadVerticesAVX(vertices + 3 * i, x, y, z);
+
+      MultVerticesAVX(broadcastMatrix, x, y, z);
+
+      _mm256_storeu_ps(resultXs + i, x);
+      _mm256_storeu_ps(resultYs + i, y);
+      _mm256_storeu_ps(resultZs + i, z);
+   }
+
+   MultVerticesScalar(m, vertices + 3 * numVectorized, numVertices - numVectorized, resultXs + numVectorized, resultYs + numVectorized, resultZs + numVectorized);
+}
+
+static LOCUS_TARGET_AVX void MultVerticesAVX(const float* m, const float* xs, const float* ys, const float* zs, std::size_t numVertices, float* resultXs, float* resultYs, float* resultZs)
+{
+   AVXMatrix broadcastMatrix = BroadcastAVX(m);
+
+   std::size_t numVectorized = numVertices - (numVertices % 8);
+
+   for (std::size_t i = 0; i < numVectorized; i += 8)
+   {
+      __m256 x = _mm256_loadu_ps(xs + i);
+      __m256 y = _mm256_loadu_ps(ys + i);
+      __m256 z = _mm256_loadu_ps(zs + i);
+
+      MultVerticesAVX(broadcastMatrix, x, y, z);
+
+      _mm256_storeu_ps(resultXs + i, x);
+      _mm256_storeu_ps(resultYs + i, y);
+      _mm256_storeu_ps(resultZs + i, z);
+   }
+
+   MultVerticesScalar(m, xs + numVectorized, ys + numVectorized, zs + numVectorized, numVertices - numVectorized, resultXs + numVectorized, resultYs + numVectorized, resultZs + numVectorized);
+}
+
+#endif //LOCUS_X86
+
+/////////////////////////////////////////Dispatch/////////////////////////////////////////
+
+struct BatchTransformKernels
+{
+   void (*interleavedToInterleaved)(const float*, const float*, std::size_t, float*);
+   void (*interleavedToSeparate)(const float*, const float*, std::size_t, float*, float*, float*);
+   void (*separateToSeparate)(const float*, const float*, const float*, const float*, std::size_t, float*, float*, float*);
+};
+
+static const BatchTransformKernels Batch_Transform_Kernels[] =
+{
+   { MultVerticesScalar, MultVerticesScalar, MultVerticesScalar },
+
+#ifdef LOCUS_X86
+   { MultVerticesSSE2, MultVerticesSSE2, MultVerticesSSE2 },
+   { MultVerticesAVX, MultVerticesAVX, MultVerticesAVX }
+#endif
+};
+
+static const BatchTransformKernels& GetKernels()
+{
+   return SelectKernelSet(Batch_Transform_Kernels);
+}
+
+InstructionSet ActiveInstructionSet()
+{
+   return DetectInstructionSet();
+}
+
+void MultVertices(const float* columnMajorElements, const float* vertices, std::size_t numVertices, float* result)
+{
+   GetKernels().interleavedToInterleaved(columnMajorElements, vertices, numVertices, result);
+}
+
+void MultVertices(const float* columnMajorElements, const float* vertices, std::size_t numVertices, float* resultXs, float* resultYs, float* resultZs)
+{
+   GetKernels().interleavedToSeparate(columnMajorElements, vertices, numVertices, resultXs, resultYs, resultZs);
+}
+
+void MultVertices(const float* columnMajorElements, const float* xs, const float* ys, const float* zs, std::size_t numVertices, float* resultXs, float* resultYs, float* resultZs)
+{
+   GetKernels().separateToSeparate(columnMajorElements, xs, ys, zs, numVertices, resultXs, resultYs, resultZs);
+}
+
+}
+
+}
\ No newline at end of file
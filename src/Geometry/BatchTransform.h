@@ -0,0 +1,51 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "InstructionSet.h"
+
+#include <cstddef>
+
+namespace Locus
+{
+
+/*!
+ * \brief Kernels for transforming many vertices by one 4 x 4
+ * transformation.
+ *
+ * \details The transformation is given as its sixteen column
+ * major elements, and only its upper three rows are used. Each
+ * call picks an AVX, SSE2, or scalar implementation based on
+ * DetectInstructionSet. All paths evaluate the same expression
+ * in the same order as Transformation::MultVertex, so they
+ * produce identical results.
+ *
+ * The result arrays may be the same as the input arrays but must
+ * not otherwise overlap them.
+ */
+namespace BatchTransform
+{
+
+/// \return the instruction set used by the kernels on this CPU.
+InstructionSet ActiveInstructionSet();
+
+/// Vertices are numVertices consecutive x, y, z triples.
+void MultVertices(const float* columnMajorElements, const float* vertices, std::size_t numVertices, float* result);
+
+/// Reads x, y, z triples and writes separate x, y, and z arrays.
+void MultVertices(const float* columnMajorElements, const float* vertices, std::size_t numVertices, float* resultXs, float* resultYs, float* resultZs);
+
+/// Reads and writes separate x, y, and z arrays.
+void MultVertices(const float* columnMajorElements, const float* xs, const float* ys, const float* zs, std::size_t numVertices, float* resultXs, float* resultYs, float* resultZs);
+
+}
+
+}
\ No newline at end of file
@@ -10,421 +10,729 @@
 
 #include "Locus/Geometry/BoundingVolumeHierarchy.h"
 
-#include <queue>
+#include "Locus/Common/ThreadPool.h"
+#include "Locus/Common/Util.h"
+#include "Locus/Common/Float.h"
+
+#include <limits>
+#include <algorithm>
 
 namespace Locus
 {
 
-static void EliminateOctants(const std::array<std::size_t, 4>& octantsToEliminate, std::array<bool, 8>& octants)
+/*!
+ * \brief Determines which side of the plane through center along
+ * a coordinate axis a triangle lies on, given the triangle's extent
+ * along that axis.
+ *
+ * \details Equivalent to calling Plane::triangleIntersectionTest
+ * with an axis-aligned plane, since the signed distance of a vertex
+ * to such a plane is just the difference of one coordinate.
+ */
+static Plane::IntersectionQuery GetSideOfAxisPlane(float triangleMin, float triangleMax, float center)
 {
-   for (std::size_t eliminatedOctant : octantsToEliminate)
+   bool anyOnPositiveSide = FGreater<float>(triangleMax - center, 0.0f);
+   bool anyOnNegativeSide = FLess<float>(triangleMin - center, 0.0f);
+
+   if (anyOnPositiveSide)
    {
-      octants[eliminatedOctant] = false;
+      return (anyOnNegativeSide ? Plane::IntersectionQuery::None : Plane::IntersectionQuery::Positive);
+   }
+   else
+   {
+      return (anyOnNegativeSide ? Plane::IntersectionQuery::Negative : Plane::IntersectionQuery::Intersects);
    }
 }
 
-static void DetermineOctants(Plane::IntersectionQuery intersectionQueryX, Plane::IntersectionQuery intersectionQueryY, Plane::IntersectionQuery intersectionQueryZ, std::array<bool, 8>& octants)
+/*!
+ * \return The octant a triangle is placed into.
+ *
+ * \details Octants 0-3 are on the positive side of the X
+ * plane, octants 2, 3, 6 and 7 are on the positive side of
+ * the Y plane and the even octants are on the positive side
+ * of the Z plane. A triangle goes to the first octant that
+ * it is not entirely outside of.
+ */
+static std::size_t GetOctant(Plane::IntersectionQuery intersectionQueryX, Plane::IntersectionQuery intersectionQueryY, Plane::IntersectionQuery intersectionQueryZ)
 {
-   static const std::array<std::size_t, 4> positiveXOctants = {0, 1, 2, 3};
-   static const std::array<std::size_t, 4> positiveYOctants = {2, 3, 6, 7};
-   static const std::array<std::size_t, 4> positiveZOctants = {0, 2, 4, 6};
-
-   static const std::array<std::size_t, 4> negativeXOctants = {4, 5, 6, 7};
-   static const std::array<std::size_t, 4> negativeYOctants = {0, 1, 4, 5};
-   static const std::array<std::size_t, 4> negativeZOctants = {1, 3, 5, 7};
+   std::size_t octant = 0;
 
-   std::fill(octants.begin(), octants.end(), true);
-
-   if (intersectionQueryX == Plane::IntersectionQuery::Positive)
-   {
-      EliminateOctants(negativeXOctants, octants);
-   }
-   else if (intersectionQueryX == Plane::IntersectionQuery::Negative)
+   if (intersectionQueryX == Plane::IntersectionQuery::Negative)
    {
-      EliminateOctants(positiveXOctants, octants);
+      octant += 4;
    }
 
    if (intersectionQueryY == Plane::IntersectionQuery::Positive)
    {
-      EliminateOctants(negativeYOctants, octants);
-   }
-   else if (intersectionQueryY == Plane::IntersectionQuery::Negative)
-   {
-      EliminateOctants(positiveYOctants, octants);
+      octant += 2;
    }
 
-   if (intersectionQueryZ == Plane::IntersectionQuery::Positive)
+   if (intersectionQueryZ == Plane::IntersectionQuery::Negative)
    {
-      EliminateOctants(negativeZOctants, octants);
-   }
-   else if (intersectionQueryZ == Plane::IntersectionQuery::Negative)
-   {
-      EliminateOctants(positiveZOctants, octants);
+      octant += 1;
    }
+
+   return octant;
+}
+
+static FVector3 GetCenterOfBoundingVolume(const Sphere& boundingVolume)
+{
+   return boundingVolume.center;
+}
+
+static FVector3 GetCenterOfBoundingVolume(const AxisAlignedBox& boundingVolume)
+{
+   return boundingVolume.Centroid();
+}
+
+static FVector3 GetCenterOfBoundingVolume(const OrientedBox& boundingVolume)
+{
+   return boundingVolume.centroid;
+}
+
+template <class BoundingVolume>
+static BoundingVolume InstantiateBoundingVolumeFromPoints(const std::vector<FVector3>& points)
+{
+   return BoundingVolume(points);
+}
+
+template <>
+AxisAlignedBox InstantiateBoundingVolumeFromPoints(const std::vector<FVector3>& points)
+{
+   return AxisAlignedBox(points, false);
+}
+
+static float GetSurfaceArea(const FVector3& min, const FVector3& max)
+{
+   FVector3 lengths = max - min;
+
+   return 2.0f * ((lengths.x * lengths.y) + (lengths.y * lengths.z) + (lengths.z * lengths.x));
 }
 
-static std::vector<FVector3> GetUniquePointsFromTriangles(const std::vector<Triangle3D_t>& triangles)
+static void ExpandBounds(const FVector3& min, const FVector3& max, FVector3& boundsMin, FVector3& boundsMax)
 {
+   boundsMin.Set(std::min(boundsMin.x, min.x), std::min(boundsMin.y, min.y), std::min(boundsMin.z, min.z));
+   boundsMax.Set(std::max(boundsMax.x, max.x), std::max(boundsMax.y, max.y), std::max(boundsMax.z, max.z));
+}
+
+template <class BoundingVolume>
+struct BoundingVolumeHierarchy<BoundingVolume>::Builder
+{
+   Builder(const std::vector<Triangle3D_t>& triangles, SplitMethod splitMethod, std::size_t leafTriangles, std::size_t maxDepth, ThreadPool* threadPool);
+
+   void BuildNode(std::size_t begin, std::size_t end, const BoundingVolume& boundingVolume, std::size_t currentDepth, std::vector<Node>& nodes);
+
+   /*!
+    * \brief Reorders triangleIndices in [begin, end) so that each child's
+    * triangles are contiguous.
+    *
+    * \return The number of children. Child i gets the range
+    * [childStarts[i], childStarts[i + 1]) and no child is empty.
+    */
+   std::size_t PartitionIntoOctants(std::size_t begin, std::size_t end, const FVector3& center, std::array<std::size_t, NUM_TREE_CHILDREN + 1>& childStarts);
+   std::size_t PartitionBySurfaceAreaHeuristic(std::size_t begin, std::size_t end, std::array<std::size_t, NUM_TREE_CHILDREN + 1>& childStarts);
+
+   BoundingVolume MakeBoundingVolume(std::size_t begin, std::size_t end) const;
+
+   SplitMethod splitMethod;
+   std::size_t leafTriangles;
+   std::size_t maxDepth;
+   ThreadPool* threadPool;
+
+   /// Sorted distinct vertices of all the triangles.
    std::vector<FVector3> uniquePoints;
 
+   /// Position of each triangle's vertices in uniquePoints.
+   std::vector<std::array<std::size_t, Triangle3D_t::NumPointsOnATriangle>> trianglePoints;
+
+   /// Axis-aligned extent of each triangle.
+   std::vector<FVector3> triangleMins;
+   std::vector<FVector3> triangleMaxes;
+
+   /// Triangle indices, partitioned in place so that every node owns a contiguous range.
+   std::vector<std::size_t> triangleIndices;
+
+   /// Same size as triangleIndices. Each node only uses the part under its own range.
+   std::vector<std::size_t> partitionScratch;
+};
+
+template <class BoundingVolume>
+BoundingVolumeHierarchy<BoundingVolume>::Builder::Builder(const std::vector<Triangle3D_t>& triangles, SplitMethod splitMethod, std::size_t leafTriangles, std::size_t maxDepth, ThreadPool* threadPool)
+   : splitMethod(splitMethod), leafTriangles(std::max<std::size_t>(leafTriangles, 1)), maxDepth(maxDepth), threadPool(threadPool)
+{
    std::size_t numTriangles = triangles.size();
 
-   if (numTriangles > 0)
+   uniquePoints.reserve(numTriangles * Triangle3D_t::NumPointsOnATriangle);
+
+   for (const Triangle3D_t& triangle : triangles)
+   {
+      uniquePoints.push_back(triangle[0]);
+      uniquePoints.push_back(triangle[1]);
+      uniquePoints.push_back(triangle[2]);
+   }
+
+   SortAndRemoveDuplicates(uniquePoints);
+
+   trianglePoints.resize(numTriangles);
+   triangleMins.resize(numTriangles);
+   triangleMaxes.resize(numTriangles);
+
+   for (std::size_t triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
    {
-      uniquePoints.reserve(numTriangles * Triangle3D_t::NumPointsOnATriangle);
+      const Triangle3D_t& triangle = triangles[triangleIndex];
 
-      for (const Triangle3D_t& triangle : triangles)
+      for (std::size_t pointIndex = 0; pointIndex < Triangle3D_t::NumPointsOnATriangle; ++pointIndex)
       {
-         uniquePoints.push_back(triangle[0]);
-         uniquePoints.push_back(triangle[1]);
-         uniquePoints.push_back(triangle[2]);
+         trianglePoints[triangleIndex][pointIndex] = std::lower_bound(uniquePoints.begin(), uniquePoints.end(), triangle[pointIndex]) - uniquePoints.begin();
       }
 
-      SortAndRemoveDuplicates(uniquePoints);
+      triangleMins[triangleIndex].Set(std::min({triangle[0].x, triangle[1].x, triangle[2].x}), std::min({triangle[0].y, triangle[1].y, triangle[2].y}), std::min({triangle[0].z, triangle[1].z, triangle[2].z}));
+      triangleMaxes[triangleIndex].Set(std::max({triangle[0].x, triangle[1].x, triangle[2].x}), std::max({triangle[0].y, triangle[1].y, triangle[2].y}), std::max({triangle[0].z, triangle[1].z, triangle[2].z}));
    }
 
-   return uniquePoints;
-}
+   triangleIndices.resize(numTriangles);
 
-static std::vector<FVector3> GetUniquePointsFromTriangles(const TriangleInputMap_t& triangles)
-{
-   std::vector<Triangle3D_t> trianglesAsVector;
-   trianglesAsVector.reserve(triangles.size());
-
-   for (const TriangleInputMap_t::value_type& triangle : triangles)
+   for (std::size_t triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
    {
-      trianglesAsVector.push_back(triangle.second);
+      triangleIndices[triangleIndex] = triangleIndex;
    }
 
-   return GetUniquePointsFromTriangles(trianglesAsVector);
+   partitionScratch.resize(numTriangles);
 }
 
-static TriangleInputMap_t MakeTriangleInputMap(const std::vector<Triangle3D_t>& triangles)
+template <class BoundingVolume>
+BoundingVolume BoundingVolumeHierarchy<BoundingVolume>::Builder::MakeBoundingVolume(std::size_t begin, std::size_t end) const
 {
-   TriangleInputMap_t triangleInputMap;
+   //sorting positions in uniquePoints gives the same sorted and deduplicated
+   //points as sorting the points themselves, without comparing any vectors
+   std::vector<std::size_t> pointIndices;
+   pointIndices.reserve((end - begin) * Triangle3D_t::NumPointsOnATriangle);
 
-   std::size_t triangleIndex = 0;
-   for (const Triangle3D_t& singleTriangle : triangles)
+   for (std::size_t index = begin; index < end; ++index)
    {
-      triangleInputMap.emplace(triangleIndex, singleTriangle);
-      ++triangleIndex;
+      const std::array<std::size_t, Triangle3D_t::NumPointsOnATriangle>& points = trianglePoints[triangleIndices[index]];
+
+      pointIndices.insert(pointIndices.end(), points.begin(), points.end());
    }
 
-   return triangleInputMap;
-}
+   SortAndRemoveDuplicates(pointIndices);
 
-static FVector3 GetCenterOfBoundingVolume(const Sphere& boundingVolume)
-{
-   return boundingVolume.center;
-}
+   std::vector<FVector3> points;
+   points.reserve(pointIndices.size());
 
-static FVector3 GetCenterOfBoundingVolume(const AxisAlignedBox& boundingVolume)
-{
-   return boundingVolume.Centroid();
-}
+   for (std::size_t pointIndex : pointIndices)
+   {
+      points.push_back(uniquePoints[pointIndex]);
+   }
 
-static FVector3 GetCenterOfBoundingVolume(const OrientedBox& boundingVolume)
-{
-   return boundingVolume.centroid;
+   return InstantiateBoundingVolumeFromPoints<BoundingVolume>(points);
 }
 
 template <class BoundingVolume>
-static BoundingVolume InstantiateBoundingVolumeFromPoints(const std::vector<FVector3>& points)
+std::size_t BoundingVolumeHierarchy<BoundingVolume>::Builder::PartitionIntoOctants(std::size_t begin, std::size_t end, const FVector3& center, std::array<std::size_t, NUM_TREE_CHILDREN + 1>& childStarts)
 {
-   return BoundingVolume(points);
-}
+   auto getOctant = [this, &center](std::size_t triangleIndex)->std::size_t
+   {
+      const FVector3& triangleMin = triangleMins[triangleIndex];
+      const FVector3& triangleMax = triangleMaxes[triangleIndex];
 
-template <>
-AxisAlignedBox InstantiateBoundingVolumeFromPoints(const std::vector<FVector3>& points)
-{
-   return AxisAlignedBox(points, false);
+      return GetOctant(GetSideOfAxisPlane(triangleMin.x, triangleMax.x, center.x),
+                       GetSideOfAxisPlane(triangleMin.y, triangleMax.y, center.y),
+                       GetSideOfAxisPlane(triangleMin.z, triangleMax.z, center.z));
+   };
+
+   //counting sort of this node's range by octant. Every triangle falls into exactly one octant,
+   //so the ranges of the children are adjacent and together form the range of this node
+   std::array<std::size_t, NUM_TREE_CHILDREN + 1> octantStarts = {};
+
+   for (std::size_t index = begin; index < end; ++index)
+   {
+      ++octantStarts[getOctant(triangleIndices[index]) + 1];
+   }
+
+   octantStarts[0] = begin;
+
+   for (std::size_t childIndex = 0; childIndex < NUM_TREE_CHILDREN; ++childIndex)
+   {
+      octantStarts[childIndex + 1] += octantStarts[childIndex];
+   }
+
+   std::array<std::size_t, NUM_TREE_CHILDREN> octantPositions;
+   std::copy(octantStarts.begin(), octantStarts.begin() + NUM_TREE_CHILDREN, octantPositions.begin());
+
+   for (std::size_t index = begin; index < end; ++index)
+   {
+      std::size_t triangleIndex = triangleIndices[index];
+
+      partitionScratch[octantPositions[getOctant(triangleIndex)]++] = triangleIndex;
+   }
+
+   std::copy(partitionScratch.begin() + begin, partitionScratch.begin() + end, triangleIndices.begin() + begin);
+
+   std::size_t numChildren = 0;
+
+   for (std::size_t childIndex = 0; childIndex < NUM_TREE_CHILDREN; ++childIndex)
+   {
+      if (octantStarts[childIndex] != octantStarts[childIndex + 1])
+      {
+         childStarts[numChildren++] = octantStarts[childIndex];
+      }
+   }
+
+   childStarts[numChildren] = end;
+
+   return numChildren;
 }
 
-//{CodeReview:NarrowPhaseCollisions}
 template <class BoundingVolume>
-BoundingVolumeHierarchy<BoundingVolume>::Node::Node(const TriangleInputMap_t& triangles, const BoundingVolume& boundingVolume, std::size_t leafTriangles, std::size_t currentDepth, std::size_t maxDepth)
-   : boundingVolume(boundingVolume)
+std::size_t BoundingVolumeHierarchy<BoundingVolume>::Builder::PartitionBySurfaceAreaHeuristic(std::size_t begin, std::size_t end, std::array<std::size_t, NUM_TREE_CHILDREN + 1>& childStarts)
 {
-   isLeaf = true;
+   //triangles are binned by the centroid of their axis-aligned extent
+   auto getCentroid = [this](std::size_t triangleIndex)->FVector3
+   {
+      return (triangleMins[triangleIndex] + triangleMaxes[triangleIndex]) / 2.0f;
+   };
+
+   float maxFloat = std::numeric_limits<float>::max();
 
-   std::size_t numContainedTriangles = triangles.size();
+   FVector3 centroidMin(maxFloat, maxFloat, maxFloat);
+   FVector3 centroidMax(-maxFloat, -maxFloat, -maxFloat);
 
-   if (numContainedTriangles > 0)
+   for (std::size_t index = begin; index < end; ++index)
    {
-      containedTriangles.reserve(numContainedTriangles);
-      for (const TriangleInputMap_t::value_type& containedTriangle : triangles)
+      FVector3 centroid = getCentroid(triangleIndices[index]);
+
+      ExpandBounds(centroid, centroid, centroidMin, centroidMax);
+   }
+
+   struct Bin
+   {
+      std::size_t numTriangles;
+      FVector3 min;
+      FVector3 max;
+   };
+
+   const Bin emptyBin = { 0, FVector3(maxFloat, maxFloat, maxFloat), FVector3(-maxFloat, -maxFloat, -maxFloat) };
+
+   float bestCost = maxFloat;
+   unsigned int bestAxis = 0;
+   std::size_t bestSplitBin = 0;
+
+   auto getBin = [&](std::size_t triangleIndex, unsigned int axis)->std::size_t
+   {
+      float binScale = Num_Surface_Area_Heuristic_Bins / (centroidMax[axis] - centroidMin[axis]);
+
+      std::size_t bin = static_cast<std::size_t>((getCentroid(triangleIndex)[axis] - centroidMin[axis]) * binScale);
+
+      return std::min(bin, Num_Surface_Area_Heuristic_Bins - 1);
+   };
+
+   for (unsigned int axis = 0; axis < 3; ++axis)
+   {
+      if (!(centroidMax[axis] > centroidMin[axis]))
       {
-         containedTriangles.push_back(containedTriangle.first);
+         continue;
       }
 
-      if ((numContainedTriangles > leafTriangles) && (currentDepth < maxDepth))
+      std::array<Bin, Num_Surface_Area_Heuristic_Bins> bins;
+      bins.fill(emptyBin);
+
+      for (std::size_t index = begin; index < end; ++index)
       {
-         isLeaf = false;
+         std::size_t triangleIndex = triangleIndices[index];
 
-         std::array<TriangleInputMap_t, 8> trianglesInOctants;
+         Bin& bin = bins[getBin(triangleIndex, axis)];
 
-         const FVector3 center = GetCenterOfBoundingVolume(boundingVolume);
+         ++bin.numTriangles;
+         ExpandBounds(triangleMins[triangleIndex], triangleMaxes[triangleIndex], bin.min, bin.max);
+      }
 
-         const std::array<Plane, 3> splitPlanes = { Plane(center, Vec3D::XAxis()), Plane(center, Vec3D::YAxis()), Plane(center, Vec3D::ZAxis()) };
-         std::array<Plane::IntersectionQuery, 3> intersectionQueries;
+      //costsAbove[i] is the cost of everything in the bins after bin i
+      std::array<float, Num_Surface_Area_Heuristic_Bins> costsAbove;
 
-         std::array<bool, NUM_TREE_CHILDREN> inOctants;
-         std::fill(inOctants.begin(), inOctants.end(), true);
+      Bin accumulated = emptyBin;
 
-         for (const std::unordered_map<std::size_t, Triangle3D_t>::value_type& containedTriangle : triangles)
-         {
-            for (unsigned int coordinate = 0; coordinate < 3; ++coordinate)
-            {
-               intersectionQueries[coordinate] = splitPlanes[coordinate].triangleIntersectionTest(containedTriangle.second);
-            }
+      for (std::size_t binIndex = Num_Surface_Area_Heuristic_Bins - 1; binIndex > 0; --binIndex)
+      {
+         accumulated.numTriangles += bins[binIndex].numTriangles;
+         ExpandBounds(bins[binIndex].min, bins[binIndex].max, accumulated.min, accumulated.max);
 
-            DetermineOctants(intersectionQueries[0], intersectionQueries[1], intersectionQueries[2], inOctants);
+         costsAbove[binIndex - 1] = (accumulated.numTriangles > 0) ? (accumulated.numTriangles * GetSurfaceArea(accumulated.min, accumulated.max)) : maxFloat;
+      }
 
-            for (std::size_t childIndex = 0; childIndex < NUM_TREE_CHILDREN; ++childIndex)
-            {
-               if (inOctants[childIndex])
-               {
-                  trianglesInOctants[childIndex][containedTriangle.first] = containedTriangle.second;
-                  break;
-               }
-            }
-         }
+      accumulated = emptyBin;
+
+      for (std::size_t binIndex = 0; binIndex < (Num_Surface_Area_Heuristic_Bins - 1); ++binIndex)
+      {
+         accumulated.numTriangles += bins[binIndex].numTriangles;
+         ExpandBounds(bins[binIndex].min, bins[binIndex].max, accumulated.min, accumulated.max);
 
-         for (std::size_t childIndex = 0; childIndex < NUM_TREE_CHILDREN; ++childIndex)
+         if ((accumulated.numTriangles > 0) && (costsAbove[binIndex] < maxFloat))
          {
-            if (!trianglesInOctants[childIndex].empty())
+            float cost = (accumulated.numTriangles * GetSurfaceArea(accumulated.min, accumulated.max)) + costsAbove[binIndex];
+
+            if (cost < bestCost)
             {
-               children[childIndex] = std::make_unique<Node>(trianglesInOctants[childIndex], InstantiateBoundingVolumeFromPoints<BoundingVolume>(GetUniquePointsFromTriangles(trianglesInOctants[childIndex])), leafTriangles, currentDepth + 1, maxDepth);
+               bestCost = cost;
+               bestAxis = axis;
+               bestSplitBin = binIndex;
             }
          }
-      }  
+      }
    }
+
+   std::size_t middle;
+
+   if (bestCost < maxFloat)
+   {
+      middle = std::partition(triangleIndices.begin() + begin, triangleIndices.begin() + end, [&](std::size_t triangleIndex)->bool
+      {
+         return (getBin(triangleIndex, bestAxis) <= bestSplitBin);
+      }) - triangleIndices.begin();
+   }
+   else
+   {
+      //all centroids coincide, so every split is as good as any other
+      middle = begin + (end - begin) / 2;
+   }
+
+   childStarts[0] = begin;
+   childStarts[1] = middle;
+   childStarts[2] = end;
+
+   return 2;
 }
 
+//{CodeReview:NarrowPhaseCollisions}
 template <class BoundingVolume>
-BoundingVolumeHierarchy<BoundingVolume>::Node::Node(const typename BoundingVolumeHierarchy<BoundingVolume>::Node& otherNode)
-      : boundingVolume(otherNode.boundingVolume), isLeaf(otherNode.isLeaf), containedTriangles(otherNode.containedTriangles)
+void BoundingVolumeHierarchy<BoundingVolume>::Builder::BuildNode(std::size_t begin, std::size_t end, const BoundingVolume& boundingVolume, std::size_t currentDepth, std::vector<Node>& nodes)
 {
-   for (std::size_t octantIndex = 0; octantIndex < NUM_TREE_CHILDREN; ++octantIndex)
+   //nodes may reallocate while the children are built, so this node is only referred to by index
+   std::size_t nodeIndex = nodes.size();
+
+   nodes.push_back( Node{boundingVolume, true, 1, begin, end - begin} );
+
+   if (((end - begin) > leafTriangles) && (currentDepth < maxDepth))
    {
-      if (otherNode.children[octantIndex] != nullptr)
+      nodes[nodeIndex].isLeaf = false;
+
+      std::array<std::size_t, NUM_TREE_CHILDREN + 1> childStarts;
+      std::size_t numChildren;
+
+      if (splitMethod == SplitMethod::Octants)
+      {
+         numChildren = PartitionIntoOctants(begin, end, GetCenterOfBoundingVolume(boundingVolume), childStarts);
+      }
+      else
       {
-         children[octantIndex] = std::make_unique<Node>(*otherNode.children[octantIndex]);
+         numChildren = PartitionBySurfaceAreaHeuristic(begin, end, childStarts);
+      }
+
+      if ((threadPool != nullptr) && (numChildren > 1) && ((end - begin) >= Parallel_Build_Min_Triangles))
+      {
+         //children own disjoint ranges of triangleIndices and partitionScratch, so they can be
+         //built concurrently into separate node arrays which are then appended in order
+         std::array<std::vector<Node>, NUM_TREE_CHILDREN> childNodes;
+
+         threadPool->ParallelFor(numChildren, 1, [this, &childStarts, &childNodes, currentDepth](std::size_t rangeBegin, std::size_t rangeEnd)
+         {
+            for (std::size_t childIndex = rangeBegin; childIndex < rangeEnd; ++childIndex)
+            {
+               std::size_t childBegin = childStarts[childIndex];
+               std::size_t childEnd = childStarts[childIndex + 1];
+
+               BuildNode(childBegin, childEnd, MakeBoundingVolume(childBegin, childEnd), currentDepth + 1, childNodes[childIndex]);
+            }
+         });
+
+         for (std::size_t childIndex = 0; childIndex < numChildren; ++childIndex)
+         {
+            nodes.insert(nodes.end(), childNodes[childIndex].begin(), childNodes[childIndex].end());
+         }
+      }
+      else
+      {
+         for (std::size_t childIndex = 0; childIndex < numChildren; ++childIndex)
+         {
+            std::size_t childBegin = childStarts[childIndex];
+            std::size_t childEnd = childStarts[childIndex + 1];
+
+            BuildNode(childBegin, childEnd, MakeBoundingVolume(childBegin, childEnd), currentDepth + 1, nodes);
+         }
       }
    }
+
+   nodes[nodeIndex].subtreeSize = nodes.size() - nodeIndex;
 }
 
 template <class BoundingVolume>
-BoundingVolumeHierarchy<BoundingVolume>::BoundingVolumeHierarchy(const std::vector<Triangle3D_t>& triangles, std::size_t leafTriangles, std::size_t maxDepth)
+BoundingVolumeHierarchy<BoundingVolume>::BoundingVolumeHierarchy(const std::vector<Triangle3D_t>& triangles, std::size_t leafTriangles, std::size_t maxDepth, ThreadPool* threadPool)
 {
-   ConstructFromTriangles(triangles, leafTriangles, maxDepth);
+   ConstructFromTriangles(triangles, SplitMethod::Octants, leafTriangles, maxDepth, threadPool);
 }
 
 template <class BoundingVolume>
-BoundingVolumeHierarchy<BoundingVolume>::BoundingVolumeHierarchy(const BoundingVolumeHierarchy<BoundingVolume>& otherBoundingVolumeHierarchy)
-   : root( std::make_unique<Node>(*otherBoundingVolumeHierarchy.root) )
+BoundingVolumeHierarchy<BoundingVolume>::BoundingVolumeHierarchy(const std::vector<Triangle3D_t>& triangles, SplitMethod splitMethod, std::size_t leafTriangles, std::size_t maxDepth, ThreadPool* threadPool)
 {
+   ConstructFromTriangles(triangles, splitMethod, leafTriangles, maxDepth, threadPool);
 }
 
 template <class BoundingVolume>
-void BoundingVolumeHierarchy<BoundingVolume>::ConstructFromTriangles(const std::vector<Triangle3D_t>& triangles, std::size_t leafTriangles, std::size_t maxDepth)
+void BoundingVolumeHierarchy<BoundingVolume>::ConstructFromTriangles(const std::vector<Triangle3D_t>& triangles, SplitMethod splitMethod, std::size_t leafTriangles, std::size_t maxDepth, ThreadPool* threadPool)
 {
-   TriangleInputMap_t triangleInputMap = MakeTriangleInputMap(triangles);
-   std::vector<FVector3> rootPoints = GetUniquePointsFromTriangles(triangles);
+   Builder builder(triangles, splitMethod, leafTriangles, maxDepth, threadPool);
+
+   nodes.clear();
 
-   root = std::make_unique<Node>(triangleInputMap, InstantiateBoundingVolumeFromPoints<BoundingVolume>(rootPoints), leafTriangles, 0, maxDepth);
+   builder.BuildNode(0, triangles.size(), InstantiateBoundingVolumeFromPoints<BoundingVolume>(builder.uniquePoints), 0, nodes);
+
+   nodes.shrink_to_fit();
+
+   triangleIndices = std::move(builder.triangleIndices);
 }
 
 template <class BoundingVolume>
-void BoundingVolumeHierarchy<BoundingVolume>::FinalizeIntersection(const Moveable& thisMoveable, const Moveable& otherMoveable, const std::vector<Node*>& thisRemainingNodes, const std::vector<Node*>& otherCheckList, std::unordered_set<std::size_t>& thisIntersectionSet)
+typename BoundingVolumeHierarchy<BoundingVolume>::Statistics BoundingVolumeHierarchy<BoundingVolume>::GetStatistics() const
 {
-   std::queue<Node*> remainingNodes;
-   for (Node* node : thisRemainingNodes)
-   {
-      remainingNodes.push(node);
-   }
+   Statistics statistics = {};
+
+   statistics.numNodes = nodes.size();
 
-   do
+   std::size_t numLeafTriangles = 0;
+
+   //ends of the subtrees enclosing the current node. Its size is the depth of the node
+   std::vector<std::size_t> enclosingSubtreeEnds;
+
+   for (std::size_t nodeIndex = 0, numNodes = nodes.size(); nodeIndex < numNodes; ++nodeIndex)
    {
-      Node* checkNode = remainingNodes.front();
-      remainingNodes.pop();
+      const Node& node = nodes[nodeIndex];
 
-      if (checkNode->isLeaf)
+      while (!enclosingSubtreeEnds.empty() && (enclosingSubtreeEnds.back() <= nodeIndex))
       {
-         for (std::size_t containedTriangle : checkNode->containedTriangles)
-         {
-            thisIntersectionSet.insert(containedTriangle);
-         }
+         enclosingSubtreeEnds.pop_back();
       }
-      else
+
+      statistics.maxDepth = std::max(statistics.maxDepth, enclosingSubtreeEnds.size());
+
+      float surfaceArea = node.boundingVolume.SurfaceArea();
+
+      if (node.isLeaf)
       {
-         for (const Node* node : otherCheckList)
-         {
-            if (checkNode->boundingVolume.Intersects(thisMoveable, node->boundingVolume, otherMoveable))
-            {
-               for (std::unique_ptr<Node>& child : checkNode->children)
-               {
-                  if (child != nullptr)
-                  {
-                     remainingNodes.push(child.get());
-                  }
-               }
+         ++statistics.numLeaves;
+         numLeafTriangles += node.numTriangles;
 
-               break;
-            }
-         }
+         statistics.surfaceAreaHeuristicCost += surfaceArea * node.numTriangles;
+      }
+      else
+      {
+         statistics.surfaceAreaHeuristicCost += surfaceArea;
       }
-   } while (!remainingNodes.empty());
+
+      enclosingSubtreeEnds.push_back(nodeIndex + node.subtreeSize);
+   }
+
+   statistics.averageLeafTriangles = static_cast<float>(numLeafTriangles) / statistics.numLeaves;
+
+   return statistics;
+}
+
+template <class BoundingVolume>
+void BoundingVolumeHierarchy<BoundingVolume>::InsertContainedTriangles(const Node& node, std::unordered_set<std::size_t>& intersectionSet) const
+{
+   intersectionSet.insert(triangleIndices.begin() + node.firstTriangle, triangleIndices.begin() + node.firstTriangle + node.numTriangles);
 }
 
+//{CodeReview:NarrowPhaseCollisions}
 template <class BoundingVolume>
-void BoundingVolumeHierarchy<BoundingVolume>::GatherIntersectionsFromCheckList(const Node* node, const std::vector<Node*>& checkList, const Moveable& moveable, const Moveable& checkMoveable, std::vector<Node*>& hitList, std::unordered_set<std::size_t>& intersectionSet)
+void BoundingVolumeHierarchy<BoundingVolume>::GetIntersection(const Moveable& thisMoveable, const BoundingVolumeHierarchy<BoundingVolume>& otherBoundingVolumeHierarchy, const Moveable& otherMoveable, std::unordered_set<std::size_t>& thisIntersectionSet, std::unordered_set<std::size_t>& otherIntersectionSet) const
 {
-   for (const std::unique_ptr<Node>& child : node->children)
+   auto insertLeafTriangles = [this, &otherBoundingVolumeHierarchy, &thisIntersectionSet, &otherIntersectionSet](const Node& thisLeaf, const Node& otherLeaf)->bool
    {
-      if (child != nullptr)
+      InsertContainedTriangles(thisLeaf, thisIntersectionSet);
+      otherBoundingVolumeHierarchy.InsertContainedTriangles(otherLeaf, otherIntersectionSet);
+
+      return false;
+   };
+
+   TraverseOverlappingLeaves(RelativeTransformation(thisMoveable, otherMoveable), otherBoundingVolumeHierarchy, 0, 0, insertLeafTriangles);
+}
+
+//{CodeReview:NarrowPhaseCollisions}
+template <class BoundingVolume>
+void BoundingVolumeHierarchy<BoundingVolume>::GetIntersection(const Moveable& thisMoveable, const OrientedBox& orientedBox, std::unordered_set<std::size_t>& thisIntersectionSet) const
+{
+   if (orientedBox.Intersects(nodes[0].boundingVolume, thisMoveable))
+   {
+      std::vector<std::size_t> thisCurrentCheckList(1, 0);
+      std::vector<std::size_t> thisHitList;
+
+      while (!thisCurrentCheckList.empty())
       {
-         for (const Node* otherNode : checkList)
+         thisHitList.clear();
+         thisHitList.reserve(thisCurrentCheckList.size() * NUM_TREE_CHILDREN);
+
+         for (std::size_t nodeIndex : thisCurrentCheckList)
          {
-            if (!otherNode->isLeaf)
+            const Node& node = nodes[nodeIndex];
+
+            if (node.isLeaf)
             {
-               if (child->boundingVolume.Intersects(moveable, otherNode->boundingVolume, checkMoveable))
+               InsertContainedTriangles(node, thisIntersectionSet);
+            }
+            else
+            {
+               for (std::size_t childIndex = nodeIndex + 1, endIndex = nodeIndex + node.subtreeSize; childIndex < endIndex; childIndex += nodes[childIndex].subtreeSize)
                {
-                  if (child->isLeaf)
+                  const Node& child = nodes[childIndex];
+
+                  if (orientedBox.Intersects(child.boundingVolume, thisMoveable))
                   {
-                     for (std::size_t containedTriangle : child->containedTriangles)
+                     if (child.isLeaf)
                      {
-                        intersectionSet.insert(containedTriangle);
+                        InsertContainedTriangles(child, thisIntersectionSet);
+                     }
+                     else
+                     {
+                        thisHitList.push_back(childIndex);
                      }
-                  }
-                  else
-                  {
-                     hitList.push_back(child.get());
                   }
                }
             }
          }
+
+         thisCurrentCheckList.swap(thisHitList);
       }
    }
 }
 
-//{CodeReview:NarrowPhaseCollisions}
 template <class BoundingVolume>
-void BoundingVolumeHierarchy<BoundingVolume>::GetIntersection(const Moveable& thisMoveable, const BoundingVolumeHierarchy<BoundingVolume>& otherBoundingVolumeHierarchy, const Moveable& otherMoveable, std::unordered_set<std::size_t>& thisIntersectionSet, std::unordered_set<std::size_t>& otherIntersectionSet) const
+template <class LeafPairFunction>
+bool BoundingVolumeHierarchy<BoundingVolume>::TraverseOverlappingLeaves(const RelativeTransformation& relativeTransformation, const BoundingVolumeHierarchy<BoundingVolume>& otherTree, std::size_t thisRootIndex, std::size_t otherRootIndex, LeafPairFunction& leafPairFunction) const
 {
-   if (root->boundingVolume.Intersects(thisMoveable, otherBoundingVolumeHierarchy.root->boundingVolume, otherMoveable))
+   //leafPairFunction is called for every pair of overlapping leaves. If it returns
+   //true then the traversal stops and true is returned
+   std::array<std::pair<std::size_t, std::size_t>, Traversal_Stack_Size> stack;
+   std::size_t stackSize = 0;
+
+   stack[stackSize++] = std::make_pair(thisRootIndex, otherRootIndex);
+
+   while (stackSize > 0)
    {
-      std::vector<Node*> thisCurrentCheckList(1, root.get());
-      std::vector<Node*> otherCurrentCheckList(1, otherBoundingVolumeHierarchy.root.get());
+      --stackSize;
 
-      std::vector<Node*> thisHitList;
-      std::vector<Node*> otherHitList;
+      std::size_t thisNodeIndex = stack[stackSize].first;
+      std::size_t otherNodeIndex = stack[stackSize].second;
 
-      while (!thisCurrentCheckList.empty() && !otherCurrentCheckList.empty())
-      {
-         thisHitList.clear();
-         thisHitList.reserve(thisCurrentCheckList.size() * NUM_TREE_CHILDREN);
+      const Node& thisNode = nodes[thisNodeIndex];
+      const Node& otherNode = otherTree.nodes[otherNodeIndex];
 
-         otherHitList.clear();
-         otherHitList.reserve(otherCurrentCheckList.size() * NUM_TREE_CHILDREN);
+      if (!thisNode.boundingVolume.Intersects(otherNode.boundingVolume, relativeTransformation))
+      {
+         continue;
+      }
 
-         for (const Node* node : thisCurrentCheckList)
+      if (thisNode.isLeaf && otherNode.isLeaf)
+      {
+         if (leafPairFunction(thisNode, otherNode))
          {
-            if (node->isLeaf)
-            {
-               for (std::size_t containedTriangle : node->containedTriangles)
-               {
-                  thisIntersectionSet.insert(containedTriangle);
-               }
-            }
-            else
-            {
-               GatherIntersectionsFromCheckList(node, otherCurrentCheckList, thisMoveable, otherMoveable, thisHitList, thisIntersectionSet);
-            }
+            return true;
          }
 
-         for (const Node* node : otherCurrentCheckList)
+         continue;
+      }
+
+      if (stackSize + NUM_TREE_CHILDREN > Traversal_Stack_Size)
+      {
+         //only reached with very deep trees. This pair is continued on a fresh stack
+         if (TraverseOverlappingLeaves(relativeTransformation, otherTree, thisNodeIndex, otherNodeIndex, leafPairFunction))
          {
-            if (node->isLeaf)
-            {
-               for (std::size_t containedTriangle : node->containedTriangles)
-               {
-                  otherIntersectionSet.insert(containedTriangle);
-               }
-            }
-            else
-            {
-               GatherIntersectionsFromCheckList(node, thisCurrentCheckList, otherMoveable, thisMoveable, otherHitList, otherIntersectionSet);
-            }
+            return true;
          }
 
-         if (thisHitList.empty() && !otherHitList.empty())
+         continue;
+      }
+
+      bool descendThis = !thisNode.isLeaf && (otherNode.isLeaf || (thisNode.boundingVolume.SurfaceArea() >= otherNode.boundingVolume.SurfaceArea()));
+
+      if (descendThis)
+      {
+         for (std::size_t childIndex = thisNodeIndex + 1, endIndex = thisNodeIndex + thisNode.subtreeSize; childIndex < endIndex; childIndex += nodes[childIndex].subtreeSize)
          {
-            FinalizeIntersection(otherMoveable, thisMoveable, otherHitList, thisCurrentCheckList, otherIntersectionSet);
-            break;
+            stack[stackSize++] = std::make_pair(childIndex, otherNodeIndex);
          }
-         else if (otherHitList.empty() && !thisHitList.empty())
+      }
+      else
+      {
+         for (std::size_t childIndex = otherNodeIndex + 1, endIndex = otherNodeIndex + otherNode.subtreeSize; childIndex < endIndex; childIndex += otherTree.nodes[childIndex].subtreeSize)
          {
-            FinalizeIntersection(thisMoveable, otherMoveable, thisHitList, otherCurrentCheckList, thisIntersectionSet);
-            break;
+            stack[stackSize++] = std::make_pair(thisNodeIndex, childIndex);
          }
-
-         thisCurrentCheckList = std::move(thisHitList);
-         otherCurrentCheckList = std::move(otherHitList);
       }
    }
+
+   return false;
 }
 
-//{CodeReview:NarrowPhaseCollisions}
 template <class BoundingVolume>
-void BoundingVolumeHierarchy<BoundingVolume>::GetIntersection(const Moveable& thisMoveable, const OrientedBox& orientedBox, std::unordered_set<std::size_t>& thisIntersectionSet) const
+void BoundingVolumeHierarchy<BoundingVolume>::GetCandidateTrianglePairs(const Moveable& thisMoveable, const BoundingVolumeHierarchy<BoundingVolume>& otherBoundingVolumeHierarchy, const Moveable& otherMoveable, std::vector<TrianglePair_t>& candidatePairs) const
 {
-   if (orientedBox.Intersects(root->boundingVolume, thisMoveable))
-   {
-      std::vector<Node*> thisCurrentCheckList(1, root.get());
+   candidatePairs.clear();
 
-      while (!thisCurrentCheckList.empty())
+   auto addLeafPairs = [this, &otherBoundingVolumeHierarchy, &candidatePairs](const Node& thisLeaf, const Node& otherLeaf)->bool
+   {
+      for (std::size_t thisIndex = thisLeaf.firstTriangle, thisEnd = thisLeaf.firstTriangle + thisLeaf.numTriangles; thisIndex < thisEnd; ++thisIndex)
       {
-         std::vector<Node*> thisHitList;
-         thisHitList.reserve(thisCurrentCheckList.size() * 8);
+         for (std::size_t otherIndex = otherLeaf.firstTriangle, otherEnd = otherLeaf.firstTriangle + otherLeaf.numTriangles; otherIndex < otherEnd; ++otherIndex)
+         {
+            candidatePairs.emplace_back(triangleIndices[thisIndex], otherBoundingVolumeHierarchy.triangleIndices[otherIndex]);
+         }
+      }
+
+      return false;
+   };
+
+   TraverseOverlappingLeaves(RelativeTransformation(thisMoveable, otherMoveable), otherBoundingVolumeHierarchy, 0, 0, addLeafPairs);
+}
+
+template <class BoundingVolume>
+bool BoundingVolumeHierarchy<BoundingVolume>::Intersects(const Moveable& thisMoveable, const BoundingVolumeHierarchy<BoundingVolume>& otherBoundingVolumeHierarchy, const Moveable& otherMoveable) const
+{
+   auto stopAtFirstLeafPair = [](const Node& /*thisLeaf*/, const Node& /*otherLeaf*/)->bool
+   {
+      return true;
+   };
+
+   return TraverseOverlappingLeaves(RelativeTransformation(thisMoveable, otherMoveable), otherBoundingVolumeHierarchy, 0, 0, stopAtFirstLeafPair);
+}
 
-         for (const Node* node : thisCurrentCheckList)
+template <class BoundingVolume>
+bool BoundingVolumeHierarchy<BoundingVolume>::Intersects(const Moveable& thisMoveable, const BoundingVolumeHierarchy<BoundingVolume>& otherBoundingVolumeHierarchy, const Moveable& otherMoveable, const std::function<bool(std::size_t, std::size_t)>& trianglePairIntersects, TrianglePair_t* intersectingPair) const
+{
+   auto testLeafPairs = [this, &otherBoundingVolumeHierarchy, &trianglePairIntersects, intersectingPair](const Node& thisLeaf, const Node& otherLeaf)->bool
+   {
+      for (std::size_t thisIndex = thisLeaf.firstTriangle, thisEnd = thisLeaf.firstTriangle + thisLeaf.numTriangles; thisIndex < thisEnd; ++thisIndex)
+      {
+         for (std::size_t otherIndex = otherLeaf.firstTriangle, otherEnd = otherLeaf.firstTriangle + otherLeaf.numTriangles; otherIndex < otherEnd; ++otherIndex)
          {
-            if (node->isLeaf)
+            std::size_t thisTriangle = triangleIndices[thisIndex];
+            std::size_t otherTriangle = otherBoundingVolumeHierarchy.triangleIndices[otherIndex];
+
+            if (trianglePairIntersects(thisTriangle, otherTriangle))
             {
-               for (std::size_t containedTriangle : node->containedTriangles)
+               if (intersectingPair != nullptr)
                {
-                  thisIntersectionSet.insert(containedTriangle);
-               }
-            }
-            else
-            {
-               for (const std::unique_ptr<Node>& child : node->children)
-               {
-                  if (child != nullptr)
-                  {
-                     if (orientedBox.Intersects(child->boundingVolume, thisMoveable))
-                     {
-                        if (child->isLeaf)
-                        {
-                           for (std::size_t containedTriangle : child->containedTriangles)
-                           {
-                              thisIntersectionSet.insert(containedTriangle);
-                           }
-                        }
-                        else
-                        {
-                           thisHitList.push_back(child.get());
-                        }
-                     }
-                  }
+                  *intersectingPair = TrianglePair_t(thisTriangle, otherTriangle);
                }
+
+               return true;
             }
          }
-
-         thisCurrentCheckList = std::move(thisHitList);
       }
-   }
+
+      return false;
+   };
+
+   return TraverseOverlappingLeaves(RelativeTransformation(thisMoveable, otherMoveable), otherBoundingVolumeHierarchy, 0, 0, testLeafPairs);
 }
 
 template class LOCUS_GEOMETRY_API_AT_DEFINITION BoundingVolumeHierarchy<Sphere>;
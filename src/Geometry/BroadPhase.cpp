@@ -0,0 +1,48 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "BroadPhase.h"
+
+namespace Locus
+{
+
+bool BroadCollisionExtents::Intersects(CollisionHandle_t handle1, CollisionHandle_t handle2) const
+{
+   for (std::size_t axis = 0; axis < Num_Axes; ++axis)
+   {
+      if ((mins[axis][handle1] > maxes[axis][handle2]) || (mins[axis][handle2] > maxes[axis][handle1]))
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+CollisionPair_t MakeCollisionPair(CollisionHandle_t handle1, CollisionHandle_t handle2)
+{
+   return ((handle1 < handle2) ? CollisionPair_t(handle1, handle2) : CollisionPair_t(handle2, handle1));
+}
+
+BroadPhase::BroadPhase(const BroadCollisionExtents& extents)
+   : extents(extents)
+{
+}
+
+BroadPhase::~BroadPhase()
+{
+}
+
+const std::vector<CollisionPair_t>& BroadPhase::GetCollisionPairs() const
+{
+   return collisionPairs;
+}
+
+}
\ No newline at end of file
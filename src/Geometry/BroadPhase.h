@@ -0,0 +1,91 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "Locus/Geometry/CollisionManager.h"
+
+#include <vector>
+#include <array>
+#include <utility>
+
+namespace Locus
+{
+
+/*!
+ * \brief The broad collision extents of all the Collidables
+ * in a CollisionManager, stored as a structure of arrays
+ * indexed by CollisionHandle_t.
+ *
+ * \details A null owner marks a handle that is free for reuse.
+ */
+struct BroadCollisionExtents
+{
+   static const std::size_t Num_Axes = 3;
+
+   std::vector<Collidable*> owners;
+   std::array<std::vector<float>, Num_Axes> mins;
+   std::array<std::vector<float>, Num_Axes> maxes;
+
+   /*!
+    * \return true if the extents of the given handles intersect.
+    * Touching extents are considered to be intersecting.
+    */
+   bool Intersects(CollisionHandle_t handle1, CollisionHandle_t handle2) const;
+};
+
+/// A pair of handles ordered so that the first handle is less than the second.
+typedef std::pair<CollisionHandle_t, CollisionHandle_t> CollisionPair_t;
+
+/// \return The handles ordered as a CollisionPair_t.
+CollisionPair_t MakeCollisionPair(CollisionHandle_t handle1, CollisionHandle_t handle2);
+
+/*!
+ * \brief Internal interface used by the CollisionManager for
+ * finding the pairs of intersecting broad collision extents.
+ *
+ * \details All implementations must find the same set of pairs
+ * given the same extents.
+ */
+class BroadPhase
+{
+public:
+   /// \param[in] extents Must outlive this object.
+   BroadPhase(const BroadCollisionExtents& extents);
+   virtual ~BroadPhase();
+
+   BroadPhase(const BroadPhase&) = delete;
+   BroadPhase& operator=(const BroadPhase&) = delete;
+
+   /*!
+    * \brief Recomputes the collision pairs from scratch.
+    * Called after handles have been added or removed.
+    */
+   virtual void Rebuild() = 0;
+
+   /*!
+    * \brief Brings the collision pairs up to date after
+    * the extents have changed.
+    *
+    * \note Handles must not have been added or removed
+    * since the last call to Rebuild.
+    */
+   virtual void UpdateCollisionPairs() = 0;
+
+   /// \return The pairs of handles whose extents intersect.
+   const std::vector<CollisionPair_t>& GetCollisionPairs() const;
+
+protected:
+   const BroadCollisionExtents& extents;
+
+   std::vector<CollisionPair_t> collisionPairs;
+};
+
+}
\ No newline at end of file
@@ -54,4 +54,8 @@ bool Collidable::CollidesWith(Collidable& /*collidable*/) const
    return true;
 }
 
+void Collidable::PrepareForNarrowPhase()
+{
+}
+
 }
\ No newline at end of file
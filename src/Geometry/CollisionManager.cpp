@@ -10,219 +10,197 @@
 
 #include "Locus/Geometry/CollisionManager.h"
 #include "Locus/Geometry/Collidable.h"
+#include "Locus/Geometry/Moveable.h"
 
-#include "Locus/Common/Float.h"
-#include "Locus/Common/Util.h"
+#include "Locus/Common/ThreadPool.h"
+
+#include "BroadPhase.h"
+#include "SweepAndPruneBroadPhase.h"
+#include "HashedGridBroadPhase.h"
 
 #include <vector>
-#include <unordered_set>
 #include <unordered_map>
-#include <forward_list>
-#include <algorithm>
-#include <list>
-#include <functional>
+#include <limits>
 
 #include <cassert>
 
 namespace Locus
 {
 
-struct CollisionInterval
+const CollisionHandle_t BAD_COLLISION_HANDLE = std::numeric_limits<CollisionHandle_t>::max();
+
+struct CollisionManager_Impl
 {
-   CollisionInterval()
-      : owner(nullptr), min(0.0), max(0.0)
+   CollisionManager_Impl(CollisionManager::BroadPhaseType broadPhaseType)
+      : broadPhaseType(broadPhaseType), gridCellSize(0.0f), doUpdateCollisionCollections(true), narrowPhaseThreadPool(nullptr)
    {
+      CreateBroadPhase();
    }
 
-   CollisionInterval(Collidable* owner, float min, float max)
-      : owner(owner), min(min), max(max)
-   {
-   }
+   BroadCollisionExtents extents;
 
-   bool Intersects(const CollisionInterval& other) const
-   {
-      return(! (FGreater<float>(min, other.max) || FLess<float>(max, other.min)) );
-   }
+   std::vector<CollisionHandle_t> freeHandles;
 
-   bool operator <(const CollisionInterval& other) const
-   {
-      return FLess<float>(min, other.min);
-   }
+   //only used to support the Collidable* overloads. The broad phase never touches it
+   std::unordered_map<Collidable*, CollisionHandle_t> collidableToHandle;
 
-   Collidable* owner;
-   float min;
-   float max;
-};
+   CollisionManager::BroadPhaseType broadPhaseType;
+   float gridCellSize;
+   std::unique_ptr<BroadPhase> broadPhase;
 
-struct CollisionIntervalComparator
-{
-   bool operator()(const CollisionInterval* interval1, const CollisionInterval* interval2) const
-   {
-      return *interval1 < *interval2;
-   }
-};
+   bool doUpdateCollisionCollections;
 
-struct CollisionManager_Impl
-{
-   CollisionManager_Impl()
-      : doUpdateCollisionCollections(true)
-   {
-   }
+   ThreadPool* narrowPhaseThreadPool;
 
-   std::unordered_set<Collidable*> collidables;
+   //the Moveable base of each owner, or null if it isn't a Moveable. Indexed by
+   //handle. The parallel narrow phase composes these before CollidesWith runs
+   std::vector<const Moveable*> moveables;
 
-   std::unordered_map<Collidable*, std::unique_ptr<CollisionInterval>> xIntervals;
-   std::unordered_map<Collidable*, std::unique_ptr<CollisionInterval>> yIntervals;
-   std::unordered_map<Collidable*, std::unique_ptr<CollisionInterval>> zIntervals;
+   //CollidesWith result for each collision pair. char is used rather
+   //than bool so that different elements can be written concurrently
+   std::vector<char> collidesWithResults;
 
-   std::vector<CollisionInterval*> xSortedIntervals;
-   std::vector<CollisionInterval*> ySortedIntervals;
-   std::vector<CollisionInterval*> zSortedIntervals;
+   void CreateBroadPhase();
 
-   std::unordered_map<Collidable*, std::size_t> collidableToIndex;
+   void SetExtent(CollisionHandle_t handle, Collidable* collidable);
 
-   //collisions tables
-   std::vector<std::vector<bool>> xCollisions;
-   std::vector<std::vector<bool>> yCollisions;
+   void PrepareForNarrowPhase(CollisionHandle_t handle);
+};
 
-   std::forward_list<std::pair<Collidable*, Collidable*>> collisionList;
+void CollisionManager_Impl::CreateBroadPhase()
+{
+   switch (broadPhaseType)
+   {
+   case CollisionManager::BroadPhaseType::SweepAndPrune:
+      broadPhase = std::make_unique<SweepAndPruneBroadPhase>(extents);
+      break;
 
-   bool doUpdateCollisionCollections;
+   case CollisionManager::BroadPhaseType::HashedGrid:
+      broadPhase = std::make_unique<HashedGridBroadPhase>(extents, gridCellSize);
+      break;
+   }
 
-   void UpdateCollisionCollections();
-   void UpdateCollisions(std::vector<CollisionInterval*>& sortedIntervals, const std::function<void(std::size_t, std::size_t, Collidable*, Collidable*)>& intervalIntersectionFunction);
-};
+   broadPhase->Rebuild();
+}
 
 CollisionManager::CollisionManager()
-   : impl(std::make_unique<CollisionManager_Impl>())
+   : impl(std::make_unique<CollisionManager_Impl>(BroadPhaseType::SweepAndPrune))
 {
 }
 
-CollisionManager::~CollisionManager()
+CollisionManager::CollisionManager(BroadPhaseType broadPhaseType)
+   : impl(std::make_unique<CollisionManager_Impl>(broadPhaseType))
 {
 }
 
-void CollisionManager::Add(Collidable* collidable)
+CollisionManager::~CollisionManager()
 {
-   bool inserted = impl->collidables.insert(collidable).second;
-
-   if (inserted)
-   {
-      const FVector3& broadCollisionExtentMin = collidable->GetBroadCollisionExtentMin();
-      const FVector3& broadCollisionExtentMax = collidable->GetBroadCollisionExtentMax();
-
-      impl->xIntervals[collidable] = std::make_unique<CollisionInterval>(collidable, broadCollisionExtentMin.x, broadCollisionExtentMax.x);
-      impl->yIntervals[collidable] = std::make_unique<CollisionInterval>(collidable, broadCollisionExtentMin.y, broadCollisionExtentMax.y);
-      impl->zIntervals[collidable] = std::make_unique<CollisionInterval>(collidable, broadCollisionExtentMin.z, broadCollisionExtentMax.z);
-
-      if (impl->doUpdateCollisionCollections)
-      {
-         impl->UpdateCollisionCollections();
-      }
-   }
 }
 
-void CollisionManager_Impl::UpdateCollisionCollections()
+CollisionHandle_t CollisionManager::Add(Collidable* collidable)
 {
-   std::size_t numCollidables = collidables.size();
-
-   collidableToIndex.clear();
+   auto insertResult = impl->collidableToHandle.emplace(collidable, BAD_COLLISION_HANDLE);
 
-   xSortedIntervals.clear();
-   xSortedIntervals.reserve(numCollidables);
+   if (!insertResult.second)
+   {
+      return insertResult.first->second;
+   }
 
-   ySortedIntervals.clear();
-   ySortedIntervals.reserve(numCollidables);
+   BroadCollisionExtents& extents = impl->extents;
 
-   zSortedIntervals.clear();
-   zSortedIntervals.reserve(numCollidables);
+   CollisionHandle_t handle;
 
-   std::size_t index = 0;
-   for (Collidable* collidable : collidables)
+   if (!impl->freeHandles.empty())
    {
-      //"index" is an index into the collisions tables
-      collidableToIndex[collidable] = index;
+      handle = impl->freeHandles.back();
+      impl->freeHandles.pop_back();
 
-      xSortedIntervals.push_back( xIntervals[collidable].get() );
-      ySortedIntervals.push_back( yIntervals[collidable].get() );
-      zSortedIntervals.push_back( zIntervals[collidable].get() );
-
-      ++index;
+      extents.owners[handle] = collidable;
+      impl->moveables[handle] = dynamic_cast<const Moveable*>(collidable);
    }
+   else
+   {
+      handle = extents.owners.size();
 
-   std::sort(xSortedIntervals.begin(), xSortedIntervals.end(), CollisionIntervalComparator());
-   std::sort(ySortedIntervals.begin(), ySortedIntervals.end(), CollisionIntervalComparator());
-   std::sort(zSortedIntervals.begin(), zSortedIntervals.end(), CollisionIntervalComparator());
+      extents.owners.push_back(collidable);
+      impl->moveables.push_back(dynamic_cast<const Moveable*>(collidable));
 
-   xCollisions = std::vector<std::vector<bool>>(numCollidables, std::vector<bool>(numCollidables));
-   yCollisions = std::vector<std::vector<bool>>(numCollidables, std::vector<bool>(numCollidables));
-}
+      for (std::size_t axis = 0; axis < BroadCollisionExtents::Num_Axes; ++axis)
+      {
+         extents.mins[axis].push_back(0.0f);
+         extents.maxes[axis].push_back(0.0f);
+      }
+   }
 
-//{CodeReview:BroadPhaseCollisions}
-void CollisionManager_Impl::UpdateCollisions(std::vector<CollisionInterval*>& sortedIntervals, const std::function<void(std::size_t, std::size_t, Collidable*, Collidable*)>& intervalIntersectionFunction)
-{
-   InsertionSort<CollisionInterval*>(sortedIntervals, CollisionIntervalComparator());
+   insertResult.first->second = handle;
 
-   std::list<const CollisionInterval*> intervalCheckList;
+   impl->SetExtent(handle, collidable);
 
-   for (CollisionInterval* interval : sortedIntervals)
+   if (impl->doUpdateCollisionCollections)
    {
-      std::list<const CollisionInterval*>::iterator checkListIter = intervalCheckList.begin();
+      impl->broadPhase->Rebuild();
+   }
 
-      while (checkListIter != intervalCheckList.end())
-      {
-         if (interval->Intersects(**checkListIter))
-         {
-            Collidable* collidable1 = interval->owner;
-            Collidable* collidable2 = (*checkListIter)->owner;
+   return handle;
+}
 
-            std::size_t index1 = collidableToIndex[collidable1];
-            std::size_t index2 = collidableToIndex[collidable2];
+void CollisionManager_Impl::SetExtent(CollisionHandle_t handle, Collidable* collidable)
+{
+   const FVector3& broadCollisionExtentMin = collidable->GetBroadCollisionExtentMin();
+   const FVector3& broadCollisionExtentMax = collidable->GetBroadCollisionExtentMax();
 
-            intervalIntersectionFunction(index1, index2, collidable1, collidable2);
+   extents.mins[0][handle] = broadCollisionExtentMin.x;
+   extents.mins[1][handle] = broadCollisionExtentMin.y;
+   extents.mins[2][handle] = broadCollisionExtentMin.z;
 
-            ++checkListIter;
-         }
-         else
-         {
-            checkListIter = intervalCheckList.erase(checkListIter);
-         }
-      }
+   extents.maxes[0][handle] = broadCollisionExtentMax.x;
+   extents.maxes[1][handle] = broadCollisionExtentMax.y;
+   extents.maxes[2][handle] = broadCollisionExtentMax.z;
+}
 
-      intervalCheckList.push_back(interval);
+//composes the owner's transformations, if it is a Moveable, so that CollidesWith
+//only reads them. Then lets the owner prepare anything else it computes on demand
+void CollisionManager_Impl::PrepareForNarrowPhase(CollisionHandle_t handle)
+{
+   if (moveables[handle] != nullptr)
+   {
+      moveables[handle]->UpdateTransformations();
    }
+
+   extents.owners[handle]->PrepareForNarrowPhase();
 }
 
 void CollisionManager::Update(Collidable* collidable)
 {
-   assert(impl->collidables.find(collidable) != impl->collidables.end());
-
-   const FVector3& broadCollisionExtentMin = collidable->GetBroadCollisionExtentMin();
-   const FVector3& broadCollisionExtentMax = collidable->GetBroadCollisionExtentMax();
+   assert(impl->collidableToHandle.find(collidable) != impl->collidableToHandle.end());
 
-   impl->xIntervals[collidable]->min = broadCollisionExtentMin.x;
-   impl->xIntervals[collidable]->max = broadCollisionExtentMax.x;
+   impl->SetExtent(impl->collidableToHandle[collidable], collidable);
+}
 
-   impl->yIntervals[collidable]->min = broadCollisionExtentMin.y;
-   impl->yIntervals[collidable]->max = broadCollisionExtentMax.y;
+void CollisionManager::Update(CollisionHandle_t handle)
+{
+   assert((handle < impl->extents.owners.size()) && (impl->extents.owners[handle] != nullptr));
 
-   impl->zIntervals[collidable]->min = broadCollisionExtentMin.z;
-   impl->zIntervals[collidable]->max = broadCollisionExtentMax.z;
+   impl->SetExtent(handle, impl->extents.owners[handle]);
 }
 
 void CollisionManager::Remove(Collidable* collidable)
 {
-   bool erased = (impl->collidables.erase(collidable) == 1);
+   auto handleIter = impl->collidableToHandle.find(collidable);
 
-   if (erased)
+   if (handleIter != impl->collidableToHandle.end())
    {
-      impl->xIntervals.erase(collidable);
-      impl->yIntervals.erase(collidable);
-      impl->zIntervals.erase(collidable);
+      CollisionHandle_t handle = handleIter->second;
+
+      impl->collidableToHandle.erase(handleIter);
+
+      impl->extents.owners[handle] = nullptr;
+      impl->moveables[handle] = nullptr;
+      impl->freeHandles.push_back(handle);
 
       if (impl->doUpdateCollisionCollections)
       {
-         impl->UpdateCollisionCollections();
+         impl->broadPhase->Rebuild();
       }
    }
 }
@@ -236,65 +214,113 @@ void CollisionManager::FinishAddRemoveBatch()
 {
    impl->doUpdateCollisionCollections = true;
 
-   impl->UpdateCollisionCollections();
+   impl->broadPhase->Rebuild();
 }
 
 void CollisionManager::Clear()
 {
-   impl->collidables.clear();
+   impl->extents.owners.clear();
+   impl->moveables.clear();
+
+   for (std::size_t axis = 0; axis < BroadCollisionExtents::Num_Axes; ++axis)
+   {
+      impl->extents.mins[axis].clear();
+      impl->extents.maxes[axis].clear();
+   }
+
+   impl->freeHandles.clear();
+   impl->collidableToHandle.clear();
+
+   impl->broadPhase->Rebuild();
+}
+
+void CollisionManager::SetBroadPhaseType(BroadPhaseType broadPhaseType)
+{
+   if (broadPhaseType != impl->broadPhaseType)
+   {
+      impl->broadPhaseType = broadPhaseType;
+
+      impl->CreateBroadPhase();
+   }
+}
+
+CollisionManager::BroadPhaseType CollisionManager::GetBroadPhaseType() const
+{
+   return impl->broadPhaseType;
+}
+
+void CollisionManager::SetGridCellSize(float cellSize)
+{
+   impl->gridCellSize = cellSize;
 
-   impl->xIntervals.clear();
-   impl->yIntervals.clear();
-   impl->zIntervals.clear();
+   if (impl->broadPhaseType == BroadPhaseType::HashedGrid)
+   {
+      impl->CreateBroadPhase();
+   }
 }
 
 //{CodeReview:BroadPhaseCollisions}
 void CollisionManager::UpdateCollisions()
 {
-   impl->collisionList.clear();
+   impl->broadPhase->UpdateCollisionPairs();
+}
 
-   std::size_t numCollidables = impl->collidables.size();
+//{CodeReview:BroadPhaseCollisions}
+void CollisionManager::TransmitCollisions()
+{
+   const std::vector<CollisionPair_t>& collisionPairs = impl->broadPhase->GetCollisionPairs();
+   const std::vector<Collidable*>& owners = impl->extents.owners;
 
-   if (numCollidables > 0)
+   if (impl->narrowPhaseThreadPool == nullptr)
    {
-      for (std::size_t i = 0; i < numCollidables; ++i)
+      for (const CollisionPair_t& collisionPair : collisionPairs)
       {
-         std::fill(impl->xCollisions[i].begin(), impl->xCollisions[i].end(), false);
-         std::fill(impl->yCollisions[i].begin(), impl->yCollisions[i].end(), false);
+         Collidable* collidable1 = owners[collisionPair.first];
+         Collidable* collidable2 = owners[collisionPair.second];
+
+         if (collidable1->CollidesWith(*collidable2))
+         {
+            collidable1->ResolveCollision(*collidable2);
+         }
       }
+   }
+   else
+   {
+      std::size_t numCollisionPairs = collisionPairs.size();
 
-      impl->UpdateCollisions(impl->xSortedIntervals, [this](std::size_t index1, std::size_t index2, Collidable* /*collidable1*/, Collidable* /*collidable2*/)
+      for (const CollisionPair_t& collisionPair : collisionPairs)
       {
-         impl->xCollisions[index1][index2] = true;
-         impl->xCollisions[index2][index1] = true;
-      });
+         impl->PrepareForNarrowPhase(collisionPair.first);
+         impl->PrepareForNarrowPhase(collisionPair.second);
+      }
+
+      impl->collidesWithResults.resize(numCollisionPairs);
 
-      impl->UpdateCollisions(impl->ySortedIntervals, [this](std::size_t index1, std::size_t index2, Collidable* /*collidable1*/, Collidable* /*collidable2*/)
+      impl->narrowPhaseThreadPool->ParallelFor(numCollisionPairs, 0, [this, &collisionPairs, &owners](std::size_t begin, std::size_t end)
       {
-         impl->yCollisions[index1][index2] = true;
-         impl->yCollisions[index2][index1] = true;
+         for (std::size_t pairIndex = begin; pairIndex < end; ++pairIndex)
+         {
+            const CollisionPair_t& collisionPair = collisionPairs[pairIndex];
+
+            impl->collidesWithResults[pairIndex] = owners[collisionPair.first]->CollidesWith(*owners[collisionPair.second]);
+         }
       });
 
-      impl->UpdateCollisions(impl->zSortedIntervals, [this](std::size_t index1, std::size_t index2, Collidable* collidable1, Collidable* collidable2)
+      for (std::size_t pairIndex = 0; pairIndex < numCollisionPairs; ++pairIndex)
       {
-         if (impl->xCollisions[index1][index2] && impl->yCollisions[index1][index2])
+         if (impl->collidesWithResults[pairIndex])
          {
-            impl->collisionList.emplace_front(std::pair<Collidable*, Collidable*>(collidable1, collidable2));
+            const CollisionPair_t& collisionPair = collisionPairs[pairIndex];
+
+            owners[collisionPair.first]->ResolveCollision(*owners[collisionPair.second]);
          }
-      });
+      }
    }
 }
 
-//{CodeReview:BroadPhaseCollisions}
-void CollisionManager::TransmitCollisions()
+void CollisionManager::SetNarrowPhaseThreadPool(ThreadPool* threadPool)
 {
-   for (const std::pair<Collidable*, Collidable*>& collisionPair : impl->collisionList)
-   {
-      if (collisionPair.first->CollidesWith(*(collisionPair.second)))
-      {
-         collisionPair.first->ResolveCollision(*(collisionPair.second));
-      }
-   }
+   impl->narrowPhaseThreadPool = threadPool;
 }
 
 }
\ No newline at end of file
@@ -91,4 +91,9 @@ bool Frustum::Within(const FVector3& centerOfSphere, float sphereRadius) const
    return true;
 }
 
+const Plane& Frustum::GetPlane(PlaneLocations location) const
+{
+   return planes[location];
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,330 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "Locus/Geometry/FrustumCuller.h"
+#include "Locus/Geometry/Frustum.h"
+#include "Locus/Geometry/Sphere.h"
+#include "Locus/Geometry/AxisAlignedBox.h"
+
+#include "Locus/Common/ThreadPool.h"
+
+#include "InstructionSet.h"
+
+#include <limits>
+
+#include <cassert>
+
+namespace Locus
+{
+
+const CullingHandle_t BAD_CULLING_HANDLE = std::numeric_limits<CullingHandle_t>::max();
+
+/// The widest kernel tests this many spheres at a time, so the arrays are padded to a multiple of it.
+static const std::size_t Block_Size = 8;
+
+static const float Removed_Radius = -std::numeric_limits<float>::infinity();
+
+/// The frustum planes as n . p + d, with n pointing into the frustum.
+struct CullingPlanes
+{
+   float nxs[Frustum::NUM_PLANES];
+   float nys[Frustum::NUM_PLANES];
+   float nzs[Frustum::NUM_PLANES];
+   float ds[Frustum::NUM_PLANES];
+};
+
+static CullingPlanes SetupPlanes(const Frustum& frustum)
+{
+   CullingPlanes planes;
+
+   for (int planeIndex = 0; planeIndex < Frustum::NUM_PLANES; ++planeIndex)
+   {
+      const Plane& plane = frustum.GetPlane(static_cast<Frustum::PlaneLocations>(planeIndex));
+
+      FVector3 normal = plane.getNormal();
+
+      planes.nxs[planeIndex] = normal.x;
+      planes.nys[planeIndex] = normal.y;
+      planes.nzs[planeIndex] = normal.z;
+      planes.ds[planeIndex] = -(normal.x * plane.P.x + normal.y * plane.P.y + normal.z * plane.P.z);
+   }
+
+   return planes;
+}
+
+/////////////////////////////////////////Scalar/////////////////////////////////////////
+
+//The SSE2 and AVX kernels below evaluate the same expressions in the same
+//order, one sphere per lane, so every path gives identical answers.
+//
+//Each kernel returns a mask with a bit set for each visible sphere in the
+//block of numLanes spheres starting at first
+
+static unsigned int CullBlockScalar(const CullingPlanes& planes, const float* xs, const float* ys, const float* zs, const float* radii, std::size_t first)
+{
+   for (int planeIndex = 0; planeIndex < Frustum::NUM_PLANES; ++planeIndex)
+   {
+      float distance = planes.nxs[planeIndex] * xs[first] + planes.nys[planeIndex] * ys[first] + planes.nzs[planeIndex] * zs[first] + planes.ds[planeIndex];
+
+      if (distance + radii[first] < 0)
+      {
+         return 0;
+      }
+   }
+
+   return 1;
+}
+
+#ifdef LOCUS_X86
+
+/////////////////////////////////////////SSE2/////////////////////////////////////////
+
+static LOCUS_TARGET_SSE2 unsigned int CullBlockSSE2(const CullingPlanes& planes, const float* xs, const float* ys, const float* zs, const float* radii, std::size_t first)
+{
+   __m128 x = _mm_loadu_ps(xs + first);
+   __m128 y = _mm_loadu_ps(ys + first);
+   __m128 z = _mm_loadu_ps(zs + first);
+   __m128 radius = _mm_loadu_ps(radii + first);
+
+   __m128 zero = _mm_setzero_ps();
+   __m128 outside = zero;
+
+   for (int planeIndex = 0; planeIndex < Frustum::NUM_PLANES; ++planeIndex)
+   {
+      __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.nxs[planeIndex]), x),
+                                                         _mm_mul_ps(_mm_set1_ps(planes.nys[planeIndex]), y)),
+                                              _mm_mul_ps(_mm_set1_ps(planes.nzs[planeIndex]), z)),
+                                   _mm_set1_ps(planes.ds[planeIndex]));
+
+      outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+   }
+
+   return static_cast<unsigned int>(~_mm_movemask_ps(outside) & 0xF);
+}
+
+/////////////////////////////////////////AVX/////////////////////////////////////////
+
+static LOCUS_TARGET_AVX unsigned int CullBlockAVX(const CullingPlanes& planes, const float* xs, const float* ys, const float* zs, const float* radii, std::size_t first)
+{
+   __m256 x = _mm256_loadu_ps(xs + first);
+   __m256 y = _mm256_loadu_ps(ys + first);
+   __m256 z = _mm256_loadu_ps(zs + first);
+   __m256 radius = _mm256_loadu_ps(radii + first);
+
+   __m256 zero = _mm256_setzero_ps();
+   __m256 outside = zero;
+
+   for (int planeIndex = 0; planeIndex < Frustum::NUM_PLANES; ++planeIndex)
+   {
+      __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes.nxs[planeIndex]), x),
+                                                                  _mm256_mul_ps(_mm256_set1_ps(planes.nys[planeIndex]), y)),
+                                                    _mm256_mul_ps(_mm256_set1_ps(planes.nzs[planeIndex]), z)),
+                                      _mm256_set1_ps(planes.ds[planeIndex]));
+
+      outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_LT_OQ));
+   }
+
+   return static_cast<unsigned int>(~_mm256_movemask_ps(outside) & 0xFF);
+}
+
+#endif //LOCUS_X86
+
+/////////////////////////////////////////Dispatch/////////////////////////////////////////
+
+struct FrustumCullerKernels
+{
+   /// The number of spheres that cullBlock handles per call. Divides Block_Size.
+   std::size_t numLanes;
+
+   unsigned int (*cullBlock)(const CullingPlanes&, const float*, const float*, const float*, const float*, std::size_t);
+};
+
+static const FrustumCullerKernels Frustum_Culler_Kernels[] =
+{
+   { 1, CullBlockScalar },
+
+#ifdef LOCUS_X86
+   { 4, CullBlockSSE2 },
+   { 8, CullBlockAVX }
+#endif
+};
+
+/// \return the visible spheres of the block of Block_Size spheres starting at first, one bit per sphere.
+static unsigned int CullBlock(const FrustumCullerKernels& kernels, const CullingPlanes& planes, const float* xs, const float* ys, const float* zs, const float* radii, std::size_t first)
+{
+   unsigned int mask = 0;
+
+   for (std::size_t lane = 0; lane < Block_Size; lane += kernels.numLanes)
+   {
+      mask |= (kernels.cullBlock(planes, xs, ys, zs, radii, first + lane) << lane);
+   }
+
+   return mask;
+}
+
+static void AppendVisibleHandles(unsigned int mask, std::size_t first, std::vector<CullingHandle_t>& visibleHandles)
+{
+   for (std::size_t lane = 0; mask != 0; ++lane, mask >>= 1)
+   {
+      if ((mask & 1) != 0)
+      {
+         visibleHandles.push_back(first + lane);
+      }
+   }
+}
+
+FrustumCuller::FrustumCuller()
+   : numHandles(0), threadPool(nullptr)
+{
+}
+
+CullingHandle_t FrustumCuller::Add(const Sphere& boundingSphere)
+{
+   return Add(boundingSphere.center.x, boundingSphere.center.y, boundingSphere.center.z, boundingSphere.radius);
+}
+
+CullingHandle_t FrustumCuller::Add(const AxisAlignedBox& boundingBox)
+{
+   FVector3 centroid = boundingBox.Centroid();
+
+   return Add(centroid.x, centroid.y, centroid.z, boundingBox.DiagonalLength() / 2);
+}
+
+CullingHandle_t FrustumCuller::Add(float centerX, float centerY, float centerZ, float radius)
+{
+   CullingHandle_t handle;
+
+   if (!freeHandles.empty())
+   {
+      handle = freeHandles.back();
+      freeHandles.pop_back();
+   }
+   else
+   {
+      handle = numHandles;
+      ++numHandles;
+
+      if (numHandles > radii.size())
+      {
+         std::size_t paddedSize = radii.size() + Block_Size;
+
+         centerXs.resize(paddedSize, 0.0f);
+         centerYs.resize(paddedSize, 0.0f);
+         centerZs.resize(paddedSize, 0.0f);
+         radii.resize(paddedSize, Removed_Radius);
+      }
+   }
+
+   Set(handle, centerX, centerY, centerZ, radius);
+
+   return handle;
+}
+
+void FrustumCuller::Update(CullingHandle_t handle, const Sphere& boundingSphere)
+{
+   Set(handle, boundingSphere.center.x, boundingSphere.center.y, boundingSphere.center.z, boundingSphere.radius);
+}
+
+void FrustumCuller::Update(CullingHandle_t handle, const AxisAlignedBox& boundingBox)
+{
+   FVector3 centroid = boundingBox.Centroid();
+
+   Set(handle, centroid.x, centroid.y, centroid.z, boundingBox.DiagonalLength() / 2);
+}
+
+void FrustumCuller::Set(CullingHandle_t handle, float centerX, float centerY, float centerZ, float radius)
+{
+   assert(handle < numHandles);
+   assert(radius >= 0);
+
+   centerXs[handle] = centerX;
+   centerYs[handle] = centerY;
+   centerZs[handle] = centerZ;
+   radii[handle] = radius;
+}
+
+void FrustumCuller::Remove(CullingHandle_t handle)
+{
+   assert((handle < numHandles) && (radii[handle] != Removed_Radius));
+
+   centerXs[handle] = 0.0f;
+   centerYs[handle] = 0.0f;
+   centerZs[handle] = 0.0f;
+   radii[handle] = Removed_Radius;
+
+   freeHandles.push_back(handle);
+}
+
+void FrustumCuller::Clear()
+{
+   centerXs.clear();
+   centerYs.clear();
+   centerZs.clear();
+   radii.clear();
+
+   numHandles = 0;
+
+   freeHandles.clear();
+}
+
+std::size_t FrustumCuller::Size() const
+{
+   return numHandles - freeHandles.size();
+}
+
+void FrustumCuller::SetThreadPool(ThreadPool* threadPool)
+{
+   this->threadPool = threadPool;
+}
+
+void FrustumCuller::Cull(const Frustum& frustum, std::vector<CullingHandle_t>& visibleHandles)
+{
+   visibleHandles.clear();
+
+   const FrustumCullerKernels& kernels = SelectKernelSet(Frustum_Culler_Kernels);
+
+   CullingPlanes planes = SetupPlanes(frustum);
+
+   const float* xs = centerXs.data();
+   const float* ys = centerYs.data();
+   const float* zs = centerZs.data();
+   const float* rs = radii.data();
+
+   std::size_t numBlocks = radii.size() / Block_Size;
+
+   if (threadPool == nullptr)
+   {
+      for (std::size_t blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+      {
+         std::size_t first = blockIndex * Block_Size;
+
+         AppendVisibleHandles(CullBlock(kernels, planes, xs, ys, zs, rs, first), first, visibleHandles);
+      }
+   }
+   else
+   {
+      blockMasks.resize(numBlocks);
+
+      threadPool->ParallelFor(numBlocks, 0, [this, &kernels, &planes, xs, ys, zs, rs](std::size_t begin, std::size_t end)
+      {
+         for (std::size_t blockIndex = begin; blockIndex < end; ++blockIndex)
+         {
+            blockMasks[blockIndex] = CullBlock(kernels, planes, xs, ys, zs, rs, blockIndex * Block_Size);
+         }
+      });
+
+      for (std::size_t blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+      {
+         AppendVisibleHandles(blockMasks[blockIndex], blockIndex * Block_Size, visibleHandles);
+      }
+   }
+}
+
+}
\ No newline at end of file
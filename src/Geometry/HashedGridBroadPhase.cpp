@@ -0,0 +1,247 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "HashedGridBroadPhase.h"
+
+#include "Locus/Common/Util.h"
+
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+namespace Locus
+{
+
+std::size_t HashedGridBroadPhase::CellCoordinatesHash::operator()(const CellCoordinates_t& cellCoordinates) const
+{
+   //large primes from "Optimized Spatial Hashing for Collision Detection of Deformable Objects" (Teschner et al.)
+   return (static_cast<std::size_t>(cellCoordinates[0]) * 73856093) ^
+          (static_cast<std::size_t>(cellCoordinates[1]) * 19349663) ^
+          (static_cast<std::size_t>(cellCoordinates[2]) * 83492791);
+}
+
+const double HashedGridBroadPhase::Max_Cells_Per_Extent = 512.0;
+
+HashedGridBroadPhase::HashedGridBroadPhase(const BroadCollisionExtents& extents, float cellSize)
+   : BroadPhase(extents), requestedCellSize(cellSize), cellSize(cellSize)
+{
+}
+
+int HashedGridBroadPhase::ToCellCoordinate(float value) const
+{
+   const float Max_Cell_Coordinate = 1e9f;
+
+   return static_cast<int>( std::floor(Clamp(value / cellSize, -Max_Cell_Coordinate, Max_Cell_Coordinate)) );
+}
+
+HashedGridBroadPhase::CellRange HashedGridBroadPhase::ComputeCellRange(CollisionHandle_t handle) const
+{
+   CellRange cellRange;
+
+   for (std::size_t axis = 0; axis < BroadCollisionExtents::Num_Axes; ++axis)
+   {
+      cellRange.min[axis] = ToCellCoordinate(extents.mins[axis][handle]);
+      cellRange.max[axis] = ToCellCoordinate(extents.maxes[axis][handle]);
+   }
+
+   return cellRange;
+}
+
+bool HashedGridBroadPhase::IsOversized(const CellRange& cellRange)
+{
+   //computed in floating point since the product may overflow an integer
+   double numCells = 1.0;
+
+   for (std::size_t axis = 0; axis < BroadCollisionExtents::Num_Axes; ++axis)
+   {
+      numCells *= (static_cast<double>(cellRange.max[axis]) - static_cast<double>(cellRange.min[axis]) + 1.0);
+   }
+
+   return (numCells > Max_Cells_Per_Extent);
+}
+
+template <class CellFunction>
+void HashedGridBroadPhase::ForEachCell(const CellRange& cellRange, const CellFunction& cellFunction)
+{
+   CellCoordinates_t cellCoordinates;
+
+   for (cellCoordinates[0] = cellRange.min[0]; cellCoordinates[0] <= cellRange.max[0]; ++cellCoordinates[0])
+   {
+      for (cellCoordinates[1] = cellRange.min[1]; cellCoordinates[1] <= cellRange.max[1]; ++cellCoordinates[1])
+      {
+         for (cellCoordinates[2] = cellRange.min[2]; cellCoordinates[2] <= cellRange.max[2]; ++cellCoordinates[2])
+         {
+            cellFunction(cellCoordinates);
+         }
+      }
+   }
+}
+
+void HashedGridBroadPhase::AddToCells(CollisionHandle_t handle, const CellRange& cellRange)
+{
+   if (IsOversized(cellRange))
+   {
+      oversizedHandles.push_back(handle);
+      return;
+   }
+
+   ForEachCell(cellRange, [this, handle](const CellCoordinates_t& cellCoordinates)
+   {
+      cells[cellCoordinates].push_back(handle);
+   });
+}
+
+void HashedGridBroadPhase::RemoveFromCells(CollisionHandle_t handle, const CellRange& cellRange)
+{
+   if (IsOversized(cellRange))
+   {
+      auto handleIter = std::find(oversizedHandles.begin(), oversizedHandles.end(), handle);
+
+      *handleIter = oversizedHandles.back();
+      oversizedHandles.pop_back();
+
+      return;
+   }
+
+   ForEachCell(cellRange, [this, handle](const CellCoordinates_t& cellCoordinates)
+   {
+      auto cellIter = cells.find(cellCoordinates);
+
+      std::vector<CollisionHandle_t>& cellHandles = cellIter->second;
+
+      auto handleIter = std::find(cellHandles.begin(), cellHandles.end(), handle);
+
+      *handleIter = cellHandles.back();
+      cellHandles.pop_back();
+
+      if (cellHandles.empty())
+      {
+         cells.erase(cellIter);
+      }
+   });
+}
+
+void HashedGridBroadPhase::Rebuild()
+{
+   CollisionHandle_t numHandles = extents.owners.size();
+
+   if (requestedCellSize <= 0.0f)
+   {
+      double totalSideLength = 0.0;
+      std::size_t numSides = 0;
+
+      for (CollisionHandle_t handle = 0; handle < numHandles; ++handle)
+      {
+         if (extents.owners[handle] != nullptr)
+         {
+            for (std::size_t axis = 0; axis < BroadCollisionExtents::Num_Axes; ++axis)
+            {
+               totalSideLength += extents.maxes[axis][handle] - extents.mins[axis][handle];
+               ++numSides;
+            }
+         }
+      }
+
+      cellSize = ((totalSideLength > 0.0) ? static_cast<float>(totalSideLength / numSides) : 1.0f);
+   }
+
+   cells.clear();
+   oversizedHandles.clear();
+   cellRanges.resize(numHandles);
+
+   for (CollisionHandle_t handle = 0; handle < numHandles; ++handle)
+   {
+      if (extents.owners[handle] != nullptr)
+      {
+         cellRanges[handle] = ComputeCellRange(handle);
+
+         AddToCells(handle, cellRanges[handle]);
+      }
+   }
+
+   UpdateCollisionPairs();
+}
+
+void HashedGridBroadPhase::UpdateCollisionPairs()
+{
+   for (CollisionHandle_t handle = 0, numHandles = extents.owners.size(); handle < numHandles; ++handle)
+   {
+      if (extents.owners[handle] != nullptr)
+      {
+         CellRange newCellRange = ComputeCellRange(handle);
+
+         if ((newCellRange.min != cellRanges[handle].min) || (newCellRange.max != cellRanges[handle].max))
+         {
+            RemoveFromCells(handle, cellRanges[handle]);
+            AddToCells(handle, newCellRange);
+
+            cellRanges[handle] = newCellRange;
+         }
+      }
+   }
+
+   collisionPairs.clear();
+
+   for (const auto& cell : cells)
+   {
+      const CellCoordinates_t& cellCoordinates = cell.first;
+      const std::vector<CollisionHandle_t>& cellHandles = cell.second;
+
+      for (std::size_t i = 0, numCellHandles = cellHandles.size(); i < numCellHandles; ++i)
+      {
+         const CellRange& cellRange1 = cellRanges[cellHandles[i]];
+
+         for (std::size_t j = i + 1; j < numCellHandles; ++j)
+         {
+            const CellRange& cellRange2 = cellRanges[cellHandles[j]];
+
+            //A pair of extents may share many cells. The pair is only reported
+            //from the lowest cell the two extents have in common
+            bool isLowestSharedCell = true;
+
+            for (std::size_t axis = 0; axis < BroadCollisionExtents::Num_Axes; ++axis)
+            {
+               if (std::max(cellRange1.min[axis], cellRange2.min[axis]) != cellCoordinates[axis])
+               {
+                  isLowestSharedCell = false;
+                  break;
+               }
+            }
+
+            if (isLowestSharedCell && extents.Intersects(cellHandles[i], cellHandles[j]))
+            {
+               collisionPairs.push_back( MakeCollisionPair(cellHandles[i], cellHandles[j]) );
+            }
+         }
+      }
+   }
+   //Oversized extents are tested against every other extent. A pair of
+   //oversized extents is only reported by the one with the lower handle
+   for (CollisionHandle_t oversizedHandle : oversizedHandles)
+   {
+      for (CollisionHandle_t handle = 0, numHandles = extents.owners.size(); handle < numHandles; ++handle)
+      {
+         if ((extents.owners[handle] != nullptr) && (handle != oversizedHandle))
+         {
+            if ((handle < oversizedHandle) && IsOversized(cellRanges[handle]))
+            {
+               continue;
+            }
+
+            if (extents.Intersects(oversizedHandle, handle))
+            {
+               collisionPairs.push_back( MakeCollisionPair(oversizedHandle, handle) );
+            }
+         }
+      }
+   }
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "BroadPhase.h"
+
+#include <unordered_map>
+
+namespace Locus
+{
+
+/*!
+ * \brief Finds intersecting extents by bucketing them into the
+ * cells of a uniform grid, stored sparsely in a hash table.
+ *
+ * \details Only pairs of extents that share a cell are tested.
+ * The grid is persistent: an extent is only moved between cells
+ * when the range of cells it covers changes. Unlike sweep and
+ * prune, it does not degrade when many extents overlap along one
+ * axis. It works best when the cell size is about the size of a
+ * typical extent.
+ *
+ * \details Extents that would cover more than Max_Cells_Per_Extent
+ * cells are not put in the grid. They are kept in a separate list
+ * and tested against every other extent instead, so that a single
+ * huge extent cannot make an update touch an unbounded number of
+ * cells.
+ */
+class HashedGridBroadPhase : public BroadPhase
+{
+public:
+   /*!
+    * \param[in] cellSize The side length of a grid cell. If it is
+    * not positive, then the cell size is set to the mean extent
+    * side length on every call to Rebuild.
+    */
+   HashedGridBroadPhase(const BroadCollisionExtents& extents, float cellSize);
+
+   virtual void Rebuild() override;
+   virtual void UpdateCollisionPairs() override;
+
+private:
+   typedef std::array<int, BroadCollisionExtents::Num_Axes> CellCoordinates_t;
+
+   struct CellCoordinatesHash
+   {
+      std::size_t operator()(const CellCoordinates_t& cellCoordinates) const;
+   };
+
+   struct CellRange
+   {
+      CellCoordinates_t min;
+      CellCoordinates_t max;
+   };
+
+   static const double Max_Cells_Per_Extent;
+
+   float requestedCellSize;
+   float cellSize;
+
+   //the range of cells covered by each handle's extent, as of the last update
+   std::vector<CellRange> cellRanges;
+
+   std::unordered_map<CellCoordinates_t, std::vector<CollisionHandle_t>, CellCoordinatesHash> cells;
+
+   //the handles whose extents cover too many cells to be put in the grid
+   std::vector<CollisionHandle_t> oversizedHandles;
+
+   int ToCellCoordinate(float value) const;
+   CellRange ComputeCellRange(CollisionHandle_t handle) const;
+
+   static bool IsOversized(const CellRange& cellRange);
+
+   void AddToCells(CollisionHandle_t handle, const CellRange& cellRange);
+   void RemoveFromCells(CollisionHandle_t handle, const CellRange& cellRange);
+
+   template <class CellFunction>
+   static void ForEachCell(const CellRange& cellRange, const CellFunction& cellFunction);
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+
+   #define LOCUS_X86
+
+   #include <immintrin.h>
+
+#endif
+
+//GCC and Clang only allow SSE and AVX intrinsics in functions compiled for
+//those instruction sets. Marking just the kernels lets the rest of the
+//library target the baseline architecture. MSVC needs no such marking
+#if defined(LOCUS_X86) && defined(__GNUC__)
+   #define LOCUS_TARGET_SSE2 __attribute__((target("sse2")))
+   #define LOCUS_TARGET_AVX __attribute__((target("avx")))
+#else
+   #define LOCUS_TARGET_SSE2
+   #define LOCUS_TARGET_AVX
+#endif
+
+#include "Locus/Common/InstructionSet.h"
+
+#include <cstddef>
+
+namespace Locus
+{
+
+/*!
+ * \return the entry of kernelSets that matches
+ * DetectInstructionSet.
+ *
+ * \details kernelSets holds one set of kernels per instruction
+ * set, in the order of InstructionSet. Builds that don't target
+ * x86 only have scalar kernels, so there kernelSets may hold
+ * just the scalar set.
+ */
+template <class KernelSet, std::size_t NumKernelSets>
+const KernelSet& SelectKernelSet(const KernelSet (&kernelSets)[NumKernelSets])
+{
+   static_assert((NumKernelSets == 1) || (NumKernelSets == Num_Instruction_Sets), "There must be one kernel set per instruction set");
+
+   std::size_t kernelSetIndex = static_cast<std::size_t>(DetectInstructionSet());
+
+   return kernelSets[(kernelSetIndex < NumKernelSets) ? kernelSetIndex : 0];
+}
+
+}
\ No newline at end of file
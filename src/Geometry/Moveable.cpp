@@ -10,11 +10,13 @@
 
 #include "Locus/Geometry/Moveable.h"
 
+#include "Locus/Common/Float.h"
+
 namespace Locus
 {
 
 Moveable::Moveable()
-   : modelScale(1, 1, 1)
+   : modelScale(1, 1, 1), transformationsAreDirty(false)
 {
 }
 
@@ -26,14 +28,14 @@ void Moveable::Translate(const FVector3& translation)
 {
    modelTranslation += translation;
 
-   UpdateTransformations();
+   transformationsAreDirty = true;
 }
 
 void Moveable::Rotate(const FVector3& rotation)
 {
    modelRotation.RotateBy(rotation);
 
-   UpdateTransformations();
+   transformationsAreDirty = true;
 }
 
 void Moveable::Scale(const FVector3& scale)
@@ -42,16 +44,43 @@ void Moveable::Scale(const FVector3& scale)
    modelScale.y *= scale.y;
    modelScale.z *= scale.z;
 
-   UpdateTransformations();
+   transformationsAreDirty = true;
 }
 
-void Moveable::UpdateTransformations()
+void Moveable::UpdateTransformations() const
 {
-   modelTranslationAndRotation = Transformation::Translation(modelTranslation);
-   modelTranslationAndRotation.MultMatrix(modelRotation);
-
-   modelTransformation = modelTranslationAndRotation;
-   modelTransformation.MultMatrix( Transformation::Scale(modelScale) );
+   if (transformationsAreDirty)
+   {
+      //Translation * Rotation * Scale, written out rather than multiplied
+      //since most of the elements of the translation and scale are zero
+      const float translation[3] = { modelTranslation.x, modelTranslation.y, modelTranslation.z };
+      //as in Transformation::Scale, zero scales are treated as one
+      const float scale[3] = { FIsZero<float>(modelScale.x) ? 1.0f : modelScale.x,
+                               FIsZero<float>(modelScale.y) ? 1.0f : modelScale.y,
+                               FIsZero<float>(modelScale.z) ? 1.0f : modelScale.z };
+
+      modelTranslationAndRotation = modelRotation;
+
+      for (unsigned int col = 0; col < 4; ++col)
+      {
+         for (unsigned int row = 0; row < 3; ++row)
+         {
+            modelTranslationAndRotation(row, col) += translation[row] * modelRotation(3, col);
+         }
+      }
+
+      modelTransformation = modelTranslationAndRotation;
+
+      for (unsigned int col = 0; col < 3; ++col)
+      {
+         for (unsigned int row = 0; row < 4; ++row)
+         {
+            modelTransformation(row, col) *= scale[col];
+         }
+      }
+
+      transformationsAreDirty = false;
+   }
 }
 
 FVector3 Moveable::Position() const
@@ -75,7 +104,7 @@ void Moveable::Reset(const FVector3& position, const Transformation& rotationTra
    modelTranslation = position;
    modelScale = scale;
 
-   UpdateTransformations();
+   transformationsAreDirty = true;
 }
 
 const FVector3& Moveable::CurrentScale() const
@@ -85,11 +114,15 @@ const FVector3& Moveable::CurrentScale() const
 
 const Transformation& Moveable::CurrentModelTransformation() const
 {
+   UpdateTransformations();
+
    return modelTransformation;
 }
 
 const Transformation& Moveable::CurrentTranslationAndRotation() const
 {
+   UpdateTransformations();
+
    return modelTranslationAndRotation;
 }
 
@@ -10,16 +10,169 @@
 
 #include "Locus/Geometry/OrientedBox.h"
 #include "Locus/Geometry/Moveable.h"
+#include "Locus/Geometry/RelativeTransformation.h"
 #include "Locus/Geometry/Triangle.h"
 #include "Locus/Geometry/Sphere.h"
 
+#include "Locus/Math/SymmetricEigen.h"
+
 #include "Locus/Common/Float.h"
 
+#include <array>
 #include <limits>
 
+#include <cmath>
+
 namespace Locus
 {
 
+static bool ProjectionsOverlap(const std::array<float, 3>& thisExtents, const std::array<float, 3>& thatExtents, const float (&dotProducts)[3][3], const FVector3& thisFrameTranslation)
+{
+   float absDotProducts[3][3];
+
+   for (unsigned int thisCoordinate = 0; thisCoordinate < 3; ++thisCoordinate)
+   {
+      for (unsigned int thatCoordinate = 0; thatCoordinate < 3; ++thatCoordinate)
+      {
+         absDotProducts[thisCoordinate][thatCoordinate] = std::fabs(dotProducts[thisCoordinate][thatCoordinate]);
+      }
+   }
+
+   float thisRadiusProjection = 0.0f;
+   float thatRadiusProjection = 0.0f;
+   float projectionThreshold = 0.0f;
+
+   //projections onto this axes
+   for (unsigned int thisCoordinate = 0; thisCoordinate < 3; ++thisCoordinate)
+   {
+      thisRadiusProjection = thisExtents[thisCoordinate];
+
+      thatRadiusProjection = (thatExtents[0] * absDotProducts[thisCoordinate][0]) +
+                             (thatExtents[1] * absDotProducts[thisCoordinate][1]) +
+                             (thatExtents[2] * absDotProducts[thisCoordinate][2]);
+
+      projectionThreshold = fabs( thisFrameTranslation[thisCoordinate] );
+
+      if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
+      {
+         return false;
+      }
+   }
+
+   //projections onto that axes
+   for (unsigned int thatCoordinate = 0; thatCoordinate < 3; ++thatCoordinate)
+   {
+      thisRadiusProjection = (thisExtents[0] * absDotProducts[0][thatCoordinate]) +
+                             (thisExtents[1] * absDotProducts[1][thatCoordinate]) +
+                             (thisExtents[2] * absDotProducts[2][thatCoordinate]);
+
+      thatRadiusProjection = thatExtents[thatCoordinate];
+
+      projectionThreshold = fabs( (thisFrameTranslation[0] * dotProducts[0][thatCoordinate]) +
+                                  (thisFrameTranslation[1] * dotProducts[1][thatCoordinate]) +
+                                  (thisFrameTranslation[2] * dotProducts[2][thatCoordinate]) );
+
+      if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
+      {
+         return false;
+      }
+   }
+
+   //9 cross products
+
+   //this_XAxis x that_XAxis
+   thisRadiusProjection = thisExtents[1] * absDotProducts[2][0] + thisExtents[2] * absDotProducts[1][0];
+   thatRadiusProjection = thatExtents[1] * absDotProducts[0][2] + thatExtents[2] * absDotProducts[0][1];
+   projectionThreshold = fabs( (thisFrameTranslation[2] * dotProducts[1][0]) - (thisFrameTranslation[1] * dotProducts[2][0]) );
+
+   if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
+   {
+      return false;
+   }
+
+   //this_XAxis x that_YAxis
+   thisRadiusProjection = thisExtents[1] * absDotProducts[2][1] + thisExtents[2] * absDotProducts[1][1];
+   thatRadiusProjection = thatExtents[0] * absDotProducts[0][2] + thatExtents[2] * absDotProducts[0][0];
+   projectionThreshold = fabs( (thisFrameTranslation[2] * dotProducts[1][1]) - (thisFrameTranslation[1] * dotProducts[2][1]) );
+
+   if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
+   {
+      return false;
+   }
+
+   //this_XAxis x that_ZAxis
+   thisRadiusProjection = thisExtents[1] * absDotProducts[2][2] + thisExtents[2] * absDotProducts[1][2];
+   thatRadiusProjection = thatExtents[0] * absDotProducts[0][1] + thatExtents[1] * absDotProducts[0][0];
+   projectionThreshold = fabs( thisFrameTranslation[2] * dotProducts[1][2] - thisFrameTranslation[1] * dotProducts[2][2] );
+
+   if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
+   {
+      return false;
+   }
+
+   //this_YAxis x that_XAxis
+   thisRadiusProjection = thisExtents[0] * absDotProducts[2][0] + thisExtents[2] * absDotProducts[0][0];
+   thatRadiusProjection = thatExtents[1] * absDotProducts[1][2] + thatExtents[2] * absDotProducts[1][1];
+   projectionThreshold = fabs( thisFrameTranslation[0] * dotProducts[2][0] - thisFrameTranslation[2]*dotProducts[0][0] );
+
+   if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
+   {
+      return false;
+   }
+
+   //this_YAxis x that_YAxis
+   thisRadiusProjection = thisExtents[0] * absDotProducts[2][1] + thisExtents[2] * absDotProducts[0][1];
+   thatRadiusProjection = thatExtents[0] * absDotProducts[1][2] + thatExtents[2] * absDotProducts[1][0];
+   projectionThreshold = fabs( thisFrameTranslation[0] * dotProducts[2][1] - thisFrameTranslation[2] * dotProducts[0][1] );
+
+   if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
+   {
+      return false;
+   }
+
+   //this_YAxis x that_ZAxis
+   thisRadiusProjection = thisExtents[0] * absDotProducts[2][2] + thisExtents[2] * absDotProducts[0][2];
+   thatRadiusProjection = thatExtents[0] * absDotProducts[1][1] + thatExtents[1] * absDotProducts[1][0];
+   projectionThreshold = fabs( thisFrameTranslation[0] * dotProducts[2][2] - thisFrameTranslation[2] * dotProducts[0][2] );
+
+   if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
+   {
+      return false;
+   }
+
+   //this_ZAxis x that_XAxis
+   thisRadiusProjection = thisExtents[0] * absDotProducts[1][0] + thisExtents[1] * absDotProducts[0][0];
+   thatRadiusProjection = thatExtents[1] * absDotProducts[2][2] + thatExtents[2] * absDotProducts[2][1];
+   projectionThreshold = fabs( thisFrameTranslation[1] * dotProducts[0][0] - thisFrameTranslation[0] * dotProducts[1][0] );
+
+   if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
+   {
+      return false;
+   }
+
+   //this_ZAxis x that_YAxis
+   thisRadiusProjection = thisExtents[0] * absDotProducts[1][1] + thisExtents[1] * absDotProducts[0][1];
+   thatRadiusProjection = thatExtents[0] * absDotProducts[2][2] + thatExtents[2] * absDotProducts[2][0];
+   projectionThreshold = fabs( thisFrameTranslation[1] * dotProducts[0][1] - thisFrameTranslation[0] * dotProducts[1][1] );
+
+   if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
+   {
+      return false;
+   }
+
+   //this_ZAxis x that_ZAxis
+   thisRadiusProjection = thisExtents[0] * absDotProducts[1][2] + thisExtents[1] * absDotProducts[0][2];
+   thatRadiusProjection = thatExtents[0] * absDotProducts[2][1] + thatExtents[1] * absDotProducts[2][0];
+   projectionThreshold = fabs( thisFrameTranslation[1] * dotProducts[0][2] - thisFrameTranslation[0] * dotProducts[1][2] );
+
+   if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
+   {
+      return false;
+   }
+
+   return true;
+}
+
 OrientedBox::OrientedBox()
 {
 }
@@ -72,36 +225,22 @@ OrientedBox::OrientedBox(const std::vector<FVector3>& points)
       float xzEntry = xzExpectedValue - (centroid.x * centroid.z);
       float yzEntry = yzExpectedValue - (centroid.y * centroid.z);
 
-      Matrix<float> covarianceMatrix(3, 3, { xxEntry, xyEntry, xzEntry,
-                                             xyEntry, yyEntry, yzEntry,
-                                             xzEntry, yzEntry, zzEntry });
+      std::array<float, 3> eigenvalues;
+      std::array<std::array<float, 3>, 3> eigenvectors;
 
-      Transformation rotation;
+      SolveSymmetricEigen3x3<float>({ xxEntry, xyEntry, xzEntry,
+                                      xyEntry, yyEntry, yzEntry,
+                                      xzEntry, yzEntry, zzEntry }, eigenvalues, eigenvectors);
 
-      std::vector<std::vector<float>> eigenvectors;
+      //the eigenvectors are orthonormal, even for degenerate point sets
+      //with repeated eigenvalues, so they are used as the box axes directly
+      Transformation rotation;
 
-      if (covarianceMatrix.SolveEigenvectors(eigenvectors))
+      for (std::size_t column = 0; column < 3; ++column)
       {
-         FVector3 columnInRotationMatrix(eigenvectors[0][0], eigenvectors[0][1], eigenvectors[0][2]);
-         Normalize(columnInRotationMatrix);
-
-         rotation(0, 0) = columnInRotationMatrix.x;
-         rotation(1, 0) = columnInRotationMatrix.y;
-         rotation(2, 0) = columnInRotationMatrix.z;
-
-         columnInRotationMatrix.Set(eigenvectors[1][0], eigenvectors[1][1], eigenvectors[1][2]);
-         Normalize(columnInRotationMatrix);
-
-         rotation(0, 1) = columnInRotationMatrix.x;
-         rotation(1, 1) = columnInRotationMatrix.y;
-         rotation(2, 1) = columnInRotationMatrix.z;
-
-         columnInRotationMatrix.Set(eigenvectors[2][0], eigenvectors[2][1], eigenvectors[2][2]);
-         Normalize(columnInRotationMatrix);
-
-         rotation(0, 2) = columnInRotationMatrix.x;
-         rotation(1, 2) = columnInRotationMatrix.y;
-         rotation(2, 2) = columnInRotationMatrix.z;
+         rotation(0, column) = eigenvectors[column][0];
+         rotation(1, column) = eigenvectors[column][1];
+         rotation(2, column) = eigenvectors[column][2];
       }
 
       rotationInverse = rotation.TransposedMatrix();
@@ -235,6 +374,11 @@ float OrientedBox::DiagonalLength() const
    return AxisAlignedBox::DiagonalLength();
 }
 
+float OrientedBox::SurfaceArea() const
+{
+   return AxisAlignedBox::SurfaceArea();
+}
+
 void OrientedBox::TransformBy(const Moveable& moveable)
 {
    centroid = moveable.CurrentModelTransformation().MultVertex(centroid);
@@ -281,155 +425,69 @@ bool OrientedBox::Intersects(const OrientedBox& box) const
                                   Dot(parentFrameTranslation, thisAxes[1]),
                                   Dot(parentFrameTranslation, thisAxes[2]) );
 
-   float thisRadiusProjection = 0.0f;
-   float thatRadiusProjection = 0.0f;
-   float projectionThreshold = 0.0f;
+   return ProjectionsOverlap(thisExtents, thatExtents, dotProducts, thisFrameTranslation);
+}
 
-   //projections onto this axes
-   for (unsigned int thisCoordinate = 0; thisCoordinate < 3; ++thisCoordinate)
-   {
-      thisRadiusProjection = thisExtents[thisCoordinate];
+bool OrientedBox::Intersects(const Sphere& sphere, const Moveable& sphereMoveable) const
+{
+   Sphere sphereInBoxSpace(sphereMoveable.CurrentModelTransformation().MultVertex(sphere.center), sphereMoveable.CurrentScale().x * sphere.radius);
 
-      thatRadiusProjection = (thatExtents[0] * fabs(dotProducts[thisCoordinate][0])) +
-                             (thatExtents[1] * fabs(dotProducts[thisCoordinate][1])) +
-                             (thatExtents[2] * fabs(dotProducts[thisCoordinate][2]));
+   sphereInBoxSpace.center = rotationInverse.MultVertex(sphereInBoxSpace.center - centroid);
 
-      projectionThreshold = fabs( thisFrameTranslation[thisCoordinate] );
+   return AxisAlignedBox::Intersects(sphereInBoxSpace);
+}
 
-      if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
-      {
-         return false;
-      }
-   }
+bool OrientedBox::Intersects(const Moveable& thisMoveable, const OrientedBox& other, const Moveable& otherMoveable) const
+{
+   return Intersects(other, RelativeTransformation(thisMoveable, otherMoveable));
+}
 
-   //projections onto that axes
-   for (unsigned int thatCoordinate = 0; thatCoordinate < 3; ++thatCoordinate)
-   {
-      thisRadiusProjection = (thisExtents[0] * fabs(dotProducts[0][thatCoordinate])) +
-                             (thisExtents[1] * fabs(dotProducts[1][thatCoordinate])) +
-                             (thisExtents[2] * fabs(dotProducts[2][thatCoordinate]));
+bool OrientedBox::Intersects(const OrientedBox& other, const RelativeTransformation& relativeTransformation) const
+{
+   //the rows of rotationInverse are the axes of a box in its model space,
+   //so the axes of the other box in the frame of this Moveable are the
+   //rows of other.rotationInverse rotated by otherRotationToThis
+   const Transformation& otherRotationToThis = relativeTransformation.otherRotationToThis;
 
-      thatRadiusProjection = thatExtents[thatCoordinate];
+   float thatAxesInThisFrame[3][3];
 
-      if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
+   for (unsigned int coordinate = 0; coordinate < 3; ++coordinate)
+   {
+      for (unsigned int thatCoordinate = 0; thatCoordinate < 3; ++thatCoordinate)
       {
-         return false;
+         thatAxesInThisFrame[coordinate][thatCoordinate] = (otherRotationToThis(coordinate, 0) * other.rotationInverse(thatCoordinate, 0)) +
+                                                          (otherRotationToThis(coordinate, 1) * other.rotationInverse(thatCoordinate, 1)) +
+                                                          (otherRotationToThis(coordinate, 2) * other.rotationInverse(thatCoordinate, 2));
       }
    }
 
-   //9 cross products
-
-   //this_XAxis x that_XAxis
-   thisRadiusProjection = thisExtents[1] * fabs(dotProducts[2][0]) + thisExtents[2] * fabs(dotProducts[1][0]);
-   thatRadiusProjection = thatExtents[1] * fabs(dotProducts[0][2]) + thatExtents[2] * fabs(dotProducts[0][1]);
-   projectionThreshold = fabs( (thisFrameTranslation[2] * dotProducts[1][0]) - (thisFrameTranslation[1] * dotProducts[2][0]) );
-
-   if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
-   {
-      return false;
-   }
-
-   //this_XAxis x that_YAxis
-   thisRadiusProjection = thisExtents[1] * fabs(dotProducts[2][1]) + thisExtents[2] * fabs(dotProducts[1][1]);
-   thatRadiusProjection = thatExtents[0] * fabs(dotProducts[0][2]) + thatExtents[2] * fabs(dotProducts[0][0]);
-   projectionThreshold = fabs( (thisFrameTranslation[2] * dotProducts[1][1]) - (thisFrameTranslation[1] * dotProducts[2][1]) );
-
-   if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
-   {
-      return false;
-   }
-
-   //this_XAxis x that_ZAxis
-   thisRadiusProjection = thisExtents[1] * fabs(dotProducts[2][2]) + thisExtents[2] * fabs(dotProducts[1][2]);
-   thatRadiusProjection = thatExtents[0] * fabs(dotProducts[0][1]) + thatExtents[1] * fabs(dotProducts[0][0]);
-   projectionThreshold = fabs( thisFrameTranslation[2] * dotProducts[1][2] - thisFrameTranslation[1] * dotProducts[2][2] );
-
-   if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
-   {
-      return false;
-   }
-
-   //this_YAxis x that_XAxis
-   thisRadiusProjection = thisExtents[0] * fabs(dotProducts[2][0]) + thisExtents[2] * fabs(dotProducts[0][0]);
-   thatRadiusProjection = thatExtents[1] * fabs(dotProducts[1][2]) + thatExtents[2] * fabs(dotProducts[1][1]);
-   projectionThreshold = fabs( thisFrameTranslation[0] * dotProducts[2][0] - thisFrameTranslation[2]*dotProducts[0][0] );
-
-   if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
-   {
-      return false;
-   }
-
-   //this_YAxis x that_YAxis
-   thisRadiusProjection = thisExtents[0] * fabs(dotProducts[2][1]) + thisExtents[2] * fabs(dotProducts[0][1]);
-   thatRadiusProjection = thatExtents[0] * fabs(dotProducts[1][2]) + thatExtents[2] * fabs(dotProducts[1][0]);
-   projectionThreshold = fabs( thisFrameTranslation[0] * dotProducts[2][1] - thisFrameTranslation[2] * dotProducts[0][1] );
-
-   if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
-   {
-      return false;
-   }
-
-   //this_YAxis x that_ZAxis
-   thisRadiusProjection = thisExtents[0] * fabs(dotProducts[2][2]) + thisExtents[2] * fabs(dotProducts[0][2]);
-   thatRadiusProjection = thatExtents[0] * fabs(dotProducts[1][1]) + thatExtents[1] * fabs(dotProducts[1][0]);
-   projectionThreshold = fabs( thisFrameTranslation[0] * dotProducts[2][2] - thisFrameTranslation[2] * dotProducts[0][2] );
-
-   if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
-   {
-      return false;
-   }
-
-   //this_ZAxis x that_XAxis
-   thisRadiusProjection = thisExtents[0] * fabs(dotProducts[1][0]) + thisExtents[1] * fabs(dotProducts[0][0]);
-   thatRadiusProjection = thatExtents[1] * fabs(dotProducts[2][2]) + thatExtents[2] * fabs(dotProducts[2][1]);
-   projectionThreshold = fabs( thisFrameTranslation[1] * dotProducts[0][0] - thisFrameTranslation[0] * dotProducts[1][0] );
+   float dotProducts[3][3];
 
-   if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
+   for (unsigned int thisCoordinate = 0; thisCoordinate < 3; ++thisCoordinate)
    {
-      return false;
+      for (unsigned int thatCoordinate = 0; thatCoordinate < 3; ++thatCoordinate)
+      {
+         dotProducts[thisCoordinate][thatCoordinate] = (rotationInverse(thisCoordinate, 0) * thatAxesInThisFrame[0][thatCoordinate]) +
+                                                       (rotationInverse(thisCoordinate, 1) * thatAxesInThisFrame[1][thatCoordinate]) +
+                                                       (rotationInverse(thisCoordinate, 2) * thatAxesInThisFrame[2][thatCoordinate]);
+      }
    }
 
-   //this_ZAxis x that_YAxis
-   thisRadiusProjection = thisExtents[0] * fabs(dotProducts[1][1]) + thisExtents[1] * fabs(dotProducts[0][1]);
-   thatRadiusProjection = thatExtents[0] * fabs(dotProducts[2][2]) + thatExtents[2] * fabs(dotProducts[2][0]);
-   projectionThreshold = fabs( thisFrameTranslation[1] * dotProducts[0][1] - thisFrameTranslation[0] * dotProducts[1][1] );
+   FVector3 thisFrameTranslation = rotationInverse.MultVector(relativeTransformation.otherToThis.MultVertex(other.centroid) - (relativeTransformation.thisScale * centroid));
 
-   if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
-   {
-      return false;
-   }
+   std::array<float, 3> thisExtents;
+   Extents(thisExtents);
 
-   //this_ZAxis x that_ZAxis
-   thisRadiusProjection = thisExtents[0] * fabs(dotProducts[1][2]) + thisExtents[1] * fabs(dotProducts[0][2]);
-   thatRadiusProjection = thatExtents[0] * fabs(dotProducts[2][1]) + thatExtents[1] * fabs(dotProducts[2][0]);
-   projectionThreshold = fabs( thisFrameTranslation[1] * dotProducts[0][2] - thisFrameTranslation[0] * dotProducts[1][2] );
+   std::array<float, 3> thatExtents;
+   other.Extents(thatExtents);
 
-   if (projectionThreshold > (thisRadiusProjection + thatRadiusProjection))
+   for (unsigned int coordinate = 0; coordinate < 3; ++coordinate)
    {
-      return false;
+      thisExtents[coordinate] *= relativeTransformation.thisScale;
+      thatExtents[coordinate] *= relativeTransformation.otherScale;
    }
 
-   return true;
-}
-
-bool OrientedBox::Intersects(const Sphere& sphere, const Moveable& sphereMoveable) const
-{
-   Sphere sphereInBoxSpace(sphereMoveable.CurrentModelTransformation().MultVertex(sphere.center), sphereMoveable.CurrentScale().x * sphere.radius);
-
-   sphereInBoxSpace.center = rotationInverse.MultVertex(sphereInBoxSpace.center - centroid);
-
-   return AxisAlignedBox::Intersects(sphereInBoxSpace);
-}
-
-bool OrientedBox::Intersects(const Moveable& thisMoveable, const OrientedBox& other, const Moveable& otherMoveable) const
-{
-   OrientedBox thisTransformed(*this);
-   thisTransformed.TransformBy(thisMoveable);
-
-   OrientedBox otherTransformed(other);
-   otherTransformed.TransformBy(otherMoveable);
-
-   return thisTransformed.Intersects(otherTransformed);
+   return ProjectionsOverlap(thisExtents, thatExtents, dotProducts, thisFrameTranslation);
 }
 
 bool OrientedBox::Intersects(const AxisAlignedBox& box, const Moveable& boxMoveable) const
@@ -51,20 +51,32 @@ std::vector<FVector3> PointCloud::GetTransformedPositions(const Transformation*
 std::vector<FVector3> PointCloud::GetTransformedPositions(const Transformation& transformation) const
 {
    std::vector<FVector3> transformedPositions;
-      
-   if (positions.size() > 0)
-   {
-      transformedPositions.reserve(positions.size());
 
-      for (const FVector3& position : positions)
-      {
-         transformedPositions.push_back(transformation.MultVertex(position));
-      }
-   }
+   GetTransformedPositions(transformedPositions, &transformation);
 
    return transformedPositions;
 }
 
+void PointCloud::GetTransformedPositions(std::vector<FVector3>& transformedPositions, const Transformation* transformation) const
+{
+   const Transformation& transformationToUse = ((transformation != nullptr) ? *transformation : CurrentModelTransformation());
+
+   transformedPositions.resize(positions.size());
+
+   transformationToUse.MultVertices(positions.data(), positions.size(), transformedPositions.data());
+}
+
+void PointCloud::GetTransformedPositions(std::vector<float>& xs, std::vector<float>& ys, std::vector<float>& zs, const Transformation* transformation) const
+{
+   const Transformation& transformationToUse = ((transformation != nullptr) ? *transformation : CurrentModelTransformation());
+
+   xs.resize(positions.size());
+   ys.resize(positions.size());
+   zs.resize(positions.size());
+
+   transformationToUse.MultVertices(positions.data(), positions.size(), xs.data(), ys.data(), zs.data());
+}
+
 void PointCloud::AddPosition(const FVector3& v)
 {
    positions.push_back(v);
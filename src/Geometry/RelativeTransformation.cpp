@@ -0,0 +1,33 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "Locus/Geometry/RelativeTransformation.h"
+#include "Locus/Geometry/Moveable.h"
+
+namespace Locus
+{
+
+RelativeTransformation::RelativeTransformation(const Moveable& thisMoveable, const Moveable& otherMoveable)
+   : thisMoveable(thisMoveable),
+     otherMoveable(otherMoveable),
+     thisScale(thisMoveable.CurrentScale().x),
+     otherScale(otherMoveable.CurrentScale().x),
+     otherRotationToThis(thisMoveable.CurrentRotation().TransposedMatrix())
+{
+   //the inverse of the rotation and translation of thisMoveable undoes the
+   //translation first and then applies the transposed rotation
+   otherToThis = otherRotationToThis;
+   otherToThis.TranslateBy(-thisMoveable.CurrentTranslation());
+   otherToThis.MultMatrix(otherMoveable.CurrentModelTransformation());
+
+   otherRotationToThis.MultMatrix(otherMoveable.CurrentRotation());
+}
+
+}
\ No newline at end of file
@@ -10,6 +10,7 @@
 
 #include "Locus/Geometry/Sphere.h"
 #include "Locus/Geometry/Moveable.h"
+#include "Locus/Geometry/RelativeTransformation.h"
 #include "Locus/Geometry/Geometry.h"
 #include "Locus/Geometry/Vector3Geometry.h"
 
@@ -67,9 +68,21 @@ bool Sphere::Intersects(const Moveable& thisMoveable, const Sphere& other, const
    return (SquaredNorm(otherMoveable.CurrentModelTransformation().MultVertex(other.center) - thisMoveable.CurrentModelTransformation().MultVertex(center)) <= (radiiSum * radiiSum));
 }
 
+bool Sphere::Intersects(const Sphere& other, const RelativeTransformation& relativeTransformation) const
+{
+   float radiiSum = (radius * relativeTransformation.thisScale) + (other.radius * relativeTransformation.otherScale);
+
+   return (SquaredNorm(relativeTransformation.otherToThis.MultVertex(other.center) - (relativeTransformation.thisScale * center)) <= (radiiSum * radiiSum));
+}
+
 float Sphere::Volume() const
 {
    return ( (4.0f / 3.0f) * PI * radius * radius * radius );
 }
 
+float Sphere::SurfaceArea() const
+{
+   return (4.0f * PI * radius * radius);
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,176 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "SweepAndPruneBroadPhase.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace Locus
+{
+
+std::size_t SweepAndPruneBroadPhase::CollisionPairHash::operator()(const CollisionPair_t& collisionPair) const
+{
+   std::hash<CollisionHandle_t> hasher;
+
+   std::size_t seed = hasher(collisionPair.first);
+   seed ^= hasher(collisionPair.second) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+
+   return seed;
+}
+
+SweepAndPruneBroadPhase::SweepAndPruneBroadPhase(const BroadCollisionExtents& extents)
+   : BroadPhase(extents)
+{
+}
+
+void SweepAndPruneBroadPhase::Rebuild()
+{
+   for (std::size_t axis = 0; axis < BroadCollisionExtents::Num_Axes; ++axis)
+   {
+      std::vector<Endpoint>& endpoints = sortedEndpoints[axis];
+
+      endpoints.clear();
+
+      for (CollisionHandle_t handle = 0, numHandles = extents.owners.size(); handle < numHandles; ++handle)
+      {
+         if (extents.owners[handle] != nullptr)
+         {
+            endpoints.emplace_back(handle, false);
+            endpoints.back().value = extents.mins[axis][handle];
+
+            endpoints.emplace_back(handle, true);
+            endpoints.back().value = extents.maxes[axis][handle];
+         }
+      }
+
+      std::sort(endpoints.begin(), endpoints.end());
+   }
+
+   //rebuild the collision pairs from scratch by sweeping along the x axis.
+   //Subsequent calls to UpdateCollisionPairs maintain them incrementally
+   collisionPairs.clear();
+   collisionPairToIndex.clear();
+
+   activeHandles.clear();
+
+   for (const Endpoint& endpoint : sortedEndpoints[0])
+   {
+      if (endpoint.isMax)
+      {
+         activeHandles.erase(std::find(activeHandles.begin(), activeHandles.end(), endpoint.handle));
+      }
+      else
+      {
+         for (CollisionHandle_t activeHandle : activeHandles)
+         {
+            if (extents.Intersects(endpoint.handle, activeHandle))
+            {
+               AddCollisionPair(endpoint.handle, activeHandle);
+            }
+         }
+
+         activeHandles.push_back(endpoint.handle);
+      }
+   }
+}
+
+void SweepAndPruneBroadPhase::UpdateCollisionPairs()
+{
+   for (std::size_t axis = 0; axis < BroadCollisionExtents::Num_Axes; ++axis)
+   {
+      UpdateCollisionPairs(axis);
+   }
+}
+
+//{CodeReview:BroadPhaseCollisions}
+void SweepAndPruneBroadPhase::UpdateCollisionPairs(std::size_t axis)
+{
+   std::vector<Endpoint>& endpoints = sortedEndpoints[axis];
+
+   const std::vector<float>& mins = extents.mins[axis];
+   const std::vector<float>& maxes = extents.maxes[axis];
+
+   for (Endpoint& endpoint : endpoints)
+   {
+      endpoint.value = (endpoint.isMax ? maxes[endpoint.handle] : mins[endpoint.handle]);
+   }
+
+   //Insertion sort the endpoints. Since objects move a small amount between
+   //frames, the endpoints are nearly sorted already. Each swap of two endpoints
+   //is the only way the intersection status of two extents on this axis can
+   //change, so the collision pairs are updated only when a swap occurs.
+
+   for (std::size_t i = 1, numEndpoints = endpoints.size(); i < numEndpoints; ++i)
+   {
+      Endpoint endpoint = endpoints[i];
+
+      std::size_t j = i;
+
+      while ((j > 0) && (endpoint < endpoints[j - 1]))
+      {
+         const Endpoint& otherEndpoint = endpoints[j - 1];
+
+         if (endpoint.isMax != otherEndpoint.isMax)
+         {
+            if (!endpoint.isMax)
+            {
+               //a min moved below a max, so the extents started intersecting on this axis
+               if (extents.Intersects(endpoint.handle, otherEndpoint.handle))
+               {
+                  AddCollisionPair(endpoint.handle, otherEndpoint.handle);
+               }
+            }
+            else
+            {
+               //a max moved below a min, so the extents stopped intersecting on this axis
+               RemoveCollisionPair(endpoint.handle, otherEndpoint.handle);
+            }
+         }
+
+         endpoints[j] = otherEndpoint;
+         --j;
+      }
+
+      endpoints[j] = endpoint;
+   }
+}
+
+void SweepAndPruneBroadPhase::AddCollisionPair(CollisionHandle_t handle1, CollisionHandle_t handle2)
+{
+   CollisionPair_t collisionPair = MakeCollisionPair(handle1, handle2);
+
+   if (collisionPairToIndex.emplace(collisionPair, collisionPairs.size()).second)
+   {
+      collisionPairs.push_back(collisionPair);
+   }
+}
+
+void SweepAndPruneBroadPhase::RemoveCollisionPair(CollisionHandle_t handle1, CollisionHandle_t handle2)
+{
+   auto pairIter = collisionPairToIndex.find( MakeCollisionPair(handle1, handle2) );
+
+   if (pairIter != collisionPairToIndex.end())
+   {
+      std::size_t index = pairIter->second;
+
+      collisionPairToIndex.erase(pairIter);
+
+      if (index != collisionPairs.size() - 1)
+      {
+         collisionPairs[index] = collisionPairs.back();
+         collisionPairToIndex[collisionPairs[index]] = index;
+      }
+
+      collisionPairs.pop_back();
+   }
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include "BroadPhase.h"
+
+#include <unordered_map>
+
+namespace Locus
+{
+
+//{CodeReview:BroadPhaseCollisions}
+/*!
+ * \brief Finds intersecting extents by keeping the interval
+ * endpoints sorted along each axis.
+ *
+ * \details The collision pairs are maintained incrementally.
+ * Pairs are only added or removed when endpoints pass each
+ * other, so the cost of an update depends on how far the
+ * extents moved rather than on the number of extents squared.
+ * It degrades when many extents overlap along one axis.
+ */
+class SweepAndPruneBroadPhase : public BroadPhase
+{
+public:
+   SweepAndPruneBroadPhase(const BroadCollisionExtents& extents);
+
+   virtual void Rebuild() override;
+   virtual void UpdateCollisionPairs() override;
+
+private:
+   /*!
+    * \brief One end of an extent on a sorted axis.
+    *
+    * \details The value is a copy of the min or max of
+    * the extent so that the sort runs over contiguous
+    * memory. When two endpoints have the same value, the
+    * min endpoint is ordered first so that touching
+    * extents are considered to be intersecting.
+    */
+   struct Endpoint
+   {
+      Endpoint(CollisionHandle_t handle, bool isMax)
+         : value(0.0f), handle(handle), isMax(isMax)
+      {
+      }
+
+      bool operator <(const Endpoint& other) const
+      {
+         return ((value < other.value) || ((value == other.value) && !isMax && other.isMax));
+      }
+
+      float value;
+      CollisionHandle_t handle;
+      bool isMax;
+   };
+
+   struct CollisionPairHash
+   {
+      std::size_t operator()(const CollisionPair_t& collisionPair) const;
+   };
+
+   std::array<std::vector<Endpoint>, BroadCollisionExtents::Num_Axes> sortedEndpoints;
+
+   //maps a pair to its index in collisionPairs
+   std::unordered_map<CollisionPair_t, std::size_t, CollisionPairHash> collisionPairToIndex;
+
+   std::vector<CollisionHandle_t> activeHandles;
+
+   void UpdateCollisionPairs(std::size_t axis);
+
+   void AddCollisionPair(CollisionHandle_t handle1, CollisionHandle_t handle2);
+   void RemoveCollisionPair(CollisionHandle_t handle1, CollisionHandle_t handle2);
+};
+
+}
\ No newline at end of file
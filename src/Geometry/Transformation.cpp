@@ -13,38 +13,61 @@
 
 #include "Locus/Common/Float.h"
 
+#include "BatchTransform.h"
+
+#include <algorithm>
+#include <utility>
+
 #include <cmath>
 #include <cassert>
 
 namespace Locus
 {
 
-Transformation::Transformation()
-   : Matrix<float>(4, 4)
+//the batch functions treat arrays of FVector3 as consecutive x, y, z triples
+static_assert(sizeof(FVector3) == 3 * sizeof(float), "FVector3 must be tightly packed");
+
+//result must not alias either operand
+static void Multiply(const float* left, const float* right, float* result)
 {
-   SetMainDiagonal(1.0f);
+   for (std::size_t col = 0; col < 4; ++col)
+   {
+      const float* rightColumn = right + col * 4;
+      float* resultColumn = result + col * 4;
+
+      resultColumn[0] = left[0] * rightColumn[0] + left[4] * rightColumn[1] + left[8]  * rightColumn[2] + left[12] * rightColumn[3];
+      resultColumn[1] = left[1] * rightColumn[0] + left[5] * rightColumn[1] + left[9]  * rightColumn[2] + left[13] * rightColumn[3];
+      resultColumn[2] = left[2] * rightColumn[0] + left[6] * rightColumn[1] + left[10] * rightColumn[2] + left[14] * rightColumn[3];
+      resultColumn[3] = left[3] * rightColumn[0] + left[7] * rightColumn[1] + left[11] * rightColumn[2] + left[15] * rightColumn[3];
+   }
 }
 
-Transformation::Transformation(float m0, float m4, float m8,  float m12,
-                               float m1, float m5, float m9,  float m13,
-                               float m2, float m6, float m10, float m14,
-                               float m3, float m7, float m11, float m15)
-   : Matrix<float>(4, 4, { m0, m4, m8,  m12,
-                           m1, m5, m9,  m13,
-                           m2, m6, m10, m14,
-                           m3, m7, m11, m15 })
+Transformation::Transformation(const Matrix<float>& matrix)
 {
+   *this = matrix;
 }
 
 Transformation& Transformation::operator=(const Matrix<float>& matrix)
 {
    assert((matrix.Rows() == 4) && (matrix.Columns() == 4));
 
-   Matrix<float>::operator=(matrix);
+   const std::vector<float>& columnMajorValues = matrix.GetElements();
+
+   std::copy(columnMajorValues.begin(), columnMajorValues.end(), elements.begin());
 
    return *this;
 }
 
+Matrix<float> Transformation::ToMatrix() const
+{
+   const Elements_t& e = elements;
+
+   return Matrix<float>(4, 4, { e[0], e[4], e[8],  e[12],
+                                e[1], e[5], e[9],  e[13],
+                                e[2], e[6], e[10], e[14],
+                                e[3], e[7], e[11], e[15] });
+}
+
 const FVector3& Transformation::IdentityScale()
 {
    static FVector3 identityScale(1.0f, 1.0f, 1.0f);
@@ -129,9 +152,117 @@ Transformation Transformation::Orthographic(float left, float right, float botto
 
 }
 
+void Transformation::SetToIdentity()
+{
+   *this = Identity();
+}
+
+std::array<float, 9> Transformation::GetUpperLeftElements() const
+{
+   return std::array<float, 9>{{ elements[0], elements[1], elements[2],
+                                 elements[4], elements[5], elements[6],
+                                 elements[8], elements[9], elements[10] }};
+}
+
+Transformation Transformation::TransposedMatrix() const
+{
+   const Elements_t& e = elements;
+
+   return Transformation(e[0],  e[1],  e[2],  e[3],
+                         e[4],  e[5],  e[6],  e[7],
+                         e[8],  e[9],  e[10], e[11],
+                         e[12], e[13], e[14], e[15]);
+}
+
+void Transformation::Transpose()
+{
+   std::swap(elements[1],  elements[4]);
+   std::swap(elements[2],  elements[8]);
+   std::swap(elements[3],  elements[12]);
+   std::swap(elements[6],  elements[9]);
+   std::swap(elements[7],  elements[13]);
+   std::swap(elements[11], elements[14]);
+}
+
+void Transformation::MultMatrix(const Transformation& otherTransformation)
+{
+   Elements_t result;
+
+   Multiply(elements.data(), otherTransformation.elements.data(), result.data());
+
+   elements = result;
+}
+
+Transformation operator*(const Transformation& transformationLeft, const Transformation& transformationRight)
+{
+   Transformation result(transformationLeft);
+
+   result.MultMatrix(transformationRight);
+
+   return result;
+}
+
+bool Transformation::Invert()
+{
+   //inverse by cofactor expansion: the adjugate is built from the 2 x 2
+   //minors of the top two rows and of the bottom two rows
+   const Elements_t& m = elements;
+
+   float s0 = m[0] * m[5]  - m[1]  * m[4];
+   float s1 = m[0] * m[9]  - m[1]  * m[8];
+   float s2 = m[0] * m[13] - m[1]  * m[12];
+   float s3 = m[4] * m[9]  - m[5]  * m[8];
+   float s4 = m[4] * m[13] - m[5]  * m[12];
+   float s5 = m[8] * m[13] - m[9]  * m[12];
+
+   float c5 = m[10] * m[15] - m[11] * m[14];
+   float c4 = m[6]  * m[15] - m[7]  * m[14];
+   float c3 = m[6]  * m[11] - m[7]  * m[10];
+   float c2 = m[2]  * m[15] - m[3]  * m[14];
+   float c1 = m[2]  * m[11] - m[3]  * m[10];
+   float c0 = m[2]  * m[7]  - m[3]  * m[6];
+
+   float determinant = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+
+   //the determinant scales with the cube of the scale factors, so a
+   //fixed tolerance would reject small but perfectly valid transformations
+   if (FIsZero<float>(determinant, NO_TOLERANCE))
+   {
+      return false;
+   }
+
+   float inverseDeterminant = 1.0f / determinant;
+
+   Elements_t inverse;
+
+   inverse[0]  = ( m[5]  * c5 - m[9]  * c4 + m[13] * c3) * inverseDeterminant;
+   inverse[4]  = (-m[4]  * c5 + m[8]  * c4 - m[12] * c3) * inverseDeterminant;
+   inverse[8]  = ( m[7]  * s5 - m[11] * s4 + m[15] * s3) * inverseDeterminant;
+   inverse[12] = (-m[6]  * s5 + m[10] * s4 - m[14] * s3) * inverseDeterminant;
+
+   inverse[1]  = (-m[1]  * c5 + m[9]  * c2 - m[13] * c1) * inverseDeterminant;
+   inverse[5]  = ( m[0]  * c5 - m[8]  * c2 + m[12] * c1) * inverseDeterminant;
+   inverse[9]  = (-m[3]  * s5 + m[11] * s2 - m[15] * s1) * inverseDeterminant;
+   inverse[13] = ( m[2]  * s5 - m[10] * s2 + m[14] * s1) * inverseDeterminant;
+
+   inverse[2]  = ( m[1]  * c4 - m[5]  * c2 + m[13] * c0) * inverseDeterminant;
+   inverse[6]  = (-m[0]  * c4 + m[4]  * c2 - m[12] * c0) * inverseDeterminant;
+   inverse[10] = ( m[3]  * s4 - m[7]  * s2 + m[15] * s0) * inverseDeterminant;
+   inverse[14] = (-m[2]  * s4 + m[6]  * s2 - m[14] * s0) * inverseDeterminant;
+
+   inverse[3]  = (-m[1]  * c3 + m[5]  * c1 - m[9]  * c0) * inverseDeterminant;
+   inverse[7]  = ( m[0]  * c3 - m[4]  * c1 + m[8]  * c0) * inverseDeterminant;
+   inverse[11] = (-m[3]  * s3 + m[7]  * s1 - m[11] * s0) * inverseDeterminant;
+   inverse[15] = ( m[2]  * s3 - m[6]  * s1 + m[10] * s0) * inverseDeterminant;
+
+   elements = inverse;
+
+   return true;
+}
+
 FVector3 Transformation::MultVector(const FVector3& v) const
 {
-   const std::vector<float>& columnMajorValues = GetElements();
+   const Elements_t& columnMajorValues = elements;
 
    return FVector3(columnMajorValues[0] * v.x + columnMajorValues[4] * v.y + columnMajorValues[8]  * v.z,
                    columnMajorValues[1] * v.x + columnMajorValues[5] * v.y + columnMajorValues[9]  * v.z,
@@ -140,13 +271,40 @@ FVector3 Transformation::MultVector(const FVector3& v) const
 
 FVector3 Transformation::MultVertex(const FVector3& v) const
 {
-   const std::vector<float>& columnMajorValues = GetElements();
+   const Elements_t& columnMajorValues = elements;
 
    return FVector3(columnMajorValues[0] * v.x + columnMajorValues[4] * v.y + columnMajorValues[8]  * v.z + columnMajorValues[12],
                    columnMajorValues[1] * v.x + columnMajorValues[5] * v.y + columnMajorValues[9]  * v.z + columnMajorValues[13],
                    columnMajorValues[2] * v.x + columnMajorValues[6] * v.y + columnMajorValues[10] * v.z + columnMajorValues[14]);
 }
 
+void Transformation::MultVectors(const FVector3* vectors, std::size_t numVectors, FVector3* result) const
+{
+   //a direction is transformed like a position with the translation removed
+   Elements_t elementsWithoutTranslation = elements;
+
+   elementsWithoutTranslation[12] = 0.0f;
+   elementsWithoutTranslation[13] = 0.0f;
+   elementsWithoutTranslation[14] = 0.0f;
+
+   BatchTransform::MultVertices(elementsWithoutTranslation.data(), reinterpret_cast<const float*>(vectors), numVectors, reinterpret_cast<float*>(result));
+}
+
+void Transformation::MultVertices(const FVector3* vertices, std::size_t numVertices, FVector3* result) const
+{
+   BatchTransform::MultVertices(elements.data(), reinterpret_cast<const float*>(vertices), numVertices, reinterpret_cast<float*>(result));
+}
+
+void Transformation::MultVertices(const FVector3* vertices, std::size_t numVertices, float* resultXs, float* resultYs, float* resultZs) const
+{
+   BatchTransform::MultVertices(elements.data(), reinterpret_cast<const float*>(vertices), numVertices, resultXs, resultYs, resultZs);
+}
+
+void Transformation::MultVertices(const float* xs, const float* ys, const float* zs, std::size_t numVertices, float* resultXs, float* resultYs, float* resultZs) const
+{
+   BatchTransform::MultVertices(elements.data(), xs, ys, zs, numVertices, resultXs, resultYs, resultZs);
+}
+
 void Transformation::TranslateBy(const FVector3& t)
 {
    MultMatrix( Transformation::Translation(t) );
@@ -154,10 +312,7 @@ void Transformation::TranslateBy(const FVector3& t)
 
 void Transformation::InverseTranslateBy(const FVector3& t)
 {
-   Transformation translationInverseResult = Transformation::Translation(-t);
-   translationInverseResult.MultMatrix(*this);
-
-   *this = translationInverseResult;
+   *this = Transformation::Translation(-t) * (*this);
 }
 
 void Transformation::RotateBy(const FVector3& rotation)
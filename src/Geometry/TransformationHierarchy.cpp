@@ -0,0 +1,171 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "Locus/Geometry/TransformationHierarchy.h"
+
+#include "Locus/Common/ThreadPool.h"
+
+#include <cassert>
+
+namespace Locus
+{
+
+const TransformationNode_t TransformationHierarchy::No_Parent;
+
+TransformationHierarchy::TransformationHierarchy()
+{
+}
+
+TransformationNode_t TransformationHierarchy::AddNode(TransformationNode_t parent)
+{
+   assert((parent == No_Parent) || (parent < parents.size()));
+
+   TransformationNode_t node = parents.size();
+
+   unsigned int depth = ((parent == No_Parent) ? 0 : depths[parent] + 1);
+
+   parents.push_back(parent);
+   depths.push_back(depth);
+   locals.emplace_back();
+   worldTransformations.push_back((parent == No_Parent) ? Transformation::Identity() : worldTransformations[parent]);
+   dirty.push_back(0);
+
+   if (depth >= levels.size())
+   {
+      levels.resize(depth + 1);
+   }
+
+   levels[depth].push_back(node);
+
+   return node;
+}
+
+void TransformationHierarchy::Clear()
+{
+   parents.clear();
+   depths.clear();
+   locals.clear();
+   worldTransformations.clear();
+   dirty.clear();
+   levels.clear();
+}
+
+std::size_t TransformationHierarchy::Size() const
+{
+   return parents.size();
+}
+
+TransformationNode_t TransformationHierarchy::GetParent(TransformationNode_t node) const
+{
+   return parents[node];
+}
+
+unsigned int TransformationHierarchy::GetDepth(TransformationNode_t node) const
+{
+   return depths[node];
+}
+
+void TransformationHierarchy::Translate(TransformationNode_t node, const FVector3& translation)
+{
+   locals[node].Translate(translation);
+   dirty[node] = 1;
+}
+
+void TransformationHierarchy::Rotate(TransformationNode_t node, const FVector3& rotation)
+{
+   locals[node].Rotate(rotation);
+   dirty[node] = 1;
+}
+
+void TransformationHierarchy::Scale(TransformationNode_t node, const FVector3& scale)
+{
+   locals[node].Scale(scale);
+   dirty[node] = 1;
+}
+
+void TransformationHierarchy::Reset(TransformationNode_t node, const FVector3& position, const Transformation& rotationTransformation, const FVector3& scale)
+{
+   locals[node].Reset(position, rotationTransformation, scale);
+   dirty[node] = 1;
+}
+
+const Moveable& TransformationHierarchy::GetLocal(TransformationNode_t node) const
+{
+   return locals[node];
+}
+
+void TransformationHierarchy::UpdateNode(TransformationNode_t node)
+{
+   TransformationNode_t parent = parents[node];
+
+   if ((parent != No_Parent) && dirty[parent])
+   {
+      dirty[node] = 1;
+   }
+
+   if (dirty[node])
+   {
+      if (parent == No_Parent)
+      {
+         worldTransformations[node] = locals[node].CurrentModelTransformation();
+      }
+      else
+      {
+         worldTransformations[node] = worldTransformations[parent];
+         worldTransformations[node].MultMatrix(locals[node].CurrentModelTransformation());
+      }
+   }
+}
+
+void TransformationHierarchy::Update(ThreadPool* threadPool)
+{
+   std::size_t numNodes = parents.size();
+
+   if (threadPool == nullptr)
+   {
+      //parents come before their children, so one pass in order sees
+      //every parent's final world transformation before its children
+      for (TransformationNode_t node = 0; node < numNodes; ++node)
+      {
+         UpdateNode(node);
+      }
+   }
+   else
+   {
+      for (const std::vector<TransformationNode_t>& level : levels)
+      {
+         threadPool->ParallelFor(level.size(), 0, [this, &level](std::size_t begin, std::size_t end)
+         {
+            for (std::size_t levelIndex = begin; levelIndex < end; ++levelIndex)
+            {
+               UpdateNode(level[levelIndex]);
+            }
+         });
+      }
+   }
+
+   //the flags of the parents were needed until every node was visited
+   for (char& nodeDirty : dirty)
+   {
+      nodeDirty = 0;
+   }
+}
+
+const Transformation& TransformationHierarchy::GetWorldTransformation(TransformationNode_t node) const
+{
+   return worldTransformations[node];
+}
+
+const std::vector<Transformation>& TransformationHierarchy::GetWorldTransformations() const
+{
+   return worldTransformations;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,601 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "Locus/Geometry/TriangleBatch.h"
+#include "Locus/Geometry/Triangle.h"
+
+#include "InstructionSet.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <cassert>
+
+namespace Locus
+{
+
+//the planes of two triangles are treated as parallel when the squared sine
+//of the angle between them is below this. Such triangles are tested as coplanar
+static const float Parallel_Sine_Squared_Tolerance = 1e-10f;
+
+static const float Infinity = std::numeric_limits<float>::infinity();
+
+/// The triangle that every candidate is tested against, with its plane n . p + d = 0.
+struct BatchTriangleSetup
+{
+   float xs[3];
+   float ys[3];
+   float zs[3];
+
+   float nx, ny, nz, d;
+
+   /// Parallel_Sine_Squared_Tolerance * (n . n)
+   float parallelThreshold;
+};
+
+static float Dot(float ax, float ay, float az, float bx, float by, float bz)
+{
+   return ax * bx + ay * by + az * bz;
+}
+
+static BatchTriangleSetup SetupTriangle(const PlainTriangle3D& triangle)
+{
+   BatchTriangleSetup setup;
+
+   for (int pointIndex = 0; pointIndex < 3; ++pointIndex)
+   {
+      setup.xs[pointIndex] = triangle.points[pointIndex].x;
+      setup.ys[pointIndex] = triangle.points[pointIndex].y;
+      setup.zs[pointIndex] = triangle.points[pointIndex].z;
+   }
+
+   float e1x = setup.xs[1] - setup.xs[0], e1y = setup.ys[1] - setup.ys[0], e1z = setup.zs[1] - setup.zs[0];
+   float e2x = setup.xs[2] - setup.xs[0], e2y = setup.ys[2] - setup.ys[0], e2z = setup.zs[2] - setup.zs[0];
+
+   setup.nx = e1y * e2z - e1z * e2y;
+   setup.ny = e1z * e2x - e1x * e2z;
+   setup.nz = e1x * e2y - e1y * e2x;
+
+   setup.d = -Dot(setup.nx, setup.ny, setup.nz, setup.xs[0], setup.ys[0], setup.zs[0]);
+
+   setup.parallelThreshold = Parallel_Sine_Squared_Tolerance * Dot(setup.nx, setup.ny, setup.nz, setup.nx, setup.ny, setup.nz);
+
+   return setup;
+}
+
+/////////////////////////////////////////Scalar/////////////////////////////////////////
+
+//The SSE2 and AVX kernels below evaluate the same expressions in the same
+//order, one candidate per lane, so every path gives identical answers.
+//
+//For candidates that are not rejected by the plane side tests, each triangle
+//crosses the line where the two planes meet over an interval. Points are
+//projected onto that line's direction D = n1 x n2, and the triangles intersect
+//when the intervals overlap. A vertex on the other plane contributes itself to
+//the interval, and an edge that crosses the other plane contributes its
+//crossing point.
+
+static bool AllOnOneSide(float d0, float d1, float d2)
+{
+   return ((d0 > 0) && (d1 > 0) && (d2 > 0)) || ((d0 < 0) && (d1 < 0) && (d2 < 0));
+}
+
+static void IncludeVertex(float d, float p, float& low, float& high)
+{
+   if (d == 0)
+   {
+      low = std::min(low, p);
+      high = std::max(high, p);
+   }
+}
+
+static void IncludeCrossing(float di, float dj, float pi, float pj, float& low, float& high)
+{
+   if (((di < 0) && (dj > 0)) || ((di > 0) && (dj < 0)))
+   {
+      float crossing = pi + (pj - pi) * (di / (di - dj));
+
+      low = std::min(low, crossing);
+      high = std::max(high, crossing);
+   }
+}
+
+static void ComputeInterval(float d0, float d1, float d2, float p0, float p1, float p2, float& low, float& high)
+{
+   low = Infinity;
+   high = -Infinity;
+
+   IncludeVertex(d0, p0, low, high);
+   IncludeVertex(d1, p1, low, high);
+   IncludeVertex(d2, p2, low, high);
+
+   IncludeCrossing(d0, d1, p0, p1, low, high);
+   IncludeCrossing(d1, d2, p1, p2, low, high);
+   IncludeCrossing(d2, d0, p2, p0, low, high);
+}
+
+//coordinates holds the nine coordinate arrays of the candidates. Sets bit 0 of
+//hitMask if the candidate at index first intersects, or bit 0 of coplanarMask
+//if it has to be tested with CoplanarTriangleIntersection instead
+static void TestCandidatesScalar(const BatchTriangleSetup& a, const float* const* coordinates, std::size_t first, unsigned int& hitMask, unsigned int& coplanarMask)
+{
+   float qx0 = coordinates[0][first], qy0 = coordinates[1][first], qz0 = coordinates[2][first];
+   float qx1 = coordinates[3][first], qy1 = coordinates[4][first], qz1 = coordinates[5][first];
+   float qx2 = coordinates[6][first], qy2 = coordinates[7][first], qz2 = coordinates[8][first];
+
+   float e1x = qx1 - qx0, e1y = qy1 - qy0, e1z = qz1 - qz0;
+   float e2x = qx2 - qx0, e2y = qy2 - qy0, e2z = qz2 - qz0;
+
+   float nx = e1y * e2z - e1z * e2y;
+   float ny = e1z * e2x - e1x * e2z;
+   float nz = e1x * e2y - e1y * e2x;
+
+   float d = -Dot(nx, ny, nz, qx0, qy0, qz0);
+
+   float da0 = Dot(nx, ny, nz, a.xs[0], a.ys[0], a.zs[0]) + d;
+   float da1 = Dot(nx, ny, nz, a.xs[1], a.ys[1], a.zs[1]) + d;
+   float da2 = Dot(nx, ny, nz, a.xs[2], a.ys[2], a.zs[2]) + d;
+
+   float db0 = Dot(a.nx, a.ny, a.nz, qx0, qy0, qz0) + a.d;
+   float db1 = Dot(a.nx, a.ny, a.nz, qx1, qy1, qz1) + a.d;
+   float db2 = Dot(a.nx, a.ny, a.nz, qx2, qy2, qz2) + a.d;
+
+   hitMask = 0;
+   coplanarMask = 0;
+
+   if (AllOnOneSide(da0, da1, da2) || AllOnOneSide(db0, db1, db2))
+   {
+      return;
+   }
+
+   float dx = a.ny * nz - a.nz * ny;
+   float dy = a.nz * nx - a.nx * nz;
+   float dz = a.nx * ny - a.ny * nx;
+
+   if (Dot(dx, dy, dz, dx, dy, dz) <= a.parallelThreshold * Dot(nx, ny, nz, nx, ny, nz))
+   {
+      coplanarMask = 1;
+      return;
+   }
+
+   float lowA, highA, lowB, highB;
+
+   ComputeInterval(da0, da1, da2,
+                   Dot(dx, dy, dz, a.xs[0], a.ys[0], a.zs[0]), Dot(dx, dy, dz, a.xs[1], a.ys[1], a.zs[1]), Dot(dx, dy, dz, a.xs[2], a.ys[2], a.zs[2]),
+                   lowA, highA);
+
+   ComputeInterval(db0, db1, db2,
+                   Dot(dx, dy, dz, qx0, qy0, qz0), Dot(dx, dy, dz, qx1, qy1, qz1), Dot(dx, dy, dz, qx2, qy2, qz2),
+                   lowB, highB);
+
+   if ((highA >= lowB) && (highB >= lowA))
+   {
+      hitMask = 1;
+   }
+}
+
+#ifdef LOCUS_X86
+
+/////////////////////////////////////////SSE2/////////////////////////////////////////
+
+static LOCUS_TARGET_SSE2 __m128 DotSSE2(__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz)
+{
+   return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+}
+
+static LOCUS_TARGET_SSE2 __m128 SelectSSE2(__m128 mask, __m128 ifTrue, __m128 ifFalse)
+{
+   return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+}
+
+static LOCUS_TARGET_SSE2 __m128 AllOnOneSideSSE2(__m128 d0, __m128 d1, __m128 d2)
+{
+   __m128 zero = _mm_setzero_ps();
+
+   __m128 allPositive = _mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(d0, zero), _mm_cmpgt_ps(d1, zero)), _mm_cmpgt_ps(d2, zero));
+   __m128 allNegative = _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(d0, zero), _mm_cmplt_ps(d1, zero)), _mm_cmplt_ps(d2, zero));
+
+   return _mm_or_ps(allPositive, allNegative);
+}
+
+static LOCUS_TARGET_SSE2 void IncludeSSE2(__m128 mask, __m128 p, __m128& low, __m128& high)
+{
+   low = _mm_min_ps(low, SelectSSE2(mask, p, _mm_set1_ps(Infinity)));
+   high = _mm_max_ps(high, SelectSSE2(mask, p, _mm_set1_ps(-Infinity)));
+}
+
+static LOCUS_TARGET_SSE2 void IncludeCrossingSSE2(__m128 di, __m128 dj, __m128 pi, __m128 pj, __m128& low, __m128& high)
+{
+   __m128 zero = _mm_setzero_ps();
+
+   __m128 crosses = _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(di, zero), _mm_cmpgt_ps(dj, zero)),
+                              _mm_and_ps(_mm_cmpgt_ps(di, zero), _mm_cmplt_ps(dj, zero)));
+
+   __m128 crossing = _mm_add_ps(pi, _mm_mul_ps(_mm_sub_ps(pj, pi), _mm_div_ps(di, _mm_sub_ps(di, dj))));
+
+   IncludeSSE2(crosses, crossing, low, high);
+}
+
+static LOCUS_TARGET_SSE2 void ComputeIntervalSSE2(__m128 d0, __m128 d1, __m128 d2, __m128 p0, __m128 p1, __m128 p2, __m128& low, __m128& high)
+{
+   __m128 zero = _mm_setzero_ps();
+
+   low = _mm_set1_ps(Infinity);
+   high = _mm_set1_ps(-Infinity);
+
+   IncludeSSE2(_mm_cmpeq_ps(d0, zero), p0, low, high);
+   IncludeSSE2(_mm_cmpeq_ps(d1, zero), p1, low, high);
+   IncludeSSE2(_mm_cmpeq_ps(d2, zero), p2, low, high);
+
+   IncludeCrossingSSE2(d0, d1, p0, p1, low, high);
+   IncludeCrossingSSE2(d1, d2, p1, p2, low, high);
+   IncludeCrossingSSE2(d2, d0, p2, p0, low, high);
+}
+
+static LOCUS_TARGET_SSE2 void TestCandidatesSSE2(const BatchTriangleSetup& a, const float* const* coordinates, std::size_t first, unsigned int& hitMask, unsigned int& coplanarMask)
+{
+   __m128 ax[3] = { _mm_set1_ps(a.xs[0]), _mm_set1_ps(a.xs[1]), _mm_set1_ps(a.xs[2]) };
+   __m128 ay[3] = { _mm_set1_ps(a.ys[0]), _mm_set1_ps(a.ys[1]), _mm_set1_ps(a.ys[2]) };
+   __m128 az[3] = { _mm_set1_ps(a.zs[0]), _mm_set1_ps(a.zs[1]), _mm_set1_ps(a.zs[2]) };
+
+   __m128 anx = _mm_set1_ps(a.nx), any = _mm_set1_ps(a.ny), anz = _mm_set1_ps(a.nz), ad = _mm_set1_ps(a.d);
+
+   __m128 qx0 = _mm_loadu_ps(coordinates[0] + first), qy0 = _mm_loadu_ps(coordinates[1] + first), qz0 = _mm_loadu_ps(coordinates[2] + first);
+   __m128 qx1 = _mm_loadu_ps(coordinates[3] + first), qy1 = _mm_loadu_ps(coordinates[4] + first), qz1 = _mm_loadu_ps(coordinates[5] + first);
+   __m128 qx2 = _mm_loadu_ps(coordinates[6] + first), qy2 = _mm_loadu_ps(coordinates[7] + first), qz2 = _mm_loadu_ps(coordinates[8] + first);
+
+   __m128 e1x = _mm_sub_ps(qx1, qx0), e1y = _mm_sub_ps(qy1, qy0), e1z = _mm_sub_ps(qz1, qz0);
+   __m128 e2x = _mm_sub_ps(qx2, qx0), e2y = _mm_sub_ps(qy2, qy0), e2z = _mm_sub_ps(qz2, qz0);
+
+   __m128 nx = _mm_sub_ps(_mm_mul_ps(e1y, e2z), _mm_mul_ps(e1z, e2y));
+   __m128 ny = _mm_sub_ps(_mm_mul_ps(e1z, e2x), _mm_mul_ps(e1x, e2z));
+   __m128 nz = _mm_sub_ps(_mm_mul_ps(e1x, e2y), _mm_mul_ps(e1y, e2x));
+
+   __m128 d = _mm_xor_ps(DotSSE2(nx, ny, nz, qx0, qy0, qz0), _mm_set1_ps(-0.0f));
+
+   __m128 da0 = _mm_add_ps(DotSSE2(nx, ny, nz, ax[0], ay[0], az[0]), d);
+   __m128 da1 = _mm_add_ps(DotSSE2(nx, ny, nz, ax[1], ay[1], az[1]), d);
+   __m128 da2 = _mm_add_ps(DotSSE2(nx, ny, nz, ax[2], ay[2], az[2]), d);
+
+   __m128 db0 = _mm_add_ps(DotSSE2(anx, any, anz, qx0, qy0, qz0), ad);
+   __m128 db1 = _mm_add_ps(DotSSE2(anx, any, anz, qx1, qy1, qz1), ad);
+   __m128 db2 = _mm_add_ps(DotSSE2(anx, any, anz, qx2, qy2, qz2), ad);
+
+   __m128 rejected = _mm_or_ps(AllOnOneSideSSE2(da0, da1, da2), AllOnOneSideSSE2(db0, db1, db2));
+
+   int rejectedBits = _mm_movemask_ps(rejected);
+
+   if (rejectedBits == 0xF)
+   {
+      hitMask = 0;
+      coplanarMask = 0;
+      return;
+   }
+
+   __m128 dx = _mm_sub_ps(_mm_mul_ps(any, nz), _mm_mul_ps(anz, ny));
+   __m128 dy = _mm_sub_ps(_mm_mul_ps(anz, nx), _mm_mul_ps(anx, nz));
+   __m128 dz = _mm_sub_ps(_mm_mul_ps(anx, ny), _mm_mul_ps(any, nx));
+
+   __m128 parallel = _mm_cmple_ps(DotSSE2(dx, dy, dz, dx, dy, dz), _mm_mul_ps(_mm_set1_ps(a.parallelThreshold), DotSSE2(nx, ny, nz, nx, ny, nz)));
+
+   __m128 lowA, highA, lowB, highB;
+
+   ComputeIntervalSSE2(da0, da1, da2,
+                       DotSSE2(dx, dy, dz, ax[0], ay[0], az[0]), DotSSE2(dx, dy, dz, ax[1], ay[1], az[1]), DotSSE2(dx, dy, dz, ax[2], ay[2], az[2]),
+                       lowA, highA);
+
+   ComputeIntervalSSE2(db0, db1, db2,
+                       DotSSE2(dx, dy, dz, qx0, qy0, qz0), DotSSE2(dx, dy, dz, qx1, qy1, qz1), DotSSE2(dx, dy, dz, qx2, qy2, qz2),
+                       lowB, highB);
+
+   __m128 overlaps = _mm_and_ps(_mm_cmpge_ps(highA, lowB), _mm_cmpge_ps(highB, lowA));
+
+   int parallelBits = _mm_movemask_ps(parallel) & ~rejectedBits;
+
+   hitMask = static_cast<unsigned int>(_mm_movemask_ps(overlaps) & ~rejectedBits & ~parallelBits);
+   coplanarMask = static_cast<unsigned int>(parallelBits);
+}
+
+/////////////////////////////////////////AVX/////////////////////////////////////////
+
+static LOCUS_TARGET_AVX __m256 DotAVX(__m256 ax, __m256 ay, __m256 az, __m256 bx, __m256 by, __m256 bz)
+{
+   return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax, bx), _mm256_mul_ps(ay, by)), _mm256_mul_ps(az, bz));
+}
+
+static LOCUS_TARGET_AVX __m256 AllOnOneSideAVX(__m256 d0, __m256 d1, __m256 d2)
+{
+   __m256 zero = _mm256_setzero_ps();
+
+   __m256 allPositive = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(d0, zero, _CMP_GT_OQ), _mm256_cmp_ps(d1, zero, _CMP_GT_OQ)), _mm256_cmp_ps(d2, zero, _CMP_GT_OQ));
+   __m256 allNegative = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(d0, zero, _CMP_LT_OQ), _mm256_cmp_ps(d1, zero, _CMP_LT_OQ)), _mm256_cmp_ps(d2, zero, _CMP_LT_OQ));
+
+   return _mm256_or_ps(allPositive, allNegative);
+}
+
+static LOCUS_TARGET_AVX void IncludeAVX(__m256 mask, __m256 p, __m256& low, __m256& high)
+{
+   low = _mm256_min_ps(low, _mm256_blendv_ps(_mm256_set1_ps(Infinity), p, mask));
+   high = _mm256_max_ps(high, _mm256_blendv_ps(_mm256_set1_ps(-Infinity), p, mask));
+}
+
+static LOCUS_TARGET_AVX void IncludeCrossingAVX(__m256 di, __m256 dj, __m256 pi, __m256 pj, __m256& low, __m256& high)
+{
+   __m256 zero = _mm256_setzero_ps();
+
+   __m256 crosses = _mm256_or_ps(_mm256_and_ps(_mm256_cmp_ps(di, zero, _CMP_LT_OQ), _mm256_cmp_ps(dj, zero, _CMP_GT_OQ)),
+                                 _mm256_and_ps(_mm256_cmp_ps(di, zero, _CMP_GT_OQ), _mm256_cmp_ps(dj, zero, _CMP_LT_OQ)));
+
+   __m256 crossing = _mm256_add_ps(pi, _mm256_mul_ps(_mm256_sub_ps(pj, pi), _mm256_div_ps(di, _mm256_sub_ps(di, dj))));
+
+   IncludeAVX(crosses, crossing, low, high);
+}
+
+static LOCUS_TARGET_AVX void ComputeIntervalAVX(__m256 d0, __m256 d1, __m256 d2, __m256 p0, __m256 p1, __m256 p2, __m256& low, __m256& high)
+{
+   __m256 zero = _mm256_setzero_ps();
+
+   low = _mm256_set1_ps(Infinity);
+   high = _mm256_set1_ps(-Infinity);
+
+   IncludeAVX(_mm256_cmp_ps(d0, zero, _CMP_EQ_OQ), p0, low, high);
+   IncludeAVX(_mm256_cmp_ps(d1, zero, _CMP_EQ_OQ), p1, low, high);
+   IncludeAVX(_mm256_cmp_ps(d2, zero, _CMP_EQ_OQ), p2, low, high);
+
+   IncludeCrossingAVX(d0, d1, p0, p1, low, high);
+   IncludeCrossingAVX(d1, d2, p1, p2, low, high);
+   IncludeCrossingAVX(d2, d0, p2, p0, low, high);
+}
+
+static LOCUS_TARGET_AVX void TestCandidatesAVX(const BatchTriangleSetup& a, const float* const* coordinates, std::size_t first, unsigned int& hitMask, unsigned int& coplanarMask)
+{
+   __m256 ax[3] = { _mm256_set1_ps(a.xs[0]), _mm256_set1_ps(a.xs[1]), _mm256_set1_ps(a.xs[2]) };
+   __m256 ay[3] = { _mm256_set1_ps(a.ys[0]), _mm256_set1_ps(a.ys[1]), _mm256_set1_ps(a.ys[2]) };
+   __m256 az[3] = { _mm256_set1_ps(a.zs[0]), _mm256_set1_ps(a.zs[1]), _mm256_set1_ps(a.zs[2]) };
+
+   __m256 anx = _mm256_set1_ps(a.nx), any = _mm256_set1_ps(a.ny), anz = _mm256_set1_ps(a.nz), ad = _mm256_set1_ps(a.d);
+
+   __m256 qx0 = _mm256_loadu_ps(coordinates[0] + first), qy0 = _mm256_loadu_ps(coordinates[1] + first), qz0 = _mm256_loadu_ps(coordinates[2] + first);
+   __m256 qx1 = _mm256_loadu_ps(coordinates[3] + first), qy1 = _mm256_loadu_ps(coordinates[4] + first), qz1 = _mm256_loadu_ps(coordinates[5] + first);
+   __m256 qx2 = _mm256_loadu_ps(coordinates[6] + first), qy2 = _mm256_loadu_ps(coordinates[7] + first), qz2 = _mm256_loadu_ps(coordinates[8] + first);
+
+   __m256 e1x = _mm256_sub_ps(qx1, qx0), e1y = _mm256_sub_ps(qy1, qy0), e1z = _mm256_sub_ps(qz1, qz0);
+   __m256 e2x = _mm256_sub_ps(qx2, qx0), e2y = _mm256_sub_ps(qy2, qy0), e2z = _mm256_sub_ps(qz2, qz0);
+
+   __m256 nx = _mm256_sub_ps(_mm256_mul_ps(e1y, e2z), _mm256_mul_ps(e1z, e2y));
+   __m256 ny = _mm256_sub_ps(_mm256_mul_ps(e1z, e2x), _mm256_mul_ps(e1x, e2z));
+   __m256 nz = _mm256_sub_ps(_mm256_mul_ps(e1x, e2y), _mm256_mul_ps(e1y, e2x));
+
+   __m256 d = _mm256_xor_ps(DotAVX(nx, ny, nz, qx0, qy0, qz0), _mm256_set1_ps(-0.0f));
+
+   __m256 da0 = _mm256_add_ps(DotAVX(nx, ny, nz, ax[0], ay[0], az[0]), d);
+   __m256 da1 = _mm256_add_ps(DotAVX(nx, ny, nz, ax[1], ay[1], az[1]), d);
+   __m256 da2 = _mm256_add_ps(DotAVX(nx, ny, nz, ax[2], ay[2], az[2]), d);
+
+   __m256 db0 = _mm256_add_ps(DotAVX(anx, any, anz, qx0, qy0, qz0), ad);
+   __m256 db1 = _mm256_add_ps(DotAVX(anx, any, anz, qx1, qy1, qz1), ad);
+   __m256 db2 = _mm256_add_ps(DotAVX(anx, any, anz, qx2, qy2, qz2), ad);
+
+   __m256 rejected = _mm256_or_ps(AllOnOneSideAVX(da0, da1, da2), AllOnOneSideAVX(db0, db1, db2));
+
+   int rejectedBits = _mm256_movemask_ps(rejected);
+
+   if (rejectedBits == 0xFF)
+   {
+      hitMask = 0;
+      coplanarMask = 0;
+      return;
+   }
+
+   __m256 dx = _mm256_sub_ps(_mm256_mul_ps(any, nz), _mm256_mul_ps(anz, ny));
+   __m256 dy = _mm256_sub_ps(_mm256_mul_ps(anz, nx), _mm256_mul_ps(anx, nz));
+   __m256 dz = _mm256_sub_ps(_mm256_mul_ps(anx, ny), _mm256_mul_ps(any, nx));
+
+   __m256 parallel = _mm256_cmp_ps(DotAVX(dx, dy, dz, dx, dy, dz), _mm256_mul_ps(_mm256_set1_ps(a.parallelThreshold), DotAVX(nx, ny, nz, nx, ny, nz)), _CMP_LE_OQ);
+
+   __m256 lowA, highA, lowB, highB;
+
+   ComputeIntervalAVX(da0, da1, da2,
+                      DotAVX(dx, dy, dz, ax[0], ay[0], az[0]), DotAVX(dx, dy, dz, ax[1], ay[1], az[1]), DotAVX(dx, dy, dz, ax[2], ay[2], az[2]),
+                      lowA, highA);
+
+   ComputeIntervalAVX(db0, db1, db2,
+                      DotAVX(dx, dy, dz, qx0, qy0, qz0), DotAVX(dx, dy, dz, qx1, qy1, qz1), DotAVX(dx, dy, dz, qx2, qy2, qz2),
+                      lowB, highB);
+
+   __m256 overlaps = _mm256_and_ps(_mm256_cmp_ps(highA, lowB, _CMP_GE_OQ), _mm256_cmp_ps(highB, lowA, _CMP_GE_OQ));
+
+   int parallelBits = _mm256_movemask_ps(parallel) & ~rejectedBits;
+
+   hitMask = static_cast<unsigned int>(_mm256_movemask_ps(overlaps) & ~rejectedBits & ~parallelBits);
+   coplanarMask = static_cast<unsigned int>(parallelBits);
+}
+
+#endif //LOCUS_X86
+
+/////////////////////////////////////////Dispatch/////////////////////////////////////////
+
+struct TriangleBatchKernels
+{
+   /// The number of candidates that testCandidates handles per call.
+   std::size_t numLanes;
+
+   void (*testCandidates)(const BatchTriangleSetup&, const float* const*, std::size_t, unsigned int&, unsigned int&);
+};
+
+static const TriangleBatchKernels Triangle_Batch_Kernels[] =
+{
+   { 1, TestCandidatesScalar },
+
+#ifdef LOCUS_X86
+   { 4, TestCandidatesSSE2 },
+   { 8, TestCandidatesAVX }
+#endif
+};
+
+static bool CoplanarTrianglesIntersect(const PlainTriangle3D& triangle1, const PlainTriangle3D& triangle2)
+{
+   return ToTriangle(triangle1).CoplanarTriangleIntersection(ToTriangle(triangle2));
+}
+
+PlainTriangle3D ToPlainTriangle(const Triangle3D_t& triangle)
+{
+   return PlainTriangle3D{ { triangle[0], triangle[1], triangle[2] } };
+}
+
+Triangle3D_t ToTriangle(const PlainTriangle3D& triangle)
+{
+   return Triangle3D_t(triangle.points[0], triangle.points[1], triangle.points[2]);
+}
+
+bool TrianglesIntersect(const PlainTriangle3D& triangle1, const PlainTriangle3D& triangle2)
+{
+   BatchTriangleSetup setup = SetupTriangle(triangle1);
+
+   const float coordinates[9] = { triangle2.points[0].x, triangle2.points[0].y, triangle2.points[0].z,
+                                  triangle2.points[1].x, triangle2.points[1].y, triangle2.points[1].z,
+                                  triangle2.points[2].x, triangle2.points[2].y, triangle2.points[2].z };
+
+   const float* const coordinatePointers[9] = { coordinates,     coordinates + 1, coordinates + 2,
+                                                coordinates + 3, coordinates + 4, coordinates + 5,
+                                                coordinates + 6, coordinates + 7, coordinates + 8 };
+
+   unsigned int hitMask, coplanarMask;
+
+   TestCandidatesScalar(setup, coordinatePointers, 0, hitMask, coplanarMask);
+
+   if (coplanarMask != 0)
+   {
+      return CoplanarTrianglesIntersect(triangle1, triangle2);
+   }
+
+   return (hitMask != 0);
+}
+
+const std::size_t TriangleBatch::No_Intersection;
+
+void TriangleBatch::Clear()
+{
+   for (std::vector<float>& coordinateArray : coordinates)
+   {
+      coordinateArray.clear();
+   }
+}
+
+void TriangleBatch::Reserve(std::size_t numTriangles)
+{
+   for (std::vector<float>& coordinateArray : coordinates)
+   {
+      coordinateArray.reserve(numTriangles);
+   }
+}
+
+void TriangleBatch::Add(const PlainTriangle3D& triangle)
+{
+   for (std::size_t pointIndex = 0; pointIndex < 3; ++pointIndex)
+   {
+      coordinates[3 * pointIndex].push_back(triangle.points[pointIndex].x);
+      coordinates[3 * pointIndex + 1].push_back(triangle.points[pointIndex].y);
+      coordinates[3 * pointIndex + 2].push_back(triangle.points[pointIndex].z);
+   }
+}
+
+std::size_t TriangleBatch::Size() const
+{
+   return coordinates[0].size();
+}
+
+PlainTriangle3D TriangleBatch::operator[](std::size_t index) const
+{
+   assert(index < Size());
+
+   PlainTriangle3D triangle;
+
+   for (std::size_t pointIndex = 0; pointIndex < 3; ++pointIndex)
+   {
+      triangle.points[pointIndex].Set(coordinates[3 * pointIndex][index], coordinates[3 * pointIndex + 1][index], coordinates[3 * pointIndex + 2][index]);
+   }
+
+   return triangle;
+}
+
+std::size_t TriangleBatch::FindFirstIntersection(const PlainTriangle3D& triangle) const
+{
+   return Find<true>(triangle, nullptr);
+}
+
+void TriangleBatch::FindIntersections(const PlainTriangle3D& triangle, std::vector<std::size_t>& intersectingIndices) const
+{
+   Find<false>(triangle, &intersectingIndices);
+}
+
+template <bool StopAtFirst>
+std::size_t TriangleBatch::Find(const PlainTriangle3D& triangle, std::vector<std::size_t>* intersectingIndices) const
+{
+   const TriangleBatchKernels& kernels = SelectKernelSet(Triangle_Batch_Kernels);
+
+   BatchTriangleSetup setup = SetupTriangle(triangle);
+
+   const float* coordinatePointers[Num_Coordinates];
+
+   for (std::size_t coordinateIndex = 0; coordinateIndex < Num_Coordinates; ++coordinateIndex)
+   {
+      coordinatePointers[coordinateIndex] = coordinates[coordinateIndex].data();
+   }
+
+   std::size_t numTriangles = Size();
+
+   std::size_t first = 0;
+
+   while (first < numTriangles)
+   {
+      //the last few candidates that don't fill the SIMD lanes are tested one at a time
+      bool fullBlock = (first + kernels.numLanes <= numTriangles);
+      std::size_t numLanes = (fullBlock ? kernels.numLanes : 1);
+
+      unsigned int hitMask, coplanarMask;
+
+      if (fullBlock)
+      {
+         kernels.testCandidates(setup, coordinatePointers, first, hitMask, coplanarMask);
+      }
+      else
+      {
+         TestCandidatesScalar(setup, coordinatePointers, first, hitMask, coplanarMask);
+      }
+
+      if ((hitMask | coplanarMask) != 0)
+      {
+         for (std::size_t lane = 0; lane < numLanes; ++lane)
+         {
+            unsigned int laneBit = (1u << lane);
+
+            bool intersects = ((hitMask & laneBit) != 0) ||
+                              (((coplanarMask & laneBit) != 0) && CoplanarTrianglesIntersect(triangle, (*this)[first + lane]));
+
+            if (intersects)
+            {
+               if (StopAtFirst)
+               {
+                  return first + lane;
+               }
+
+               intersectingIndices->push_back(first + lane);
+            }
+         }
+      }
+
+      first += numLanes;
+   }
+
+   return No_Intersection;
+}
+
+}
\ No newline at end of file
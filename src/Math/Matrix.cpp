@@ -16,12 +16,181 @@
 
 #include <set>
 #include <algorithm>
+#include <limits>
 
 #include <cassert>
+#include <cmath>
 
 namespace Locus
 {
 
+//side length, in elements, of the square tiles of the left matrix that are
+//kept in cache while a strip of columns of the result is accumulated
+static const unsigned int Multiplication_Block_Size = 64;
+
+//result must be zero filled. All matrices are in column major order. For
+//every element of the result, the products are still summed in order of
+//the common dimension so the result matches the naive triple loop
+template <typename ScalarType>
+static void MultiplyColumnMajor(const ScalarType* left, unsigned int leftRows, unsigned int commonDimension,
+                         const ScalarType* right, unsigned int rightColumns, ScalarType* result)
+{
+   for (unsigned int commonBlockStart = 0; commonBlockStart < commonDimension; commonBlockStart += Multiplication_Block_Size)
+   {
+      unsigned int commonBlockEnd = std::min(commonBlockStart + Multiplication_Block_Size, commonDimension);
+
+      for (unsigned int rowBlockStart = 0; rowBlockStart < leftRows; rowBlockStart += Multiplication_Block_Size)
+      {
+         unsigned int rowBlockEnd = std::min(rowBlockStart + Multiplication_Block_Size, leftRows);
+
+         for (unsigned int col = 0; col < rightColumns; ++col)
+         {
+            ScalarType* resultColumn = result + (static_cast<std::size_t>(col) * leftRows);
+            const ScalarType* rightColumn = right + (static_cast<std::size_t>(col) * commonDimension);
+
+            for (unsigned int commonIndex = commonBlockStart; commonIndex < commonBlockEnd; ++commonIndex)
+            {
+               const ScalarType* leftColumn = left + (static_cast<std::size_t>(commonIndex) * leftRows);
+               ScalarType rightValue = rightColumn[commonIndex];
+
+               for (unsigned int row = rowBlockStart; row < rowBlockEnd; ++row)
+               {
+                  resultColumn[row] += leftColumn[row] * rightValue;
+               }
+            }
+         }
+      }
+   }
+}
+
+//factors the column major dimension x dimension matrix in lu into PA = LU with
+//partial pivoting, in place. L is unit lower triangular and is stored below
+//the diagonal, U is stored on and above it. rowSwaps[k] is the row that was
+//swapped with row k at step k. Returns false, leaving the factorization
+//incomplete, as soon as a pivot's magnitude is at most singularThreshold
+template <typename ScalarType>
+static bool FactorLU(std::vector<ScalarType>& lu, unsigned int dimension, std::vector<unsigned int>& rowSwaps, ScalarType& permutationSign, ScalarType singularThreshold)
+{
+   rowSwaps.resize(dimension);
+   permutationSign = 1;
+
+   for (unsigned int k = 0; k < dimension; ++k)
+   {
+      ScalarType* columnK = lu.data() + (static_cast<std::size_t>(k) * dimension);
+
+      unsigned int pivotRow = k;
+      ScalarType largestMagnitude = std::abs(columnK[k]);
+
+      for (unsigned int row = k + 1; row < dimension; ++row)
+      {
+         ScalarType magnitude = std::abs(columnK[row]);
+
+         if (magnitude > largestMagnitude)
+         {
+            largestMagnitude = magnitude;
+            pivotRow = row;
+         }
+      }
+
+      rowSwaps[k] = pivotRow;
+
+      if (largestMagnitude <= singularThreshold)
+      {
+         return false;
+      }
+
+      if (pivotRow != k)
+      {
+         for (unsigned int col = 0; col < dimension; ++col)
+         {
+            std::size_t columnStart = static_cast<std::size_t>(col) * dimension;
+
+            std::swap(lu[columnStart + k], lu[columnStart + pivotRow]);
+         }
+
+         permutationSign = -permutationSign;
+      }
+
+      ScalarType inversePivot = 1 / columnK[k];
+
+      for (unsigned int row = k + 1; row < dimension; ++row)
+      {
+         columnK[row] *= inversePivot;
+      }
+
+      for (unsigned int col = k + 1; col < dimension; ++col)
+      {
+         ScalarType* column = lu.data() + (static_cast<std::size_t>(col) * dimension);
+         ScalarType multiplier = column[k];
+
+         if (multiplier != 0)
+         {
+            for (unsigned int row = k + 1; row < dimension; ++row)
+            {
+               column[row] -= columnK[row] * multiplier;
+            }
+         }
+      }
+   }
+
+   return true;
+}
+
+//overwrites b with the solution x of Ax = b, given the output of a successful FactorLU
+template <typename ScalarType>
+static void SolveFactoredLU(const std::vector<ScalarType>& lu, unsigned int dimension, const std::vector<unsigned int>& rowSwaps, ScalarType* b)
+{
+   for (unsigned int k = 0; k < dimension; ++k)
+   {
+      std::swap(b[k], b[rowSwaps[k]]);
+   }
+
+   for (unsigned int k = 0; k < dimension; ++k)
+   {
+      const ScalarType* columnK = lu.data() + (static_cast<std::size_t>(k) * dimension);
+      ScalarType bk = b[k];
+
+      if (bk != 0)
+      {
+         for (unsigned int row = k + 1; row < dimension; ++row)
+         {
+            b[row] -= columnK[row] * bk;
+         }
+      }
+   }
+
+   for (unsigned int k = dimension; k-- > 0;)
+   {
+      const ScalarType* columnK = lu.data() + (static_cast<std::size_t>(k) * dimension);
+
+      b[k] /= columnK[k];
+      ScalarType bk = b[k];
+
+      if (bk != 0)
+      {
+         for (unsigned int row = 0; row < k; ++row)
+         {
+            b[row] -= columnK[row] * bk;
+         }
+      }
+   }
+}
+
+//a pivot this small relative to the largest element of the matrix means the
+//matrix is singular to working precision
+template <typename ScalarType>
+static ScalarType SingularPivotThreshold(const std::vector<ScalarType>& values, unsigned int dimension)
+{
+   ScalarType largestMagnitude = 0;
+
+   for (ScalarType value : values)
+   {
+      largestMagnitude = std::max(largestMagnitude, std::abs(value));
+   }
+
+   return dimension * std::numeric_limits<ScalarType>::epsilon() * largestMagnitude;
+}
+
 template <typename ScalarType>
 Matrix<ScalarType>::Matrix(unsigned int rows, unsigned int columns)
    : rows(rows), columns(columns), values(rows * columns)
@@ -273,20 +442,7 @@ void Matrix<ScalarType>::MultMatrix(const Matrix<ScalarType>& otherMatrix)
 
    std::vector<ScalarType> newValues(rows * columns);
 
-   for (unsigned int rowInResult = 0; rowInResult < rows; ++rowInResult)
-   {
-      for (unsigned int columnInResult = 0; columnInResult < columns; ++columnInResult)
-      {
-         ScalarType multipliedValue = 0;
-
-         for (unsigned int commonDimensionIndex = 0; commonDimensionIndex < columns; ++commonDimensionIndex)
-         {
-            multipliedValue += At(rowInResult, commonDimensionIndex) * otherMatrix.At(commonDimensionIndex, columnInResult);
-         }
-
-         newValues[(columnInResult * rows) + rowInResult] = multipliedValue;
-      }
-   }
+   MultiplyColumnMajor(values.data(), rows, columns, otherMatrix.values.data(), columns, newValues.data());
 
    values = std::move(newValues);
 }
@@ -433,25 +589,46 @@ ScalarType Matrix<ScalarType>::Determinant() const
 {
    assert(IsSquare());
 
-   ScalarType determinant = 0;
-
-   SJTPermutations permutations(this->rows);
+   //the permutation expansion is cheap and free of pivoting round off for the
+   //smallest matrices, but its n! terms make it unusable beyond that
+   if (this->rows <= 3)
+   {
+      ScalarType determinant = 0;
 
-   char signOfPermutation = 1;
+      SJTPermutations permutations(this->rows);
 
-   do
-   {
-      ScalarType determinantSubProduct = signOfPermutation;
+      char signOfPermutation = 1;
 
-      for (unsigned int dimensionIndex = 0; dimensionIndex < this->rows; ++dimensionIndex)
+      do
       {
-         determinantSubProduct *= this->At(dimensionIndex, permutations.GetElement(dimensionIndex));
-      }
+         ScalarType determinantSubProduct = signOfPermutation;
+
+         for (unsigned int dimensionIndex = 0; dimensionIndex < this->rows; ++dimensionIndex)
+         {
+            determinantSubProduct *= this->At(dimensionIndex, permutations.GetElement(dimensionIndex));
+         }
+
+         determinant += determinantSubProduct;
+
+         signOfPermutation *= -1;
+      } while (permutations.GenerateNext());
+
+      return determinant;
+   }
 
-      determinant += determinantSubProduct;
+   std::vector<ScalarType> lu(values);
+   std::vector<unsigned int> rowSwaps;
+   ScalarType determinant;
 
-      signOfPermutation *= -1;
-   } while (permutations.GenerateNext());
+   if (!FactorLU<ScalarType>(lu, this->rows, rowSwaps, determinant, 0))
+   {
+      return 0;
+   }
+
+   for (unsigned int dimensionIndex = 0; dimensionIndex < this->rows; ++dimensionIndex)
+   {
+      determinant *= lu[(static_cast<std::size_t>(dimensionIndex) * this->rows) + dimensionIndex];
+   }
 
    return determinant;
 }
@@ -459,7 +636,16 @@ ScalarType Matrix<ScalarType>::Determinant() const
 template <typename ScalarType>
 bool Matrix<ScalarType>::IsInvertible() const
 {
-   return ( IsSquare() && FNotZero<ScalarType>(Determinant()) );
+   if (!IsSquare())
+   {
+      return false;
+   }
+
+   std::vector<ScalarType> lu(values);
+   std::vector<unsigned int> rowSwaps;
+   ScalarType permutationSign;
+
+   return FactorLU(lu, this->rows, rowSwaps, permutationSign, SingularPivotThreshold(values, this->rows));
 }
 
 template <typename ScalarType>
@@ -482,33 +668,51 @@ bool Matrix<ScalarType>::Invert()
 {
    assert(IsSquare());
 
-   Matrix<ScalarType> augmentedMatrix = *this;
+   const unsigned int dimension = this->rows;
 
-   augmentedMatrix.AddColumns(this->columns);
+   std::vector<ScalarType> lu(values);
+   std::vector<unsigned int> rowSwaps;
+   ScalarType permutationSign;
 
-   for (unsigned int col = this->columns; col < (2 * this->columns); ++col)
+   if (!FactorLU(lu, dimension, rowSwaps, permutationSign, SingularPivotThreshold(values, dimension)))
    {
-      augmentedMatrix(col - this->columns, col) = 1;
+      return false;
    }
 
-   augmentedMatrix.MakeRowEchelon(true);
+   //column j of the inverse is the solution of Ax = e_j
+   std::fill(values.begin(), values.end(), static_cast<ScalarType>(0));
 
-   for (unsigned int col = 0; col < this->columns; ++col)
+   for (unsigned int col = 0; col < dimension; ++col)
    {
-      if (FNotEqual<ScalarType>(augmentedMatrix(col, col), 1))
-      {
-         return false;
-      }
+      ScalarType* inverseColumn = values.data() + (static_cast<std::size_t>(col) * dimension);
+
+      inverseColumn[col] = 1;
+
+      SolveFactoredLU(lu, dimension, rowSwaps, inverseColumn);
    }
 
-   for (unsigned int row = 0; row < this->rows; ++row)
+   return true;
+}
+
+template <typename ScalarType>
+bool Matrix<ScalarType>::Solve(const std::vector<ScalarType>& b, std::vector<ScalarType>& x) const
+{
+   assert(IsSquare());
+   assert(b.size() == this->rows);
+
+   std::vector<ScalarType> lu(values);
+   std::vector<unsigned int> rowSwaps;
+   ScalarType permutationSign;
+
+   if (!FactorLU(lu, this->rows, rowSwaps, permutationSign, SingularPivotThreshold(values, this->rows)))
    {
-      for (unsigned int col = 0; col < this->columns; ++col)
-      {
-         this->At(row, col) = augmentedMatrix(row, this->columns + col);
-      }
+      return false;
    }
 
+   x = b;
+
+   SolveFactoredLU(lu, this->rows, rowSwaps, x.data());
+
    return true;
 }
 
@@ -790,20 +994,7 @@ Matrix<ScalarType> operator*(const Matrix<ScalarType>& matrixLeft, const Matrix<
 
    Matrix<ScalarType> multiplied(numRowsLeft, numColumnsRight);
 
-   for (unsigned int rowInResult = 0; rowInResult < numRowsLeft; ++rowInResult)
-   {
-      for (unsigned int columnInResult = 0; columnInResult < numColumnsRight; ++columnInResult)
-      {
-         ScalarType multipliedValue = 0;
-
-         for (unsigned int commonDimensionIndex = 0; commonDimensionIndex < numColumnsLeft; ++commonDimensionIndex)
-         {
-            multipliedValue += matrixLeft(rowInResult, commonDimensionIndex) * matrixRight(commonDimensionIndex, columnInResult);
-         }
-
-         multiplied(rowInResult, columnInResult) = multipliedValue;
-      }
-   }
+   MultiplyColumnMajor(matrixLeft.GetElements().data(), numRowsLeft, numColumnsLeft, matrixRight.GetElements().data(), numColumnsRight, &multiplied(0, 0));
 
    return multiplied;
 }
@@ -0,0 +1,159 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "Locus/Math/SymmetricEigen.h"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace Locus
+{
+
+//a handful of sweeps is almost always enough since convergence is quadratic
+static const unsigned int Max_Jacobi_Sweeps = 32;
+
+template <typename ScalarType>
+static ScalarType SumOfSquaredOffDiagonals(const ScalarType (&a)[3][3])
+{
+   return (a[0][1] * a[0][1]) + (a[0][2] * a[0][2]) + (a[1][2] * a[1][2]);
+}
+
+//zeroes a[p][q] (and a[q][p]) by applying the plane rotation J^T * a * J,
+//and accumulates J into the columns of v
+template <typename ScalarType>
+static void JacobiRotate(ScalarType (&a)[3][3], ScalarType (&v)[3][3], unsigned int p, unsigned int q)
+{
+   ScalarType apq = a[p][q];
+
+   if (apq == 0)
+   {
+      return;
+   }
+
+   ScalarType theta = (a[q][q] - a[p][p]) / (2 * apq);
+
+   //tangent of the smaller of the two rotation angles. For huge theta,
+   //theta^2 would overflow, but t is then 1 / (2 * theta) to within rounding
+   ScalarType t;
+
+   if (std::abs(theta) > std::sqrt(std::numeric_limits<ScalarType>::max()) / 2)
+   {
+      t = 1 / (2 * theta);
+   }
+   else
+   {
+      t = 1 / (std::abs(theta) + std::sqrt((theta * theta) + 1));
+
+      if (theta < 0)
+      {
+         t = -t;
+      }
+   }
+
+   ScalarType c = 1 / std::sqrt((t * t) + 1);
+   ScalarType s = t * c;
+
+   a[p][p] -= t * apq;
+   a[q][q] += t * apq;
+   a[p][q] = a[q][p] = 0;
+
+   unsigned int r = 3 - p - q;
+
+   ScalarType arp = a[r][p];
+   ScalarType arq = a[r][q];
+
+   a[r][p] = a[p][r] = (c * arp) - (s * arq);
+   a[r][q] = a[q][r] = (s * arp) + (c * arq);
+
+   for (unsigned int row = 0; row < 3; ++row)
+   {
+      ScalarType vrp = v[row][p];
+      ScalarType vrq = v[row][q];
+
+      v[row][p] = (c * vrp) - (s * vrq);
+      v[row][q] = (s * vrp) + (c * vrq);
+   }
+}
+
+template <typename ScalarType>
+void SolveSymmetricEigen3x3(const std::array<ScalarType, 9>& matrix, std::array<ScalarType, 3>& eigenvalues, std::array<std::array<ScalarType, 3>, 3>& eigenvectors)
+{
+   ScalarType a[3][3] = { { matrix[0], matrix[1], matrix[2] },
+                          { matrix[1], matrix[4], matrix[5] },
+                          { matrix[2], matrix[5], matrix[8] } };
+
+   ScalarType v[3][3] = { { 1, 0, 0 },
+                          { 0, 1, 0 },
+                          { 0, 0, 1 } };
+
+   //rotations preserve the Frobenius norm, so this bounds every entry for the whole solve
+   ScalarType frobeniusSquared = (a[0][0] * a[0][0]) + (a[1][1] * a[1][1]) + (a[2][2] * a[2][2]) + 2 * SumOfSquaredOffDiagonals(a);
+
+   ScalarType epsilon = std::numeric_limits<ScalarType>::epsilon();
+   ScalarType convergenceThreshold = (epsilon * epsilon) * frobeniusSquared;
+
+   for (unsigned int sweep = 0; sweep < Max_Jacobi_Sweeps; ++sweep)
+   {
+      if (SumOfSquaredOffDiagonals(a) <= convergenceThreshold)
+      {
+         break;
+      }
+
+      JacobiRotate(a, v, 0, 1);
+      JacobiRotate(a, v, 0, 2);
+      JacobiRotate(a, v, 1, 2);
+   }
+
+   unsigned int order[3] = { 0, 1, 2 };
+
+   std::sort(order, order + 3, [&a](unsigned int i, unsigned int j)
+   {
+      return a[i][i] > a[j][j];
+   });
+
+   for (unsigned int i = 0; i < 3; ++i)
+   {
+      eigenvalues[i] = a[order[i]][order[i]];
+
+      for (unsigned int row = 0; row < 3; ++row)
+      {
+         eigenvectors[i][row] = v[row][order[i]];
+      }
+   }
+
+   //the accumulated rotations have determinant one, but sorting may have
+   //swapped two columns. Flip the last eigenvector to stay right handed
+   const std::array<ScalarType, 3>& e0 = eigenvectors[0];
+   const std::array<ScalarType, 3>& e1 = eigenvectors[1];
+   std::array<ScalarType, 3>& e2 = eigenvectors[2];
+
+   ScalarType determinant = (e0[0] * ((e1[1] * e2[2]) - (e1[2] * e2[1]))) -
+                            (e0[1] * ((e1[0] * e2[2]) - (e1[2] * e2[0]))) +
+                            (e0[2] * ((e1[0] * e2[1]) - (e1[1] * e2[0])));
+
+   if (determinant < 0)
+   {
+      e2[0] = -e2[0];
+      e2[1] = -e2[1];
+      e2[2] = -e2[2];
+   }
+}
+
+#define LOCUS_SYMMETRIC_EIGEN_TEMPLATE_INSTANTIATION(Type) \
+template LOCUS_MATH_API void SolveSymmetricEigen3x3<Type>(const std::array<Type, 9>& matrix, std::array<Type, 3>& eigenvalues, std::array<std::array<Type, 3>, 3>& eigenvectors);
+
+LOCUS_SYMMETRIC_EIGEN_TEMPLATE_INSTANTIATION(float);
+LOCUS_SYMMETRIC_EIGEN_TEMPLATE_INSTANTIATION(double);
+LOCUS_SYMMETRIC_EIGEN_TEMPLATE_INSTANTIATION(long double);
+
+#undef LOCUS_SYMMETRIC_EIGEN_TEMPLATE_INSTANTIATION
+
+}
\ No newline at end of file
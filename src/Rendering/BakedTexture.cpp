@@ -0,0 +1,622 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "Locus/Rendering/BakedTexture.h"
+#include "Locus/Rendering/Image.h"
+#include "Locus/Rendering/MipChain.h"
+
+#include "Locus/FileSystem/FileOnDisk.h"
+#include "Locus/FileSystem/MappedFile.h"
+#include "Locus/FileSystem/MountedFilePath.h"
+#include "Locus/FileSystem/FileSystemUtil.h"
+
+#include "Locus/Common/ThreadPool.h"
+#include "Locus/Common/Exception.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+
+namespace Locus
+{
+
+static const char Magic[4] = { 'L', 'B', 'T', 'X' };
+static const std::uint32_t Version = 3;
+
+//magic, version, format, pixel components, level count, 4 unused bytes, source hash, source size, source modified time
+static const std::size_t Header_Size = 48;
+static const std::size_t Source_Hash_Offset = 24;
+static const std::size_t Source_Size_Offset = 32;
+static const std::size_t Source_Modified_Time_Offset = 40;
+static const std::size_t Level_Entry_Size = 24;
+static const std::size_t Level_Alignment = 16;
+static const unsigned int Max_Levels = 32;
+
+static const std::size_t BC1_Block_Size = 8;
+static const std::size_t BC3_Block_Size = 16;
+
+static void WriteUInt32(unsigned char* bytes, std::uint32_t value)
+{
+   for (unsigned int byteIndex = 0; byteIndex < 4; ++byteIndex)
+   {
+      bytes[byteIndex] = static_cast<unsigned char>(value >> (8 * byteIndex));
+   }
+}
+
+static void WriteUInt64(unsigned char* bytes, std::uint64_t value)
+{
+   for (unsigned int byteIndex = 0; byteIndex < 8; ++byteIndex)
+   {
+      bytes[byteIndex] = static_cast<unsigned char>(value >> (8 * byteIndex));
+   }
+}
+
+static std::uint32_t ReadUInt32(const unsigned char* bytes)
+{
+   std::uint32_t value = 0;
+
+   for (unsigned int byteIndex = 0; byteIndex < 4; ++byteIndex)
+   {
+      value |= static_cast<std::uint32_t>(bytes[byteIndex]) << (8 * byteIndex);
+   }
+
+   return value;
+}
+
+static std::uint64_t ReadUInt64(const unsigned char* bytes)
+{
+   std::uint64_t value = 0;
+
+   for (unsigned int byteIndex = 0; byteIndex < 8; ++byteIndex)
+   {
+      value |= static_cast<std::uint64_t>(bytes[byteIndex]) << (8 * byteIndex);
+   }
+
+   return value;
+}
+
+static std::size_t AlignUp(std::size_t offset)
+{
+   return (offset + Level_Alignment - 1) / Level_Alignment * Level_Alignment;
+}
+
+static std::size_t NumBlocks(unsigned int dimension)
+{
+   return (dimension / 4) + (((dimension % 4) != 0) ? 1 : 0);
+}
+
+/// \return false if the size of the level doesn't fit in a std::size_t.
+static bool LevelSize(BakedTexture::Format format, unsigned int width, unsigned int height, unsigned int numPixelComponents, std::size_t& levelSize)
+{
+   std::size_t numUnitsX = width;
+   std::size_t numUnitsY = height;
+   std::size_t unitSize = numPixelComponents;
+
+   if (format != BakedTexture::Format::Uncompressed)
+   {
+      numUnitsX = NumBlocks(width);
+      numUnitsY = NumBlocks(height);
+      unitSize = ((format == BakedTexture::Format::BC1) ? BC1_Block_Size : BC3_Block_Size);
+   }
+
+   const std::size_t maxSize = std::numeric_limits<std::size_t>::max();
+
+   if ((numUnitsX > maxSize / numUnitsY) || (numUnitsX * numUnitsY > maxSize / unitSize))
+   {
+      return false;
+   }
+
+   levelSize = numUnitsX * numUnitsY * unitSize;
+
+   return true;
+}
+
+static unsigned int LevelDimension(unsigned int baseDimension, unsigned int level)
+{
+   return std::max(baseDimension >> level, 1u);
+}
+
+//The block encoders below fit the endpoints to the bounding box of the block
+//(inset slightly to reduce the error from rounding to the endpoints) and then
+//pick the closest palette entry for each pixel. This is fast rather than
+//optimal, which suits a first run bake.
+
+//gathers a 4x4 block as RGBA, clamping at the edges of the level
+static void GatherBlock(const unsigned char* pixels, unsigned int width, unsigned int height, unsigned int numPixelComponents, unsigned int blockX, unsigned int blockY, unsigned char block[16][4])
+{
+   for (unsigned int y = 0; y < 4; ++y)
+   {
+      unsigned int pixelY = std::min(blockY * 4 + y, height - 1);
+
+      for (unsigned int x = 0; x < 4; ++x)
+      {
+         unsigned int pixelX = std::min(blockX * 4 + x, width - 1);
+
+         const unsigned char* pixel = pixels + (static_cast<std::size_t>(pixelY) * width + pixelX) * numPixelComponents;
+
+         unsigned char* blockPixel = block[y * 4 + x];
+
+         blockPixel[0] = pixel[0];
+         blockPixel[1] = pixel[1];
+         blockPixel[2] = pixel[2];
+         blockPixel[3] = ((numPixelComponents == 4) ? pixel[3] : 255);
+      }
+   }
+}
+
+static std::uint16_t ToRGB565(const int rgb[3])
+{
+   int r = (rgb[0] * 31 + 127) / 255;
+   int g = (rgb[1] * 63 + 127) / 255;
+   int b = (rgb[2] * 31 + 127) / 255;
+
+   return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+}
+
+static void FromRGB565(std::uint16_t color, int rgb[3])
+{
+   int r = (color >> 11) & 31;
+   int g = (color >> 5) & 63;
+   int b = color & 31;
+
+   rgb[0] = (r << 3) | (r >> 2);
+   rgb[1] = (g << 2) | (g >> 4);
+   rgb[2] = (b << 3) | (b >> 2);
+}
+
+static void EncodeColorBlock(const unsigned char block[16][4], unsigned char* output)
+{
+   int minColor[3] = { 255, 255, 255 };
+   int maxColor[3] = { 0, 0, 0 };
+
+   for (unsigned int pixelIndex = 0; pixelIndex < 16; ++pixelIndex)
+   {
+      for (unsigned int channel = 0; channel < 3; ++channel)
+      {
+         minColor[channel] = std::min<int>(minColor[channel], block[pixelIndex][channel]);
+         maxColor[channel] = std::max<int>(maxColor[channel], block[pixelIndex][channel]);
+      }
+   }
+
+   for (unsigned int channel = 0; channel < 3; ++channel)
+   {
+      int inset = (maxColor[channel] - minColor[channel]) >> 4;
+
+      minColor[channel] += inset;
+      maxColor[channel] -= inset;
+   }
+
+   //the max endpoint is never below the min endpoint, so color0 >= color1
+   //and BC1 decodes the block in four color mode unless they are equal
+   std::uint16_t color0 = ToRGB565(maxColor);
+   std::uint16_t color1 = ToRGB565(minColor);
+
+   std::uint32_t indices = 0;
+
+   if (color0 != color1)
+   {
+      int palette[4][3];
+
+      FromRGB565(color0, palette[0]);
+      FromRGB565(color1, palette[1]);
+
+      for (unsigned int channel = 0; channel < 3; ++channel)
+      {
+         palette[2][channel] = (2 * palette[0][channel] + palette[1][channel]) / 3;
+         palette[3][channel] = (palette[0][channel] + 2 * palette[1][channel]) / 3;
+      }
+
+      for (unsigned int pixelIndex = 0; pixelIndex < 16; ++pixelIndex)
+      {
+         unsigned int bestIndex = 0;
+         int bestDistance = -1;
+
+         for (unsigned int paletteIndex = 0; paletteIndex < 4; ++paletteIndex)
+         {
+            int distance = 0;
+
+            for (unsigned int channel = 0; channel < 3; ++channel)
+            {
+               int difference = block[pixelIndex][channel] - palette[paletteIndex][channel];
+               distance += difference * difference;
+            }
+
+            if ((bestDistance < 0) || (distance < bestDistance))
+            {
+               bestDistance = distance;
+               bestIndex = paletteIndex;
+            }
+         }
+
+         indices |= static_cast<std::uint32_t>(bestIndex) << (2 * pixelIndex);
+      }
+   }
+
+   output[0] = static_cast<unsigned char>(color0);
+   output[1] = static_cast<unsigned char>(color0 >> 8);
+   output[2] = static_cast<unsigned char>(color1);
+   output[3] = static_cast<unsigned char>(color1 >> 8);
+
+   WriteUInt32(output + 4, indices);
+}
+
+static void EncodeAlphaBlock(const unsigned char block[16][4], unsigned char* output)
+{
+   int alpha0 = 0;
+   int alpha1 = 255;
+
+   for (unsigned int pixelIndex = 0; pixelIndex < 16; ++pixelIndex)
+   {
+      alpha0 = std::max<int>(alpha0, block[pixelIndex][3]);
+      alpha1 = std::min<int>(alpha1, block[pixelIndex][3]);
+   }
+
+   std::uint64_t indices = 0;
+
+   //alpha0 > alpha1 selects the eight alpha mode
+   if (alpha0 != alpha1)
+   {
+      int palette[8];
+
+      palette[0] = alpha0;
+      palette[1] = alpha1;
+
+      for (int paletteIndex = 2; paletteIndex < 8; ++paletteIndex)
+      {
+         palette[paletteIndex] = ((8 - paletteIndex) * alpha0 + (paletteIndex - 1) * alpha1) / 7;
+      }
+
+      for (unsigned int pixelIndex = 0; pixelIndex < 16; ++pixelIndex)
+      {
+         unsigned int bestIndex = 0;
+         int bestDistance = 256;
+
+         for (unsigned int paletteIndex = 0; paletteIndex < 8; ++paletteIndex)
+         {
+            int distance = std::abs(block[pixelIndex][3] - palette[paletteIndex]);
+
+            if (distance < bestDistance)
+            {
+               bestDistance = distance;
+               bestIndex = paletteIndex;
+            }
+         }
+
+         indices |= static_cast<std::uint64_t>(bestIndex) << (3 * pixelIndex);
+      }
+   }
+
+   output[0] = static_cast<unsigned char>(alpha0);
+   output[1] = static_cast<unsigned char>(alpha1);
+
+   for (unsigned int byteIndex = 0; byteIndex < 6; ++byteIndex)
+   {
+      output[2 + byteIndex] = static_cast<unsigned char>(indices >> (8 * byteIndex));
+   }
+}
+
+static void CompressLevel(BakedTexture::Format format, const unsigned char* pixels, unsigned int width, unsigned int height, unsigned int numPixelComponents, unsigned char* output, ThreadPool* threadPool)
+{
+   const std::size_t numBlocksX = NumBlocks(width);
+   const std::size_t numBlocksY = NumBlocks(height);
+   const std::size_t blockSize = ((format == BakedTexture::Format::BC1) ? BC1_Block_Size : BC3_Block_Size);
+
+   auto compressBlockRows = [&](std::size_t beginBlockY, std::size_t endBlockY)
+   {
+      unsigned char block[16][4];
+
+      for (std::size_t blockY = beginBlockY; blockY < endBlockY; ++blockY)
+      {
+         for (std::size_t blockX = 0; blockX < numBlocksX; ++blockX)
+         {
+            GatherBlock(pixels, width, height, numPixelComponents, static_cast<unsigned int>(blockX), static_cast<unsigned int>(blockY), block);
+
+            unsigned char* blockOutput = output + (blockY * numBlocksX + blockX) * blockSize;
+
+            if (format == BakedTexture::Format::BC3)
+            {
+               EncodeAlphaBlock(block, blockOutput);
+               blockOutput += 8;
+            }
+
+            EncodeColorBlock(block, blockOutput);
+         }
+      }
+   };
+
+   if (threadPool != nullptr)
+   {
+      threadPool->ParallelFor(numBlocksY, 0, compressBlockRows);
+   }
+   else
+   {
+      compressBlockRows(0, numBlocksY);
+   }
+}
+
+BakedTexture::BakedTexture(const std::string& filePath)
+   : mappedFile(std::make_unique<MappedFile>(filePath))
+{
+   const unsigned char* fileData = mappedFile->Data();
+   const std::size_t fileSize = mappedFile->SizeInBytes();
+
+   const std::string invalidFileMessage = std::string("Invalid baked texture ") + filePath;
+
+   if ((fileSize < Header_Size) || (std::memcmp(fileData, Magic, sizeof(Magic)) != 0) || (ReadUInt32(fileData + 4) != Version))
+   {
+      throw Exception(invalidFileMessage);
+   }
+
+   std::uint32_t formatAsInt = ReadUInt32(fileData + 8);
+   numPixelComponents = ReadUInt32(fileData + 12);
+   std::uint32_t numLevels = ReadUInt32(fileData + 16);
+   sourceHash = ReadUInt64(fileData + Source_Hash_Offset);
+   sourceStamp.sizeInBytes = ReadUInt64(fileData + Source_Size_Offset);
+   sourceStamp.lastModifiedTime = static_cast<std::int64_t>(ReadUInt64(fileData + Source_Modified_Time_Offset));
+
+   if ((formatAsInt > static_cast<std::uint32_t>(Format::BC3)) || !Image::ValidPixelComponents(numPixelComponents) ||
+       (numLevels == 0) || (numLevels > Max_Levels) || (fileSize < Header_Size + numLevels * Level_Entry_Size))
+   {
+      throw Exception(invalidFileMessage);
+   }
+
+   format = static_cast<Format>(formatAsInt);
+
+   levels.resize(numLevels);
+
+   for (std::uint32_t levelIndex = 0; levelIndex < numLevels; ++levelIndex)
+   {
+      const unsigned char* levelEntry = fileData + Header_Size + levelIndex * Level_Entry_Size;
+
+      Level& level = levels[levelIndex];
+
+      level.width = ReadUInt32(levelEntry);
+      level.height = ReadUInt32(levelEntry + 4);
+
+      std::uint64_t offset = ReadUInt64(levelEntry + 8);
+      std::uint64_t sizeInBytes = ReadUInt64(levelEntry + 16);
+
+      bool validDimensions = (levelIndex == 0) ? ((level.width != 0) && (level.height != 0)) :
+                                                 ((level.width == LevelDimension(levels[0].width, levelIndex)) && (level.height == LevelDimension(levels[0].height, levelIndex)));
+
+      std::size_t expectedSize = 0;
+
+      if (!validDimensions || !LevelSize(format, level.width, level.height, numPixelComponents, expectedSize) ||
+          (sizeInBytes != expectedSize) || (offset > fileSize) || (sizeInBytes > fileSize - offset))
+      {
+         throw Exception(invalidFileMessage);
+      }
+
+      level.pixelData = fileData + offset;
+      level.sizeInBytes = static_cast<std::size_t>(sizeInBytes);
+   }
+}
+
+BakedTexture::~BakedTexture()
+{
+}
+
+BakedTexture::Format BakedTexture::GetFormat() const
+{
+   return format;
+}
+
+unsigned int BakedTexture::NumPixelComponents() const
+{
+   return numPixelComponents;
+}
+
+unsigned int BakedTexture::NumLevels() const
+{
+   return static_cast<unsigned int>(levels.size());
+}
+
+const BakedTexture::Level& BakedTexture::GetLevel(unsigned int level) const
+{
+   assert(level < NumLevels());
+
+   return levels[level];
+}
+
+const FileStamp& BakedTexture::SourceStamp() const
+{
+   return sourceStamp;
+}
+
+std::uint64_t BakedTexture::SourceHash() const
+{
+   return sourceHash;
+}
+
+std::uint64_t BakedTexture::HashSource(const std::vector<char>& sourceBytes)
+{
+   //64 bit FNV-1a
+   std::uint64_t hash = 14695981039346656037ULL;
+
+   for (char sourceByte : sourceBytes)
+   {
+      hash ^= static_cast<unsigned char>(sourceByte);
+      hash *= 1099511628211ULL;
+   }
+
+   return hash;
+}
+
+void BakedTexture::Bake(const Image& image, Format format, const std::string& filePath, const FileStamp& sourceStamp, std::uint64_t sourceHash, ThreadPool* threadPool)
+{
+   unsigned int sourcePixelComponents = image.NumPixelComponents();
+   unsigned int bakedPixelComponents = sourcePixelComponents;
+
+   if (format == Format::BC1)
+   {
+      if (sourcePixelComponents < 3)
+      {
+         throw Exception("BC1 requires an image with three or four components");
+      }
+
+      bakedPixelComponents = 3;
+   }
+   else if (format == Format::BC3)
+   {
+      if (sourcePixelComponents != 4)
+      {
+         throw Exception("BC3 requires an image with four components");
+      }
+   }
+
+   MipChain mipChain(image, false, threadPool);
+
+   const unsigned int numLevels = mipChain.NumLevels();
+
+   std::vector<std::size_t> levelOffsets(numLevels);
+   std::vector<std::size_t> levelSizes(numLevels);
+
+   std::size_t fileSize = AlignUp(Header_Size + numLevels * Level_Entry_Size);
+
+   for (unsigned int level = 0; level < numLevels; ++level)
+   {
+      const MipChain::Level& mipLevel = mipChain.GetLevel(level);
+
+      if (!LevelSize(format, mipLevel.width, mipLevel.height, bakedPixelComponents, levelSizes[level]))
+      {
+         throw Exception(std::string("The image is too large to bake to ") + filePath);
+      }
+
+      levelOffsets[level] = fileSize;
+      fileSize = AlignUp(fileSize + levelSizes[level]);
+   }
+
+   std::vector<unsigned char> fileBytes(fileSize);
+
+   std::memcpy(fileBytes.data(), Magic, sizeof(Magic));
+   WriteUInt32(fileBytes.data() + 4, Version);
+   WriteUInt32(fileBytes.data() + 8, static_cast<std::uint32_t>(format));
+   WriteUInt32(fileBytes.data() + 12, bakedPixelComponents);
+   WriteUInt32(fileBytes.data() + 16, numLevels);
+   WriteUInt64(fileBytes.data() + Source_Hash_Offset, sourceHash);
+   WriteUInt64(fileBytes.data() + Source_Size_Offset, sourceStamp.sizeInBytes);
+   WriteUInt64(fileBytes.data() + Source_Modified_Time_Offset, static_cast<std::uint64_t>(sourceStamp.lastModifiedTime));
+
+   for (unsigned int level = 0; level < numLevels; ++level)
+   {
+      const MipChain::Level& mipLevel = mipChain.GetLevel(level);
+      const std::size_t levelSize = levelSizes[level];
+
+      unsigned char* levelEntry = fileBytes.data() + Header_Size + level * Level_Entry_Size;
+
+      WriteUInt32(levelEntry, mipLevel.width);
+      WriteUInt32(levelEntry + 4, mipLevel.height);
+      WriteUInt64(levelEntry + 8, levelOffsets[level]);
+      WriteUInt64(levelEntry + 16, levelSize);
+
+      unsigned char* levelBytes = fileBytes.data() + levelOffsets[level];
+
+      if (format == Format::Uncompressed)
+      {
+         std::memcpy(levelBytes, mipChain.LevelPixelData(level), levelSize);
+      }
+      else
+      {
+         CompressLevel(format, mipChain.LevelPixelData(level), mipLevel.width, mipLevel.height, sourcePixelComponents, levelBytes, threadPool);
+      }
+   }
+
+   FileOnDisk file(filePath, DataStream::OpenMode::Write);
+
+   if (file.Write(reinterpret_cast<const char*>(fileBytes.data()), fileBytes.size()) != fileBytes.size())
+   {
+      throw Exception(std::string("Failed to write baked texture ") + filePath);
+   }
+}
+
+template <class FilePathType>
+static std::uint64_t HashSourceFile(const FilePathType& sourceFilePath)
+{
+   std::vector<char> sourceBytes;
+   ReadWholeFile(sourceFilePath, sourceBytes);
+
+   return BakedTexture::HashSource(sourceBytes);
+}
+
+template <class FilePathType>
+static std::unique_ptr<BakedTexture> LoadOrBakeTexture(const FilePathType& sourceFilePath, const std::string& bakedFilePath, BakedTexture::Format format, ThreadPool* threadPool, BakedTexture::StalenessCheck stalenessCheck)
+{
+   const FileStamp sourceStamp = GetFileStamp(sourceFilePath);
+
+   //without a modified time, an edit that keeps the size would go unnoticed
+   if (sourceStamp.lastModifiedTime == -1)
+   {
+      stalenessCheck = BakedTexture::StalenessCheck::SourceHash;
+   }
+
+   std::unique_ptr<BakedTexture> bakedTexture;
+
+   try
+   {
+      bakedTexture = std::make_unique<BakedTexture>(bakedFilePath);
+   }
+   catch (Exception&)
+   {
+   }
+
+   bool upToDate = (bakedTexture && (bakedTexture->GetFormat() == format));
+
+   bool hashedSource = false;
+   std::uint64_t sourceHash = 0;
+
+   if (upToDate)
+   {
+      if (stalenessCheck == BakedTexture::StalenessCheck::SourceStamp)
+      {
+         upToDate = (bakedTexture->SourceStamp() == sourceStamp);
+      }
+      else
+      {
+         sourceHash = HashSourceFile(sourceFilePath);
+         hashedSource = true;
+
+         upToDate = (bakedTexture->SourceHash() == sourceHash);
+      }
+   }
+
+   if (!upToDate)
+   {
+      //the stale file has to be unmapped before it is overwritten
+      bakedTexture.reset();
+
+      //baking is rare enough to always record the hash, so that either check can be used later
+      if (!hashedSource)
+      {
+         sourceHash = HashSourceFile(sourceFilePath);
+      }
+
+      BakedTexture::Bake(Image(sourceFilePath), format, bakedFilePath, sourceStamp, sourceHash, threadPool);
+
+      bakedTexture = std::make_unique<BakedTexture>(bakedFilePath);
+   }
+
+   return bakedTexture;
+}
+
+std::unique_ptr<BakedTexture> BakedTexture::LoadOrBake(const std::string& sourceFilePath, const std::string& bakedFilePath, Format format, ThreadPool* threadPool, StalenessCheck stalenessCheck)
+{
+   return LoadOrBakeTexture(sourceFilePath, bakedFilePath, format, threadPool, stalenessCheck);
+}
+
+std::unique_ptr<BakedTexture> BakedTexture::LoadOrBake(const MountedFilePath& sourceFilePath, const std::string& bakedFilePath, Format format, ThreadPool* threadPool, StalenessCheck stalenessCheck)
+{
+   return LoadOrBakeTexture(sourceFilePath, bakedFilePath, format, threadPool, stalenessCheck);
+}
+
+}
\ No newline at end of file
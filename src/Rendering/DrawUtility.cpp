@@ -55,19 +55,27 @@ bool DrawUtility::Unproject(
    int resolutionY,
    FVector3& worldCoordinate)
 {
-   Locus::Matrix<float> modelViewProjectionInverted = projection * modelView;
+   Transformation modelViewProjectionInverted = projection * modelView;
 
    if (!modelViewProjectionInverted.Invert())
    {
       return false;
    }
 
-   std::vector<float> windowCoordinate{ ( 2.0f * (windowCoordX / resolutionX) ) - 1.0f,
-                                        ( 2.0f * ((resolutionY - windowCoordY) / resolutionY) ) - 1.0f,
-                                        ( 2.0f * windowCoordZ ) - 1.0f,
-                                        1.0f };
+   float windowCoordinate[4] = { ( 2.0f * (windowCoordX / resolutionX) ) - 1.0f,
+                                 ( 2.0f * ((resolutionY - windowCoordY) / resolutionY) ) - 1.0f,
+                                 ( 2.0f * windowCoordZ ) - 1.0f,
+                                 1.0f };
 
-   std::vector<float> objectCoordinate = modelViewProjectionInverted * windowCoordinate;
+   float objectCoordinate[4];
+
+   for (unsigned int row = 0; row < 4; ++row)
+   {
+      objectCoordinate[row] = modelViewProjectionInverted(row, 0) * windowCoordinate[0] +
+                              modelViewProjectionInverted(row, 1) * windowCoordinate[1] +
+                              modelViewProjectionInverted(row, 2) * windowCoordinate[2] +
+                              modelViewProjectionInverted(row, 3) * windowCoordinate[3];
+   }
 
    if (objectCoordinate[3] == 0.0f)
    {
@@ -22,10 +22,12 @@ namespace Locus
 {
 
 GLInfo::GLInfo(GLSLVersion minRequiredGLSLVersion)
-   : vendor(Vendor::Unknown), highestSupportedGLSLVersion(GLSLVersion::Unsupported)
+   : vendor(Vendor::Unknown), highestSupportedGLSLVersion(GLSLVersion::Unsupported), supportsInstancing(false)
 {
    InitializeVendor();
 
+   supportsInstancing = (GLEW_VERSION_3_3 || GLEW_ARB_instanced_arrays);
+
    if (!InitializeGLSL())
    {
       throw Exception("Failed to read GLSL version");
@@ -121,4 +123,9 @@ bool GLInfo::Supports(GLInfo::GLSLVersion version) const
    return version <= highestSupportedGLSLVersion;
 }
 
+bool GLInfo::SupportsInstancing() const
+{
+   return supportsInstancing;
+}
+
 }
\ No newline at end of file
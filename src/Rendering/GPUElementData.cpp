@@ -0,0 +1,94 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "Locus/Rendering/GPUElementData.h"
+
+#include <Locus/Rendering/Locus_glew.h>
+
+#include <limits>
+
+namespace Locus
+{
+
+GPUElementData::GPUElementData()
+   : elementBufferID(0), indexType(GL_UNSIGNED_INT), numIndices(0)
+{
+   glGenBuffers(1, &elementBufferID);
+}
+
+GPUElementData::~GPUElementData()
+{
+   glDeleteBuffers(1, &elementBufferID);
+}
+
+void GPUElementData::Bind() const
+{
+   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBufferID);
+}
+
+void GPUElementData::Buffer(const std::vector<std::uint32_t>& indices, std::size_t numVertices, GLenum usage)
+{
+   numIndices = indices.size();
+
+   Bind();
+
+   if (numVertices <= static_cast<std::size_t>(std::numeric_limits<std::uint16_t>::max()) + 1)
+   {
+      indexType = GL_UNSIGNED_SHORT;
+
+      std::vector<std::uint16_t> shortIndices(numIndices);
+
+      for (std::size_t index = 0; index < numIndices; ++index)
+      {
+         shortIndices[index] = static_cast<std::uint16_t>(indices[index]);
+      }
+
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, numIndices * sizeof(std::uint16_t), shortIndices.data(), usage);
+   }
+   else
+   {
+      indexType = GL_UNSIGNED_INT;
+
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, numIndices * sizeof(std::uint32_t), indices.data(), usage);
+   }
+}
+
+void GPUElementData::Draw(GLenum drawMode) const
+{
+   Bind();
+
+   glDrawElements(drawMode, static_cast<GLsizei>(numIndices), indexType, nullptr);
+}
+
+void GPUElementData::DrawInstanced(GLenum drawMode, GLsizei numInstances) const
+{
+   Bind();
+
+   if (GLEW_VERSION_3_1)
+   {
+      glDrawElementsInstanced(drawMode, static_cast<GLsizei>(numIndices), indexType, nullptr, numInstances);
+   }
+   else
+   {
+      glDrawElementsInstancedARB(drawMode, static_cast<GLsizei>(numIndices), indexType, nullptr, numInstances);
+   }
+}
+
+std::size_t GPUElementData::NumIndices() const
+{
+   return numIndices;
+}
+
+std::size_t GPUElementData::SizeInBytes() const
+{
+   return numIndices * ((indexType == GL_UNSIGNED_SHORT) ? sizeof(std::uint16_t) : sizeof(std::uint32_t));
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "Locus/Rendering/GPUInstanceData.h"
+#include "Locus/Rendering/ShaderController.h"
+#include "Locus/Rendering/ShaderVariables.h"
+
+#include <Locus/Rendering/Locus_glew.h>
+
+#include <cstddef>
+
+namespace Locus
+{
+
+static const unsigned int Num_Model_Transformation_Columns = 4;
+
+static void SetAttributeDivisor(GLint attributeLocation, GLuint divisor)
+{
+   if (GLEW_VERSION_3_3)
+   {
+      glVertexAttribDivisor(attributeLocation, divisor);
+   }
+   else
+   {
+      glVertexAttribDivisorARB(attributeLocation, divisor);
+   }
+}
+
+GPUInstanceData::GPUInstanceData()
+   : instanceBufferID(0), numInstances(0), capacity(0)
+{
+   glGenBuffers(1, &instanceBufferID);
+}
+
+GPUInstanceData::~GPUInstanceData()
+{
+   glDeleteBuffers(1, &instanceBufferID);
+}
+
+void GPUInstanceData::Bind() const
+{
+   glBindBuffer(GL_ARRAY_BUFFER, instanceBufferID);
+}
+
+void GPUInstanceData::Buffer(const std::vector<GPUInstanceDataStorage>& instances)
+{
+   numInstances = instances.size();
+
+   Bind();
+
+   if (numInstances > capacity)
+   {
+      capacity = numInstances;
+
+      glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(GPUInstanceDataStorage), instances.data(), GL_STREAM_DRAW);
+   }
+   else if (numInstances > 0)
+   {
+      //orphan the old storage so that draws still using it don't stall the upload
+      glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(GPUInstanceDataStorage), nullptr, GL_STREAM_DRAW);
+      glBufferSubData(GL_ARRAY_BUFFER, 0, numInstances * sizeof(GPUInstanceDataStorage), instances.data());
+   }
+}
+
+void GPUInstanceData::SetAttributes(ShaderController& shaderController) const
+{
+   Bind();
+
+   GLint modelAttribLocation = shaderController.EnableAttribute(ShaderSource::Instance_Model, Num_Model_Transformation_Columns);
+
+   if (modelAttribLocation != -1)
+   {
+      //a mat4 attribute takes up one location per column
+      for (unsigned int column = 0; column < Num_Model_Transformation_Columns; ++column)
+      {
+         std::size_t columnOffset = offsetof(GPUInstanceDataStorage, modelTransformation) + column * 4 * sizeof(float);
+
+         glVertexAttribPointer(modelAttribLocation + column, 4, GL_FLOAT, GL_FALSE, sizeof(GPUInstanceDataStorage), reinterpret_cast<GLvoid*>(columnOffset));
+
+         SetAttributeDivisor(modelAttribLocation + column, 1);
+      }
+   }
+
+   GLint colorAttribLocation = shaderController.EnableAttribute(ShaderSource::Instance_Color);
+
+   if (colorAttribLocation != -1)
+   {
+      glVertexAttribPointer(colorAttribLocation, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(GPUInstanceDataStorage), reinterpret_cast<GLvoid*>( offsetof(GPUInstanceDataStorage, color) ));
+
+      SetAttributeDivisor(colorAttribLocation, 1);
+   }
+}
+
+void GPUInstanceData::ResetAttributeDivisors(ShaderController& shaderController) const
+{
+   GLint modelAttribLocation = shaderController.GetAttributeLocation(ShaderSource::Instance_Model);
+
+   if (modelAttribLocation != -1)
+   {
+      for (unsigned int column = 0; column < Num_Model_Transformation_Columns; ++column)
+      {
+         SetAttributeDivisor(modelAttribLocation + column, 0);
+      }
+
+      shaderController.DisableAttribute(ShaderSource::Instance_Model, Num_Model_Transformation_Columns);
+   }
+
+   GLint colorAttribLocation = shaderController.GetAttributeLocation(ShaderSource::Instance_Color);
+
+   if (colorAttribLocation != -1)
+   {
+      SetAttributeDivisor(colorAttribLocation, 0);
+
+      shaderController.DisableAttribute(ShaderSource::Instance_Color);
+   }
+}
+
+void GPUInstanceData::SetConstantAttributes(ShaderController& shaderController, const GPUInstanceDataStorage& instance)
+{
+   GLint modelAttribLocation = shaderController.GetAttributeLocation(ShaderSource::Instance_Model);
+
+   if (modelAttribLocation != -1)
+   {
+      for (unsigned int column = 0; column < Num_Model_Transformation_Columns; ++column)
+      {
+         glVertexAttrib4fv(modelAttribLocation + column, instance.modelTransformation + column * 4);
+      }
+   }
+
+   GLint colorAttribLocation = shaderController.GetAttributeLocation(ShaderSource::Instance_Color);
+
+   if (colorAttribLocation != -1)
+   {
+      glVertexAttrib4Nub(colorAttribLocation, instance.color[0], instance.color[1], instance.color[2], instance.color[3]);
+   }
+}
+
+std::size_t GPUInstanceData::NumInstances() const
+{
+   return numInstances;
+}
+
+}
\ No newline at end of file
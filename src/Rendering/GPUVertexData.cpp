@@ -9,6 +9,7 @@
 \********************************************************************************************************/
 
 #include "Locus/Rendering/GPUVertexData.h"
+#include "Locus/Rendering/GPUElementData.h"
 #include "Locus/Rendering/ShaderController.h"
 
 #include <Locus/Rendering/Locus_glew.h>
@@ -47,6 +48,21 @@ void GPUVertexData::BufferSub(GLintptr offset, std::size_t numSubVertices, GLvoi
    glBufferSubData(GL_ARRAY_BUFFER, offset, numSubVertices * sizeOfSingleElementInBytes, data);
 }
 
+void GPUVertexData::BufferElements(const std::vector<std::uint32_t>& indices, GLenum usage)
+{
+   if (elementData == nullptr)
+   {
+      elementData = std::make_unique<GPUElementData>();
+   }
+
+   elementData->Buffer(indices, numVertices, usage);
+}
+
+void GPUVertexData::ClearElements()
+{
+   elementData.reset();
+}
+
 void GPUVertexData::PreDraw(ShaderController& shaderController) const
 {
    if (populated)
@@ -70,7 +86,7 @@ void GPUVertexData::Draw(ShaderController& shaderController) const
    {
       PreDraw(shaderController);
 
-      glDrawArrays(drawMode, 0, numVertices);
+      DrawPrepared();
 
       if (shaderController.GetActiveGLSLVersion() < GLInfo::GLSLVersion::V_130)
       {
@@ -79,6 +95,40 @@ void GPUVertexData::Draw(ShaderController& shaderController) const
    }
 }
 
+void GPUVertexData::DrawPrepared() const
+{
+   if (populated)
+   {
+      if (elementData != nullptr)
+      {
+         elementData->Draw(drawMode);
+      }
+      else
+      {
+         glDrawArrays(drawMode, 0, numVertices);
+      }
+   }
+}
+
+void GPUVertexData::DrawPreparedInstanced(GLsizei numInstances) const
+{
+   if (populated)
+   {
+      if (elementData != nullptr)
+      {
+         elementData->DrawInstanced(drawMode, numInstances);
+      }
+      else if (GLEW_VERSION_3_1)
+      {
+         glDrawArraysInstanced(drawMode, 0, numVertices, numInstances);
+      }
+      else
+      {
+         glDrawArraysInstancedARB(drawMode, 0, numVertices, numInstances);
+      }
+   }
+}
+
 void GPUVertexData::SetClientStateToDefault()
 {
    if (GLEW_VERSION_2_0)
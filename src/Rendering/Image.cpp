@@ -20,11 +20,33 @@
 #include "stb_image/stb_image.h"
 #include "stb_image/stb_image_write.h"
 
+#include <mutex>
+
+#include <cmath>
 #include <cassert>
 
 namespace Locus
 {
 
+//stb_image fills in the fixed Huffman code lengths of zlib the first time a
+//PNG uses them, which races when images are decoded concurrently. Decoding an
+//empty fixed Huffman block once, before any image, fills them in up front.
+//The only other state that decoding writes, the failure reason, is thread local
+static void InitializeDecoding()
+{
+   static std::once_flag initializedFlag;
+
+   std::call_once(initializedFlag, []()
+   {
+      //BFINAL = 1 and BTYPE = 01 (fixed Huffman codes), followed by the end of block code
+      const char emptyFixedHuffmanBlock[] = { 0x03, 0x00 };
+
+      char output[1];
+
+      stbi_zlib_decode_noheader_buffer(output, sizeof(output), emptyFixedHuffmanBlock, sizeof(emptyFixedHuffmanBlock));
+   });
+}
+
 Image::Image(unsigned int width, unsigned int height, unsigned int numPixelComponents)
    : width(width), height(height), numPixelComponents(numPixelComponents), pixelData(width * height * numPixelComponents)
 {
@@ -37,6 +59,8 @@ Image::Image(const std::string& filePath)
    int numPixelsY = 0;
    int numPixelComponentsAsInt = 0;
 
+   InitializeDecoding();
+
    unsigned char* pixels = stbi_load(filePath.c_str(), &numPixelsX, &numPixelsY, &numPixelComponentsAsInt, 0);
 
    if (pixels == nullptr)
@@ -63,6 +87,8 @@ Image::Image(const MountedFilePath& mountedFilePath)
 
       const stbi_uc* bytesInMemory = reinterpret_cast<const stbi_uc*>(bytes.data());
 
+      InitializeDecoding();
+
       pixels = stbi_load_from_memory(bytesInMemory, LossyCast<int, std::size_t>(bytes.size()), &numPixelsX, &numPixelsY, &numPixelComponentsAsInt, 0);
    }
 
@@ -335,6 +361,44 @@ void Image::Scale(unsigned int newWidth, unsigned int newHeight)
    height = newHeight;
 }
 
+unsigned int Image::ClosestPowerOf2(unsigned int num)
+{
+   assert(num >= 1);
+
+   unsigned int closestPowerOf2 = 1;
+   while (closestPowerOf2 < num)
+   {
+      closestPowerOf2 *= 2;
+   }
+
+   if (closestPowerOf2 != 1)
+   {
+      unsigned int previousPowerOf2 = closestPowerOf2 / 2;
+
+      unsigned int diffPrevious = num - previousPowerOf2;
+
+      if ((closestPowerOf2 - num) > diffPrevious)
+      {
+         closestPowerOf2 = previousPowerOf2;
+      }
+   }
+
+   return closestPowerOf2;
+}
+
+void Image::ScaleToClosestPowerOf2()
+{
+   if (!HasPowerOf2Dimensions())
+   {
+      Scale(Image::ClosestPowerOf2(width), Image::ClosestPowerOf2(height));
+   }
+}
+
+bool Image::HasPowerOf2Dimensions() const
+{
+   return (Image::ClosestPowerOf2(width) == width) && (Image::ClosestPowerOf2(height) == height);
+}
+
 bool Image::SaveAsBMP(const std::string& filePath) const
 {
    return (stbi_write_bmp(filePath.c_str(), Width(), Height(), NumPixelComponents(), pixelData.data()) != 0);
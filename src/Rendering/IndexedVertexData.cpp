@@ -0,0 +1,349 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "Locus/Rendering/IndexedVertexData.h"
+
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+
+#include <cmath>
+#include <cstring>
+#include <cassert>
+
+namespace Locus
+{
+
+struct VertexBytesHash
+{
+   std::size_t operator()(const GPUVertexDataStorage& vertex) const
+   {
+      //FNV-1a
+      const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&vertex);
+
+      std::uint32_t hash = 2166136261u;
+
+      for (std::size_t byteIndex = 0; byteIndex < sizeof(GPUVertexDataStorage); ++byteIndex)
+      {
+         hash ^= bytes[byteIndex];
+         hash *= 16777619u;
+      }
+
+      return hash;
+   }
+};
+
+struct VertexBytesEqual
+{
+   bool operator()(const GPUVertexDataStorage& first, const GPUVertexDataStorage& second) const
+   {
+      return (std::memcmp(&first, &second, sizeof(GPUVertexDataStorage)) == 0);
+   }
+};
+
+static const std::size_t Num_Triangle_Vertices = 3;
+
+//the scoring constants from Forsyth's paper
+static const std::size_t Scoring_Cache_Size = 32;
+static const float Cache_Decay_Power = 1.5f;
+static const float Last_Triangle_Score = 0.75f;
+static const float Valence_Boost_Scale = 2.0f;
+static const float Valence_Boost_Power = 0.5f;
+
+static const int Not_In_Cache = -1;
+static const std::size_t No_Triangle = std::numeric_limits<std::size_t>::max();
+
+static float VertexScore(int cachePosition, std::uint32_t numRemainingTriangles)
+{
+   if (numRemainingTriangles == 0)
+   {
+      return -1.0f;
+   }
+
+   float score = 0.0f;
+
+   if (cachePosition != Not_In_Cache)
+   {
+      if (cachePosition < static_cast<int>(Num_Triangle_Vertices))
+      {
+         //the vertices of the last triangle get a fixed score so
+         //that the next triangle doesn't simply reuse its edge
+         score = Last_Triangle_Score;
+      }
+      else
+      {
+         const float scaler = 1.0f / (Scoring_Cache_Size - Num_Triangle_Vertices);
+
+         score = std::pow(1.0f - (cachePosition - static_cast<int>(Num_Triangle_Vertices)) * scaler, Cache_Decay_Power);
+      }
+   }
+
+   //boost vertices with few triangles left so that lone triangles aren't left behind
+   score += Valence_Boost_Scale * std::pow(static_cast<float>(numRemainingTriangles), -Valence_Boost_Power);
+
+   return score;
+}
+
+void BuildIndexedVertexData(const std::vector<GPUVertexDataStorage>& triangleVertices, IndexedVertexData& indexedVertexData)
+{
+   std::size_t numTriangleVertices = triangleVertices.size();
+
+   indexedVertexData.vertices.clear();
+   indexedVertexData.indices.resize(numTriangleVertices);
+
+   std::unordered_map<GPUVertexDataStorage, std::uint32_t, VertexBytesHash, VertexBytesEqual> vertexToIndex;
+   vertexToIndex.reserve(numTriangleVertices);
+
+   for (std::size_t triangleVertexIndex = 0; triangleVertexIndex < numTriangleVertices; ++triangleVertexIndex)
+   {
+      const GPUVertexDataStorage& vertex = triangleVertices[triangleVertexIndex];
+
+      auto insertResult = vertexToIndex.emplace(vertex, static_cast<std::uint32_t>(indexedVertexData.vertices.size()));
+
+      if (insertResult.second)
+      {
+         indexedVertexData.vertices.push_back(vertex);
+      }
+
+      indexedVertexData.indices[triangleVertexIndex] = insertResult.first->second;
+   }
+
+   indexedVertexData.vertices.shrink_to_fit();
+}
+
+void OptimizeVertexCacheOrder(std::vector<std::uint32_t>& triangleIndices, std::size_t numVertices)
+{
+   std::size_t numTriangles = triangleIndices.size() / Num_Triangle_Vertices;
+
+   if (numTriangles == 0)
+   {
+      return;
+   }
+
+   //the triangles using each vertex, stored back to back. The first
+   //numRemainingTriangles[v] entries for v are the ones not yet emitted
+   std::vector<std::uint32_t> vertexTrianglesStart(numVertices + 1, 0);
+
+   for (std::uint32_t index : triangleIndices)
+   {
+      assert(index < numVertices);
+
+      ++vertexTrianglesStart[index + 1];
+   }
+
+   for (std::size_t vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+   {
+      vertexTrianglesStart[vertexIndex + 1] += vertexTrianglesStart[vertexIndex];
+   }
+
+   std::vector<std::uint32_t> vertexTriangles(triangleIndices.size());
+   std::vector<std::uint32_t> numRemainingTriangles(numVertices, 0);
+
+   for (std::size_t triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+   {
+      for (std::size_t i = 0; i < Num_Triangle_Vertices; ++i)
+      {
+         std::uint32_t vertexIndex = triangleIndices[triangleIndex * Num_Triangle_Vertices + i];
+
+         vertexTriangles[vertexTrianglesStart[vertexIndex] + numRemainingTriangles[vertexIndex]] = static_cast<std::uint32_t>(triangleIndex);
+         ++numRemainingTriangles[vertexIndex];
+      }
+   }
+
+   std::vector<int> cachePositions(numVertices, Not_In_Cache);
+   std::vector<float> vertexScores(numVertices);
+
+   for (std::size_t vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+   {
+      vertexScores[vertexIndex] = VertexScore(Not_In_Cache, numRemainingTriangles[vertexIndex]);
+   }
+
+   auto TriangleScore = [&](std::size_t triangleIndex)->float
+   {
+      const std::uint32_t* triangle = &triangleIndices[triangleIndex * Num_Triangle_Vertices];
+
+      return vertexScores[triangle[0]] + vertexScores[triangle[1]] + vertexScores[triangle[2]];
+   };
+
+   std::vector<float> triangleScores(numTriangles);
+   std::vector<char> triangleEmitted(numTriangles, false);
+
+   std::size_t bestTriangle = 0;
+
+   for (std::size_t triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+   {
+      triangleScores[triangleIndex] = TriangleScore(triangleIndex);
+
+      if (triangleScores[triangleIndex] > triangleScores[bestTriangle])
+      {
+         bestTriangle = triangleIndex;
+      }
+   }
+
+   std::vector<std::uint32_t> optimizedIndices;
+   optimizedIndices.reserve(triangleIndices.size());
+
+   std::vector<std::uint32_t> cache;
+   cache.reserve(Scoring_Cache_Size + Num_Triangle_Vertices);
+
+   std::vector<std::uint32_t> newCache;
+   newCache.reserve(Scoring_Cache_Size + Num_Triangle_Vertices);
+
+   std::size_t nextUnemittedTriangle = 0;
+
+   for (std::size_t numEmitted = 0; numEmitted < numTriangles; ++numEmitted)
+   {
+      if (bestTriangle == No_Triangle)
+      {
+         //nothing in the cache has triangles left, so start again
+         //from the next triangle that hasn't been emitted
+         while (triangleEmitted[nextUnemittedTriangle])
+         {
+            ++nextUnemittedTriangle;
+         }
+
+         bestTriangle = nextUnemittedTriangle;
+      }
+
+      triangleEmitted[bestTriangle] = true;
+
+      const std::uint32_t* triangle = &triangleIndices[bestTriangle * Num_Triangle_Vertices];
+
+      newCache.clear();
+
+      for (std::size_t i = 0; i < Num_Triangle_Vertices; ++i)
+      {
+         std::uint32_t vertexIndex = triangle[i];
+
+         optimizedIndices.push_back(vertexIndex);
+         newCache.push_back(vertexIndex);
+
+         //remove the emitted triangle from the vertex's remaining triangles
+         std::uint32_t* remainingTriangles = &vertexTriangles[vertexTrianglesStart[vertexIndex]];
+         std::uint32_t* remainingTrianglesEnd = remainingTriangles + numRemainingTriangles[vertexIndex];
+
+         std::uint32_t* emittedTriangle = std::find(remainingTriangles, remainingTrianglesEnd, static_cast<std::uint32_t>(bestTriangle));
+         assert(emittedTriangle != remainingTrianglesEnd);
+
+         std::swap(*emittedTriangle, *(remainingTrianglesEnd - 1));
+         --numRemainingTriangles[vertexIndex];
+      }
+
+      for (std::uint32_t vertexIndex : cache)
+      {
+         if ((vertexIndex != triangle[0]) && (vertexIndex != triangle[1]) && (vertexIndex != triangle[2]))
+         {
+            newCache.push_back(vertexIndex);
+         }
+      }
+
+      for (std::size_t cachePosition = 0, newCacheSize = newCache.size(); cachePosition < newCacheSize; ++cachePosition)
+      {
+         std::uint32_t vertexIndex = newCache[cachePosition];
+
+         cachePositions[vertexIndex] = (cachePosition < Scoring_Cache_Size) ? static_cast<int>(cachePosition) : Not_In_Cache;
+         vertexScores[vertexIndex] = VertexScore(cachePositions[vertexIndex], numRemainingTriangles[vertexIndex]);
+      }
+
+      //only the triangles touching the cache changed score, so the next
+      //triangle is picked from among them
+      bestTriangle = No_Triangle;
+      float bestScore = -1.0f;
+
+      for (std::uint32_t vertexIndex : newCache)
+      {
+         const std::uint32_t* remainingTriangles = &vertexTriangles[vertexTrianglesStart[vertexIndex]];
+
+         for (std::uint32_t i = 0; i < numRemainingTriangles[vertexIndex]; ++i)
+         {
+            std::uint32_t triangleIndex = remainingTriangles[i];
+
+            triangleScores[triangleIndex] = TriangleScore(triangleIndex);
+
+            if (triangleScores[triangleIndex] > bestScore)
+            {
+               bestScore = triangleScores[triangleIndex];
+               bestTriangle = triangleIndex;
+            }
+         }
+      }
+
+      if (newCache.size() > Scoring_Cache_Size)
+      {
+         newCache.resize(Scoring_Cache_Size);
+      }
+
+      cache.swap(newCache);
+   }
+
+   triangleIndices.swap(optimizedIndices);
+}
+
+void OptimizeVertexFetchOrder(IndexedVertexData& indexedVertexData)
+{
+   const std::uint32_t Not_Remapped = std::numeric_limits<std::uint32_t>::max();
+
+   std::vector<std::uint32_t> remapping(indexedVertexData.vertices.size(), Not_Remapped);
+
+   std::vector<GPUVertexDataStorage> remappedVertices;
+   remappedVertices.reserve(indexedVertexData.vertices.size());
+
+   for (std::uint32_t& index : indexedVertexData.indices)
+   {
+      if (remapping[index] == Not_Remapped)
+      {
+         remapping[index] = static_cast<std::uint32_t>(remappedVertices.size());
+         remappedVertices.push_back(indexedVertexData.vertices[index]);
+      }
+
+      index = remapping[index];
+   }
+
+   indexedVertexData.vertices.swap(remappedVertices);
+}
+
+float AverageCacheMissRatio(const std::vector<std::uint32_t>& triangleIndices, std::size_t cacheSize)
+{
+   std::size_t numTriangles = triangleIndices.size() / Num_Triangle_Vertices;
+
+   if ((numTriangles == 0) || (cacheSize == 0))
+   {
+      return 0.0f;
+   }
+
+   //FIFO cache stored as a ring
+   std::vector<std::uint32_t> cache;
+   cache.reserve(cacheSize);
+
+   std::size_t oldestEntry = 0;
+   std::size_t numMisses = 0;
+
+   for (std::uint32_t index : triangleIndices)
+   {
+      if (std::find(cache.begin(), cache.end(), index) == cache.end())
+      {
+         ++numMisses;
+
+         if (cache.size() < cacheSize)
+         {
+            cache.push_back(index);
+         }
+         else
+         {
+            cache[oldestEntry] = index;
+            oldestEntry = (oldestEntry + 1) % cacheSize;
+         }
+      }
+   }
+
+   return static_cast<float>(numMisses) / numTriangles;
+}
+
+}
\ No newline at end of file
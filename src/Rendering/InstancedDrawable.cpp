@@ -0,0 +1,168 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "Locus/Rendering/InstancedDrawable.h"
+#include "Locus/Rendering/SingleDrawable.h"
+#include "Locus/Rendering/GPUVertexData.h"
+#include "Locus/Rendering/RenderingState.h"
+#include "Locus/Rendering/ShaderVariables.h"
+
+#include <algorithm>
+
+#include <cassert>
+
+namespace Locus
+{
+
+static void SerializeInstance(const InstancedDrawable::Instance& instance, GPUInstanceDataStorage& storage)
+{
+   const Transformation::Elements_t& elements = instance.modelTransformation.GetElements();
+
+   std::copy(elements.begin(), elements.end(), storage.modelTransformation);
+
+   instance.color.SerializeTo(storage.color);
+}
+
+InstancedDrawable::InstancedDrawable(const SingleDrawable& sharedDrawable)
+   : sharedDrawable(sharedDrawable)
+{
+}
+
+void InstancedDrawable::ClearInstances()
+{
+   instances.clear();
+}
+
+void InstancedDrawable::AddInstance(const Transformation& modelTransformation, const Color& color)
+{
+   instances.push_back(Instance{ modelTransformation, color });
+}
+
+void InstancedDrawable::SetInstance(std::size_t instanceIndex, const Transformation& modelTransformation, const Color& color)
+{
+   assert(instanceIndex < instances.size());
+
+   instances[instanceIndex].modelTransformation = modelTransformation;
+   instances[instanceIndex].color = color;
+}
+
+std::size_t InstancedDrawable::NumInstances() const
+{
+   return instances.size();
+}
+
+void InstancedDrawable::CreateGPUVertexData()
+{
+   gpuInstanceData = std::make_unique<GPUInstanceData>();
+}
+
+void InstancedDrawable::DeleteGPUVertexData()
+{
+   gpuInstanceData.reset();
+}
+
+void InstancedDrawable::UpdateGPUVertexData()
+{
+   if (gpuInstanceData != nullptr)
+   {
+      std::size_t numInstances = instances.size();
+
+      instanceStorage.resize(numInstances);
+
+      for (std::size_t instanceIndex = 0; instanceIndex < numInstances; ++instanceIndex)
+      {
+         SerializeInstance(instances[instanceIndex], instanceStorage[instanceIndex]);
+      }
+
+      gpuInstanceData->Buffer(instanceStorage);
+   }
+}
+
+bool InstancedDrawable::CanDrawInstanced(RenderingState& renderingState) const
+{
+   return (gpuInstanceData != nullptr) &&
+          renderingState.glInfo.SupportsInstancing() &&
+          (renderingState.shaderController.GetActiveGLSLVersion() == GLInfo::GLSLVersion::V_130) &&
+          (renderingState.shaderController.GetAttributeLocation(ShaderSource::Instance_Model) != -1);
+}
+
+void InstancedDrawable::Draw(RenderingState& renderingState) const
+{
+   const GPUVertexData* sharedVertexData = sharedDrawable.GetGPUVertexData();
+
+   if (sharedVertexData == nullptr)
+   {
+      return;
+   }
+
+   ShaderController& shaderController = renderingState.shaderController;
+
+   if (CanDrawInstanced(renderingState))
+   {
+      if (gpuInstanceData->NumInstances() > 0)
+      {
+         renderingState.transformationStack.UploadTransformations(shaderController);
+
+         sharedVertexData->PreDraw(shaderController);
+         gpuInstanceData->SetAttributes(shaderController);
+
+         sharedVertexData->DrawPreparedInstanced(static_cast<GLsizei>(gpuInstanceData->NumInstances()));
+
+         gpuInstanceData->ResetAttributeDivisors(shaderController);
+      }
+   }
+   else if (!instances.empty())
+   {
+      DrawOnePerInstance(renderingState, *sharedVertexData);
+   }
+}
+
+void InstancedDrawable::DrawOnePerInstance(RenderingState& renderingState, const GPUVertexData& sharedVertexData) const
+{
+   ShaderController& shaderController = renderingState.shaderController;
+
+   sharedVertexData.PreDraw(shaderController);
+
+   if (shaderController.GetAttributeLocation(ShaderSource::Instance_Model) != -1)
+   {
+      //The program expects its model transformation and color from the
+      //instance attributes, and the uniform matrices to hold only the view
+      //and projection. Without this, every instance would be drawn with
+      //the attributes' default values, which collapses the geometry
+      renderingState.transformationStack.UploadTransformations(shaderController);
+
+      GPUInstanceDataStorage storage;
+
+      for (const Instance& instance : instances)
+      {
+         SerializeInstance(instance, storage);
+
+         GPUInstanceData::SetConstantAttributes(shaderController, storage);
+
+         sharedVertexData.DrawPrepared();
+      }
+   }
+   else
+   {
+      for (const Instance& instance : instances)
+      {
+         renderingState.transformationStack.UploadTransformations(shaderController, instance.modelTransformation);
+
+         sharedVertexData.DrawPrepared();
+      }
+   }
+
+   if (shaderController.GetActiveGLSLVersion() < GLInfo::GLSLVersion::V_130)
+   {
+      GPUVertexData::SetClientStateToDefault();
+   }
+}
+
+}
\ No newline at end of file
@@ -10,6 +10,7 @@
 
 #include "Locus/Rendering/Mesh.h"
 #include "Locus/Rendering/DefaultGPUVertexData.h"
+#include "Locus/Rendering/IndexedVertexData.h"
 #include "Locus/Rendering/RenderingState.h"
 
 #include "Locus/Common/Util.h"
@@ -119,17 +120,10 @@ void Mesh::Construct(const std::vector<std::vector<MeshVertex>>& faceTriangles,
    GetUniqueItems<TextureCoordinate>(vertTexCoords, textureCoordinates, sortedTexCoordIndices);
 
    //fill faces
-
-   std::size_t numVertices = 0;
-   for (std::size_t faceIndex = 0, numFaces = faces.size(); faceIndex < numFaces; ++faceIndex)
+   for (std::size_t vertexIndex = 0, numVertices = faceVertices.size(); vertexIndex < numVertices; ++vertexIndex)
    {
-      for (std::size_t vertexIndex = 0; vertexIndex < Triangle3D_t::NumPointsOnATriangle; ++vertexIndex)
-      {
-         faces[faceIndex][vertexIndex].textureCoordinateID = sortedTexCoordIndices[numVertices];
-         faces[faceIndex][vertexIndex].colorID = sortedColorIndices[numVertices];
-
-         ++numVertices;
-      }
+      faceVertices[vertexIndex].textureCoordinateID = static_cast<std::uint32_t>(sortedTexCoordIndices[vertexIndex]);
+      faceVertices[vertexIndex].colorID = static_cast<std::uint32_t>(sortedColorIndices[vertexIndex]);
    }
 
    if (degenerateFaceIndices != nullptr)
@@ -142,7 +136,7 @@ MeshVertex Mesh::GetVertex(std::size_t faceIndex, int vertexIndex) const
 {
    MeshVertex vertex;
 
-   vertex.textureCoordinate = textureCoordinates[faces[faceIndex][vertexIndex].textureCoordinateID];
+   vertex.textureCoordinate = textureCoordinates[FaceVertex(faceIndex, vertexIndex).textureCoordinateID];
 
    return vertex;
 }
@@ -158,8 +152,10 @@ void Mesh::AssignNormals()
 
    FVector3 faceNormal;
 
-   for (face_t& face : faces)
+   for (std::size_t faceIndex = 0, numFaces = NumFaces(); faceIndex < numFaces; ++faceIndex)
    {
+      MeshVertexIndexer* face = &FaceVertex(faceIndex, 0);
+
       faceNormal = Cross(positions[face[1].positionID] - positions[face[0].positionID], positions[face[2].positionID] - positions[face[1].positionID]);
 
       for (std::size_t vertexIndex = 0; vertexIndex < Triangle3D_t::NumPointsOnATriangle; ++vertexIndex)
@@ -190,64 +186,86 @@ void Mesh::BindGPUVertexData() const
    gpuVertexData->Bind();
 }
 
+GPUVertexDataTransferInfo Mesh::GetTransferInfoToSend() const
+{
+   GPUVertexDataTransferInfo transferInfoToSend = gpuVertexDataTransferInfo;
+
+   transferInfoToSend.sendNormals = gpuVertexDataTransferInfo.sendNormals && (normals.size() > 0);
+
+   return transferInfoToSend;
+}
+
+void Mesh::GetIndexedVertexData(IndexedVertexData& indexedVertexData) const
+{
+   std::size_t numTotalVertices = faceVertices.size();
+
+   GPUVertexDataTransferInfo transferInfoToSend = GetTransferInfoToSend();
+
+   //attributes that aren't sent stay zero filled so that they don't keep
+   //otherwise identical vertices apart
+   std::vector<GPUVertexDataStorage> vertData(numTotalVertices);
+
+   for (std::size_t vertDataIndex = 0; vertDataIndex < numTotalVertices; ++vertDataIndex)
+   {
+      const MeshVertexIndexer& vertex = faceVertices[vertDataIndex];
+
+      GPUVertexDataStorage& currentVertData = vertData[vertDataIndex];
+
+      if (transferInfoToSend.sendPositions)
+      {
+         currentVertData.position[0] = static_cast<float>(positions[vertex.positionID].x);
+         currentVertData.position[1] = static_cast<float>(positions[vertex.positionID].y);
+         currentVertData.position[2] = static_cast<float>(positions[vertex.positionID].z);
+      }
+
+      if (transferInfoToSend.sendNormals)
+      {
+         currentVertData.normal[0] = static_cast<float>(normals[vertex.normalID].x);
+         currentVertData.normal[1] = static_cast<float>(normals[vertex.normalID].y);
+         currentVertData.normal[2] = static_cast<float>(normals[vertex.normalID].z);
+      }
+
+      if (transferInfoToSend.sendColors)
+      {
+         currentVertData.color[0] = colors[vertex.colorID].r;
+         currentVertData.color[1] = colors[vertex.colorID].g;
+         currentVertData.color[2] = colors[vertex.colorID].b;
+         currentVertData.color[3] = colors[vertex.colorID].a;
+      }
+
+      if (transferInfoToSend.sendTexCoords)
+      {
+         currentVertData.texCoord[0] = static_cast<float>(textureCoordinates[vertex.textureCoordinateID].x);
+         currentVertData.texCoord[1] = static_cast<float>(textureCoordinates[vertex.textureCoordinateID].y);
+      }
+   }
+
+   BuildIndexedVertexData(vertData, indexedVertexData);
+
+   ClearAndShrink(vertData);
+
+   OptimizeVertexCacheOrder(indexedVertexData.indices, indexedVertexData.vertices.size());
+   OptimizeVertexFetchOrder(indexedVertexData);
+}
+
 void Mesh::UpdateGPUVertexData()
 {
-   if (numTotalVertices > 0)
+   if (!faceVertices.empty())
    {
       if (defaultGPUVertexData != nullptr)
       {
-         bool hasNormals = normals.size() > 0;
+         IndexedVertexData indexedVertexData;
+         GetIndexedVertexData(indexedVertexData);
 
-         bool sendNormals = gpuVertexDataTransferInfo.sendNormals && hasNormals;
+         std::size_t numUniqueVertices = indexedVertexData.vertices.size();
 
          defaultGPUVertexData->Bind();
-         defaultGPUVertexData->Buffer(numTotalVertices, GL_STATIC_DRAW);
-
-         std::vector<GPUVertexDataStorage> vertData(numTotalVertices);
-
-         std::size_t vertDataIndex = 0;
-         for (const face_t& face : faces)
-         {
-            for (const MeshVertexIndexer& vertex : face)
-            {
-               GPUVertexDataStorage& currentVertData = vertData[vertDataIndex];
-
-               if (gpuVertexDataTransferInfo.sendPositions)
-               {
-                  currentVertData.position[0] = static_cast<float>(positions[vertex.positionID].x);
-                  currentVertData.position[1] = static_cast<float>(positions[vertex.positionID].y);
-                  currentVertData.position[2] = static_cast<float>(positions[vertex.positionID].z);
-               }
-
-               if (sendNormals)
-               {
-                  currentVertData.normal[0] = static_cast<float>(normals[vertex.normalID].x);
-                  currentVertData.normal[1] = static_cast<float>(normals[vertex.normalID].y);
-                  currentVertData.normal[2] = static_cast<float>(normals[vertex.normalID].z);
-               }
-
-               if (gpuVertexDataTransferInfo.sendColors)
-               {
-                  currentVertData.color[0] = colors[vertex.colorID].r;
-                  currentVertData.color[1] = colors[vertex.colorID].g;
-                  currentVertData.color[2] = colors[vertex.colorID].b;
-                  currentVertData.color[3] = colors[vertex.colorID].a;
-               }
-
-               if (gpuVertexDataTransferInfo.sendTexCoords)
-               {
-                  currentVertData.texCoord[0] = static_cast<float>(textureCoordinates[vertex.textureCoordinateID].x);
-                  currentVertData.texCoord[1] = static_cast<float>(textureCoordinates[vertex.textureCoordinateID].y);
-               }
-
-               ++vertDataIndex;
-            }
-         }
+         defaultGPUVertexData->Buffer(numUniqueVertices, GL_STATIC_DRAW);
+         defaultGPUVertexData->BufferSub(0, numUniqueVertices, indexedVertexData.vertices.data());
 
-         defaultGPUVertexData->BufferSub(0, numTotalVertices, vertData.data());
+         defaultGPUVertexData->BufferElements(indexedVertexData.indices, GL_STATIC_DRAW);
 
-         defaultGPUVertexData->transferInfo = gpuVertexDataTransferInfo;
-         defaultGPUVertexData->transferInfo.sendNormals = sendNormals;
+         defaultGPUVertexData->transferInfo = GetTransferInfoToSend();
 
          defaultGPUVertexData->drawMode = GL_TRIANGLES;
       }
@@ -0,0 +1,324 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "Locus/Rendering/MipChain.h"
+#include "Locus/Rendering/Image.h"
+
+#include "Locus/Common/ThreadPool.h"
+#include "Locus/Common/InstructionSet.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <cassert>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define LOCUS_MIP_CHAIN_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Locus
+{
+
+//levels with at least this many pixels are split across the thread pool
+static const std::size_t Min_Pixels_For_Threading = 128 * 128;
+
+//sRGB components are converted to 16 bit linear values, averaged, then converted back
+struct SRGBTables
+{
+   SRGBTables()
+      : linearToSRGB(65536)
+   {
+      for (unsigned int i = 0; i < 256; ++i)
+      {
+         float sRGB = i / 255.0f;
+         float linear = (sRGB <= 0.04045f) ? (sRGB / 12.92f) : std::pow((sRGB + 0.055f) / 1.055f, 2.4f);
+
+         sRGBToLinear[i] = static_cast<std::uint16_t>(linear * 65535.0f + 0.5f);
+      }
+
+      for (unsigned int i = 0; i < 65536; ++i)
+      {
+         float linear = i / 65535.0f;
+         float sRGB = (linear <= 0.0031308f) ? (linear * 12.92f) : (1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f);
+
+         linearToSRGB[i] = static_cast<unsigned char>(std::min(sRGB, 1.0f) * 255.0f + 0.5f);
+      }
+   }
+
+   std::uint16_t sRGBToLinear[256];
+   std::vector<unsigned char> linearToSRGB;
+};
+
+static const SRGBTables& GetSRGBTables()
+{
+   static const SRGBTables tables;
+   return tables;
+}
+
+struct RowFilterParams
+{
+   const unsigned char* sourceRow0;
+   const unsigned char* sourceRow1;
+   unsigned int sourceWidth;
+   unsigned char* destinationRow;
+   unsigned int destinationWidth;
+   unsigned int numPixelComponents;
+};
+
+static void FilterRowScalar(const RowFilterParams& params, unsigned int fromX)
+{
+   const unsigned int numPixelComponents = params.numPixelComponents;
+
+   for (unsigned int x = fromX; x < params.destinationWidth; ++x)
+   {
+      unsigned int left = (2 * x) * numPixelComponents;
+      unsigned int right = std::min(2 * x + 1, params.sourceWidth - 1) * numPixelComponents;
+
+      unsigned char* destinationPixel = params.destinationRow + x * numPixelComponents;
+
+      for (unsigned int component = 0; component < numPixelComponents; ++component)
+      {
+         unsigned int sum = params.sourceRow0[left + component] + params.sourceRow0[right + component] +
+                            params.sourceRow1[left + component] + params.sourceRow1[right + component];
+
+         destinationPixel[component] = static_cast<unsigned char>((sum + 2) >> 2);
+      }
+   }
+}
+
+#ifdef LOCUS_MIP_CHAIN_SSE2
+
+//Sums 16 bytes from each row vertically into 16 bit lanes, then adds the
+//horizontally adjacent pixels. The result holds one 16 bit sum per component
+//of the destination pixels covered by the 16 source bytes. The rounding is the
+//same as FilterRowScalar, so the output is bit for bit identical.
+static __m128i SumPixelPairs(const unsigned char* row0, const unsigned char* row1, unsigned int numPixelComponents)
+{
+   const __m128i zero = _mm_setzero_si128();
+
+   __m128i bytes0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0));
+   __m128i bytes1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1));
+
+   __m128i low = _mm_add_epi16(_mm_unpacklo_epi8(bytes0, zero), _mm_unpacklo_epi8(bytes1, zero));
+   __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(bytes0, zero), _mm_unpackhi_epi8(bytes1, zero));
+
+   switch (numPixelComponents)
+   {
+   case 4:
+      return _mm_add_epi16(_mm_unpacklo_epi64(low, high), _mm_unpackhi_epi64(low, high));
+
+   case 2:
+      low = _mm_shuffle_epi32(low, _MM_SHUFFLE(3, 1, 2, 0));
+      high = _mm_shuffle_epi32(high, _MM_SHUFFLE(3, 1, 2, 0));
+      return _mm_add_epi16(_mm_unpacklo_epi64(low, high), _mm_unpackhi_epi64(low, high));
+
+   case 1:
+   default:
+      {
+         const __m128i ones = _mm_set1_epi16(1);
+         return _mm_packs_epi32(_mm_madd_epi16(low, ones), _mm_madd_epi16(high, ones));
+      }
+   }
+}
+
+static void FilterRowSSE2(const RowFilterParams& params)
+{
+   const unsigned int numPixelComponents = params.numPixelComponents;
+
+   unsigned int x = 0;
+
+   //each iteration reads 32 bytes from both source rows and writes 16 bytes
+   if ((numPixelComponents != 3) && (params.sourceWidth >= 2 * params.destinationWidth))
+   {
+      const unsigned int destinationPixelsPerIteration = 16 / numPixelComponents;
+      const __m128i two = _mm_set1_epi16(2);
+
+      for (; x + destinationPixelsPerIteration <= params.destinationWidth; x += destinationPixelsPerIteration)
+      {
+         unsigned int sourceOffset = 2 * x * numPixelComponents;
+
+         __m128i sums0 = SumPixelPairs(params.sourceRow0 + sourceOffset, params.sourceRow1 + sourceOffset, numPixelComponents);
+         __m128i sums1 = SumPixelPairs(params.sourceRow0 + sourceOffset + 16, params.sourceRow1 + sourceOffset + 16, numPixelComponents);
+
+         sums0 = _mm_srli_epi16(_mm_add_epi16(sums0, two), 2);
+         sums1 = _mm_srli_epi16(_mm_add_epi16(sums1, two), 2);
+
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(params.destinationRow + x * numPixelComponents), _mm_packus_epi16(sums0, sums1));
+      }
+   }
+
+   FilterRowScalar(params, x);
+}
+
+#endif
+
+static void FilterRowSRGB(const RowFilterParams& params)
+{
+   const SRGBTables& tables = GetSRGBTables();
+
+   const unsigned int numPixelComponents = params.numPixelComponents;
+   const bool hasAlpha = ((numPixelComponents == 2) || (numPixelComponents == 4));
+   const unsigned int numColorComponents = (hasAlpha ? (numPixelComponents - 1) : numPixelComponents);
+
+   for (unsigned int x = 0; x < params.destinationWidth; ++x)
+   {
+      unsigned int left = (2 * x) * numPixelComponents;
+      unsigned int right = std::min(2 * x + 1, params.sourceWidth - 1) * numPixelComponents;
+
+      unsigned char* destinationPixel = params.destinationRow + x * numPixelComponents;
+
+      for (unsigned int component = 0; component < numColorComponents; ++component)
+      {
+         unsigned int sum = tables.sRGBToLinear[params.sourceRow0[left + component]] + tables.sRGBToLinear[params.sourceRow0[right + component]] +
+                            tables.sRGBToLinear[params.sourceRow1[left + component]] + tables.sRGBToLinear[params.sourceRow1[right + component]];
+
+         destinationPixel[component] = tables.linearToSRGB[(sum + 2) >> 2];
+      }
+
+      if (hasAlpha)
+      {
+         unsigned int alpha = numColorComponents;
+
+         unsigned int sum = params.sourceRow0[left + alpha] + params.sourceRow0[right + alpha] +
+                            params.sourceRow1[left + alpha] + params.sourceRow1[right + alpha];
+
+         destinationPixel[alpha] = static_cast<unsigned char>((sum + 2) >> 2);
+      }
+   }
+}
+
+static void FilterRow(const RowFilterParams& params, bool sRGB, bool useSSE2)
+{
+   if (sRGB)
+   {
+      FilterRowSRGB(params);
+   }
+#ifdef LOCUS_MIP_CHAIN_SSE2
+   else if (useSSE2)
+   {
+      FilterRowSSE2(params);
+   }
+#endif
+   else
+   {
+      FilterRowScalar(params, 0);
+   }
+}
+
+MipChain::MipChain(const Image& image, bool sRGB, ThreadPool* threadPool)
+   : numPixelComponents(image.NumPixelComponents())
+{
+   assert(Image::ValidPixelComponents(numPixelComponents));
+   assert((image.Width() > 0) && (image.Height() > 0));
+
+   std::size_t totalSize = 0;
+
+   unsigned int width = image.Width();
+   unsigned int height = image.Height();
+
+   while (true)
+   {
+      levels.push_back( Level{width, height, totalSize} );
+
+      totalSize += static_cast<std::size_t>(width) * height * numPixelComponents;
+
+      if ((width == 1) && (height == 1))
+      {
+         break;
+      }
+
+      width = std::max(width / 2, 1u);
+      height = std::max(height / 2, 1u);
+   }
+
+   pixelData.resize(totalSize);
+
+   std::memcpy(pixelData.data(), image.PixelData(), static_cast<std::size_t>(image.Width()) * image.Height() * numPixelComponents);
+
+   for (unsigned int level = 1; level < NumLevels(); ++level)
+   {
+      BuildLevel(level, sRGB, threadPool);
+   }
+}
+
+void MipChain::BuildLevel(unsigned int level, bool sRGB, ThreadPool* threadPool)
+{
+   const Level& source = levels[level - 1];
+   const Level& destination = levels[level];
+
+   const std::size_t sourceRowSize = static_cast<std::size_t>(source.width) * numPixelComponents;
+   const std::size_t destinationRowSize = static_cast<std::size_t>(destination.width) * numPixelComponents;
+
+   const unsigned char* sourceData = pixelData.data() + source.offset;
+   unsigned char* destinationData = pixelData.data() + destination.offset;
+
+   //checked at run time rather than only at compile time so that tests can
+   //compare the two paths with LimitInstructionSet
+   const bool useSSE2 = (DetectInstructionSet() >= InstructionSet::SSE2);
+
+   auto filterRows = [&](std::size_t beginRow, std::size_t endRow)
+   {
+      RowFilterParams params;
+      params.sourceWidth = source.width;
+      params.destinationWidth = destination.width;
+      params.numPixelComponents = numPixelComponents;
+
+      for (std::size_t y = beginRow; y < endRow; ++y)
+      {
+         params.sourceRow0 = sourceData + (2 * y) * sourceRowSize;
+         params.sourceRow1 = sourceData + std::min<std::size_t>(2 * y + 1, source.height - 1) * sourceRowSize;
+         params.destinationRow = destinationData + y * destinationRowSize;
+
+         FilterRow(params, sRGB, useSSE2);
+      }
+   };
+
+   if ((threadPool != nullptr) && (static_cast<std::size_t>(destination.width) * destination.height >= Min_Pixels_For_Threading))
+   {
+      threadPool->ParallelFor(destination.height, 0, filterRows);
+   }
+   else
+   {
+      filterRows(0, destination.height);
+   }
+}
+
+unsigned int MipChain::NumLevels() const
+{
+   return static_cast<unsigned int>(levels.size());
+}
+
+unsigned int MipChain::NumPixelComponents() const
+{
+   return numPixelComponents;
+}
+
+const MipChain::Level& MipChain::GetLevel(unsigned int level) const
+{
+   assert(level < NumLevels());
+
+   return levels[level];
+}
+
+const unsigned char* MipChain::LevelPixelData(unsigned int level) const
+{
+   assert(level < NumLevels());
+
+   return pixelData.data() + levels[level].offset;
+}
+
+const std::vector<unsigned char>& MipChain::PixelData() const
+{
+   return pixelData;
+}
+
+}
\ No newline at end of file
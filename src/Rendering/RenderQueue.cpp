@@ -0,0 +1,209 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "Locus/Rendering/RenderQueue.h"
+#include "Locus/Rendering/RenderingState.h"
+#include "Locus/Rendering/ShaderVariables.h"
+#include "Locus/Rendering/Texture.h"
+#include "Locus/Rendering/GPUVertexData.h"
+#include "Locus/Rendering/SingleDrawable.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <cassert>
+
+namespace Locus
+{
+
+static const unsigned int Layer_Shift = 56;
+static const unsigned int Program_Shift = 40;
+static const unsigned int Texture_Shift = 20;
+
+static const std::uint64_t Program_Mask = (std::uint64_t(1) << 16) - 1;
+static const std::uint64_t Pointer_Mask = (std::uint64_t(1) << 20) - 1;
+
+//The key only needs equal objects to get equal bits, so pointers are
+//folded into 20 bits. Two objects sharing bits only costs an extra state
+//change, because Submit compares the real pointers.
+static std::uint64_t FoldPointer(const void* pointer)
+{
+   std::uint64_t bits = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(pointer)) >> 4;
+
+   return (bits ^ (bits >> 20) ^ (bits >> 40)) & Pointer_Mask;
+}
+
+template <class PacketFunc>
+static void ForEachStateChange(const std::vector<RenderQueue::Packet>& packets, const std::vector<std::pair<std::uint64_t, std::uint32_t>>& order, PacketFunc packetFunc)
+{
+   ID_t currentProgram = BAD_ID;
+   const Texture* currentTexture = nullptr;
+   const GPUVertexData* currentVertexData = nullptr;
+
+   for (const std::pair<std::uint64_t, std::uint32_t>& keyAndIndex : order)
+   {
+      const RenderQueue::Packet& packet = packets[keyAndIndex.second];
+
+      bool programChanged = (packet.program != currentProgram);
+
+      //changing the program disables the attributes of the previous
+      //one, so the vertex data has to be set up again
+      bool textureChanged = (packet.texture != currentTexture) && (packet.texture != nullptr);
+      bool vertexDataChanged = programChanged || (packet.vertexData != currentVertexData);
+
+      packetFunc(packet, programChanged, textureChanged, vertexDataChanged);
+
+      currentProgram = packet.program;
+      currentVertexData = packet.vertexData;
+
+      if (packet.texture != nullptr)
+      {
+         currentTexture = packet.texture;
+      }
+   }
+}
+
+RenderQueue::RenderQueue()
+{
+}
+
+void RenderQueue::Clear()
+{
+   packets.clear();
+   order.clear();
+}
+
+void RenderQueue::Reserve(std::size_t numPackets)
+{
+   packets.reserve(numPackets);
+   order.reserve(numPackets);
+}
+
+void RenderQueue::Add(ID_t program, const Texture* texture, const GPUVertexData* vertexData, const Transformation& modelTransformation, unsigned int layer)
+{
+   assert(layer <= Max_Layer);
+   assert(packets.size() < std::numeric_limits<std::uint32_t>::max());
+
+   if (vertexData == nullptr)
+   {
+      return;
+   }
+
+   order.emplace_back(MakeSortKey(layer, program, texture, vertexData), static_cast<std::uint32_t>(packets.size()));
+
+   packets.push_back(Packet{program, texture, vertexData, modelTransformation});
+}
+
+void RenderQueue::Add(ID_t program, const Texture* texture, const SingleDrawable& drawable, const Transformation& modelTransformation, unsigned int layer)
+{
+   Add(program, texture, drawable.GetGPUVertexData(), modelTransformation, layer);
+}
+
+std::size_t RenderQueue::Size() const
+{
+   return packets.size();
+}
+
+const RenderQueue::Packet& RenderQueue::operator[](std::size_t packetIndex) const
+{
+   return packets[packetIndex];
+}
+
+void RenderQueue::Sort()
+{
+   //the packet index breaks ties, so equal keys keep their recorded order
+   std::sort(order.begin(), order.end());
+}
+
+std::vector<std::size_t> RenderQueue::GetSubmissionOrder() const
+{
+   std::vector<std::size_t> submissionOrder;
+   submissionOrder.reserve(order.size());
+
+   for (const std::pair<std::uint64_t, std::uint32_t>& keyAndIndex : order)
+   {
+      submissionOrder.push_back(keyAndIndex.second);
+   }
+
+   return submissionOrder;
+}
+
+RenderQueue::StateChanges RenderQueue::CountStateChanges() const
+{
+   StateChanges stateChanges = {0, 0, 0, 0};
+
+   ForEachStateChange(packets, order, [&stateChanges](const Packet& /*packet*/, bool programChanged, bool textureChanged, bool vertexDataChanged)
+   {
+      stateChanges.programChanges += programChanged;
+      stateChanges.textureChanges += textureChanged;
+      stateChanges.vertexDataChanges += vertexDataChanged;
+      ++stateChanges.drawCalls;
+   });
+
+   return stateChanges;
+}
+
+void RenderQueue::Submit(RenderingState& renderingState) const
+{
+   ShaderController& shaderController = renderingState.shaderController;
+
+   bool resetsClientState = (shaderController.GetActiveGLSLVersion() < GLInfo::GLSLVersion::V_130);
+
+   const GPUVertexData* preparedVertexData = nullptr;
+
+   ForEachStateChange(packets, order, [&](const Packet& packet, bool programChanged, bool textureChanged, bool vertexDataChanged)
+   {
+      if (programChanged)
+      {
+         shaderController.UseProgram(packet.program);
+      }
+
+      if (textureChanged)
+      {
+         packet.texture->Bind();
+      }
+
+      if (packet.texture != nullptr)
+      {
+         shaderController.SetTextureUniform(ShaderSource::UniformID::Map_Diffuse, 0);
+      }
+
+      renderingState.transformationStack.UploadTransformations(shaderController, packet.modelTransformation);
+
+      if (vertexDataChanged)
+      {
+         if (resetsClientState && (preparedVertexData != nullptr))
+         {
+            GPUVertexData::SetClientStateToDefault();
+         }
+
+         packet.vertexData->PreDraw(shaderController);
+
+         preparedVertexData = packet.vertexData;
+      }
+
+      packet.vertexData->DrawPrepared();
+   });
+
+   if (resetsClientState && (preparedVertexData != nullptr))
+   {
+      GPUVertexData::SetClientStateToDefault();
+   }
+}
+
+std::uint64_t RenderQueue::MakeSortKey(unsigned int layer, ID_t program, const Texture* texture, const GPUVertexData* vertexData)
+{
+   return (static_cast<std::uint64_t>(layer & Max_Layer) << Layer_Shift) |
+          ((static_cast<std::uint64_t>(program) & Program_Mask) << Program_Shift) |
+          (FoldPointer(texture) << Texture_Shift) |
+          FoldPointer(vertexData);
+}
+
+}
\ No newline at end of file
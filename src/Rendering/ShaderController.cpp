@@ -67,13 +67,13 @@ ID_t ShaderController::LoadShaderProgram(const Shader& shader1, const Shader& sh
    return thisProgramID;
 }
 
-ID_t ShaderController::LoadShaderProgram(GLInfo::GLSLVersion activeGLSLVersion, bool doesTexturing, unsigned int numLights)
+ID_t ShaderController::LoadShaderProgram(GLInfo::GLSLVersion activeGLSLVersion, bool doesTexturing, unsigned int numLights, bool doesInstancing)
 {
    ID_t thisProgramID = nextProgramID;
 
    shaderProgramMap[thisProgramID] = std::make_unique<ShaderProgram>
    (
-      Shader(Shader::ShaderType::Vertex, Locus::ShaderSource::Vert(activeGLSLVersion, doesTexturing, numLights)),
+      Shader(Shader::ShaderType::Vertex, Locus::ShaderSource::Vert(activeGLSLVersion, doesTexturing, numLights, doesInstancing)),
       Shader(Shader::ShaderType::Fragment, Locus::ShaderSource::Frag(activeGLSLVersion, doesTexturing, numLights)),
       doesTexturing,
       (numLights > 0)
@@ -92,6 +92,8 @@ void ShaderController::SetTextureUniform(const std::string& whichTex, GLuint tex
 
       if (uniformLocation != -1)
       {
+         currentProgram->ForgetUniformValue(uniformLocation);
+
          glUniform1i(uniformLocation, textureUnit);
       }
    }
@@ -105,6 +107,8 @@ void ShaderController::SetMatrix4Uniform(const std::string& whichMatrix, const f
 
       if (uniformLocation != -1)
       {
+         currentProgram->ForgetUniformValue(uniformLocation);
+
          glUniformMatrix4fv(uniformLocation, 1, GL_FALSE, matrixElements);
       }
    }
@@ -118,76 +122,56 @@ void ShaderController::SetMatrix3Uniform(const std::string& whichMatrix, const f
 
       if (uniformLocation != -1)
       {
+         currentProgram->ForgetUniformValue(uniformLocation);
+
          glUniformMatrix3fv(uniformLocation, 1, GL_FALSE, matrixElements);
       }
    }
 }
 
-void ShaderController::SetGlobalAmbientLightColorUniform(const Color& globalAmbientColor)
+void ShaderController::SetTextureUniform(ShaderSource::UniformID whichTex, GLuint textureUnit)
 {
    if (currentProgram != nullptr)
    {
-      GLint globalAmbientLightColorUniformLocation = currentProgram->GetUniformLocation(ShaderSource::Light_GlobalAmbient);
-
-      if (globalAmbientLightColorUniformLocation != -1)
-      {
-         glUniform4f(globalAmbientLightColorUniformLocation, globalAmbientColor.r / 255.0f, globalAmbientColor.g / 255.0f, globalAmbientColor.b / 255.0f, globalAmbientColor.a / 255.0f);
-      }
+      currentProgram->SetUniform(whichTex, static_cast<GLint>(textureUnit));
    }
 }
 
-void ShaderController::SetLightUniforms(unsigned int whichLight, const Light& light)
+void ShaderController::SetMatrix4Uniform(ShaderSource::UniformID whichMatrix, const float* matrixElements)
 {
    if (currentProgram != nullptr)
    {
-      GLint eyePosUniformLocation = currentProgram->GetUniformLocation( ShaderSource::GetMultiVariableName(ShaderSource::Light_EyePos, whichLight) );
-
-      if (eyePosUniformLocation != -1)
-      {
-         glUniform3f(eyePosUniformLocation, light.eyePosition.x, light.eyePosition.y, light.eyePosition.z);
-      }
-
-      GLint diffuseLightUniformLocation = currentProgram->GetUniformLocation( ShaderSource::GetMultiVariableName(ShaderSource::Light_Diffuse, whichLight) );
-
-      if (diffuseLightUniformLocation != -1)
-      {
-         glUniform4f(diffuseLightUniformLocation, light.diffuseColor.r / 255.0f, light.diffuseColor.g / 255.0f, light.diffuseColor.b / 255.0f, light.diffuseColor.a / 255.0f);
-      }
-
-      GLint ambientLightUniformLocation = currentProgram->GetUniformLocation( ShaderSource::GetMultiVariableName(ShaderSource::Light_Ambient, whichLight) );
-
-      if (ambientLightUniformLocation != -1)
-      {
-         glUniform4f(ambientLightUniformLocation, light.ambientColor.r / 255.0f, light.ambientColor.g / 255.0f, light.ambientColor.b / 255.0f, light.ambientColor.a / 255.0f);
-      }
-
-      GLint specularLightUniformLocation = currentProgram->GetUniformLocation( ShaderSource::GetMultiVariableName(ShaderSource::Light_Specular, whichLight) );
-
-      if (specularLightUniformLocation != -1)
-      {
-         glUniform4f(specularLightUniformLocation, light.specularColor.r / 255.0f, light.specularColor.g / 255.0f, light.specularColor.b / 255.0f, light.specularColor.a / 255.0f);
-      }
-
-      GLint attenuationUniformLocation = currentProgram->GetUniformLocation( ShaderSource::GetMultiVariableName(ShaderSource::Light_Attenuation, whichLight) );
-
-      if (attenuationUniformLocation != -1)
-      {
-         glUniform1f(attenuationUniformLocation, light.attenuation);
-      }
-
-      GLint linearAttenuationUniformLocation = currentProgram->GetUniformLocation( ShaderSource::GetMultiVariableName(ShaderSource::Light_LinearAttenuation, whichLight) );
+      currentProgram->SetUniformMatrix4(whichMatrix, matrixElements);
+   }
+}
 
-      if (linearAttenuationUniformLocation != -1)
-      {
-         glUniform1f(linearAttenuationUniformLocation, light.linearAttenuation);
-      }
+void ShaderController::SetMatrix3Uniform(ShaderSource::UniformID whichMatrix, const float* matrixElements)
+{
+   if (currentProgram != nullptr)
+   {
+      currentProgram->SetUniformMatrix3(whichMatrix, matrixElements);
+   }
+}
 
-      GLint quadraticAttenuationUniformLocation = currentProgram->GetUniformLocation( ShaderSource::GetMultiVariableName(ShaderSource::Light_QuadraticAttenuation, whichLight) );
+void ShaderController::SetGlobalAmbientLightColorUniform(const Color& globalAmbientColor)
+{
+   if (currentProgram != nullptr)
+   {
+      currentProgram->SetUniform(ShaderSource::UniformID::Light_GlobalAmbient, globalAmbientColor.r / 255.0f, globalAmbientColor.g / 255.0f, globalAmbientColor.b / 255.0f, globalAmbientColor.a / 255.0f);
+   }
+}
 
-      if (quadraticAttenuationUniformLocation != -1)
-      {
-         glUniform1f(quadraticAttenuationUniformLocation, light.quadraticAttenuation);
-      }
+void ShaderController::SetLightUniforms(unsigned int whichLight, const Light& light)
+{
+   if ((currentProgram != nullptr) && (whichLight < currentProgram->NumLights()))
+   {
+      currentProgram->SetLightUniform(whichLight, ShaderSource::LightUniformID::EyePos, light.eyePosition.x, light.eyePosition.y, light.eyePosition.z);
+      currentProgram->SetLightUniform(whichLight, ShaderSource::LightUniformID::Diffuse, light.diffuseColor.r / 255.0f, light.diffuseColor.g / 255.0f, light.diffuseColor.b / 255.0f, light.diffuseColor.a / 255.0f);
+      currentProgram->SetLightUniform(whichLight, ShaderSource::LightUniformID::Ambient, light.ambientColor.r / 255.0f, light.ambientColor.g / 255.0f, light.ambientColor.b / 255.0f, light.ambientColor.a / 255.0f);
+      currentProgram->SetLightUniform(whichLight, ShaderSource::LightUniformID::Specular, light.specularColor.r / 255.0f, light.specularColor.g / 255.0f, light.specularColor.b / 255.0f, light.specularColor.a / 255.0f);
+      currentProgram->SetLightUniform(whichLight, ShaderSource::LightUniformID::Attenuation, light.attenuation);
+      currentProgram->SetLightUniform(whichLight, ShaderSource::LightUniformID::LinearAttenuation, light.linearAttenuation);
+      currentProgram->SetLightUniform(whichLight, ShaderSource::LightUniformID::QuadraticAttenuation, light.quadraticAttenuation);
    }
 }
 
@@ -227,6 +211,26 @@ GLint ShaderController::EnableAttribute(const std::string& attribute)
    }
 }
 
+GLint ShaderController::EnableAttribute(const std::string& attribute, unsigned int numLocations)
+{
+   if (currentProgram != nullptr)
+   {
+      return currentProgram->EnableAttribute(attribute, numLocations);
+   }
+   else
+   {
+      return -1;
+   }
+}
+
+void ShaderController::DisableAttribute(const std::string& attribute, unsigned int numLocations)
+{
+   if (currentProgram != nullptr)
+   {
+      currentProgram->DisableAttribute(attribute, numLocations);
+   }
+}
+
 void ShaderController::DisableCurrentProgramAttributes()
 {
    if (currentProgram != nullptr)
@@ -11,10 +11,14 @@
 #include "Locus/Rendering/ShaderProgram.h"
 #include "Locus/Rendering/ShaderSourceStore.h"
 #include "Locus/Rendering/ShaderLinkException.h"
+#include "Locus/Rendering/ShaderVariables.h"
 
 #include <Locus/Rendering/Locus_glew.h>
 
 #include <vector>
+#include <algorithm>
+
+#include <cassert>
 
 namespace Locus
 {
@@ -52,6 +56,8 @@ ShaderProgram::ShaderProgram(const Shader& shader1, const Shader& shader2, bool
 
       throw ShaderLinkException(std::string("Shader program failed to link.\n\nLog:\n") + log);
    }
+
+   ResolveUniformLocations();
 }
 
 ShaderProgram::~ShaderProgram()
@@ -59,9 +65,95 @@ ShaderProgram::~ShaderProgram()
    glDeleteProgram(id);
 }
 
+ShaderProgram::CachedUniform::CachedUniform()
+   : location(-1), hasIntValue(false), intValue(0), numValues(0)
+{
+}
+
+bool ShaderProgram::CachedUniform::Update(const float* newValues, std::size_t numNewValues)
+{
+   assert(numNewValues <= Max_Uniform_Values);
+
+   if (location == -1)
+   {
+      return false;
+   }
+
+   if ((numValues == numNewValues) && std::equal(newValues, newValues + numNewValues, values.begin()))
+   {
+      return false;
+   }
+
+   std::copy(newValues, newValues + numNewValues, values.begin());
+   numValues = numNewValues;
+   hasIntValue = false;
+
+   return true;
+}
+
+bool ShaderProgram::CachedUniform::Update(GLint newValue)
+{
+   if (location == -1)
+   {
+      return false;
+   }
+
+   if (hasIntValue && (intValue == newValue))
+   {
+      return false;
+   }
+
+   intValue = newValue;
+   hasIntValue = true;
+   numValues = 0;
+
+   return true;
+}
+
+void ShaderProgram::CachedUniform::Forget()
+{
+   hasIntValue = false;
+   numValues = 0;
+}
+
+void ShaderProgram::ResolveUniformLocations()
+{
+   for (std::size_t uniformIndex = 0; uniformIndex < uniforms.size(); ++uniformIndex)
+   {
+      uniforms[uniformIndex].location = glGetUniformLocation(id, ShaderSource::GetUniformName(static_cast<ShaderSource::UniformID>(uniformIndex)).c_str());
+   }
+
+   //the generated shaders declare the light uniforms with consecutive
+   //indices, so stop at the first light that has none of them
+   for (unsigned int whichLight = 0; ; ++whichLight)
+   {
+      LightUniforms_t lightUniformsForLight;
+
+      bool foundAnyLightUniform = false;
+
+      for (std::size_t lightUniformIndex = 0; lightUniformIndex < lightUniformsForLight.size(); ++lightUniformIndex)
+      {
+         const std::string& lightUniformName = ShaderSource::GetLightUniformName(static_cast<ShaderSource::LightUniformID>(lightUniformIndex));
+
+         GLint location = glGetUniformLocation(id, ShaderSource::GetMultiVariableName(lightUniformName, whichLight).c_str());
+
+         lightUniformsForLight[lightUniformIndex].location = location;
+
+         foundAnyLightUniform = foundAnyLightUniform || (location != -1);
+      }
+
+      if (!foundAnyLightUniform)
+      {
+         break;
+      }
+
+      lightUniforms.push_back(lightUniformsForLight);
+   }
+}
+
 GLint ShaderProgram::GetAttributeLocation(const std::string& attribute) const
 {
-   std::map<std::string, GLint>::const_iterator iter = attributeLocationMap.find(attribute);
+   std::unordered_map<std::string, GLint>::const_iterator iter = attributeLocationMap.find(attribute);
 
    if (iter != attributeLocationMap.end())
    {
@@ -79,7 +171,7 @@ GLint ShaderProgram::GetAttributeLocation(const std::string& attribute) const
 
 GLint ShaderProgram::GetUniformLocation(const std::string& uniform) const
 {
-   std::map<std::string, GLint>::const_iterator iter = uniformLocationMap.find(uniform);
+   std::unordered_map<std::string, GLint>::const_iterator iter = uniformLocationMap.find(uniform);
 
    if (iter != uniformLocationMap.end())
    {
@@ -95,6 +187,143 @@ GLint ShaderProgram::GetUniformLocation(const std::string& uniform) const
    }
 }
 
+GLint ShaderProgram::GetUniformLocation(ShaderSource::UniformID uniform) const
+{
+   return uniforms[static_cast<std::size_t>(uniform)].location;
+}
+
+GLint ShaderProgram::GetLightUniformLocation(unsigned int whichLight, ShaderSource::LightUniformID lightUniform) const
+{
+   if (whichLight < lightUniforms.size())
+   {
+      return lightUniforms[whichLight][static_cast<std::size_t>(lightUniform)].location;
+   }
+   else
+   {
+      return -1;
+   }
+}
+
+unsigned int ShaderProgram::NumLights() const
+{
+   return static_cast<unsigned int>(lightUniforms.size());
+}
+
+void ShaderProgram::SetUniform(ShaderSource::UniformID uniform, GLint value)
+{
+   CachedUniform& cachedUniform = uniforms[static_cast<std::size_t>(uniform)];
+
+   if (cachedUniform.Update(value))
+   {
+      glUniform1i(cachedUniform.location, value);
+   }
+}
+
+void ShaderProgram::SetUniform(ShaderSource::UniformID uniform, float x, float y, float z, float w)
+{
+   CachedUniform& cachedUniform = uniforms[static_cast<std::size_t>(uniform)];
+
+   const float values[] = {x, y, z, w};
+
+   if (cachedUniform.Update(values, 4))
+   {
+      glUniform4f(cachedUniform.location, x, y, z, w);
+   }
+}
+
+void ShaderProgram::SetUniformMatrix3(ShaderSource::UniformID uniform, const float* matrixElements)
+{
+   CachedUniform& cachedUniform = uniforms[static_cast<std::size_t>(uniform)];
+
+   if (cachedUniform.Update(matrixElements, 9))
+   {
+      glUniformMatrix3fv(cachedUniform.location, 1, GL_FALSE, matrixElements);
+   }
+}
+
+void ShaderProgram::SetUniformMatrix4(ShaderSource::UniformID uniform, const float* matrixElements)
+{
+   CachedUniform& cachedUniform = uniforms[static_cast<std::size_t>(uniform)];
+
+   if (cachedUniform.Update(matrixElements, 16))
+   {
+      glUniformMatrix4fv(cachedUniform.location, 1, GL_FALSE, matrixElements);
+   }
+}
+
+ShaderProgram::CachedUniform* ShaderProgram::GetLightUniform(unsigned int whichLight, ShaderSource::LightUniformID lightUniform)
+{
+   if (whichLight < lightUniforms.size())
+   {
+      return &lightUniforms[whichLight][static_cast<std::size_t>(lightUniform)];
+   }
+   else
+   {
+      return nullptr;
+   }
+}
+
+void ShaderProgram::SetLightUniform(unsigned int whichLight, ShaderSource::LightUniformID lightUniform, float value)
+{
+   CachedUniform* cachedUniform = GetLightUniform(whichLight, lightUniform);
+
+   if ((cachedUniform != nullptr) && cachedUniform->Update(&value, 1))
+   {
+      glUniform1f(cachedUniform->location, value);
+   }
+}
+
+void ShaderProgram::SetLightUniform(unsigned int whichLight, ShaderSource::LightUniformID lightUniform, float x, float y, float z)
+{
+   CachedUniform* cachedUniform = GetLightUniform(whichLight, lightUniform);
+
+   const float values[] = {x, y, z};
+
+   if ((cachedUniform != nullptr) && cachedUniform->Update(values, 3))
+   {
+      glUniform3f(cachedUniform->location, x, y, z);
+   }
+}
+
+void ShaderProgram::SetLightUniform(unsigned int whichLight, ShaderSource::LightUniformID lightUniform, float x, float y, float z, float w)
+{
+   CachedUniform* cachedUniform = GetLightUniform(whichLight, lightUniform);
+
+   const float values[] = {x, y, z, w};
+
+   if ((cachedUniform != nullptr) && cachedUniform->Update(values, 4))
+   {
+      glUniform4f(cachedUniform->location, x, y, z, w);
+   }
+}
+
+void ShaderProgram::ForgetUniformValue(GLint location)
+{
+   if (location == -1)
+   {
+      return;
+   }
+
+   for (CachedUniform& cachedUniform : uniforms)
+   {
+      if (cachedUniform.location == location)
+      {
+         cachedUniform.Forget();
+      }
+   }
+
+   for (LightUniforms_t& lightUniformsForLight : lightUniforms)
+   {
+      for (CachedUniform& cachedUniform : lightUniformsForLight)
+      {
+         if (cachedUniform.location == location)
+         {
+            cachedUniform.Forget();
+         }
+      }
+   }
+}
+
 GLint ShaderProgram::EnableAttribute(const std::string& attribute)
 {
    GLint attributeLocation = GetAttributeLocation(attribute);
@@ -109,6 +338,39 @@ GLint ShaderProgram::EnableAttribute(const std::string& attribute)
    return attributeLocation;
 }
 
+GLint ShaderProgram::EnableAttribute(const std::string& attribute, unsigned int numLocations)
+{
+   GLint attributeLocation = GetAttributeLocation(attribute);
+
+   if (attributeLocation != -1)
+   {
+      for (unsigned int locationOffset = 0; locationOffset < numLocations; ++locationOffset)
+      {
+         glEnableVertexAttribArray(attributeLocation + locationOffset);
+
+         enabledAttributes.insert(attributeLocation + locationOffset);
+      }
+   }
+
+   return attributeLocation;
+}
+
+void ShaderProgram::DisableAttribute(const std::string& attribute, unsigned int numLocations)
+{
+   GLint attributeLocation = GetAttributeLocation(attribute);
+
+   if (attributeLocation != -1)
+   {
+      for (unsigned int locationOffset = 0; locationOffset < numLocations; ++locationOffset)
+      {
+         if (enabledAttributes.erase(attributeLocation + locationOffset) > 0)
+         {
+            glDisableVertexAttribArray(attributeLocation + locationOffset);
+         }
+      }
+   }
+}
+
 void ShaderProgram::DisableProgramAttributes()
 {
    for (GLint attributeLocation : enabledAttributes)
@@ -54,7 +54,7 @@ static const char* const Low = "lowp";
 
 static const std::string FragColorVar130 = "mygl_FragColor";
 
-static std::string Vert_1_30(bool textured, unsigned int numLights);
+static std::string Vert_1_30(bool textured, unsigned int numLights, bool instanced);
 static std::string Frag_1_30(bool textured, unsigned int numLights);
 static std::string Vert_Pre_1_30(GLInfo::GLSLVersion version, bool textured, unsigned int numLights);
 static std::string Frag_Pre_1_30(GLInfo::GLSLVersion version, bool textured, unsigned int numLights);
@@ -133,11 +133,11 @@ static void AddInOutVar(std::string& source, const char* varType, const std::str
    }
 }
 
-std::string Vert(GLInfo::GLSLVersion version, bool textured, unsigned int numLights)
+std::string Vert(GLInfo::GLSLVersion version, bool textured, unsigned int numLights, bool instanced)
 {
    if (version == GLInfo::GLSLVersion::V_130)
    {
-      return Vert_1_30(textured, numLights);
+      return Vert_1_30(textured, numLights, instanced);
    }
    else
    {
@@ -160,7 +160,7 @@ std::string Frag(GLInfo::GLSLVersion version, bool textured, unsigned int numLig
 ///////////////////////////// 1.30 Shaders ////////////////////////////////////
 
 //{CodeReview:ShaderGeneration}
-static std::string Vert_1_30(bool textured, unsigned int numLights)
+static std::string Vert_1_30(bool textured, unsigned int numLights, bool instanced)
 {
    GLInfo::GLSLVersion version = GLInfo::GLSLVersion::V_130;
 
@@ -177,6 +177,12 @@ static std::string Vert_1_30(bool textured, unsigned int numLights)
 
    AddVar(source, VariableSpecifiers::Uniform, VariableTypes::Mat4, Mat_MVP);
 
+   if (instanced)
+   {
+      AddVar(source, VariableSpecifiers::In, VariableTypes::Mat4, Instance_Model);
+      AddVar(source, VariableSpecifiers::In, VariableTypes::Vec4, Instance_Color);
+   }
+
    if (textured)
    {
       AddInOutVar(source, VariableTypes::Vec2, Vert_Tex, version);
@@ -207,7 +213,22 @@ static std::string Vert_1_30(bool textured, unsigned int numLights)
    source.append("void main()\n");
    source.append("{\n");
 
-   source.append(GetOutVariableName(Color) + " = " + Color + ";\n");
+   //when instanced, the uniform matrices only hold the view and projection,
+   //and the model matrix of each instance comes from Instance_Model
+   std::string positionVar = Vert_Pos;
+   std::string normalVar = Vert_Normal;
+
+   if (instanced)
+   {
+      positionVar = "instancePosition";
+
+      source.append(std::string("vec4 ") + positionVar + " = " + Instance_Model + " * " + Vert_Pos + ";\n");
+      source.append(GetOutVariableName(Color) + " = " + Color + " * " + Instance_Color + ";\n");
+   }
+   else
+   {
+      source.append(GetOutVariableName(Color) + " = " + Color + ";\n");
+   }
 
    if (textured)
    {
@@ -218,9 +239,15 @@ static std::string Vert_1_30(bool textured, unsigned int numLights)
    {
       std::string positionInViewSpaceVar = "positionInViewSpace";
 
-      source.append(GetOutVariableName(Vert_Normal) + " = normalize(" + Mat_Normal + " * " + Vert_Normal + ");\n");
+      if (instanced)
+      {
+         //as with Mat_Normal, this assumes the model matrix has no non-uniform scales
+         normalVar = std::string("(mat3(") + Instance_Model + ") * " + Vert_Normal + ")";
+      }
+
+      source.append(GetOutVariableName(Vert_Normal) + " = normalize(" + Mat_Normal + " * " + normalVar + ");\n");
 
-      source.append(std::string("vec3 ") + positionInViewSpaceVar + " = vec3(" + Mat_MV + " * " + Vert_Pos + ");\n");
+      source.append(std::string("vec3 ") + positionInViewSpaceVar + " = vec3(" + Mat_MV + " * " + positionVar + ");\n");
       //source.append(ToEyeDirection + " = -" + positionInViewSpaceVar + ";\n");
 
       std::string lightDistanceVar = "lightDistance";
@@ -244,7 +271,7 @@ static std::string Vert_1_30(bool textured, unsigned int numLights)
       }
    }
 
-   source.append(std::string("gl_Position = ") + Mat_MVP + " * " + Vert_Pos + ";\n");
+   source.append(std::string("gl_Position = ") + Mat_MVP + " * " + positionVar + ";\n");
 
    source.append("}");
 
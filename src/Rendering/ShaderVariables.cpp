@@ -10,6 +10,8 @@
 
 #include "Locus/Rendering/ShaderVariables.h"
 
+#include <cassert>
+
 namespace Locus
 {
 
@@ -25,6 +27,9 @@ LOCUS_RENDERING_API_AT_DEFINITION const std::string Vert_Pos = "Vert_Pos";
 LOCUS_RENDERING_API_AT_DEFINITION const std::string Vert_Tex = "Vert_Tex";
 LOCUS_RENDERING_API_AT_DEFINITION const std::string Vert_Normal = "Vert_Normal";
 
+LOCUS_RENDERING_API_AT_DEFINITION const std::string Instance_Model = "Instance_Model";
+LOCUS_RENDERING_API_AT_DEFINITION const std::string Instance_Color = "Instance_Color";
+
 LOCUS_RENDERING_API_AT_DEFINITION const std::string Light_GlobalAmbient = "Light_Global_Ambient";
 LOCUS_RENDERING_API_AT_DEFINITION const std::string Light_EyePos = "Light_EyePos";
 LOCUS_RENDERING_API_AT_DEFINITION const std::string Light_Diffuse = "Light_Diffuse";
@@ -37,6 +42,58 @@ LOCUS_RENDERING_API_AT_DEFINITION const std::string ToLightDirection = "ToLightD
 LOCUS_RENDERING_API_AT_DEFINITION const std::string ToEyeDirection = "ToEyeDirection";
 LOCUS_RENDERING_API_AT_DEFINITION const std::string CalculatedLightAttenuation = "CalculatedLightAttenuation";
 
+const std::string& GetUniformName(UniformID uniform)
+{
+   switch (uniform)
+   {
+   case UniformID::Map_Diffuse:
+      return Map_Diffuse;
+
+   case UniformID::Mat_MVP:
+      return Mat_MVP;
+
+   case UniformID::Mat_MV:
+      return Mat_MV;
+
+   case UniformID::Mat_Normal:
+      return Mat_Normal;
+
+   case UniformID::Light_GlobalAmbient:
+   default:
+      assert(uniform == UniformID::Light_GlobalAmbient);
+      return Light_GlobalAmbient;
+   }
+}
+
+const std::string& GetLightUniformName(LightUniformID lightUniform)
+{
+   switch (lightUniform)
+   {
+   case LightUniformID::EyePos:
+      return Light_EyePos;
+
+   case LightUniformID::Diffuse:
+      return Light_Diffuse;
+
+   case LightUniformID::Ambient:
+      return Light_Ambient;
+
+   case LightUniformID::Specular:
+      return Light_Specular;
+
+   case LightUniformID::Attenuation:
+      return Light_Attenuation;
+
+   case LightUniformID::LinearAttenuation:
+      return Light_LinearAttenuation;
+
+   case LightUniformID::QuadraticAttenuation:
+   default:
+      assert(lightUniform == LightUniformID::QuadraticAttenuation);
+      return Light_QuadraticAttenuation;
+   }
+}
+
 }
 
 }
\ No newline at end of file
@@ -24,6 +24,11 @@ void SingleDrawable::DeleteGPUVertexData()
    gpuVertexData.reset();
 }
 
+const GPUVertexData* SingleDrawable::GetGPUVertexData() const
+{
+   return gpuVertexData.get();
+}
+
 void SingleDrawable::Draw(RenderingState& renderingState) const
 {
    if (gpuVertexData != nullptr)
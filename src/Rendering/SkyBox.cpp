@@ -87,7 +87,7 @@ void SkyBox::UpdateGPUVertexData()
 
 void SkyBox::Draw(RenderingState& renderingState) const
 {
-   renderingState.shaderController.SetTextureUniform(ShaderSource::Map_Diffuse, 0);
+   renderingState.shaderController.SetTextureUniform(ShaderSource::UniformID::Map_Diffuse, 0);
 
    if (frontTexture != nullptr)
    {
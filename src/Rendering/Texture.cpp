@@ -11,12 +11,13 @@
 #include "Locus/Rendering/Texture.h"
 #include "Locus/Rendering/GLInfo.h"
 #include "Locus/Rendering/Image.h"
+#include "Locus/Rendering/MipChain.h"
+#include "Locus/Rendering/BakedTexture.h"
 
-#include <Locus/Rendering/Locus_glew.h>
+#include "Locus/Common/Exception.h"
 
-#include <algorithm>
+#include <Locus/Rendering/Locus_glew.h>
 
-#include <cmath>
 #include <cassert>
 
 namespace Locus
@@ -28,30 +29,72 @@ Texture::Texture(const Image& image, MipmapGeneration mipmapGeneration, TextureF
 
    Bind();
 
-   bool linearFiltering = (filtering == TextureFiltering::Linear);
+   Texture::SetFiltering(mipmapGeneration != MipmapGeneration::None, filtering);
 
-   GLint minFilterParam;
+   GenerateMipmaps(image, mipmapGeneration, glInfo);
 
-   if (mipmapGeneration == MipmapGeneration::None)
+   Texture::SetWrapping(clamp);
+}
+
+Texture::Texture(const MipChain& mipChain, TextureFiltering filtering, bool clamp)
+{
+   glGenTextures(1, &id);
+
+   Bind();
+
+   Texture::SetFiltering(mipChain.NumLevels() > 1, filtering);
+
+   Texture::SetUnpackAlignmentForPixelComponents(mipChain.NumPixelComponents());
+
+   for (unsigned int level = 0; level < mipChain.NumLevels(); ++level)
    {
-      minFilterParam = linearFiltering ? GL_LINEAR : GL_NEAREST;
+      const MipChain::Level& mipLevel = mipChain.GetLevel(level);
+
+      Texture::SendTextureData(mipChain.LevelPixelData(level), mipLevel.width, mipLevel.height, mipChain.NumPixelComponents(), static_cast<GLint>(level));
    }
-   else
+
+   Texture::SetWrapping(clamp);
+}
+
+Texture::Texture(const BakedTexture& bakedTexture, TextureFiltering filtering, bool clamp)
+{
+   BakedTexture::Format format = bakedTexture.GetFormat();
+
+   bool compressed = (format != BakedTexture::Format::Uncompressed);
+
+   if (compressed && !(GLEW_VERSION_1_3 && GLEW_EXT_texture_compression_s3tc))
    {
-      minFilterParam = linearFiltering ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR;
+      throw Exception("S3TC texture compression is not supported");
    }
 
-   GLint magFilterParam = linearFiltering ? GL_LINEAR : GL_NEAREST;
+   glGenTextures(1, &id);
 
-   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilterParam);
-   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilterParam);
+   Bind();
 
-   GenerateMipmaps(image, mipmapGeneration, glInfo);
+   Texture::SetFiltering(bakedTexture.NumLevels() > 1, filtering);
 
-   bool doClamp = (clamp && (GLEW_VERSION_1_2 || glewIsExtensionSupported("GL_EXT_texture_edge_clamp")));
+   if (!compressed)
+   {
+      Texture::SetUnpackAlignmentForPixelComponents(bakedTexture.NumPixelComponents());
+   }
 
-   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, doClamp ? GL_CLAMP_TO_EDGE : GL_REPEAT);
-   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, doClamp ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+   GLenum compressedFormat = ((format == BakedTexture::Format::BC1) ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+
+   for (unsigned int level = 0; level < bakedTexture.NumLevels(); ++level)
+   {
+      const BakedTexture::Level& bakedLevel = bakedTexture.GetLevel(level);
+
+      if (compressed)
+      {
+         glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), compressedFormat, bakedLevel.width, bakedLevel.height, 0, static_cast<GLsizei>(bakedLevel.sizeInBytes), bakedLevel.pixelData);
+      }
+      else
+      {
+         Texture::SendTextureData(bakedLevel.pixelData, bakedLevel.width, bakedLevel.height, bakedTexture.NumPixelComponents(), static_cast<GLint>(level));
+      }
+   }
+
+   Texture::SetWrapping(clamp);
 }
 
 Texture::~Texture()
@@ -64,6 +107,35 @@ void Texture::Bind() const
    glBindTexture(GL_TEXTURE_2D, id);
 }
 
+void Texture::SetFiltering(bool mipmapped, TextureFiltering filtering)
+{
+   bool linearFiltering = (filtering == TextureFiltering::Linear);
+
+   GLint minFilterParam;
+
+   if (!mipmapped)
+   {
+      minFilterParam = linearFiltering ? GL_LINEAR : GL_NEAREST;
+   }
+   else
+   {
+      minFilterParam = linearFiltering ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR;
+   }
+
+   GLint magFilterParam = linearFiltering ? GL_LINEAR : GL_NEAREST;
+
+   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilterParam);
+   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilterParam);
+}
+
+void Texture::SetWrapping(bool clamp)
+{
+   bool doClamp = (clamp && (GLEW_VERSION_1_2 || glewIsExtensionSupported("GL_EXT_texture_edge_clamp")));
+
+   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, doClamp ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, doClamp ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+}
+
 void Texture::SetUnpackAlignmentForPixelComponents(unsigned int numPixelComponents)
 {
    assert(Image::ValidPixelComponents(numPixelComponents));
@@ -136,8 +208,13 @@ GLint Texture::GLSizedFormat(unsigned int numPixelComponents)
 
 void Texture::SendTextureData(const Image& image, GLint textureLevel)
 {
-   GLint format = Texture::GLFormat(image.NumPixelComponents());
-   glTexImage2D(GL_TEXTURE_2D, textureLevel, format, image.Width(), image.Height(), 0, format, GL_UNSIGNED_BYTE, image.PixelData());
+   Texture::SendTextureData(image.PixelData(), image.Width(), image.Height(), image.NumPixelComponents(), textureLevel);
+}
+
+void Texture::SendTextureData(const unsigned char* pixelData, unsigned int width, unsigned int height, unsigned int numPixelComponents, GLint textureLevel)
+{
+   GLint format = Texture::GLFormat(numPixelComponents);
+   glTexImage2D(GL_TEXTURE_2D, textureLevel, format, width, height, 0, format, GL_UNSIGNED_BYTE, pixelData);
 }
 
 void Texture::GenerateMipmaps(const Image& image, MipmapGeneration mipmapGeneration, const GLInfo& glInfo) const
@@ -207,69 +284,31 @@ void Texture::GenerateMipmapsLegacy(const Image& image) const
    }
 }
 
-unsigned int Texture::ClosestPowerOf2(unsigned int num)
+void Texture::GenerateManualMipmaps(const Image& image) const
 {
-   assert(num >= 1);
-
-   unsigned int closestPowerOf2 = 1;
-   while (closestPowerOf2 < num)
+   if (image.HasPowerOf2Dimensions())
    {
-      closestPowerOf2 *= 2;
+      GenerateManualMipmapsUsingPowerOf2Image(image);
    }
-
-   if (closestPowerOf2 != 1)
+   else
    {
-      unsigned int previousPowerOf2 = closestPowerOf2 / 2;
-
-      unsigned int diffPrevious = num - previousPowerOf2;
-
-      if ((closestPowerOf2 - num) > diffPrevious)
-      {
-         closestPowerOf2 = previousPowerOf2;
-      }
-   }
-
-   return closestPowerOf2;
-}
-
-void Texture::GenerateManualMipmaps(const Image& image) const
-{
-   unsigned int closestXPowerOf2 = Texture::ClosestPowerOf2(image.Width());
-   unsigned int closestYPowerOf2 = Texture::ClosestPowerOf2(image.Height());
-
-   Image scaledImage(image);
+      Image scaledImage(image);
+      scaledImage.ScaleToClosestPowerOf2();
 
-   if ((closestXPowerOf2 != image.Width()) || (closestYPowerOf2 != image.Height()))
-   {
-      scaledImage.Scale(closestXPowerOf2, closestYPowerOf2);
+      GenerateManualMipmapsUsingPowerOf2Image(scaledImage);
    }
-
-   GenerateManualMipmapsUsingPowerOf2Image(scaledImage);
 }
 
-void Texture::GenerateManualMipmapsUsingPowerOf2Image(Image& image)
+void Texture::GenerateManualMipmapsUsingPowerOf2Image(const Image& image)
 {
-   GLint maxTextureSize = 0;
-   glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
-
-   const float log2 = std::log(2.0f);
-
-   int maxLevels = (int) (std::log((float) maxTextureSize) / log2) + 1;
+   //level 0 has already been sent, so every level of the chain fits within GL_MAX_TEXTURE_SIZE
+   MipChain mipChain(image, false);
 
-   int divisionsX = (int) std::ceil(std::log((float) image.Width()) / log2) + 1;
-   int divisionsY = (int) std::ceil(std::log((float) image.Height()) / log2) + 1;
-
-   int numLevels = std::max(divisionsX, divisionsY);
-   numLevels = std::min(numLevels, maxLevels);
-
-   for (int level = 1; level < numLevels; ++level)
+   for (unsigned int level = 1; level < mipChain.NumLevels(); ++level)
    {
-      unsigned int newWidth = ((image.Width() != 1) ? (image.Width() / 2) : 1);
-      unsigned int newHeight = ((image.Height() != 1) ? (image.Height() / 2) : 1);
-
-      image.Scale(newWidth, newHeight);
+      const MipChain::Level& mipLevel = mipChain.GetLevel(level);
 
-      Texture::SendTextureData(image, level);
+      Texture::SendTextureData(mipChain.LevelPixelData(level), mipLevel.width, mipLevel.height, mipChain.NumPixelComponents(), static_cast<GLint>(level));
    }
 }
 
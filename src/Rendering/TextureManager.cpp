@@ -11,12 +11,40 @@
 #include "Locus/Rendering/TextureManager.h"
 #include "Locus/Rendering/GLInfo.h"
 #include "Locus/Rendering/Image.h"
+#include "Locus/Rendering/MipChain.h"
+
+#include "Locus/FileSystem/MountedFilePath.h"
 
 namespace Locus
 {
 
+class TextureManagerUploader : public TextureUploader
+{
+public:
+   TextureManagerUploader(std::unordered_map<std::string, std::unique_ptr<Texture>>& textures, const GLInfo& glInfo)
+      : textures(textures), glInfo(glInfo)
+   {
+   }
+
+   virtual void Upload(StreamedTexture& streamedTexture) override
+   {
+      if (streamedTexture.mipChain)
+      {
+         textures[streamedTexture.textureName] = std::make_unique<Texture>(*streamedTexture.mipChain, streamedTexture.filtering, streamedTexture.clamp);
+      }
+      else
+      {
+         textures[streamedTexture.textureName] = std::make_unique<Texture>(*streamedTexture.image, streamedTexture.mipmapGeneration, streamedTexture.filtering, streamedTexture.clamp, glInfo);
+      }
+   }
+
+private:
+   std::unordered_map<std::string, std::unique_ptr<Texture>>& textures;
+   const GLInfo& glInfo;
+};
+
 TextureManager::TextureManager(const GLInfo& glInfo)
-   : glInfo(glInfo)
+   : glInfo(glInfo), uploader(std::make_unique<TextureManagerUploader>(textures, glInfo)), streamer(std::make_unique<TextureStreamer>(*uploader))
 {
 }
 
@@ -28,7 +56,7 @@ TextureManager::~TextureManager()
 template <class FilePathType>
 void TextureManager::Load(const std::string& textureName, const FilePathType& textureFilePath, Texture::MipmapGeneration mipmapGeneration, TextureFiltering filtering, bool clamp)
 {
-   if (textures.find(textureName) == textures.end())
+   if ((textures.find(textureName) == textures.end()) && (streamHandles.find(textureName) == streamHandles.end()))
    {
       textures[textureName] = std::make_unique<Texture>(Image(textureFilePath), mipmapGeneration, filtering, clamp, glInfo);
    }
@@ -44,6 +72,105 @@ void TextureManager::Load(const std::string& textureName, const MountedFilePath&
    Load<MountedFilePath>(textureName, textureLocation, mipmapGeneration, filtering, clamp);
 }
 
+template <class FilePathType>
+void TextureManager::LoadBaked(const std::string& textureName, const FilePathType& textureFilePath, const std::string& bakedFilePath, BakedTexture::Format format, TextureFiltering filtering, bool clamp)
+{
+   if ((textures.find(textureName) == textures.end()) && (streamHandles.find(textureName) == streamHandles.end()))
+   {
+      std::unique_ptr<BakedTexture> bakedTexture = BakedTexture::LoadOrBake(textureFilePath, bakedFilePath, format);
+
+      textures[textureName] = std::make_unique<Texture>(*bakedTexture, filtering, clamp);
+   }
+}
+
+void TextureManager::LoadBaked(const std::string& textureName, const std::string& textureLocation, const std::string& bakedFilePath, BakedTexture::Format format, TextureFiltering filtering, bool clamp)
+{
+   LoadBaked<std::string>(textureName, textureLocation, bakedFilePath, format, filtering, clamp);
+}
+
+void TextureManager::LoadBaked(const std::string& textureName, const MountedFilePath& textureLocation, const std::string& bakedFilePath, BakedTexture::Format format, TextureFiltering filtering, bool clamp)
+{
+   LoadBaked<MountedFilePath>(textureName, textureLocation, bakedFilePath, format, filtering, clamp);
+}
+
+template <class FilePathType>
+TextureStreamHandle_t TextureManager::LoadAsync(const std::string& textureName, const FilePathType& textureFilePath, Texture::MipmapGeneration mipmapGeneration, TextureFiltering filtering, bool clamp)
+{
+   std::unordered_map<std::string, TextureStreamHandle_t>::const_iterator streamHandleIterator = streamHandles.find(textureName);
+   if (streamHandleIterator != streamHandles.end())
+   {
+      return streamHandleIterator->second;
+   }
+
+   if (textures.find(textureName) != textures.end())
+   {
+      return BAD_TEXTURE_STREAM_HANDLE;
+   }
+
+   if (!placeholderTexture)
+   {
+      const unsigned char whitePixel[4] = { 255, 255, 255, 255 };
+
+      placeholderTexture = std::make_unique<Texture>(Image(whitePixel, 1, 1, 4), Texture::MipmapGeneration::None, TextureFiltering::Nearest, false, glInfo);
+   }
+
+   TextureStreamHandle_t handle = streamer->Request(textureName, [textureFilePath]()
+   {
+      return Image(textureFilePath);
+   },
+   mipmapGeneration, filtering, clamp);
+
+   streamHandles[textureName] = handle;
+
+   return handle;
+}
+
+TextureStreamHandle_t TextureManager::LoadAsync(const std::string& textureName, const std::string& textureLocation, Texture::MipmapGeneration mipmapGeneration, TextureFiltering filtering, bool clamp)
+{
+   return LoadAsync<std::string>(textureName, textureLocation, mipmapGeneration, filtering, clamp);
+}
+
+TextureStreamHandle_t TextureManager::LoadAsync(const std::string& textureName, const MountedFilePath& textureLocation, Texture::MipmapGeneration mipmapGeneration, TextureFiltering filtering, bool clamp)
+{
+   return LoadAsync<MountedFilePath>(textureName, textureLocation, mipmapGeneration, filtering, clamp);
+}
+
+void TextureManager::SetStreamingThreadPool(ThreadPool* threadPool)
+{
+   streamer->SetThreadPool(threadPool);
+}
+
+std::size_t TextureManager::UpdateStreaming(std::size_t uploadBudget)
+{
+   std::size_t numUploaded = streamer->ProcessUploads(uploadBudget);
+
+   //finished requests are forgotten so that GetTexture stops returning the
+   //placeholder for failed ones and LoadAsync can retry them. Their handles
+   //are released so that the streamer doesn't grow with every request
+   for (std::unordered_map<std::string, TextureStreamHandle_t>::const_iterator streamHandleIterator = streamHandles.begin(); streamHandleIterator != streamHandles.end(); )
+   {
+      TextureStreamer::State state = streamer->GetState(streamHandleIterator->second);
+
+      if ((state == TextureStreamer::State::Ready) || (state == TextureStreamer::State::Failed))
+      {
+         streamer->Release(streamHandleIterator->second);
+
+         streamHandleIterator = streamHandles.erase(streamHandleIterator);
+      }
+      else
+      {
+         ++streamHandleIterator;
+      }
+   }
+
+   return numUploaded;
+}
+
+TextureStreamer::State TextureManager::GetStreamState(TextureStreamHandle_t handle) const
+{
+   return streamer->GetState(handle);
+}
+
 Texture* TextureManager::GetTexture(const std::string& textureName) const
 {
    Texture* texture = nullptr;
@@ -53,13 +180,21 @@ Texture* TextureManager::GetTexture(const std::string& textureName) const
    {
       texture = textureMapIterator->second.get();
    }
+   else if (streamHandles.find(textureName) != streamHandles.end())
+   {
+      texture = placeholderTexture.get();
+   }
 
    return texture;
 }
 
 void TextureManager::UnLoad()
 {
+   streamer->Clear();
+   streamHandles.clear();
+
    textures.clear();
+   placeholderTexture.reset();
 }
 
 }
\ No newline at end of file
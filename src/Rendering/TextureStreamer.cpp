@@ -0,0 +1,283 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "Locus/Rendering/TextureStreamer.h"
+#include "Locus/Rendering/Image.h"
+#include "Locus/Rendering/MipChain.h"
+
+#include "Locus/Common/ThreadPool.h"
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <limits>
+
+#include <cassert>
+
+namespace Locus
+{
+
+const TextureStreamHandle_t BAD_TEXTURE_STREAM_HANDLE = std::numeric_limits<TextureStreamHandle_t>::max();
+
+std::size_t StreamedTexture::NumBytes() const
+{
+   if (mipChain)
+   {
+      return mipChain->PixelData().size();
+   }
+
+   if (image)
+   {
+      return static_cast<std::size_t>(image->Width()) * image->Height() * image->NumPixelComponents();
+   }
+
+   return 0;
+}
+
+TextureUploader::~TextureUploader()
+{
+}
+
+struct TextureStreamer_Impl
+{
+   TextureStreamer_Impl(TextureUploader& uploader)
+      : uploader(uploader), threadPool(nullptr), numDecoding(0), numPending(0)
+   {
+   }
+
+   TextureUploader& uploader;
+   ThreadPool* threadPool;
+
+   //guards everything below. The uploader is never called while it is held
+   mutable std::mutex mutex;
+   std::condition_variable decodingFinished;
+
+   std::vector<TextureStreamer::State> states;
+   std::vector<TextureStreamHandle_t> freeHandles;
+   std::deque<std::unique_ptr<StreamedTexture>> decodedTextures;
+
+   std::size_t numDecoding;
+   std::size_t numPending;
+
+   void Decode(std::unique_ptr<StreamedTexture> streamedTexture, const std::function<Image()>& loadImage, ThreadPool* mipChainThreadPool);
+
+   void WaitForDecoding(std::unique_lock<std::mutex>& lock);
+};
+
+void TextureStreamer_Impl::Decode(std::unique_ptr<StreamedTexture> streamedTexture, const std::function<Image()>& loadImage, ThreadPool* mipChainThreadPool)
+{
+   bool decoded = true;
+
+   try
+   {
+      streamedTexture->image = std::make_unique<Image>(loadImage());
+
+      if (streamedTexture->mipmapGeneration == Texture::MipmapGeneration::Manual)
+      {
+         streamedTexture->image->ScaleToClosestPowerOf2();
+
+         streamedTexture->mipChain = std::make_unique<MipChain>(*streamedTexture->image, false, mipChainThreadPool);
+         streamedTexture->image.reset();
+      }
+   }
+   catch (...)
+   {
+      decoded = false;
+   }
+
+   std::lock_guard<std::mutex> lock(mutex);
+
+   if (decoded)
+   {
+      states[streamedTexture->handle] = TextureStreamer::State::WaitingForUpload;
+      decodedTextures.push_back(std::move(streamedTexture));
+   }
+   else
+   {
+      states[streamedTexture->handle] = TextureStreamer::State::Failed;
+      --numPending;
+   }
+
+   --numDecoding;
+
+   decodingFinished.notify_all();
+}
+
+void TextureStreamer_Impl::WaitForDecoding(std::unique_lock<std::mutex>& lock)
+{
+   decodingFinished.wait(lock, [this]()
+   {
+      return (numDecoding == 0);
+   });
+}
+
+TextureStreamer::TextureStreamer(TextureUploader& uploader)
+   : impl(std::make_unique<TextureStreamer_Impl>(uploader))
+{
+}
+
+TextureStreamer::~TextureStreamer()
+{
+   std::unique_lock<std::mutex> lock(impl->mutex);
+
+   impl->WaitForDecoding(lock);
+}
+
+void TextureStreamer::SetThreadPool(ThreadPool* threadPool)
+{
+   impl->threadPool = threadPool;
+}
+
+TextureStreamHandle_t TextureStreamer::Request(const std::string& textureName, const std::function<Image()>& loadImage, Texture::MipmapGeneration mipmapGeneration, TextureFiltering filtering, bool clamp)
+{
+   TextureStreamHandle_t handle;
+
+   {
+      std::lock_guard<std::mutex> lock(impl->mutex);
+
+      if (!impl->freeHandles.empty())
+      {
+         handle = impl->freeHandles.back();
+         impl->freeHandles.pop_back();
+
+         impl->states[handle] = State::Decoding;
+      }
+      else
+      {
+         handle = impl->states.size();
+         impl->states.push_back(State::Decoding);
+      }
+
+      ++impl->numDecoding;
+      ++impl->numPending;
+   }
+
+   ThreadPool* threadPool = impl->threadPool;
+   TextureStreamer_Impl* streamerImpl = impl.get();
+
+   auto decode = [streamerImpl, handle, textureName, loadImage, mipmapGeneration, filtering, clamp, threadPool]()
+   {
+      std::unique_ptr<StreamedTexture> streamedTexture = std::make_unique<StreamedTexture>();
+
+      streamedTexture->handle = handle;
+      streamedTexture->textureName = textureName;
+      streamedTexture->mipmapGeneration = mipmapGeneration;
+      streamedTexture->filtering = filtering;
+      streamedTexture->clamp = clamp;
+
+      streamerImpl->Decode(std::move(streamedTexture), loadImage, threadPool);
+   };
+
+   if (threadPool != nullptr)
+   {
+      threadPool->Enqueue(decode);
+   }
+   else
+   {
+      decode();
+   }
+
+   return handle;
+}
+
+TextureStreamer::State TextureStreamer::GetState(TextureStreamHandle_t handle) const
+{
+   std::lock_guard<std::mutex> lock(impl->mutex);
+
+   assert(handle < impl->states.size());
+
+   return impl->states[handle];
+}
+
+void TextureStreamer::Release(TextureStreamHandle_t handle)
+{
+   std::lock_guard<std::mutex> lock(impl->mutex);
+
+   assert(handle < impl->states.size());
+   assert((impl->states[handle] == State::Ready) || (impl->states[handle] == State::Failed));
+
+   impl->freeHandles.push_back(handle);
+}
+
+std::size_t TextureStreamer::NumPending() const
+{
+   std::lock_guard<std::mutex> lock(impl->mutex);
+
+   return impl->numPending;
+}
+
+std::size_t TextureStreamer::ProcessUploads(std::size_t uploadBudget)
+{
+   std::size_t numUploaded = 0;
+   std::size_t uploadedBytes = 0;
+
+   while (true)
+   {
+      std::unique_ptr<StreamedTexture> streamedTexture;
+      std::size_t numBytes = 0;
+
+      {
+         std::lock_guard<std::mutex> lock(impl->mutex);
+
+         if (impl->decodedTextures.empty())
+         {
+            break;
+         }
+
+         numBytes = impl->decodedTextures.front()->NumBytes();
+
+         if ((numUploaded > 0) && (uploadedBytes + numBytes > uploadBudget))
+         {
+            break;
+         }
+
+         streamedTexture = std::move(impl->decodedTextures.front());
+         impl->decodedTextures.pop_front();
+      }
+
+      State uploadedState = State::Ready;
+
+      try
+      {
+         impl->uploader.Upload(*streamedTexture);
+      }
+      catch (...)
+      {
+         uploadedState = State::Failed;
+      }
+
+      {
+         std::lock_guard<std::mutex> lock(impl->mutex);
+
+         impl->states[streamedTexture->handle] = uploadedState;
+         --impl->numPending;
+      }
+
+      ++numUploaded;
+      uploadedBytes += numBytes;
+   }
+
+   return numUploaded;
+}
+
+void TextureStreamer::Clear()
+{
+   std::unique_lock<std::mutex> lock(impl->mutex);
+
+   impl->WaitForDecoding(lock);
+
+   impl->states.clear();
+   impl->freeHandles.clear();
+   impl->decodedTextures.clear();
+   impl->numPending = 0;
+}
+
+}
\ No newline at end of file
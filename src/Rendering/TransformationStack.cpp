@@ -151,7 +151,7 @@ void TransformationStack::UploadMatricesToShader(ShaderController& shaderControl
       modelViewProjectionMatrix.MultMatrix(*modelTransformation);
    }
 
-   shaderController.SetMatrix4Uniform(ShaderSource::Mat_MVP, modelViewProjectionMatrix.GetElements().data());
+   shaderController.SetMatrix4Uniform(ShaderSource::UniformID::Mat_MVP, modelViewProjectionMatrix.GetElements().data());
 
    if (shaderController.CurrentProgramDoesLighting())
    {
@@ -162,12 +162,12 @@ void TransformationStack::UploadMatricesToShader(ShaderController& shaderControl
          modelViewMatrix.MultMatrix(*modelTransformation);
       }
 
-      shaderController.SetMatrix4Uniform(ShaderSource::Mat_MV, modelViewMatrix.GetElements().data());
+      shaderController.SetMatrix4Uniform(ShaderSource::UniformID::Mat_MV, modelViewMatrix.GetElements().data());
 
       //for now, assume that only rotations, translations, and homogeneous scales have been done.
       //Therefore, the normal matrix would be the same as the top left sub matrix of the model view matrix
       //(Otherwise, we would have to use the transpose of the inverse of the top left sub matrix)
-      shaderController.SetMatrix3Uniform(ShaderSource::Mat_Normal, modelViewMatrix.SubMatrix(3, 3).GetElements().data());
+      shaderController.SetMatrix3Uniform(ShaderSource::UniformID::Mat_Normal, modelViewMatrix.GetUpperLeftElements().data());
    }
 }
 
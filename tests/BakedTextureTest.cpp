@@ -0,0 +1,241 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "TestUtility.h"
+
+#include "Locus/Rendering/BakedTexture.h"
+#include "Locus/Rendering/MipChain.h"
+#include "Locus/Rendering/Image.h"
+
+#include "Locus/FileSystem/FileOnDisk.h"
+#include "Locus/FileSystem/FileSystemUtil.h"
+
+#include "Locus/Common/Exception.h"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <algorithm>
+
+#include <cstdint>
+#include <cstdio>
+
+using namespace Locus;
+
+static const std::string Source_File_Path = "BakedTextureTest.png";
+static const std::string Baked_File_Path = "BakedTextureTest.lbtx";
+
+//the layout of version 3 baked texture files
+static const std::size_t Header_Size = 48;
+static const std::size_t Level_Entry_Size = 24;
+
+static Image MakeImage(unsigned int width, unsigned int height, unsigned char seed)
+{
+   Image image(width, height, 4);
+
+   for (unsigned int y = 0; y < height; ++y)
+   {
+      for (unsigned int x = 0; x < width; ++x)
+      {
+         unsigned char* pixel = image.GetPixel(x, y);
+
+         pixel[0] = static_cast<unsigned char>(x * 11 + seed);
+         pixel[1] = static_cast<unsigned char>(y * 7 + seed);
+         pixel[2] = seed;
+         pixel[3] = 255;
+      }
+   }
+
+   return image;
+}
+
+static void WriteFile(const std::string& filePath, const std::vector<char>& bytes)
+{
+   FileOnDisk file(filePath, DataStream::OpenMode::Write);
+   file.Write(bytes.data(), bytes.size());
+}
+
+static void WriteUInt32(std::vector<char>& bytes, std::size_t offset, std::uint32_t value)
+{
+   for (unsigned int byteIndex = 0; byteIndex < 4; ++byteIndex)
+   {
+      bytes[offset + byteIndex] = static_cast<char>(value >> (8 * byteIndex));
+   }
+}
+
+static void WriteUInt64(std::vector<char>& bytes, std::size_t offset, std::uint64_t value)
+{
+   for (unsigned int byteIndex = 0; byteIndex < 8; ++byteIndex)
+   {
+      bytes[offset + byteIndex] = static_cast<char>(value >> (8 * byteIndex));
+   }
+}
+
+static bool IsValidBakedTexture(const std::string& filePath)
+{
+   try
+   {
+      BakedTexture bakedTexture(filePath);
+      return true;
+   }
+   catch (Exception&)
+   {
+      return false;
+   }
+}
+
+static bool LevelMatches(const BakedTexture& bakedTexture, const MipChain& mipChain, unsigned int level)
+{
+   const BakedTexture::Level& bakedLevel = bakedTexture.GetLevel(level);
+   const MipChain::Level& mipLevel = mipChain.GetLevel(level);
+
+   return (bakedLevel.width == mipLevel.width) && (bakedLevel.height == mipLevel.height) &&
+          std::equal(bakedLevel.pixelData, bakedLevel.pixelData + bakedLevel.sizeInBytes, mipChain.LevelPixelData(level));
+}
+
+static void TestLoadOrBake()
+{
+   Image sourceImage = MakeImage(20, 12, 1);
+   sourceImage.SaveAsPNG(Source_File_Path);
+
+   std::remove(Baked_File_Path.c_str());
+
+   {
+      std::unique_ptr<BakedTexture> bakedTexture = BakedTexture::LoadOrBake(Source_File_Path, Baked_File_Path, BakedTexture::Format::Uncompressed);
+
+      MipChain mipChain(Image(Source_File_Path), false);
+
+      LOCUS_CHECK(bakedTexture->NumLevels() == 5);
+      LOCUS_CHECK(bakedTexture->NumLevels() == mipChain.NumLevels());
+
+      for (unsigned int level = 0; level < std::min(bakedTexture->NumLevels(), mipChain.NumLevels()); ++level)
+      {
+         LOCUS_CHECK(LevelMatches(*bakedTexture, mipChain, level));
+      }
+   }
+
+   const Image loadedSourceImage(Source_File_Path);
+   const FileStamp sourceStamp = GetFileStamp(Source_File_Path);
+
+   std::vector<char> sourceBytes;
+   ReadWholeFile(Source_File_Path, sourceBytes);
+
+   const std::uint64_t sourceHash = BakedTexture::HashSource(sourceBytes);
+
+   //a baked file whose stamp matches the source is used as is, even though
+   //its pixels and hash don't. This is how a load that skips baking can be
+   //told apart, and shows that the source isn't hashed by default
+   Image otherImage = MakeImage(20, 12, 2);
+
+   BakedTexture::Bake(otherImage, BakedTexture::Format::Uncompressed, Baked_File_Path, sourceStamp, 0);
+
+   {
+      std::unique_ptr<BakedTexture> bakedTexture = BakedTexture::LoadOrBake(Source_File_Path, Baked_File_Path, BakedTexture::Format::Uncompressed);
+
+      LOCUS_CHECK(LevelMatches(*bakedTexture, MipChain(otherImage, false), 0));
+   }
+
+   //checking the hash rebakes it, and records both the stamp and the hash
+   {
+      std::unique_ptr<BakedTexture> bakedTexture = BakedTexture::LoadOrBake(Source_File_Path, Baked_File_Path, BakedTexture::Format::Uncompressed, nullptr,
+                                                                            BakedTexture::StalenessCheck::SourceHash);
+
+      LOCUS_CHECK(LevelMatches(*bakedTexture, MipChain(loadedSourceImage, false), 0));
+      LOCUS_CHECK(bakedTexture->SourceStamp() == sourceStamp);
+      LOCUS_CHECK(bakedTexture->SourceHash() == sourceHash);
+   }
+
+   //when only the stamp differs, checking the hash uses the file as is, but checking the stamp rebakes it
+   FileStamp touchedStamp = sourceStamp;
+   ++touchedStamp.lastModifiedTime;
+
+   BakedTexture::Bake(otherImage, BakedTexture::Format::Uncompressed, Baked_File_Path, touchedStamp, sourceHash);
+
+   {
+      std::unique_ptr<BakedTexture> bakedTexture = BakedTexture::LoadOrBake(Source_File_Path, Baked_File_Path, BakedTexture::Format::Uncompressed, nullptr,
+                                                                            BakedTexture::StalenessCheck::SourceHash);
+
+      LOCUS_CHECK(LevelMatches(*bakedTexture, MipChain(otherImage, false), 0));
+   }
+
+   {
+      std::unique_ptr<BakedTexture> bakedTexture = BakedTexture::LoadOrBake(Source_File_Path, Baked_File_Path, BakedTexture::Format::Uncompressed);
+
+      LOCUS_CHECK(LevelMatches(*bakedTexture, MipChain(loadedSourceImage, false), 0));
+   }
+
+   //changing the source rebakes. The new source has a different size, since a
+   //rewrite can land within the granularity of the file system's timestamps
+   MakeImage(24, 12, 2).SaveAsPNG(Source_File_Path);
+
+   LOCUS_CHECK(GetFileStamp(Source_File_Path) != sourceStamp);
+
+   {
+      std::unique_ptr<BakedTexture> bakedTexture = BakedTexture::LoadOrBake(Source_File_Path, Baked_File_Path, BakedTexture::Format::Uncompressed);
+
+      LOCUS_CHECK(LevelMatches(*bakedTexture, MipChain(Image(Source_File_Path), false), 0));
+   }
+
+   //so does asking for another format
+   {
+      std::unique_ptr<BakedTexture> bakedTexture = BakedTexture::LoadOrBake(Source_File_Path, Baked_File_Path, BakedTexture::Format::BC3);
+
+      LOCUS_CHECK(bakedTexture->GetFormat() == BakedTexture::Format::BC3);
+      LOCUS_CHECK(bakedTexture->GetLevel(0).sizeInBytes == 6 * 3 * 16);
+   }
+}
+
+static void TestValidation()
+{
+   Image image = MakeImage(16, 8, 3);
+
+   BakedTexture::Bake(image, BakedTexture::Format::Uncompressed, Baked_File_Path, FileStamp{0, 0}, 0);
+
+   std::vector<char> validBytes;
+   ReadWholeFile(Baked_File_Path, validBytes);
+
+   LOCUS_CHECK(IsValidBakedTexture(Baked_File_Path));
+
+   //level 1 of 16x8 must be 8x4. 8x8 has a consistent size, but not a consistent width
+   std::vector<char> bytes = validBytes;
+
+   const std::size_t level1Entry = Header_Size + Level_Entry_Size;
+
+   WriteUInt32(bytes, level1Entry + 4, 8);
+   WriteUInt64(bytes, level1Entry + 16, 8 * 8 * 4);
+
+   WriteFile(Baked_File_Path, bytes);
+
+   LOCUS_CHECK(!IsValidBakedTexture(Baked_File_Path));
+
+   //a single 2^31 x 2^31 level of 4 byte pixels needs 2^64 bytes, which
+   //wraps around to a size of 0 in 64 bits
+   bytes = validBytes;
+
+   WriteUInt32(bytes, 16, 1);
+   WriteUInt32(bytes, Header_Size, 1u << 31);
+   WriteUInt32(bytes, Header_Size + 4, 1u << 31);
+   WriteUInt64(bytes, Header_Size + 16, 0);
+
+   WriteFile(Baked_File_Path, bytes);
+
+   LOCUS_CHECK(!IsValidBakedTexture(Baked_File_Path));
+}
+
+int main()
+{
+   TestLoadOrBake();
+   TestValidation();
+
+   std::remove(Source_File_Path.c_str());
+   std::remove(Baked_File_Path.c_str());
+
+   return Test::Finish();
+}
\ No newline at end of file
@@ -0,0 +1,422 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "TestUtility.h"
+
+#include "Locus/Common/ThreadPool.h"
+
+#include "Locus/Geometry/BoundingVolumeHierarchy.h"
+#include "Locus/Geometry/AxisAlignedBox.h"
+#include "Locus/Geometry/OrientedBox.h"
+#include "Locus/Geometry/Sphere.h"
+#include "Locus/Geometry/Triangle.h"
+#include "Locus/Geometry/TriangleBatch.h"
+#include "Locus/Geometry/Moveable.h"
+#include "Locus/Geometry/Transformation.h"
+#include "Locus/Geometry/Geometry.h"
+
+#include <vector>
+#include <unordered_set>
+#include <algorithm>
+#include <cmath>
+
+using namespace Locus;
+
+//two instances of one mesh placed so that some of their triangles intersect
+struct Scene
+{
+   std::vector<Triangle3D_t> triangles;
+
+   Moveable moveable1;
+   Moveable moveable2;
+
+   std::vector<PlainTriangle3D> transformedTriangles1;
+   std::vector<PlainTriangle3D> transformedTriangles2;
+
+   /// Every intersecting pair of transformed triangles, found by testing all of them.
+   std::vector<TrianglePair_t> intersectingPairs;
+};
+
+//a torus around the Z axis with two triangles per quad
+static std::vector<Triangle3D_t> MakeTorus(float majorRadius, float minorRadius, std::size_t numMajorSegments, std::size_t numMinorSegments)
+{
+   auto getPoint = [=](std::size_t majorIndex, std::size_t minorIndex)->FVector3
+   {
+      float majorAngle = (TWO_PI * (majorIndex % numMajorSegments)) / numMajorSegments;
+      float minorAngle = (TWO_PI * (minorIndex % numMinorSegments)) / numMinorSegments;
+
+      float distanceFromAxis = majorRadius + minorRadius * std::cos(minorAngle);
+
+      return FVector3(distanceFromAxis * std::cos(majorAngle), distanceFromAxis * std::sin(majorAngle), minorRadius * std::sin(minorAngle));
+   };
+
+   std::vector<Triangle3D_t> triangles;
+
+   for (std::size_t majorIndex = 0; majorIndex < numMajorSegments; ++majorIndex)
+   {
+      for (std::size_t minorIndex = 0; minorIndex < numMinorSegments; ++minorIndex)
+      {
+         FVector3 corner00 = getPoint(majorIndex, minorIndex);
+         FVector3 corner10 = getPoint(majorIndex + 1, minorIndex);
+         FVector3 corner01 = getPoint(majorIndex, minorIndex + 1);
+         FVector3 corner11 = getPoint(majorIndex + 1, minorIndex + 1);
+
+         triangles.push_back(Triangle3D_t(corner00, corner10, corner11));
+         triangles.push_back(Triangle3D_t(corner00, corner11, corner01));
+      }
+   }
+
+   return triangles;
+}
+
+static std::vector<PlainTriangle3D> TransformTriangles(const std::vector<Triangle3D_t>& triangles, const Moveable& moveable)
+{
+   const Transformation& modelTransformation = moveable.CurrentModelTransformation();
+
+   std::vector<PlainTriangle3D> transformedTriangles(triangles.size());
+
+   for (std::size_t triangleIndex = 0; triangleIndex < triangles.size(); ++triangleIndex)
+   {
+      for (std::size_t pointIndex = 0; pointIndex < Triangle3D_t::NumPointsOnATriangle; ++pointIndex)
+      {
+         transformedTriangles[triangleIndex].points[pointIndex] = modelTransformation.MultVertex(triangles[triangleIndex][pointIndex]);
+      }
+   }
+
+   return transformedTriangles;
+}
+
+//the candidate pairs whose triangles intersect, sorted and without repeats
+static std::vector<TrianglePair_t> KeepIntersectingPairs(const Scene& scene, const std::vector<TrianglePair_t>& candidatePairs)
+{
+   std::vector<TrianglePair_t> intersectingPairs;
+
+   for (const TrianglePair_t& candidatePair : candidatePairs)
+   {
+      if (TrianglesIntersect(scene.transformedTriangles1[candidatePair.first], scene.transformedTriangles2[candidatePair.second]))
+      {
+         intersectingPairs.push_back(candidatePair);
+      }
+   }
+
+   std::sort(intersectingPairs.begin(), intersectingPairs.end());
+   intersectingPairs.erase(std::unique(intersectingPairs.begin(), intersectingPairs.end()), intersectingPairs.end());
+
+   return intersectingPairs;
+}
+
+static void FinishScene(Scene& scene)
+{
+   scene.transformedTriangles1 = TransformTriangles(scene.triangles, scene.moveable1);
+   scene.transformedTriangles2 = TransformTriangles(scene.triangles, scene.moveable2);
+
+   std::vector<TrianglePair_t> allPairs;
+   allPairs.reserve(scene.triangles.size() * scene.triangles.size());
+
+   for (std::size_t triangleIndex1 = 0; triangleIndex1 < scene.triangles.size(); ++triangleIndex1)
+   {
+      for (std::size_t triangleIndex2 = 0; triangleIndex2 < scene.triangles.size(); ++triangleIndex2)
+      {
+         allPairs.emplace_back(triangleIndex1, triangleIndex2);
+      }
+   }
+
+   scene.intersectingPairs = KeepIntersectingPairs(scene, allPairs);
+}
+
+//a torus and a tilted copy of it overlapping its rim
+static Scene MakeTorusScene()
+{
+   Scene scene;
+
+   scene.triangles = MakeTorus(2.0f, 0.6f, 48, 16);
+
+   scene.moveable2.Rotate(FVector3(0.4f, 0.2f, 0.0f));
+   scene.moveable2.Translate(FVector3(3.2f, 0.3f, 0.1f));
+
+   FinishScene(scene);
+
+   return scene;
+}
+
+//two triangles crossing at center, within size of it along every axis
+static void AddCrossingTriangles(const FVector3& center, float size, std::vector<Triangle3D_t>& triangles)
+{
+   triangles.push_back(Triangle3D_t(center + FVector3(size, 0.0f, 0.0f), center + FVector3(0.0f, size, 0.0f), center + FVector3(-size, -size, 0.0f)));
+   triangles.push_back(Triangle3D_t(center + FVector3(0.0f, 0.0f, size), center + FVector3(0.0f, 0.5f * size, -0.5f * size), center + FVector3(0.0f, -0.5f * size, -0.5f * size)));
+}
+
+/*!
+ * \brief Makes a scene whose octant trees are deep enough for the
+ * traversal to outgrow its fixed-size stack.
+ *
+ * \details Nodes are split around the centroid of their points. Every
+ * level adds seven small clusters to seven octants around the level's
+ * centroid, spaced so that the previous levels stay in octant 7, which
+ * is the last child pushed onto the stack. The two copies overlap down
+ * to the innermost level, so each descent leaves seven pairs behind on
+ * the stack.
+ */
+static Scene MakeDeepChainScene(std::size_t numLevels)
+{
+   Scene scene;
+
+   AddCrossingTriangles(FVector3(0.0f, 0.0f, 0.0f), 1.0f, scene.triangles);
+
+   const FVector3 innerOctant(-1.0f, 1.0f, -1.0f);
+
+   for (std::size_t level = 0; level < numLevels; ++level)
+   {
+      const float numPoints = static_cast<float>(scene.triangles.size() * Triangle3D_t::NumPointsOnATriangle);
+
+      FVector3 centroid(0.0f, 0.0f, 0.0f);
+
+      for (const Triangle3D_t& triangle : scene.triangles)
+      {
+         centroid += triangle[0] + triangle[1] + triangle[2];
+      }
+
+      centroid /= numPoints;
+
+      float extent = 0.0f;
+
+      for (const Triangle3D_t& triangle : scene.triangles)
+      {
+         for (std::size_t pointIndex = 0; pointIndex < Triangle3D_t::NumPointsOnATriangle; ++pointIndex)
+         {
+            for (unsigned int axis = 0; axis < 3; ++axis)
+            {
+               extent = std::max(extent, std::fabs(triangle[pointIndex][axis] - centroid[axis]));
+            }
+         }
+      }
+
+      //the clusters' six points each balance the previous levels around levelCenter
+      FVector3 levelCenter = centroid - (innerOctant * (1.1f * extent));
+
+      float spacing = (1.1f * extent * numPoints) / 6.0f;
+
+      for (float x : { 1.0f, -1.0f })
+      {
+         for (float y : { -1.0f, 1.0f })
+         {
+            for (float z : { 1.0f, -1.0f })
+            {
+               if (FVector3(x, y, z) != innerOctant)
+               {
+                  AddCrossingTriangles(levelCenter + (FVector3(x, y, z) * spacing), spacing / 1000.0f, scene.triangles);
+               }
+            }
+         }
+      }
+   }
+
+   scene.moveable2.Translate(FVector3(0.25f, 0.15f, 0.05f));
+
+   FinishScene(scene);
+
+   return scene;
+}
+
+/*!
+ * \brief Checks that GetIntersection finds every intersecting pair of
+ * triangles.
+ *
+ * \return The intersecting pairs among the triangles in the two
+ * intersection sets.
+ */
+template <class BoundingVolume>
+static std::vector<TrianglePair_t> CheckIntersectionSets(const Scene& scene, const BoundingVolumeHierarchy<BoundingVolume>& tree)
+{
+   std::unordered_set<std::size_t> intersectionSet1;
+   std::unordered_set<std::size_t> intersectionSet2;
+
+   tree.GetIntersection(scene.moveable1, tree, scene.moveable2, intersectionSet1, intersectionSet2);
+
+   std::vector<TrianglePair_t> candidatePairs;
+
+   for (std::size_t triangleIndex1 : intersectionSet1)
+   {
+      for (std::size_t triangleIndex2 : intersectionSet2)
+      {
+         candidatePairs.emplace_back(triangleIndex1, triangleIndex2);
+      }
+   }
+
+   std::vector<TrianglePair_t> intersectingPairs = KeepIntersectingPairs(scene, candidatePairs);
+
+   LOCUS_CHECK(intersectingPairs == scene.intersectingPairs);
+
+   return intersectingPairs;
+}
+
+//GetCandidateTrianglePairs and both Intersects overloads must agree with testing every pair
+template <class BoundingVolume>
+static void CheckCandidatePairs(const Scene& scene, const BoundingVolumeHierarchy<BoundingVolume>& tree)
+{
+   std::vector<TrianglePair_t> candidatePairs;
+
+   tree.GetCandidateTrianglePairs(scene.moveable1, tree, scene.moveable2, candidatePairs);
+
+   LOCUS_CHECK(KeepIntersectingPairs(scene, candidatePairs) == scene.intersectingPairs);
+
+   auto trianglePairIntersects = [&scene](std::size_t triangleIndex1, std::size_t triangleIndex2)->bool
+   {
+      return TrianglesIntersect(scene.transformedTriangles1[triangleIndex1], scene.transformedTriangles2[triangleIndex2]);
+   };
+
+   TrianglePair_t intersectingPair;
+
+   bool intersects = tree.Intersects(scene.moveable1, tree, scene.moveable2, trianglePairIntersects, &intersectingPair);
+
+   LOCUS_CHECK(intersects == !scene.intersectingPairs.empty());
+
+   if (intersects)
+   {
+      LOCUS_CHECK(std::binary_search(scene.intersectingPairs.begin(), scene.intersectingPairs.end(), intersectingPair));
+      LOCUS_CHECK(tree.Intersects(scene.moveable1, tree, scene.moveable2));
+   }
+}
+
+//all the centroids coincide, so the surface area heuristic cannot choose a
+//split and falls back to splitting the range in half
+static void CheckCoincidentTriangles(std::size_t leafTriangles)
+{
+   const std::size_t numTriangles = 5;
+
+   std::vector<Triangle3D_t> triangles(numTriangles, Triangle3D_t(FVector3(0.0f, 0.0f, 0.0f), FVector3(1.0f, 0.0f, 0.0f), FVector3(0.0f, 1.0f, 0.0f)));
+
+   BoundingVolumeHierarchy<AxisAlignedBox> tree(triangles, BoundingVolumeHierarchy<AxisAlignedBox>::SplitMethod::BinnedSurfaceAreaHeuristic, leafTriangles, 16);
+
+   BoundingVolumeHierarchy<AxisAlignedBox>::Statistics statistics = tree.GetStatistics();
+
+   LOCUS_CHECK(statistics.numLeaves <= numTriangles);
+   LOCUS_CHECK(statistics.averageLeafTriangles >= 1.0f);
+}
+
+//the two split methods give differently shaped trees, which must still find the same intersecting pairs
+template <class BoundingVolume>
+static void CheckSplitMethods(const Scene& scene)
+{
+   typedef BoundingVolumeHierarchy<BoundingVolume> Tree_t;
+
+   const Tree_t octantTree(scene.triangles, Tree_t::SplitMethod::Octants, 4, 4);
+   const Tree_t surfaceAreaHeuristicTree(scene.triangles, Tree_t::SplitMethod::BinnedSurfaceAreaHeuristic, 4, 12);
+
+   LOCUS_CHECK(CheckIntersectionSets(scene, octantTree) == CheckIntersectionSets(scene, surfaceAreaHeuristicTree));
+}
+
+//building large subtrees on a ThreadPool must give the same tree as building serially
+template <class BoundingVolume>
+static void CheckThreadedBuild(const std::vector<Triangle3D_t>& triangles, const Moveable& moveable1, const Moveable& moveable2, ThreadPool& threadPool)
+{
+   typedef BoundingVolumeHierarchy<BoundingVolume> Tree_t;
+
+   const typename Tree_t::SplitMethod splitMethods[] = { Tree_t::SplitMethod::Octants, Tree_t::SplitMethod::BinnedSurfaceAreaHeuristic };
+
+   for (typename Tree_t::SplitMethod splitMethod : splitMethods)
+   {
+      const Tree_t serialTree(triangles, splitMethod, 4, 12);
+      const Tree_t threadedTree(triangles, splitMethod, 4, 12, &threadPool);
+
+      typename Tree_t::Statistics serialStatistics = serialTree.GetStatistics();
+      typename Tree_t::Statistics threadedStatistics = threadedTree.GetStatistics();
+
+      LOCUS_CHECK(serialStatistics.numNodes == threadedStatistics.numNodes);
+      LOCUS_CHECK(serialStatistics.numLeaves == threadedStatistics.numLeaves);
+      LOCUS_CHECK(serialStatistics.maxDepth == threadedStatistics.maxDepth);
+      LOCUS_CHECK(serialStatistics.surfaceAreaHeuristicCost == threadedStatistics.surfaceAreaHeuristicCost);
+
+      std::unordered_set<std::size_t> serialSet1, serialSet2;
+      serialTree.GetIntersection(moveable1, serialTree, moveable2, serialSet1, serialSet2);
+
+      std::unordered_set<std::size_t> threadedSet1, threadedSet2;
+      threadedTree.GetIntersection(moveable1, threadedTree, moveable2, threadedSet1, threadedSet2);
+
+      LOCUS_CHECK(!serialSet1.empty());
+      LOCUS_CHECK((serialSet1 == threadedSet1) && (serialSet2 == threadedSet2));
+   }
+}
+
+int main()
+{
+   CheckCoincidentTriangles(0);
+   CheckCoincidentTriangles(1);
+   CheckCoincidentTriangles(2);
+
+   const Scene torusScene = MakeTorusScene();
+
+   LOCUS_CHECK(!torusScene.intersectingPairs.empty());
+
+   const std::size_t leafTriangleCounts[] = { 1, 4 };
+
+   for (std::size_t leafTriangles : leafTriangleCounts)
+   {
+      CheckIntersectionSets(torusScene, SphereTree_t(torusScene.triangles, leafTriangles, 8));
+      CheckIntersectionSets(torusScene, AABBTree_t(torusScene.triangles, leafTriangles, 8));
+      CheckIntersectionSets(torusScene, OBBTree_t(torusScene.triangles, leafTriangles, 8));
+   }
+
+   CheckSplitMethods<Sphere>(torusScene);
+   CheckSplitMethods<AxisAlignedBox>(torusScene);
+   CheckSplitMethods<OrientedBox>(torusScene);
+
+   CheckCandidatePairs(torusScene, SphereTree_t(torusScene.triangles, 4, 8));
+   CheckCandidatePairs(torusScene, AABBTree_t(torusScene.triangles, 4, 8));
+   CheckCandidatePairs(torusScene, OBBTree_t(torusScene.triangles, 4, 8));
+
+   Scene separatedScene = torusScene;
+
+   separatedScene.moveable2.Translate(FVector3(100.0f, 0.0f, 0.0f));
+
+   FinishScene(separatedScene);
+
+   LOCUS_CHECK(separatedScene.intersectingPairs.empty());
+
+   const AABBTree_t torusTree(torusScene.triangles, 4, 8);
+
+   LOCUS_CHECK(!torusTree.Intersects(separatedScene.moveable1, torusTree, separatedScene.moveable2));
+
+   CheckCandidatePairs(separatedScene, torusTree);
+
+   //deep enough for the traversal to continue some pairs on a fresh stack
+   const std::size_t numChainLevels = 10;
+
+   const Scene deepChainScene = MakeDeepChainScene(numChainLevels);
+
+   LOCUS_CHECK(!deepChainScene.intersectingPairs.empty());
+
+   const SphereTree_t deepChainSphereTree(deepChainScene.triangles, 2, 64);
+   const AABBTree_t deepChainAABBTree(deepChainScene.triangles, 2, 64);
+   const OBBTree_t deepChainOBBTree(deepChainScene.triangles, 2, 64);
+
+   LOCUS_CHECK(deepChainSphereTree.GetStatistics().maxDepth == numChainLevels);
+   LOCUS_CHECK(deepChainAABBTree.GetStatistics().maxDepth == numChainLevels);
+   LOCUS_CHECK(deepChainOBBTree.GetStatistics().maxDepth == numChainLevels);
+
+   CheckCandidatePairs(deepChainScene, deepChainSphereTree);
+   CheckCandidatePairs(deepChainScene, deepChainAABBTree);
+   CheckCandidatePairs(deepChainScene, deepChainOBBTree);
+
+   CheckIntersectionSets(deepChainScene, deepChainSphereTree);
+   CheckIntersectionSets(deepChainScene, deepChainAABBTree);
+   CheckIntersectionSets(deepChainScene, deepChainOBBTree);
+
+   //large enough for subtrees to be built in parallel
+   const std::vector<Triangle3D_t> largeTorus = MakeTorus(2.0f, 0.6f, 256, 48);
+
+   ThreadPool threadPool(4);
+
+   CheckThreadedBuild<Sphere>(largeTorus, torusScene.moveable1, torusScene.moveable2, threadPool);
+   CheckThreadedBuild<AxisAlignedBox>(largeTorus, torusScene.moveable1, torusScene.moveable2, threadPool);
+   CheckThreadedBuild<OrientedBox>(largeTorus, torusScene.moveable1, torusScene.moveable2, threadPool);
+
+   return Test::Finish();
+}
\ No newline at end of file
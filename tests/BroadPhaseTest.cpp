@@ -0,0 +1,160 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "TestUtility.h"
+
+#include "Locus/Geometry/CollisionManager.h"
+#include "Locus/Geometry/Collidable.h"
+
+#include <vector>
+#include <set>
+#include <utility>
+#include <random>
+
+using namespace Locus;
+
+typedef std::set<std::pair<const Collidable*, const Collidable*>> PairSet_t;
+
+static std::pair<const Collidable*, const Collidable*> MakeOrderedPair(const Collidable* first, const Collidable* second)
+{
+   return (first < second) ? std::make_pair(first, second) : std::make_pair(second, first);
+}
+
+class Box : public Collidable
+{
+public:
+   Box()
+      : halfLength(1.0f), resolvedPairs(nullptr)
+   {
+   }
+
+   FVector3 center;
+   float halfLength;
+   PairSet_t* resolvedPairs;
+
+   virtual void UpdateBroadCollisionExtent() override
+   {
+      Collidable::UpdateBroadCollisionExtent(center, halfLength);
+   }
+
+   virtual void ResolveCollision(Collidable& collidable) override
+   {
+      resolvedPairs->insert( MakeOrderedPair(this, &collidable) );
+   }
+};
+
+static bool ExtentsIntersect(const Collidable& first, const Collidable& second)
+{
+   const FVector3& firstMin = first.GetBroadCollisionExtentMin();
+   const FVector3& firstMax = first.GetBroadCollisionExtentMax();
+   const FVector3& secondMin = second.GetBroadCollisionExtentMin();
+   const FVector3& secondMax = second.GetBroadCollisionExtentMax();
+
+   return (firstMin.x <= secondMax.x) && (secondMin.x <= firstMax.x) &&
+          (firstMin.y <= secondMax.y) && (secondMin.y <= firstMax.y) &&
+          (firstMin.z <= secondMax.z) && (secondMin.z <= firstMax.z);
+}
+
+static PairSet_t BruteForcePairs(const std::vector<Box>& boxes, const Box* excludedBox)
+{
+   PairSet_t pairs;
+
+   for (std::size_t first = 0; first < boxes.size(); ++first)
+   {
+      for (std::size_t second = first + 1; second < boxes.size(); ++second)
+      {
+         if ((&boxes[first] != excludedBox) && (&boxes[second] != excludedBox) && ExtentsIntersect(boxes[first], boxes[second]))
+         {
+            pairs.insert( MakeOrderedPair(&boxes[first], &boxes[second]) );
+         }
+      }
+   }
+
+   return pairs;
+}
+
+//moves boxes around for a number of frames, adding and removing some
+//of them along the way, and compares the transmitted pairs with a
+//brute force check after every frame. One of the boxes is much larger
+//than the rest so that it covers a huge number of grid cells
+static void CheckAgainstBruteForce(CollisionManager::BroadPhaseType broadPhaseType, float gridCellSize)
+{
+   const std::size_t numBoxes = 600;
+   const int numFrames = 30;
+
+   std::mt19937 randomEngine(1);
+   std::uniform_real_distribution<float> positionDistribution(-50.0f, 50.0f);
+   std::uniform_real_distribution<float> motionDistribution(-1.0f, 1.0f);
+   std::uniform_real_distribution<float> halfLengthDistribution(0.5f, 3.0f);
+
+   PairSet_t resolvedPairs;
+
+   std::vector<Box> boxes(numBoxes);
+
+   CollisionManager collisionManager(broadPhaseType);
+   collisionManager.SetGridCellSize(gridCellSize);
+
+   collisionManager.StartAddRemoveBatch();
+
+   for (Box& box : boxes)
+   {
+      box.center = FVector3(positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine));
+      box.halfLength = ((&box == &boxes[3]) ? 1000.0f : halfLengthDistribution(randomEngine));
+      box.resolvedPairs = &resolvedPairs;
+      box.UpdateBroadCollisionExtent();
+
+      collisionManager.Add(&box);
+   }
+
+   collisionManager.FinishAddRemoveBatch();
+
+   const Box* removedBox = nullptr;
+
+   for (int frame = 0; frame < numFrames; ++frame)
+   {
+      for (Box& box : boxes)
+      {
+         box.center += FVector3(motionDistribution(randomEngine), motionDistribution(randomEngine), motionDistribution(randomEngine));
+         box.UpdateBroadCollisionExtent();
+
+         if (&box != removedBox)
+         {
+            collisionManager.Update(&box);
+         }
+      }
+
+      if (frame == numFrames / 3)
+      {
+         removedBox = &boxes[7];
+         collisionManager.Remove(&boxes[7]);
+      }
+      else if (frame == 2 * numFrames / 3)
+      {
+         removedBox = nullptr;
+         collisionManager.Add(&boxes[7]);
+      }
+
+      collisionManager.UpdateCollisions();
+
+      resolvedPairs.clear();
+      collisionManager.TransmitCollisions();
+
+      LOCUS_CHECK(resolvedPairs == BruteForcePairs(boxes, removedBox));
+   }
+}
+
+int main()
+{
+   CheckAgainstBruteForce(CollisionManager::BroadPhaseType::SweepAndPrune, 0.0f);
+   CheckAgainstBruteForce(CollisionManager::BroadPhaseType::HashedGrid, 0.0f);
+   CheckAgainstBruteForce(CollisionManager::BroadPhaseType::HashedGrid, 2.0f);
+
+   return Test::Finish();
+}
\ No newline at end of file
@@ -0,0 +1,197 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "TestUtility.h"
+
+#include "Locus/Rendering/IndexedVertexData.h"
+
+#include <vector>
+#include <array>
+#include <string>
+#include <set>
+#include <random>
+#include <algorithm>
+#include <iostream>
+
+#include <cmath>
+#include <cstring>
+
+using namespace Locus;
+
+static GPUVertexDataStorage MakeVertex(float theta, float phi, float u, float v)
+{
+   GPUVertexDataStorage vertex;
+   std::memset(&vertex, 0, sizeof(vertex));
+
+   vertex.position[0] = std::sin(theta) * std::cos(phi);
+   vertex.position[1] = std::sin(theta) * std::sin(phi);
+   vertex.position[2] = std::cos(theta);
+
+   std::copy(vertex.position, vertex.position + 3, vertex.normal);
+
+   vertex.texCoord[0] = u;
+   vertex.texCoord[1] = v;
+
+   std::fill(vertex.color, vertex.color + 4, static_cast<unsigned char>(255));
+
+   return vertex;
+}
+
+//an unindexed triangle list of a gridSize by gridSize tessellated sphere,
+//two triangles per quad. If shuffled, the quads are in random order
+static std::vector<GPUVertexDataStorage> MakeSphereTriangles(int gridSize, bool shuffled)
+{
+   const float Pi = 3.14159265f;
+
+   std::vector<std::array<int, 2>> quads;
+
+   for (int row = 0; row < gridSize; ++row)
+   {
+      for (int col = 0; col < gridSize; ++col)
+      {
+         quads.push_back({ {row, col} });
+      }
+   }
+
+   if (shuffled)
+   {
+      std::mt19937 randomEngine(1);
+      std::shuffle(quads.begin(), quads.end(), randomEngine);
+   }
+
+   auto gridVertex = [&](int row, int col)->GPUVertexDataStorage
+   {
+      return MakeVertex(Pi * row / gridSize, 2 * Pi * (col % gridSize) / gridSize, static_cast<float>(col) / gridSize, static_cast<float>(row) / gridSize);
+   };
+
+   std::vector<GPUVertexDataStorage> triangleVertices;
+
+   for (const std::array<int, 2>& quad : quads)
+   {
+      int row = quad[0];
+      int col = quad[1];
+
+      GPUVertexDataStorage corners[4] = { gridVertex(row, col), gridVertex(row + 1, col), gridVertex(row + 1, col + 1), gridVertex(row, col + 1) };
+
+      for (int corner : { 0, 1, 2, 0, 2, 3 })
+      {
+         triangleVertices.push_back(corners[corner]);
+      }
+   }
+
+   return triangleVertices;
+}
+
+static std::string TriangleBytes(const GPUVertexDataStorage& vertex0, const GPUVertexDataStorage& vertex1, const GPUVertexDataStorage& vertex2)
+{
+   std::string bytes;
+
+   bytes.append(reinterpret_cast<const char*>(&vertex0), sizeof(GPUVertexDataStorage));
+   bytes.append(reinterpret_cast<const char*>(&vertex1), sizeof(GPUVertexDataStorage));
+   bytes.append(reinterpret_cast<const char*>(&vertex2), sizeof(GPUVertexDataStorage));
+
+   return bytes;
+}
+
+//every triangle, with its winding, is still drawn exactly once
+static bool SameTriangles(const std::vector<GPUVertexDataStorage>& triangleVertices, const IndexedVertexData& indexedVertexData)
+{
+   if (indexedVertexData.indices.size() != triangleVertices.size())
+   {
+      return false;
+   }
+
+   std::multiset<std::string> originalTriangles;
+   std::multiset<std::string> indexedTriangles;
+
+   for (std::size_t first = 0; first < triangleVertices.size(); first += 3)
+   {
+      originalTriangles.insert( TriangleBytes(triangleVertices[first], triangleVertices[first + 1], triangleVertices[first + 2]) );
+
+      const std::vector<GPUVertexDataStorage>& vertices = indexedVertexData.vertices;
+      const std::vector<std::uint32_t>& indices = indexedVertexData.indices;
+
+      indexedTriangles.insert( TriangleBytes(vertices[indices[first]], vertices[indices[first + 1]], vertices[indices[first + 2]]) );
+   }
+
+   return (originalTriangles == indexedTriangles);
+}
+
+static void CheckOptimization(int gridSize, bool shuffled)
+{
+   const std::size_t cacheSize = 16;
+
+   std::vector<GPUVertexDataStorage> triangleVertices = MakeSphereTriangles(gridSize, shuffled);
+
+   IndexedVertexData indexedVertexData;
+   BuildIndexedVertexData(triangleVertices, indexedVertexData);
+
+   LOCUS_CHECK(SameTriangles(triangleVertices, indexedVertexData));
+
+   //a closed grid shares most vertices, one extra row and column are for the texture seams
+   LOCUS_CHECK(indexedVertexData.vertices.size() <= static_cast<std::size_t>((gridSize + 1) * (gridSize + 1)));
+
+   float missRatioBefore = AverageCacheMissRatio(indexedVertexData.indices, cacheSize);
+
+   OptimizeVertexCacheOrder(indexedVertexData.indices, indexedVertexData.vertices.size());
+   LOCUS_CHECK(SameTriangles(triangleVertices, indexedVertexData));
+
+   float missRatioAfter = AverageCacheMissRatio(indexedVertexData.indices, cacheSize);
+
+   LOCUS_CHECK(missRatioAfter <= missRatioBefore);
+   LOCUS_CHECK(missRatioAfter < 0.8f);
+
+   OptimizeVertexFetchOrder(indexedVertexData);
+   LOCUS_CHECK(SameTriangles(triangleVertices, indexedVertexData));
+
+   //the vertices are in the order in which they are first used
+   std::uint32_t nextNewVertex = 0;
+   bool inFirstUseOrder = true;
+
+   for (std::uint32_t index : indexedVertexData.indices)
+   {
+      if (index == nextNewVertex)
+      {
+         ++nextNewVertex;
+      }
+      else if (index > nextNewVertex)
+      {
+         inFirstUseOrder = false;
+      }
+   }
+
+   LOCUS_CHECK(inFirstUseOrder);
+   LOCUS_CHECK(AverageCacheMissRatio(indexedVertexData.indices, cacheSize) == missRatioAfter);
+
+   std::size_t unindexedBytes = triangleVertices.size() * sizeof(GPUVertexDataStorage);
+   std::size_t indexedBytes = indexedVertexData.vertices.size() * sizeof(GPUVertexDataStorage) + indexedVertexData.indices.size() * sizeof(std::uint32_t);
+
+   std::cout << gridSize << "x" << gridSize << (shuffled ? " shuffled" : "") << " sphere: "
+             << unindexedBytes << " -> " << indexedBytes << " bytes uploaded, "
+             << "cache miss ratio " << missRatioBefore << " -> " << missRatioAfter << std::endl;
+}
+
+int main()
+{
+   CheckOptimization(20, false);
+   CheckOptimization(100, false);
+   CheckOptimization(100, true);
+
+   //empty input
+   IndexedVertexData indexedVertexData;
+   BuildIndexedVertexData(std::vector<GPUVertexDataStorage>(), indexedVertexData);
+   OptimizeVertexCacheOrder(indexedVertexData.indices, indexedVertexData.vertices.size());
+   OptimizeVertexFetchOrder(indexedVertexData);
+
+   LOCUS_CHECK(indexedVertexData.vertices.empty() && indexedVertexData.indices.empty());
+   LOCUS_CHECK(AverageCacheMissRatio(indexedVertexData.indices, 16) == 0.0f);
+
+   return Test::Finish();
+}
\ No newline at end of file
@@ -0,0 +1,271 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "TestUtility.h"
+
+#include "Locus/Math/Matrix.h"
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+using namespace Locus;
+
+//true if every element is within tolerance of the expected one, relative to the
+//largest expected element
+template <typename ScalarType>
+static bool ElementsMatch(const Matrix<ScalarType>& matrix, const Matrix<ScalarType>& expected, ScalarType tolerance)
+{
+   ScalarType largestMagnitude = 0;
+
+   for (ScalarType element : expected.GetElements())
+   {
+      largestMagnitude = std::max(largestMagnitude, std::abs(element));
+   }
+
+   for (std::size_t elementIndex = 0; elementIndex < expected.GetElements().size(); ++elementIndex)
+   {
+      if (std::abs(matrix.GetElements()[elementIndex] - expected.GetElements()[elementIndex]) > (tolerance * largestMagnitude))
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+template <typename ScalarType>
+static Matrix<ScalarType> Scaled(const Matrix<ScalarType>& matrix, ScalarType factor)
+{
+   Matrix<ScalarType> scaled(matrix);
+
+   for (unsigned int row = 0; row < matrix.Rows(); ++row)
+   {
+      for (unsigned int col = 0; col < matrix.Columns(); ++col)
+      {
+         scaled(row, col) *= factor;
+      }
+   }
+
+   return scaled;
+}
+
+template <typename ScalarType>
+static bool ValuesMatch(ScalarType value, ScalarType expected, ScalarType tolerance)
+{
+   return (std::abs(value - expected) <= (tolerance * std::abs(expected)));
+}
+
+template <typename ScalarType>
+static bool VectorsMatch(const std::vector<ScalarType>& vector, const std::vector<ScalarType>& expected, ScalarType tolerance)
+{
+   for (std::size_t index = 0; index < expected.size(); ++index)
+   {
+      if (!ValuesMatch(vector[index], expected[index], tolerance))
+      {
+         return false;
+      }
+   }
+
+   return (vector.size() == expected.size());
+}
+
+//checks Determinant, IsInvertible, Invert, GetInverse and Solve on an invertible matrix
+//with a known determinant, inverse and solution
+template <typename ScalarType>
+static void CheckInvertible(const Matrix<ScalarType>& matrix, ScalarType determinant, const Matrix<ScalarType>& inverse, const std::vector<ScalarType>& b, const std::vector<ScalarType>& x, ScalarType tolerance)
+{
+   LOCUS_CHECK(ValuesMatch(matrix.Determinant(), determinant, tolerance));
+   LOCUS_CHECK(matrix.IsInvertible());
+
+   Matrix<ScalarType> inverted(matrix);
+
+   LOCUS_CHECK(inverted.Invert());
+   LOCUS_CHECK(ElementsMatch(inverted, inverse, tolerance));
+   LOCUS_CHECK(ElementsMatch(matrix.GetInverse(), inverse, tolerance));
+
+   std::vector<ScalarType> solution;
+
+   LOCUS_CHECK(matrix.Solve(b, solution));
+   LOCUS_CHECK(VectorsMatch(solution, x, tolerance));
+}
+
+//a singular matrix must be reported by IsInvertible, Invert, GetInverse and Solve,
+//which leave their outputs unchanged
+template <typename ScalarType>
+static void CheckSingular(const Matrix<ScalarType>& matrix)
+{
+   LOCUS_CHECK(!matrix.IsInvertible());
+
+   Matrix<ScalarType> inverted(matrix);
+
+   LOCUS_CHECK(!inverted.Invert());
+   LOCUS_CHECK(inverted.GetElements() == matrix.GetElements());
+   LOCUS_CHECK(matrix.GetInverse().IsZeroMatrix());
+
+   const std::vector<ScalarType> b(matrix.Rows(), 1);
+   std::vector<ScalarType> solution(matrix.Rows(), 7);
+
+   LOCUS_CHECK(!matrix.Solve(b, solution));
+   LOCUS_CHECK(solution == std::vector<ScalarType>(matrix.Rows(), 7));
+}
+
+template <typename ScalarType>
+static void CheckKnownMatrices()
+{
+   const ScalarType tolerance = 64 * std::numeric_limits<ScalarType>::epsilon();
+
+   //small enough for the permutation expansion
+   CheckInvertible(Matrix<ScalarType>(3, 3, {  2, -1,  0,
+                                              -1,  2, -1,
+                                               0, -1,  2 }),
+                   ScalarType(4),
+                   Matrix<ScalarType>(3, 3, { ScalarType(0.75), ScalarType(0.5), ScalarType(0.25),
+                                              ScalarType(0.5),  ScalarType(1),   ScalarType(0.5),
+                                              ScalarType(0.25), ScalarType(0.5), ScalarType(0.75) }),
+                   { 1, 0, 1 },
+                   { 1, 1, 1 },
+                   tolerance);
+
+   //every diagonal element is zero, so every column needs a row swap. The rows
+   //are a 4-cycle of the identity's, which is an odd permutation
+   CheckInvertible(Matrix<ScalarType>(4, 4, { 0, 2, 0, 0,
+                                              0, 0, 0, 3,
+                                              4, 0, 0, 0,
+                                              0, 0, 5, 0 }),
+                   ScalarType(-120),
+                   Matrix<ScalarType>(4, 4, { 0,                 0,                 1 / ScalarType(4), 0,
+                                              1 / ScalarType(2), 0,                 0,                 0,
+                                              0,                 0,                 0,                 1 / ScalarType(5),
+                                              0,                 1 / ScalarType(3), 0,                 0 }),
+                   { 2, 3, 4, 5 },
+                   { 1, 1, 1, 1 },
+                   tolerance);
+
+   //P * L * U with integer factors and det(U) = -24, where P moves the first row to the bottom
+   const Matrix<ScalarType> inverseTimes24(5, 5, { -104,   22, -24,   2,   240,
+                                                    656, -136, 120, -32, -1416,
+                                                    196,  -38,  36, -10,  -420,
+                                                    288,  -60,  48, -12,  -624,
+                                                    -84,   18, -12,   6,   180 });
+
+   CheckInvertible(Matrix<ScalarType>(5, 5, {  4,  1,  0,  1,  6,
+                                              -2, -4, 10,  1, -2,
+                                               0,  2, -1, -3,  3,
+                                               2,  0, -2,  5, 10,
+                                               2,  1, -1,  0,  3 }),
+                   ScalarType(-24),
+                   Scaled(inverseTimes24, 1 / ScalarType(24)),
+                   { 28, 22, 20, 26, 12 },
+                   { 1, -2, 3, -4, 5 },
+                   100 * tolerance);
+
+   //the last row is the sum of the first two
+   CheckSingular(Matrix<ScalarType>(3, 3, { 1, 2, 3,
+                                            4, 5, 6,
+                                            5, 7, 9 }));
+
+   CheckSingular(Matrix<ScalarType>(5, 5, { 1, 2, 0, 4, 5,
+                                            0, 1, 0, 3, 1,
+                                            2, 0, 0, 1, 1,
+                                            3, 3, 0, 2, 2,
+                                            1, 1, 0, 1, 4 }));
+
+   CheckSingular(Matrix<ScalarType>(4, 4));
+}
+
+//a matrix is singular when a pivot is at most n * epsilon times its largest element,
+//so scaling a matrix never changes whether it is invertible
+template <typename ScalarType>
+static void CheckRelativeSingularity()
+{
+   const ScalarType epsilon = std::numeric_limits<ScalarType>::epsilon();
+   const ScalarType tolerance = 64 * epsilon;
+
+   const ScalarType scales[] = { 1, std::ldexp(ScalarType(1), -20), std::ldexp(ScalarType(1), 20) };
+
+   for (ScalarType scale : scales)
+   {
+      //a pivot well above and well below the threshold of 4 * epsilon
+      const ScalarType smallPivots[] = { 1000 * epsilon, epsilon / 1000 };
+
+      for (ScalarType smallPivot : smallPivots)
+      {
+         const Matrix<ScalarType> matrix = Scaled(Matrix<ScalarType>(4, 4, { 1, 1, 0,          0,
+                                                                             0, 1, 0,          0,
+                                                                             0, 0, 0,          1,
+                                                                             0, 0, smallPivot, 0 }), scale);
+
+         if (smallPivot > epsilon)
+         {
+            const Matrix<ScalarType> inverse = Scaled(Matrix<ScalarType>(4, 4, { 1, -1, 0, 0,
+                                                                                 0,  1, 0, 0,
+                                                                                 0,  0, 0, 1 / smallPivot,
+                                                                                 0,  0, 1, 0 }), 1 / scale);
+
+            CheckInvertible(matrix, -smallPivot * scale * scale * scale * scale, inverse, { 2 * scale, scale, scale, 3 * smallPivot * scale }, { 1, 1, 3, 1 }, tolerance);
+         }
+         else
+         {
+            CheckSingular(matrix);
+         }
+      }
+   }
+}
+
+//the 5 x 5 Hilbert matrix has a condition number near 5e5 and an inverse with integer elements
+template <typename ScalarType>
+static void CheckHilbertMatrix()
+{
+   Matrix<ScalarType> hilbert(5, 5);
+
+   for (unsigned int row = 0; row < 5; ++row)
+   {
+      for (unsigned int col = 0; col < 5; ++col)
+      {
+         hilbert(row, col) = 1 / static_cast<ScalarType>(row + col + 1);
+      }
+   }
+
+   const Matrix<ScalarType> inverse(5, 5, {    25,   -300,    1050,   -1400,    630,
+                                              -300,   4800,  -18900,   26880, -12600,
+                                              1050, -18900,   79380, -117600,  56700,
+                                             -1400,  26880, -117600,  179200, -88200,
+                                               630, -12600,   56700,  -88200,  44100 });
+
+   std::vector<ScalarType> b(5);
+
+   for (unsigned int row = 0; row < 5; ++row)
+   {
+      for (unsigned int col = 0; col < 5; ++col)
+      {
+         b[row] += hilbert(row, col);
+      }
+   }
+
+   CheckInvertible(hilbert, 1 / static_cast<ScalarType>(266716800000.0L), inverse, b, std::vector<ScalarType>(5, 1), 1.0e6f * std::numeric_limits<ScalarType>::epsilon());
+}
+
+int main()
+{
+   CheckKnownMatrices<float>();
+   CheckKnownMatrices<double>();
+   CheckKnownMatrices<long double>();
+
+   CheckRelativeSingularity<float>();
+   CheckRelativeSingularity<double>();
+   CheckRelativeSingularity<long double>();
+
+   CheckHilbertMatrix<double>();
+   CheckHilbertMatrix<long double>();
+
+   return Test::Finish();
+}
\ No newline at end of file
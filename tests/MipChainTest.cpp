@@ -0,0 +1,159 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "TestUtility.h"
+
+#include "Locus/Rendering/MipChain.h"
+#include "Locus/Rendering/Image.h"
+
+#include "Locus/Common/ThreadPool.h"
+#include "Locus/Common/InstructionSet.h"
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <iostream>
+
+using namespace Locus;
+
+static Image MakeRandomImage(unsigned int width, unsigned int height, unsigned int numPixelComponents, std::mt19937& randomEngine)
+{
+   std::uniform_int_distribution<int> byteDistribution(0, 255);
+
+   std::vector<unsigned char> pixelData(static_cast<std::size_t>(width) * height * numPixelComponents);
+
+   for (unsigned char& byte : pixelData)
+   {
+      byte = static_cast<unsigned char>(byteDistribution(randomEngine));
+   }
+
+   return Image(pixelData.data(), width, height, numPixelComponents);
+}
+
+//the 2x2 box filter as MipChain documents it, written out one pixel at a time
+static std::vector<unsigned char> ReferenceLevel(const std::vector<unsigned char>& source, unsigned int sourceWidth, unsigned int sourceHeight, unsigned int numPixelComponents)
+{
+   unsigned int width = std::max(sourceWidth / 2, 1u);
+   unsigned int height = std::max(sourceHeight / 2, 1u);
+
+   std::vector<unsigned char> level(static_cast<std::size_t>(width) * height * numPixelComponents);
+
+   for (unsigned int y = 0; y < height; ++y)
+   {
+      unsigned int sourceYs[2] = { 2 * y, std::min(2 * y + 1, sourceHeight - 1) };
+
+      for (unsigned int x = 0; x < width; ++x)
+      {
+         unsigned int sourceXs[2] = { 2 * x, std::min(2 * x + 1, sourceWidth - 1) };
+
+         for (unsigned int component = 0; component < numPixelComponents; ++component)
+         {
+            unsigned int sum = 0;
+
+            for (unsigned int sourceY : sourceYs)
+            {
+               for (unsigned int sourceX : sourceXs)
+               {
+                  sum += source[(static_cast<std::size_t>(sourceY) * sourceWidth + sourceX) * numPixelComponents + component];
+               }
+            }
+
+            level[(static_cast<std::size_t>(y) * width + x) * numPixelComponents + component] = static_cast<unsigned char>((sum + 2) / 4);
+         }
+      }
+   }
+
+   return level;
+}
+
+//every level must match the reference built from the level before it
+static bool LevelsMatchReference(const MipChain& mipChain)
+{
+   for (unsigned int level = 1; level < mipChain.NumLevels(); ++level)
+   {
+      const MipChain::Level& source = mipChain.GetLevel(level - 1);
+      const MipChain::Level& destination = mipChain.GetLevel(level);
+
+      if ((destination.width != std::max(source.width / 2, 1u)) || (destination.height != std::max(source.height / 2, 1u)))
+      {
+         return false;
+      }
+
+      std::size_t sourceSize = static_cast<std::size_t>(source.width) * source.height * mipChain.NumPixelComponents();
+      std::size_t destinationSize = static_cast<std::size_t>(destination.width) * destination.height * mipChain.NumPixelComponents();
+
+      std::vector<unsigned char> sourcePixels(mipChain.LevelPixelData(level - 1), mipChain.LevelPixelData(level - 1) + sourceSize);
+      std::vector<unsigned char> destinationPixels(mipChain.LevelPixelData(level), mipChain.LevelPixelData(level) + destinationSize);
+
+      if (destinationPixels != ReferenceLevel(sourcePixels, source.width, source.height, mipChain.NumPixelComponents()))
+      {
+         return false;
+      }
+   }
+
+   const MipChain::Level& lastLevel = mipChain.GetLevel(mipChain.NumLevels() - 1);
+
+   return ((lastLevel.width == 1) && (lastLevel.height == 1));
+}
+
+static void CheckImage(const Image& image, ThreadPool& threadPool)
+{
+   const bool sse2Supported = (DetectInstructionSet() >= InstructionSet::SSE2);
+
+   MipChain mipChain(image, false);
+
+   LOCUS_CHECK(LevelsMatchReference(mipChain));
+
+   LOCUS_CHECK(std::equal(image.PixelData(), image.PixelData() + static_cast<std::size_t>(image.Width()) * image.Height() * image.NumPixelComponents(), mipChain.LevelPixelData(0)));
+
+   //the SSE2 path must match the scalar path bit for bit
+   LimitInstructionSet(InstructionSet::Scalar);
+
+   MipChain scalarMipChain(image, false);
+
+   LimitInstructionSet(InstructionSet::AVX);
+
+   LOCUS_CHECK(LevelsMatchReference(scalarMipChain));
+
+   if (sse2Supported)
+   {
+      LOCUS_CHECK(scalarMipChain.PixelData() == mipChain.PixelData());
+   }
+
+   //splitting the rows across threads must not change anything
+   LOCUS_CHECK(MipChain(image, false, &threadPool).PixelData() == mipChain.PixelData());
+   LOCUS_CHECK(MipChain(image, true, &threadPool).PixelData() == MipChain(image, true).PixelData());
+}
+
+int main()
+{
+   std::mt19937 randomEngine(1);
+
+   ThreadPool threadPool(4);
+
+   if (DetectInstructionSet() < InstructionSet::SSE2)
+   {
+      std::cout << "SSE2 is not supported, so only the scalar path is checked" << std::endl;
+   }
+
+   //odd sizes, sizes that leave a partial SSE2 block, and a size large enough
+   //that the first levels are split across the thread pool
+   const unsigned int sizes[][2] = { {1, 1}, {1, 7}, {7, 1}, {2, 2}, {5, 3}, {37, 23}, {64, 64}, {131, 67}, {517, 301} };
+
+   for (unsigned int numPixelComponents = 1; numPixelComponents <= 4; ++numPixelComponents)
+   {
+      for (const unsigned int (&size)[2] : sizes)
+      {
+         CheckImage(MakeRandomImage(size[0], size[1], numPixelComponents, randomEngine), threadPool);
+      }
+   }
+
+   return Test::Finish();
+}
\ No newline at end of file
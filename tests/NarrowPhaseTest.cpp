@@ -0,0 +1,163 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "TestUtility.h"
+
+#include "Locus/Geometry/CollisionManager.h"
+#include "Locus/Geometry/Collidable.h"
+#include "Locus/Geometry/Moveable.h"
+#include "Locus/Geometry/TickMoveables.h"
+#include "Locus/Geometry/Vector3Geometry.h"
+
+#include "Locus/Common/ThreadPool.h"
+
+#include <vector>
+#include <utility>
+#include <random>
+
+using namespace Locus;
+
+//the indices of the two balls passed to each ResolveCollision call, in call order
+typedef std::vector<std::pair<std::size_t, std::size_t>> ResolutionOrder_t;
+
+//CollidesWith reads the lazily composed model transformation and doesn't
+//override PrepareForNarrowPhase, so the parallel narrow phase relies on the
+//CollisionManager composing it first
+class Ball : public Collidable, public Moveable
+{
+public:
+   Ball()
+      : index(0), radius(1.0f), resolutionOrder(nullptr)
+   {
+   }
+
+   std::size_t index;
+   float radius;
+   ResolutionOrder_t* resolutionOrder;
+
+   FVector3 Center() const
+   {
+      const Transformation& modelTransformation = CurrentModelTransformation();
+
+      return FVector3(modelTransformation(0, 3), modelTransformation(1, 3), modelTransformation(2, 3));
+   }
+
+   virtual void UpdateBroadCollisionExtent() override
+   {
+      Collidable::UpdateBroadCollisionExtent(Position(), radius);
+   }
+
+   virtual bool CollidesWith(Collidable& collidable) const override
+   {
+      const Ball& other = static_cast<const Ball&>(collidable);
+
+      const float radiusSum = radius + other.radius;
+
+      return SquaredNorm(Center() - other.Center()) <= radiusSum * radiusSum;
+   }
+
+   virtual void ResolveCollision(Collidable& collidable) override
+   {
+      resolutionOrder->push_back( std::make_pair(index, static_cast<const Ball&>(collidable).index) );
+   }
+};
+
+//records the order of the ResolveCollision calls over a number of frames
+//of moving balls. The same seed always produces the same motion
+static std::vector<ResolutionOrder_t> RecordResolutionOrder(ThreadPool* threadPool)
+{
+   const std::size_t numBalls = 2000;
+   const int numFrames = 10;
+
+   std::mt19937 randomEngine(1);
+   std::uniform_real_distribution<float> positionDistribution(-60.0f, 60.0f);
+   std::uniform_real_distribution<float> motionDistribution(-1.0f, 1.0f);
+   std::uniform_real_distribution<float> radiusDistribution(0.5f, 3.0f);
+
+   ResolutionOrder_t resolutionOrder;
+
+   std::vector<Ball> balls(numBalls);
+
+   CollisionManager collisionManager;
+   collisionManager.SetNarrowPhaseThreadPool(threadPool);
+
+   collisionManager.StartAddRemoveBatch();
+
+   for (std::size_t ballIndex = 0; ballIndex < numBalls; ++ballIndex)
+   {
+      Ball& ball = balls[ballIndex];
+
+      ball.index = ballIndex;
+      ball.Translate(FVector3(positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine)));
+      ball.radius = radiusDistribution(randomEngine);
+      ball.resolutionOrder = &resolutionOrder;
+      ball.UpdateBroadCollisionExtent();
+
+      collisionManager.Add(&ball);
+   }
+
+   collisionManager.FinishAddRemoveBatch();
+
+   std::vector<ResolutionOrder_t> resolutionOrderPerFrame;
+
+   std::vector<MoveableMotion> motions(numBalls);
+
+   for (int frame = 0; frame < numFrames; ++frame)
+   {
+      for (MoveableMotion& motion : motions)
+      {
+         motion.translation = FVector3(motionDistribution(randomEngine), motionDistribution(randomEngine), motionDistribution(randomEngine));
+      }
+
+      TickMoveables(balls.data(), motions.data(), numBalls, threadPool);
+
+      for (Ball& ball : balls)
+      {
+         ball.UpdateBroadCollisionExtent();
+
+         collisionManager.Update(&ball);
+      }
+
+      collisionManager.UpdateCollisions();
+
+      resolutionOrder.clear();
+      collisionManager.TransmitCollisions();
+
+      resolutionOrderPerFrame.push_back(resolutionOrder);
+   }
+
+   return resolutionOrderPerFrame;
+}
+
+int main()
+{
+   const std::vector<ResolutionOrder_t> serialOrder = RecordResolutionOrder(nullptr);
+
+   bool anyCollisions = false;
+   for (const ResolutionOrder_t& frameOrder : serialOrder)
+   {
+      anyCollisions = anyCollisions || !frameOrder.empty();
+   }
+
+   LOCUS_CHECK(anyCollisions);
+
+   const unsigned int threadCounts[] = { 1, 2, 4, 8 };
+
+   for (unsigned int numThreads : threadCounts)
+   {
+      ThreadPool threadPool(numThreads);
+
+      const std::vector<ResolutionOrder_t> parallelOrder = RecordResolutionOrder(&threadPool);
+
+      LOCUS_CHECK(parallelOrder == serialOrder);
+   }
+
+   return Test::Finish();
+}
\ No newline at end of file
@@ -0,0 +1,179 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "TestUtility.h"
+
+#include "Locus/Math/SymmetricEigen.h"
+
+#include <array>
+#include <random>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+using namespace Locus;
+
+//checks that the decomposition reconstructs the matrix, that the eigenvectors
+//form a right handed orthonormal basis, and that the eigenvalues are sorted.
+//The residual is relative to the Frobenius norm of the matrix. The checks are
+//done in long double so that they are precise enough for every ScalarType
+template <typename ScalarType>
+static void CheckDecomposition(const std::array<ScalarType, 9>& matrix)
+{
+   const long double tolerance = 64 * static_cast<long double>(std::numeric_limits<ScalarType>::epsilon());
+
+   std::array<ScalarType, 3> eigenvalues;
+   std::array<std::array<ScalarType, 3>, 3> eigenvectors;
+
+   SolveSymmetricEigen3x3<ScalarType>(matrix, eigenvalues, eigenvectors);
+
+   long double frobeniusNorm = 0;
+   for (ScalarType element : matrix)
+   {
+      frobeniusNorm += static_cast<long double>(element) * static_cast<long double>(element);
+   }
+
+   frobeniusNorm = ((frobeniusNorm > 0) ? std::sqrt(frobeniusNorm) : 1);
+
+   long double maxResidual = 0;
+   long double maxOrthogonalityError = 0;
+
+   for (std::size_t i = 0; i < 3; ++i)
+   {
+      for (std::size_t row = 0; row < 3; ++row)
+      {
+         long double product = 0;
+
+         for (std::size_t col = 0; col < 3; ++col)
+         {
+            product += static_cast<long double>(matrix[row * 3 + col]) * static_cast<long double>(eigenvectors[i][col]);
+         }
+
+         maxResidual = std::max(maxResidual, std::fabs(product - static_cast<long double>(eigenvalues[i]) * static_cast<long double>(eigenvectors[i][row])) / frobeniusNorm);
+      }
+
+      for (std::size_t j = 0; j < 3; ++j)
+      {
+         long double dot = 0;
+
+         for (std::size_t k = 0; k < 3; ++k)
+         {
+            dot += static_cast<long double>(eigenvectors[i][k]) * static_cast<long double>(eigenvectors[j][k]);
+         }
+
+         maxOrthogonalityError = std::max(maxOrthogonalityError, std::fabs(dot - ((i == j) ? 1 : 0)));
+      }
+   }
+
+   const std::array<std::array<ScalarType, 3>, 3>& v = eigenvectors;
+
+   long double determinant = static_cast<long double>(v[0][0]) * (static_cast<long double>(v[1][1]) * v[2][2] - static_cast<long double>(v[1][2]) * v[2][1]) -
+                             static_cast<long double>(v[0][1]) * (static_cast<long double>(v[1][0]) * v[2][2] - static_cast<long double>(v[1][2]) * v[2][0]) +
+                             static_cast<long double>(v[0][2]) * (static_cast<long double>(v[1][0]) * v[2][1] - static_cast<long double>(v[1][1]) * v[2][0]);
+
+   LOCUS_CHECK(maxResidual <= tolerance);
+   LOCUS_CHECK(maxOrthogonalityError <= tolerance);
+   LOCUS_CHECK(std::fabs(determinant - 1) <= tolerance);
+   LOCUS_CHECK((eigenvalues[0] >= eigenvalues[1]) && (eigenvalues[1] >= eigenvalues[2]));
+}
+
+//returns R * diag(eigenvalue0, eigenvalue1, eigenvalue2) * R^T for a random rotation R
+template <typename ScalarType>
+static std::array<ScalarType, 9> RandomlyRotatedDiagonal(std::mt19937& randomEngine, double eigenvalue0, double eigenvalue1, double eigenvalue2)
+{
+   std::normal_distribution<double> normalDistribution;
+
+   double q[4] = { normalDistribution(randomEngine), normalDistribution(randomEngine), normalDistribution(randomEngine), normalDistribution(randomEngine) };
+
+   double length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+
+   double w = q[0] / length;
+   double x = q[1] / length;
+   double y = q[2] / length;
+   double z = q[3] / length;
+
+   double rotation[3][3] =
+   {
+      { 1 - 2 * (y * y + z * z), 2 * (x * y - w * z), 2 * (x * z + w * y) },
+      { 2 * (x * y + w * z), 1 - 2 * (x * x + z * z), 2 * (y * z - w * x) },
+      { 2 * (x * z - w * y), 2 * (y * z + w * x), 1 - 2 * (x * x + y * y) }
+   };
+
+   double diagonal[3] = { eigenvalue0, eigenvalue1, eigenvalue2 };
+
+   std::array<ScalarType, 9> matrix;
+
+   for (std::size_t row = 0; row < 3; ++row)
+   {
+      for (std::size_t col = row; col < 3; ++col)
+      {
+         double sum = 0.0;
+
+         for (std::size_t k = 0; k < 3; ++k)
+         {
+            sum += rotation[row][k] * diagonal[k] * rotation[col][k];
+         }
+
+         matrix[row * 3 + col] = static_cast<ScalarType>(sum);
+         matrix[col * 3 + row] = static_cast<ScalarType>(sum);
+      }
+   }
+
+   return matrix;
+}
+
+template <typename ScalarType>
+static void CheckSuite()
+{
+   const ScalarType Zero = 0;
+   const ScalarType One = 1;
+
+   CheckDecomposition<ScalarType>({ Zero, Zero, Zero, Zero, Zero, Zero, Zero, Zero, Zero });
+   CheckDecomposition<ScalarType>({ One, Zero, Zero, Zero, One, Zero, Zero, Zero, One });
+   CheckDecomposition<ScalarType>({ 5 * One, Zero, Zero, Zero, 5 * One, Zero, Zero, Zero, 5 * One });
+   CheckDecomposition<ScalarType>({ One, Zero, Zero, Zero, 3 * One, Zero, Zero, Zero, 2 * One });
+   CheckDecomposition<ScalarType>({ One, One, One, One, One, One, One, One, One });
+   CheckDecomposition<ScalarType>({ 2 * One, -One, Zero, -One, 2 * One, -One, Zero, -One, 2 * One });
+   CheckDecomposition<ScalarType>({ static_cast<ScalarType>(1e-30), Zero, Zero, Zero, static_cast<ScalarType>(1e-30), Zero, Zero, Zero, static_cast<ScalarType>(1e-30) });
+
+   std::mt19937 randomEngine(7);
+   std::uniform_real_distribution<double> eigenvalueDistribution(-10.0, 10.0);
+
+   for (int trial = 0; trial < 2000; ++trial)
+   {
+      double a = eigenvalueDistribution(randomEngine);
+      double b = eigenvalueDistribution(randomEngine);
+      double c = eigenvalueDistribution(randomEngine);
+
+      //distinct eigenvalues
+      CheckDecomposition<ScalarType>(RandomlyRotatedDiagonal<ScalarType>(randomEngine, a, b, c));
+
+      //a repeated pair and a triple
+      CheckDecomposition<ScalarType>(RandomlyRotatedDiagonal<ScalarType>(randomEngine, a, a, c));
+      CheckDecomposition<ScalarType>(RandomlyRotatedDiagonal<ScalarType>(randomEngine, a, a, a));
+
+      //singular: the covariance of planar and collinear point sets
+      CheckDecomposition<ScalarType>(RandomlyRotatedDiagonal<ScalarType>(randomEngine, a, b, 0.0));
+      CheckDecomposition<ScalarType>(RandomlyRotatedDiagonal<ScalarType>(randomEngine, a, 0.0, 0.0));
+
+      //nearly repeated and nearly singular
+      CheckDecomposition<ScalarType>(RandomlyRotatedDiagonal<ScalarType>(randomEngine, a, a * (1.0 + 1e-6), a * (1.0 - 1e-6)));
+      CheckDecomposition<ScalarType>(RandomlyRotatedDiagonal<ScalarType>(randomEngine, a, b, c * 1e-7));
+   }
+}
+
+int main()
+{
+   CheckSuite<float>();
+   CheckSuite<double>();
+   CheckSuite<long double>();
+
+   return Test::Finish();
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#pragma once
+
+#include <iostream>
+
+namespace Locus
+{
+
+namespace Test
+{
+
+inline int& NumFailures()
+{
+   static int numFailures = 0;
+   return numFailures;
+}
+
+inline void Check(bool passed, const char* expression, const char* file, int line)
+{
+   if (!passed)
+   {
+      std::cout << file << "(" << line << "): check failed: " << expression << std::endl;
+      ++NumFailures();
+   }
+}
+
+/// \return the exit code for main.
+inline int Finish()
+{
+   if (NumFailures() == 0)
+   {
+      std::cout << "All checks passed" << std::endl;
+      return 0;
+   }
+
+   std::cout << NumFailures() << " check(s) failed" << std::endl;
+   return 1;
+}
+
+}
+
+}
+
+#define LOCUS_CHECK(expression) Locus::Test::Check((expression), #expression, __FILE__, __LINE__)
\ No newline at end of file
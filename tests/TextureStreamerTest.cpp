@@ -0,0 +1,353 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "TestUtility.h"
+
+#include "Locus/Rendering/TextureStreamer.h"
+#include "Locus/Rendering/Image.h"
+#include "Locus/Rendering/MipChain.h"
+
+#include "Locus/Common/ThreadPool.h"
+#include "Locus/Common/Exception.h"
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+
+#include <cstdio>
+
+using namespace Locus;
+
+//records what would have been uploaded, without a GL context
+class FakeUploader : public TextureUploader
+{
+public:
+   struct Upload_t
+   {
+      std::string textureName;
+      std::size_t numBytes;
+      std::vector<unsigned char> pixelData;
+   };
+
+   std::vector<Upload_t> uploads;
+
+   virtual void Upload(StreamedTexture& streamedTexture) override
+   {
+      if (streamedTexture.textureName == "RejectedByUploader")
+      {
+         throw Exception("Upload failed");
+      }
+
+      Upload_t upload{ streamedTexture.textureName, streamedTexture.NumBytes(), std::vector<unsigned char>() };
+
+      if (streamedTexture.image)
+      {
+         const Image& image = *streamedTexture.image;
+
+         upload.pixelData.assign(image.PixelData(), image.PixelData() + image.Width() * image.Height() * image.NumPixelComponents());
+      }
+
+      uploads.push_back(upload);
+   }
+};
+
+static Image MakeImage(unsigned int width, unsigned int height, unsigned int seed)
+{
+   Image image(width, height, 4);
+
+   for (unsigned int y = 0; y < height; ++y)
+   {
+      for (unsigned int x = 0; x < width; ++x)
+      {
+         unsigned char* pixel = image.GetPixel(x, y);
+
+         pixel[0] = static_cast<unsigned char>(x + seed);
+         pixel[1] = static_cast<unsigned char>(y * 3 + seed);
+         pixel[2] = static_cast<unsigned char>(x ^ y);
+         pixel[3] = 255;
+      }
+   }
+
+   return image;
+}
+
+static std::size_t UploadedBytes(const FakeUploader& uploader, std::size_t firstUpload)
+{
+   std::size_t numBytes = 0;
+
+   for (std::size_t uploadIndex = firstUpload; uploadIndex < uploader.uploads.size(); ++uploadIndex)
+   {
+      numBytes += uploader.uploads[uploadIndex].numBytes;
+   }
+
+   return numBytes;
+}
+
+//uploads until nothing is pending, checking that the budget is only exceeded by single uploads
+static void UploadAll(TextureStreamer& streamer, FakeUploader& uploader, std::size_t uploadBudget)
+{
+   while (streamer.NumPending() > 0)
+   {
+      std::size_t firstUpload = uploader.uploads.size();
+
+      std::size_t numUploaded = streamer.ProcessUploads(uploadBudget);
+
+      LOCUS_CHECK((numUploaded <= 1) || (UploadedBytes(uploader, firstUpload) <= uploadBudget));
+   }
+}
+
+static void TestRequests(ThreadPool* threadPool)
+{
+   const unsigned int numImages = 20;
+
+   FakeUploader uploader;
+   TextureStreamer streamer(uploader);
+   streamer.SetThreadPool(threadPool);
+
+   std::vector<TextureStreamHandle_t> handles;
+
+   for (unsigned int imageIndex = 0; imageIndex < numImages; ++imageIndex)
+   {
+      unsigned int size = 64 + imageIndex;
+
+      Texture::MipmapGeneration mipmapGeneration = ((imageIndex % 2) == 1) ? Texture::MipmapGeneration::Manual : Texture::MipmapGeneration::None;
+
+      handles.push_back(streamer.Request(std::to_string(imageIndex), [size, imageIndex]()
+      {
+         return MakeImage(size, size, imageIndex);
+      },
+      mipmapGeneration, TextureFiltering::Linear, false));
+   }
+
+   TextureStreamHandle_t failedDecodeHandle = streamer.Request("FailedDecode", []()->Image
+   {
+      throw Exception("Decode failed");
+   },
+   Texture::MipmapGeneration::None, TextureFiltering::Linear, false);
+
+   TextureStreamHandle_t failedUploadHandle = streamer.Request("RejectedByUploader", []()
+   {
+      return MakeImage(2, 2, 0);
+   },
+   Texture::MipmapGeneration::None, TextureFiltering::Linear, false);
+
+   UploadAll(streamer, uploader, 40000);
+
+   for (TextureStreamHandle_t handle : handles)
+   {
+      LOCUS_CHECK(streamer.GetState(handle) == TextureStreamer::State::Ready);
+   }
+
+   LOCUS_CHECK(streamer.GetState(failedDecodeHandle) == TextureStreamer::State::Failed);
+   LOCUS_CHECK(streamer.GetState(failedUploadHandle) == TextureStreamer::State::Failed);
+
+   LOCUS_CHECK(uploader.uploads.size() == numImages);
+
+   if (threadPool == nullptr)
+   {
+      //decoded on the calling thread, so uploaded in request order
+      for (unsigned int imageIndex = 0; imageIndex < numImages; ++imageIndex)
+      {
+         LOCUS_CHECK(uploader.uploads[imageIndex].textureName == std::to_string(imageIndex));
+      }
+   }
+
+   //65x65 is scaled to 64x64 before its mip chain is built
+   std::vector<FakeUploader::Upload_t>::const_iterator manualUpload = std::find_if(uploader.uploads.begin(), uploader.uploads.end(), [](const FakeUploader::Upload_t& upload)
+   {
+      return (upload.textureName == "1");
+   });
+
+   LOCUS_CHECK(manualUpload != uploader.uploads.end());
+   LOCUS_CHECK((manualUpload != uploader.uploads.end()) && (manualUpload->numBytes == 4 * (64*64 + 32*32 + 16*16 + 8*8 + 4*4 + 2*2 + 1)));
+
+   //released handles are reused rather than adding a slot per request
+   streamer.Release(failedDecodeHandle);
+   streamer.Release(failedUploadHandle);
+
+   std::vector<TextureStreamHandle_t> reusedHandles;
+
+   for (unsigned int requestIndex = 0; requestIndex < 2; ++requestIndex)
+   {
+      reusedHandles.push_back(streamer.Request("Reused", []()
+      {
+         return MakeImage(2, 2, 0);
+      },
+      Texture::MipmapGeneration::None, TextureFiltering::Linear, false));
+   }
+
+   std::sort(reusedHandles.begin(), reusedHandles.end());
+
+   LOCUS_CHECK(reusedHandles == std::vector<TextureStreamHandle_t>({ std::min(failedDecodeHandle, failedUploadHandle), std::max(failedDecodeHandle, failedUploadHandle) }));
+
+   UploadAll(streamer, uploader, 40000);
+
+   LOCUS_CHECK(streamer.GetState(failedDecodeHandle) == TextureStreamer::State::Ready);
+   LOCUS_CHECK(streamer.GetState(failedUploadHandle) == TextureStreamer::State::Ready);
+
+   //dropping requests that are still being decoded
+   for (unsigned int requestIndex = 0; requestIndex < 10; ++requestIndex)
+   {
+      streamer.Request("Dropped", []()
+      {
+         return MakeImage(32, 32, 0);
+      },
+      Texture::MipmapGeneration::Manual, TextureFiltering::Linear, false);
+   }
+
+   streamer.Clear();
+
+   LOCUS_CHECK(streamer.NumPending() == 0);
+   LOCUS_CHECK(streamer.ProcessUploads(1) == 0);
+}
+
+//decodes the same PNG files directly on several threads that all start at
+//once. This runs first, so it also covers the first decode in the process
+static void TestConcurrentImageDecoding()
+{
+   const unsigned int numFiles = 8;
+   const unsigned int numThreads = 8;
+
+   std::vector<Image> images;
+   std::vector<std::string> filePaths;
+
+   for (unsigned int fileIndex = 0; fileIndex < numFiles; ++fileIndex)
+   {
+      images.push_back(MakeImage(96 + fileIndex, 80, fileIndex));
+      filePaths.push_back("TextureStreamerTest_Direct_" + std::to_string(fileIndex) + ".png");
+
+      LOCUS_CHECK(images.back().SaveAsPNG(filePaths.back()));
+
+      //loading flips the rows, so flip the source the same way
+      images.back().FlipVertically();
+   }
+
+   std::atomic<bool> start(false);
+   std::atomic<unsigned int> numMismatches(0);
+
+   std::vector<std::thread> threads;
+
+   for (unsigned int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+   {
+      threads.emplace_back([&, threadIndex]()
+      {
+         while (!start.load())
+         {
+            std::this_thread::yield();
+         }
+
+         for (unsigned int decodeIndex = 0; decodeIndex < numFiles; ++decodeIndex)
+         {
+            unsigned int fileIndex = (threadIndex + decodeIndex) % numFiles;
+
+            Image decodedImage(filePaths[fileIndex]);
+
+            const Image& image = images[fileIndex];
+
+            std::size_t numBytes = static_cast<std::size_t>(image.Width()) * image.Height() * image.NumPixelComponents();
+
+            if ((decodedImage.Width() != image.Width()) || (decodedImage.Height() != image.Height()) || (decodedImage.NumPixelComponents() != image.NumPixelComponents()) ||
+                !std::equal(image.PixelData(), image.PixelData() + numBytes, decodedImage.PixelData()))
+            {
+               ++numMismatches;
+            }
+         }
+      });
+   }
+
+   start.store(true);
+
+   for (std::thread& thread : threads)
+   {
+      thread.join();
+   }
+
+   LOCUS_CHECK(numMismatches.load() == 0);
+
+   for (const std::string& filePath : filePaths)
+   {
+      std::remove(filePath.c_str());
+   }
+}
+
+//decodes PNG files on several threads at once
+static void TestConcurrentFileDecoding(ThreadPool& threadPool)
+{
+   const unsigned int numFiles = 16;
+
+   std::vector<Image> images;
+   std::vector<std::string> filePaths;
+
+   for (unsigned int fileIndex = 0; fileIndex < numFiles; ++fileIndex)
+   {
+      images.push_back(MakeImage(48 + fileIndex, 40, fileIndex));
+      filePaths.push_back("TextureStreamerTest_" + std::to_string(fileIndex) + ".png");
+
+      LOCUS_CHECK(images.back().SaveAsPNG(filePaths.back()));
+   }
+
+   FakeUploader uploader;
+
+   {
+      TextureStreamer streamer(uploader);
+      streamer.SetThreadPool(&threadPool);
+
+      for (unsigned int repetition = 0; repetition < 4; ++repetition)
+      {
+         for (unsigned int fileIndex = 0; fileIndex < numFiles; ++fileIndex)
+         {
+            std::string filePath = filePaths[fileIndex];
+
+            streamer.Request(std::to_string(fileIndex), [filePath]()
+            {
+               return Image(filePath);
+            },
+            Texture::MipmapGeneration::None, TextureFiltering::Linear, false);
+         }
+      }
+
+      UploadAll(streamer, uploader, 1);
+   }
+
+   LOCUS_CHECK(uploader.uploads.size() == 4 * numFiles);
+
+   for (const FakeUploader::Upload_t& upload : uploader.uploads)
+   {
+      const Image& image = images[std::stoul(upload.textureName)];
+
+      //loading flips the rows, so flip the source the same way
+      Image expectedImage(image);
+      expectedImage.FlipVertically();
+
+      LOCUS_CHECK(std::equal(upload.pixelData.begin(), upload.pixelData.end(), expectedImage.PixelData()) && (upload.pixelData.size() == image.Width() * image.Height() * 4));
+   }
+
+   for (const std::string& filePath : filePaths)
+   {
+      std::remove(filePath.c_str());
+   }
+}
+
+int main()
+{
+   TestConcurrentImageDecoding();
+
+   TestRequests(nullptr);
+
+   ThreadPool threadPool(4);
+
+   TestRequests(&threadPool);
+
+   TestConcurrentFileDecoding(threadPool);
+
+   return Test::Finish();
+}
\ No newline at end of file
@@ -0,0 +1,349 @@
+/********************************************************************************************************\
+*                                                                                                        *
+*   This file is part of the Locus Game Engine                                                           *
+*                                                                                                        *
+*   Copyright (c) 2014 Shachar Avni. All rights reserved.                                                *
+*                                                                                                        *
+*   Use of this file is governed by a BSD-style license. See the accompanying LICENSE.txt for details    *
+*                                                                                                        *
+\********************************************************************************************************/
+
+#include "TestUtility.h"
+
+#include "Locus/Common/InstructionSet.h"
+
+#include "Locus/Geometry/TriangleBatch.h"
+#include "Locus/Geometry/Triangle.h"
+#include "Locus/Geometry/Geometry.h"
+#include "Locus/Geometry/Vector3Geometry.h"
+
+#include <vector>
+#include <limits>
+#include <random>
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <iterator>
+
+using namespace Locus;
+
+//query triangles and a batch of candidates to test each of them against
+struct TrianglePairs
+{
+   std::vector<PlainTriangle3D> queries;
+   std::vector<PlainTriangle3D> candidates;
+};
+
+static PlainTriangle3D MakeTriangle(const FVector3& point0, const FVector3& point1, const FVector3& point2)
+{
+   PlainTriangle3D triangle;
+
+   triangle.points[0] = point0;
+   triangle.points[1] = point1;
+   triangle.points[2] = point2;
+
+   return triangle;
+}
+
+//small triangles around random centers, so that a few candidates intersect each query.
+//If flat is true, then every triangle lies in the z = 0 plane
+static std::vector<PlainTriangle3D> MakeRandomTriangles(std::size_t numTriangles, bool flat, std::mt19937& randomEngine)
+{
+   std::uniform_real_distribution<float> centerDistribution(-1.0f, 1.0f);
+   std::uniform_real_distribution<float> offsetDistribution(-0.4f, 0.4f);
+
+   auto randomPoint = [&](const FVector3& center)->FVector3
+   {
+      return center + FVector3(offsetDistribution(randomEngine), offsetDistribution(randomEngine), (flat ? 0.0f : offsetDistribution(randomEngine)));
+   };
+
+   std::vector<PlainTriangle3D> triangles;
+
+   for (std::size_t triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+   {
+      FVector3 center(centerDistribution(randomEngine), centerDistribution(randomEngine), (flat ? 0.0f : centerDistribution(randomEngine)));
+
+      triangles.push_back(MakeTriangle(randomPoint(center), randomPoint(center), randomPoint(center)));
+   }
+
+   return triangles;
+}
+
+//a torus around the Z axis with two triangles per quad, rotated by the given angle around the X axis and then moved
+static std::vector<PlainTriangle3D> MakeTorus(std::size_t numMajorSegments, std::size_t numMinorSegments, float angle, const FVector3& translation)
+{
+   auto getPoint = [=](std::size_t majorIndex, std::size_t minorIndex)->FVector3
+   {
+      float majorAngle = (TWO_PI * (majorIndex % numMajorSegments)) / numMajorSegments;
+      float minorAngle = (TWO_PI * (minorIndex % numMinorSegments)) / numMinorSegments;
+
+      float distanceFromAxis = 2.0f + 0.6f * std::cos(minorAngle);
+
+      FVector3 point(distanceFromAxis * std::cos(majorAngle), distanceFromAxis * std::sin(majorAngle), 0.6f * std::sin(minorAngle));
+
+      return FVector3(point.x, (point.y * std::cos(angle)) - (point.z * std::sin(angle)), (point.y * std::sin(angle)) + (point.z * std::cos(angle))) + translation;
+   };
+
+   std::vector<PlainTriangle3D> triangles;
+
+   for (std::size_t majorIndex = 0; majorIndex < numMajorSegments; ++majorIndex)
+   {
+      for (std::size_t minorIndex = 0; minorIndex < numMinorSegments; ++minorIndex)
+      {
+         FVector3 corner00 = getPoint(majorIndex, minorIndex);
+         FVector3 corner10 = getPoint(majorIndex + 1, minorIndex);
+         FVector3 corner01 = getPoint(majorIndex, minorIndex + 1);
+         FVector3 corner11 = getPoint(majorIndex + 1, minorIndex + 1);
+
+         triangles.push_back(MakeTriangle(corner00, corner10, corner11));
+         triangles.push_back(MakeTriangle(corner00, corner11, corner01));
+      }
+   }
+
+   return triangles;
+}
+
+//Triangle3D_t::TriangleIntersection only tests the edges of one triangle against
+//the other, so it is called both ways
+static bool ReferenceIntersects(const PlainTriangle3D& triangle1, const PlainTriangle3D& triangle2)
+{
+   Triangle3D_t referenceTriangle1 = ToTriangle(triangle1);
+   Triangle3D_t referenceTriangle2 = ToTriangle(triangle2);
+
+   return (referenceTriangle1.TriangleIntersection(referenceTriangle2) || referenceTriangle2.TriangleIntersection(referenceTriangle1));
+}
+
+static float PointSegmentDistance(const FVector3& point, const FVector3& start, const FVector3& end)
+{
+   FVector3 direction = end - start;
+
+   float t = std::min(std::max(Dot(point - start, direction) / SquaredNorm(direction), 0.0f), 1.0f);
+
+   return Norm(point - (start + direction * t));
+}
+
+static float SegmentSegmentDistance(const FVector3& start1, const FVector3& end1, const FVector3& start2, const FVector3& end2)
+{
+   FVector3 direction1 = end1 - start1;
+   FVector3 direction2 = end2 - start2;
+   FVector3 startOffset = start1 - start2;
+
+   float a = SquaredNorm(direction1);
+   float b = Dot(direction1, direction2);
+   float c = Dot(direction1, startOffset);
+   float e = SquaredNorm(direction2);
+   float f = Dot(direction2, startOffset);
+
+   float denominator = (a * e) - (b * b);
+
+   float s = ((denominator > 0.0f) ? std::min(std::max(((b * f) - (c * e)) / denominator, 0.0f), 1.0f) : 0.0f);
+   float t = ((b * s) + f) / e;
+
+   if (t < 0.0f)
+   {
+      t = 0.0f;
+      s = std::min(std::max(-c / a, 0.0f), 1.0f);
+   }
+   else if (t > 1.0f)
+   {
+      t = 1.0f;
+      s = std::min(std::max((b - c) / a, 0.0f), 1.0f);
+   }
+
+   return Norm((start1 + direction1 * s) - (start2 + direction2 * t));
+}
+
+static float PointTriangleDistance(const FVector3& point, const PlainTriangle3D& triangle)
+{
+   FVector3 edge1 = triangle.points[1] - triangle.points[0];
+   FVector3 edge2 = triangle.points[2] - triangle.points[0];
+   FVector3 normal = Cross(edge1, edge2);
+
+   FVector3 offset = point - triangle.points[0];
+   FVector3 projection = point - normal * (Dot(offset, normal) / SquaredNorm(normal));
+
+   //barycentric coordinates of the projection
+   float v = Dot(Cross(projection - triangle.points[0], edge2), normal);
+   float w = Dot(Cross(edge1, projection - triangle.points[0]), normal);
+
+   if ((v >= 0.0f) && (w >= 0.0f) && (v + w <= SquaredNorm(normal)))
+   {
+      return Norm(point - projection);
+   }
+
+   float distance = PointSegmentDistance(point, triangle.points[0], triangle.points[1]);
+   distance = std::min(distance, PointSegmentDistance(point, triangle.points[1], triangle.points[2]));
+   distance = std::min(distance, PointSegmentDistance(point, triangle.points[2], triangle.points[0]));
+
+   return distance;
+}
+
+//the distance between two triangles that do not intersect
+static float TriangleDistance(const PlainTriangle3D& triangle1, const PlainTriangle3D& triangle2)
+{
+   float distance = std::numeric_limits<float>::max();
+
+   for (int pointIndex = 0; pointIndex < 3; ++pointIndex)
+   {
+      distance = std::min(distance, PointTriangleDistance(triangle1.points[pointIndex], triangle2));
+      distance = std::min(distance, PointTriangleDistance(triangle2.points[pointIndex], triangle1));
+
+      for (int otherPointIndex = 0; otherPointIndex < 3; ++otherPointIndex)
+      {
+         distance = std::min(distance, SegmentSegmentDistance(triangle1.points[pointIndex], triangle1.points[(pointIndex + 1) % 3],
+                                                              triangle2.points[otherPointIndex], triangle2.points[(otherPointIndex + 1) % 3]));
+      }
+   }
+
+   return distance;
+}
+
+//Triangle3D_t compares with a tolerance, so it also reports triangles that
+//only come within about that tolerance of each other. The batch does not
+static const float Near_Contact_Distance = 1e-3f;
+
+//Every kernel the CPU supports must give the same answers as the scalar one
+//and as TrianglesIntersect. Where those differ from Triangle3D_t, the
+//triangles must be disjoint but nearly touching
+static void CheckKernels(const TrianglePairs& pairs)
+{
+   std::vector<std::vector<std::size_t>> referenceIndices(pairs.queries.size());
+
+   std::size_t numIntersecting = 0;
+
+   for (std::size_t queryIndex = 0; queryIndex < pairs.queries.size(); ++queryIndex)
+   {
+      for (std::size_t candidateIndex = 0; candidateIndex < pairs.candidates.size(); ++candidateIndex)
+      {
+         if (ReferenceIntersects(pairs.queries[queryIndex], pairs.candidates[candidateIndex]))
+         {
+            referenceIndices[queryIndex].push_back(candidateIndex);
+         }
+      }
+
+      numIntersecting += referenceIndices[queryIndex].size();
+   }
+
+   //a batch that only gave misses would prove nothing
+   LOCUS_CHECK(numIntersecting > 0);
+
+   TriangleBatch batch;
+
+   for (const PlainTriangle3D& candidate : pairs.candidates)
+   {
+      batch.Add(candidate);
+   }
+
+   std::vector<std::vector<std::size_t>> scalarIndices(pairs.queries.size());
+
+   const InstructionSet supportedInstructionSet = DetectInstructionSet();
+
+   const InstructionSet instructionSets[] = { InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX };
+
+   for (InstructionSet instructionSet : instructionSets)
+   {
+      if (instructionSet > supportedInstructionSet)
+      {
+         std::cout << "instruction set " << static_cast<int>(instructionSet) << " is not supported, so its kernel is not checked" << std::endl;
+         continue;
+      }
+
+      LimitInstructionSet(instructionSet);
+
+      LOCUS_CHECK(DetectInstructionSet() == instructionSet);
+
+      std::size_t numMismatches = 0;
+
+      for (std::size_t queryIndex = 0; queryIndex < pairs.queries.size(); ++queryIndex)
+      {
+         const PlainTriangle3D& query = pairs.queries[queryIndex];
+
+         std::vector<std::size_t> intersectingIndices;
+
+         batch.FindIntersections(query, intersectingIndices);
+
+         std::size_t expectedFirst = (intersectingIndices.empty() ? TriangleBatch::No_Intersection : intersectingIndices.front());
+
+         if (batch.FindFirstIntersection(query) != expectedFirst)
+         {
+            ++numMismatches;
+         }
+
+         if (instructionSet == InstructionSet::Scalar)
+         {
+            scalarIndices[queryIndex] = intersectingIndices;
+
+            std::size_t intersectingPosition = 0;
+
+            for (std::size_t candidateIndex = 0; candidateIndex < pairs.candidates.size(); ++candidateIndex)
+            {
+               bool batchIntersects = ((intersectingPosition < intersectingIndices.size()) && (intersectingIndices[intersectingPosition] == candidateIndex));
+
+               if (batchIntersects)
+               {
+                  ++intersectingPosition;
+               }
+
+               if (batchIntersects != TrianglesIntersect(query, pairs.candidates[candidateIndex]))
+               {
+                  ++numMismatches;
+               }
+            }
+
+            LOCUS_CHECK(intersectingPosition == intersectingIndices.size());
+
+            std::vector<std::size_t> onlyReference;
+            std::vector<std::size_t> onlyBatch;
+
+            std::set_difference(referenceIndices[queryIndex].begin(), referenceIndices[queryIndex].end(), intersectingIndices.begin(), intersectingIndices.end(), std::back_inserter(onlyReference));
+            std::set_difference(intersectingIndices.begin(), intersectingIndices.end(), referenceIndices[queryIndex].begin(), referenceIndices[queryIndex].end(), std::back_inserter(onlyBatch));
+
+            numMismatches += onlyBatch.size();
+
+            for (std::size_t candidateIndex : onlyReference)
+            {
+               if (TriangleDistance(query, pairs.candidates[candidateIndex]) > Near_Contact_Distance)
+               {
+                  ++numMismatches;
+               }
+            }
+         }
+         else if (intersectingIndices != scalarIndices[queryIndex])
+         {
+            ++numMismatches;
+         }
+      }
+
+      LOCUS_CHECK(numMismatches == 0);
+   }
+
+   LimitInstructionSet(InstructionSet::AVX);
+}
+
+int main()
+{
+   std::mt19937 randomEngine(1);
+
+   //candidate counts that leave a partial block for the scalar tail
+   TrianglePairs randomPairs;
+   randomPairs.queries = MakeRandomTriangles(200, false, randomEngine);
+   randomPairs.candidates = MakeRandomTriangles(1003, false, randomEngine);
+
+   CheckKernels(randomPairs);
+
+   //parallel planes go through the coplanar test
+   TrianglePairs coplanarPairs;
+   coplanarPairs.queries = MakeRandomTriangles(100, true, randomEngine);
+   coplanarPairs.candidates = MakeRandomTriangles(501, true, randomEngine);
+
+   CheckKernels(coplanarPairs);
+
+   //two tori whose tubes cross, tested face against face
+   TrianglePairs meshPairs;
+   meshPairs.queries = MakeTorus(32, 12, 0.0f, FVector3(0.0f, 0.0f, 0.0f));
+   meshPairs.candidates = MakeTorus(32, 12, HALF_PI, FVector3(3.0f, 0.0f, 0.0f));
+
+   CheckKernels(meshPairs);
+
+   return Test::Finish();
+}
\ No newline at end of file
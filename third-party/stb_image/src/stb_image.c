@@ -367,8 +367,21 @@ static stbi_uc *stbi__gif_load(stbi__context *s, int *x, int *y, int *comp, int
 static int      stbi__gif_info(stbi__context *s, int *x, int *y, int *comp);
 
 
-// this is not threadsafe
-static const char *stbi__g_failure_reason;
+// each thread keeps its own failure reason, so that images can be decoded
+// concurrently (as in later versions of stb_image)
+#ifndef STBI_THREAD_LOCAL
+   #if defined(_MSC_VER)
+      #define STBI_THREAD_LOCAL __declspec(thread)
+   #elif defined(__GNUC__)
+      #define STBI_THREAD_LOCAL __thread
+   #elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+      #define STBI_THREAD_LOCAL _Thread_local
+   #else
+      #define STBI_THREAD_LOCAL
+   #endif
+#endif
+
+static STBI_THREAD_LOCAL const char *stbi__g_failure_reason;
 
 const char *stbi_failure_reason(void)
 {